@@ -42,6 +42,8 @@ android {
   defaultConfig {
     minSdk = Configuration.minSdk
     testInstrumentationRunner = "androidx.test.runner.AndroidJUnitRunner"
+    // The x86 kernels are mostly run on emulators, so the benchmarks are allowed to run there.
+    testInstrumentationRunnerArguments["androidx.benchmark.suppressErrors"] = "EMULATOR"
     externalNativeBuild {
       cmake {
         cppFlags += "-std=c++17"
@@ -54,6 +56,9 @@ android {
       path = file("src/main/cpp/CMakeLists.txt")
     }
   }
+  // The benchmarks time the native code, so the instrumented tests run against the release
+  // build, which compiles it with optimizations. See src/androidTest/AndroidManifest.xml.
+  testBuildType = "release"
 }
 
 baselineProfile {
@@ -74,6 +79,7 @@ dependencies {
   androidTestImplementation(libs.androidx.test.rules)
   androidTestImplementation(libs.androidx.test.runner)
   androidTestImplementation(libs.androidx.test.junit)
+  androidTestImplementation(libs.androidx.benchmark.junit4)
   androidTestImplementation(libs.androidx.compose.ui)
   androidTestImplementation(libs.androidx.compose.ui.test)
 }
\ No newline at end of file
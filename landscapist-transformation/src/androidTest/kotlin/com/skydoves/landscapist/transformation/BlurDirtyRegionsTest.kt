@@ -0,0 +1,111 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.MediumTest
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@MediumTest
+@RunWith(AndroidJUnit4::class)
+internal class BlurDirtyRegionsTest {
+
+  @Test
+  fun blurDirtyRegions_matchesFullBlur() {
+    for (vectorSize in intArrayOf(1, 4)) {
+      for (edgeMode in EdgeMode.entries) {
+        for (radiusY in intArrayOf(3, 8, 13)) {
+          checkDirtyRegions(vectorSize, radiusY, AlphaType.PREMULTIPLIED, ColorSpace.SRGB, edgeMode)
+        }
+      }
+    }
+    for (edgeMode in EdgeMode.entries) {
+      checkDirtyRegions(4, 8, AlphaType.UNPREMULTIPLIED, ColorSpace.LINEAR, edgeMode)
+    }
+  }
+
+  private fun checkDirtyRegions(
+    vectorSize: Int,
+    radiusY: Int,
+    alphaType: AlphaType,
+    colorSpace: ColorSpace,
+    edgeMode: EdgeMode,
+  ) {
+    val seed = vectorSize * 100 + radiusY * 10 + edgeMode.value
+    val before = randomImage(vectorSize, SIZE_X, SIZE_Y, seed)
+    val changes = randomImage(vectorSize, SIZE_X, SIZE_Y, seed + 1)
+    val after = before.copyOf()
+    for (region in DIRTY_REGIONS) {
+      for (y in region.startY until region.endY) {
+        val start = (y * SIZE_X + region.startX) * vectorSize
+        val end = (y * SIZE_X + region.endX) * vectorSize
+        changes.copyInto(after, start, start, end)
+      }
+    }
+
+    fun blur(image: ByteArray) = RenderScriptToolkit.blur(
+      image,
+      vectorSize,
+      SIZE_X,
+      SIZE_Y,
+      RADIUS_X,
+      radiusY,
+      alphaType,
+      colorSpace,
+      edgeMode,
+    )
+
+    val output = blur(before)
+    RenderScriptToolkit.blurDirtyRegions(
+      after,
+      output,
+      vectorSize,
+      SIZE_X,
+      SIZE_Y,
+      RADIUS_X,
+      radiusY,
+      DIRTY_REGIONS,
+      alphaType,
+      colorSpace,
+      edgeMode,
+    )
+    val expected = blur(after)
+
+    // The SIMD and scalar paths round differently depending on where a span starts.
+    assertTrue(
+      "vectorSize $vectorSize, radiusY $radiusY, $alphaType, $colorSpace, $edgeMode",
+      maxDifference(expected, output) <= 1,
+    )
+  }
+
+  private companion object {
+    const val SIZE_X = 67
+    const val SIZE_Y = 45
+    const val RADIUS_X = 7
+
+    /**
+     * The corner regions expand past two edges, so the wrap mode splits them across the
+     * opposite edges and the mirror mode folds them back.
+     */
+    val DIRTY_REGIONS = listOf(
+      Range2d(0, 5, 0, 4),
+      Range2d(60, 67, 40, 45),
+      Range2d(30, 34, 20, 22),
+    )
+  }
+}
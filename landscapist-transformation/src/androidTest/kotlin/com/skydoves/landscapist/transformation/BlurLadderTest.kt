@@ -0,0 +1,95 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.MediumTest
+import org.junit.Assert.assertArrayEquals
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * The rungs after the first are blurred from the previous rung, so only the first rung is exactly
+ * a direct blur; the others differ from it by up to 15 levels.
+ */
+@MediumTest
+@RunWith(AndroidJUnit4::class)
+internal class BlurLadderTest {
+
+  @Test
+  fun blurLadder_firstRungMatchesBlur() {
+    forEachLadder { input, vectorSize, sizeX, radii, quality, ladder ->
+      val expected = RenderScriptToolkit.blur(input, vectorSize, sizeX, SIZE_Y, radii[0], quality)
+      assertArrayEquals("vectorSize $vectorSize, sizeX $sizeX, $quality", expected, ladder[0])
+    }
+  }
+
+  @Test
+  fun interpolateBlurLadder_atRungRadiusMatchesRung() {
+    forEachLadder { _, vectorSize, sizeX, radii, quality, ladder ->
+      for (rung in radii.indices) {
+        val output = RenderScriptToolkit.interpolateBlurLadder(
+          ladder,
+          radii,
+          vectorSize,
+          sizeX,
+          SIZE_Y,
+          radii[rung].toFloat(),
+        )
+        assertArrayEquals(
+          "vectorSize $vectorSize, sizeX $sizeX, $quality, rung $rung",
+          ladder[rung],
+          output,
+        )
+      }
+    }
+  }
+
+  private fun forEachLadder(
+    check: (
+      input: ByteArray,
+      vectorSize: Int,
+      sizeX: Int,
+      radii: IntArray,
+      quality: BlurQuality,
+      ladder: List<ByteArray>,
+    ) -> Unit,
+  ) {
+    for (quality in BlurQuality.entries) {
+      val radii = if (quality == BlurQuality.GAUSSIAN) GAUSSIAN_RADII else FAST_RADII
+      for (vectorSize in intArrayOf(1, 4)) {
+        for (sizeX in intArrayOf(1, 17, 101)) {
+          val input = randomImage(vectorSize, sizeX, SIZE_Y, seed = vectorSize * 1000 + sizeX)
+          val ladder = RenderScriptToolkit.blurLadder(
+            input,
+            vectorSize,
+            sizeX,
+            SIZE_Y,
+            radii,
+            quality,
+          )
+          check(input, vectorSize, sizeX, radii, quality, ladder)
+        }
+      }
+    }
+  }
+
+  private companion object {
+    const val SIZE_Y = 37
+    val GAUSSIAN_RADII = IntArray(8) { 3 * (it + 1) }
+    val FAST_RADII = IntArray(8) { 5 * (it + 1) }
+  }
+}
@@ -0,0 +1,106 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.MediumTest
+import org.junit.After
+import org.junit.Assert.assertArrayEquals
+import org.junit.Test
+import org.junit.runner.RunWith
+
+/**
+ * The SIMD kernels of the Catmull-Rom resize, the ARM assembly and the x86 kernels that match it,
+ * should give exactly the results of the fixed point model of the assembly.
+ */
+@MediumTest
+@RunWith(AndroidJUnit4::class)
+internal class FixedBicubicResizeTest {
+
+  @After
+  fun restoreSimdLevel() {
+    RenderScriptToolkit.setMaxSimdLevel(SimdLevel.AVX512)
+  }
+
+  @Test
+  fun simdKernels_matchFixedPointModel() {
+    for (level in SimdLevel.entries) {
+      if (level == SimdLevel.SCALAR) continue
+      if (RenderScriptToolkit.setMaxSimdLevel(level) != level) continue
+      for ((index, case) in CASES.withIndex()) {
+        val (inputSizeX, inputSizeY, vectorSize, outputSizeX, outputSizeY) = case
+        val random = randomImage(vectorSize, inputSizeX, inputSizeY, seed = index)
+        // Runs of black and white pixels saturate the results at both ends.
+        val steps = ByteArray(random.size) { if (it / vectorSize % 7 < 3) 0 else -1 }
+        val restriction = Range2d(
+          outputSizeX / 5,
+          outputSizeX - outputSizeX / 7,
+          outputSizeY / 4,
+          outputSizeY - outputSizeY / 6,
+        )
+        for (input in listOf(random, steps)) {
+          for (range in listOf(null, restriction)) {
+            val expected = referenceFixedBicubicResize(
+              input,
+              vectorSize,
+              inputSizeX,
+              inputSizeY,
+              outputSizeX,
+              outputSizeY,
+              range,
+            )
+            val output = RenderScriptToolkit.resize(
+              input,
+              vectorSize,
+              inputSizeX,
+              inputSizeY,
+              outputSizeX,
+              outputSizeY,
+              restriction = range,
+            )
+            val message = "$level, ${inputSizeX}x$inputSizeY to ${outputSizeX}x$outputSizeY, " +
+              "vectorSize $vectorSize, $range"
+            assertArrayEquals(message, expected, output)
+          }
+        }
+      }
+    }
+  }
+
+  private companion object {
+    /**
+     * The input width and height, the vector size and the output width and height. They cover
+     * rows shorter than a kernel step, single pixel inputs, and reductions of up to 1.85.
+     */
+    val CASES = listOf(
+      intArrayOf(64, 64, 4, 128, 128),
+      intArrayOf(50, 40, 4, 70, 25),
+      intArrayOf(3, 2, 4, 17, 9),
+      intArrayOf(1, 1, 4, 5, 3),
+      intArrayOf(1, 1, 1, 37, 3),
+      intArrayOf(2, 2, 2, 41, 5),
+      intArrayOf(7, 5, 1, 100, 50),
+      intArrayOf(33, 170, 4, 47, 301),
+      intArrayOf(1000, 3, 1, 1999, 2),
+      intArrayOf(40, 40, 4, 79, 79),
+      intArrayOf(97, 61, 2, 60, 40),
+      intArrayOf(97, 61, 1, 70, 50),
+      intArrayOf(333, 17, 2, 401, 13),
+      intArrayOf(97, 61, 4, 53, 33),
+      intArrayOf(300, 9, 1, 163, 5),
+    )
+  }
+}
@@ -0,0 +1,81 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.MediumTest
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@MediumTest
+@RunWith(AndroidJUnit4::class)
+internal class LensBlurTest {
+
+  @Test
+  fun lensBlur_matchesBruteForce() {
+    for (vectorSize in intArrayOf(1, 4)) {
+      for (shape in LensShape.entries) {
+        for (radius in intArrayOf(1, 4, 13)) {
+          val message = "vectorSize $vectorSize, $shape, radius $radius"
+          val input = randomImage(vectorSize, SIZE_X, SIZE_Y, seed = vectorSize * 100 + radius)
+          val expected = referenceLensBlur(input, vectorSize, SIZE_X, SIZE_Y, radius, shape)
+          val output = RenderScriptToolkit.lensBlur(
+            input,
+            vectorSize,
+            SIZE_X,
+            SIZE_Y,
+            radius,
+            shape,
+          )
+          assertArrayEquals(message, expected, output)
+
+          val restricted = RenderScriptToolkit.lensBlur(
+            input,
+            vectorSize,
+            SIZE_X,
+            SIZE_Y,
+            radius,
+            shape,
+            RESTRICTION,
+          )
+          for (y in 0 until SIZE_Y) {
+            for (x in 0 until SIZE_X) {
+              val inside = x in RESTRICTION.startX until RESTRICTION.endX &&
+                y in RESTRICTION.startY until RESTRICTION.endY
+              for (c in 0 until vectorSize) {
+                val i = (y * SIZE_X + x) * vectorSize + c
+                val wanted: Byte = if (inside) expected[i] else 0
+                assertTrue("$message, restricted ($x, $y)", restricted[i] == wanted)
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+
+  private companion object {
+    /**
+     * Wide enough for the 16 bit prefix sums of a row to wrap around, which the differences
+     * between them have to survive.
+     */
+    const val SIZE_X = 613
+    const val SIZE_Y = 31
+    val RESTRICTION = Range2d(10, 600, 5, 25)
+  }
+}
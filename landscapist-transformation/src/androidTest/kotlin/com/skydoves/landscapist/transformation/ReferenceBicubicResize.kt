@@ -0,0 +1,68 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import kotlin.math.floor
+
+/**
+ * Resizes an image as [RenderScriptToolkit.resize] did before it used separable tap tables: each
+ * output pixel interpolates 4x4 input pixels with a Catmull-Rom cubic, recomputing the positions
+ * and the horizontal interpolations every time. It takes 4 taps whatever the scale, so large
+ * reductions skip input pixels.
+ */
+internal fun referenceBicubicResize(
+  inputArray: ByteArray,
+  vectorSize: Int,
+  inputSizeX: Int,
+  inputSizeY: Int,
+  outputSizeX: Int,
+  outputSizeY: Int,
+): ByteArray {
+  val scaleX = inputSizeX.toFloat() / outputSizeX
+  val scaleY = inputSizeY.toFloat() / outputSizeY
+  val output = ByteArray(outputSizeX * outputSizeY * vectorSize)
+  val sourceXs = IntArray(4)
+  val pixels = FloatArray(4)
+  val rows = FloatArray(4)
+  for (y in 0 until outputSizeY) {
+    val yf = (y + 0.5f) * scaleY - 0.5f
+    val startY = floor(yf).toInt() - 1
+    for (x in 0 until outputSizeX) {
+      val xf = (x + 0.5f) * scaleX - 0.5f
+      val startX = floor(xf).toInt() - 1
+      for (j in 0 until 4) sourceXs[j] = (startX + j).coerceIn(0, inputSizeX - 1)
+      for (c in 0 until vectorSize) {
+        for (i in 0 until 4) {
+          val row = (startY + i).coerceIn(0, inputSizeY - 1) * inputSizeX
+          for (j in 0 until 4) {
+            val value = inputArray[(row + sourceXs[j]) * vectorSize + c].toInt() and 0xff
+            pixels[j] = value.toFloat()
+          }
+          rows[i] = cubicInterpolate(pixels[0], pixels[1], pixels[2], pixels[3], xf - floor(xf))
+        }
+        val value = cubicInterpolate(rows[0], rows[1], rows[2], rows[3], yf - floor(yf))
+        output[(y * outputSizeX + x) * vectorSize + c] =
+          (value + 0.5f).coerceIn(0f, 255f).toInt().toByte()
+      }
+    }
+  }
+  return output
+}
+
+private fun cubicInterpolate(p0: Float, p1: Float, p2: Float, p3: Float, x: Float): Float {
+  val cubic = 3f * (p1 - p2) + p3 - p0
+  return p1 + 0.5f * x * (p2 - p0 + x * (2f * p0 - 5f * p1 + 4f * p2 - p3 + x * cubic))
+}
@@ -0,0 +1,102 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import kotlin.math.round
+
+/**
+ * Resizes an image as the ARM assembly kernels of [RenderScriptToolkit.resize] do, step by step in
+ * their fixed point, so that the x86 kernels can be checked against them bit for bit.
+ *
+ * The kernels are only used with the Catmull-Rom filter, for premultiplied sRGB cells of 1, 2 or 4
+ * bytes, when neither axis is reduced by 2 or more. The positions along x are stepped from the
+ * start of [restriction], as the kernels step them from the start of each row they process.
+ * Outside of [restriction], the output stays zero.
+ */
+internal fun referenceFixedBicubicResize(
+  inputArray: ByteArray,
+  vectorSize: Int,
+  inputSizeX: Int,
+  inputSizeY: Int,
+  outputSizeX: Int,
+  outputSizeY: Int,
+  restriction: Range2d? = null,
+): ByteArray {
+  val scaleX = inputSizeX.toFloat() / outputSizeX
+  val scaleY = inputSizeY.toFloat() / outputSizeY
+  val area = restriction ?: Range2d(0, outputSizeX, 0, outputSizeY)
+  val output = ByteArray(outputSizeX * outputSizeY * vectorSize)
+  val rowCoefficients = IntArray(4)
+  val columns = IntArray(4)
+  val startX16 = fixedPosition(area.startX, scaleX)
+  val increment16 = round(scaleX * 0x10000).toLong()
+
+  for (y in area.startY until area.endY) {
+    // The vertical coefficients have 16 fractional bits and are saturated to 16 bits unsigned.
+    val y16 = fixedPosition(y, scaleY)
+    val startY = (y16 shr 16).toInt() - 1
+    val yf = (y16 and 0xffff) / 65536.0f
+    val a = round(yf * 0x10000).toInt()
+    val b = round(yf * yf * 0x10000).toInt()
+    val c = round(yf * yf * yf * 0x10000).toInt()
+    rowCoefficients[0] = (-(2 * b - c - a) shr 1).coerceIn(0, 0xffff)
+    rowCoefficients[1] = ((3 * c - 5 * b + 0x20000) shr 1).coerceIn(0, 0xffff)
+    rowCoefficients[2] = ((-3 * c + 4 * b + a) shr 1).coerceIn(0, 0xffff)
+    rowCoefficients[3] = (-(c - b) shr 1).coerceIn(0, 0xffff)
+
+    for (x in area.startX until area.endX) {
+      val x16 = startX16 + (x - area.startX) * increment16
+      val startX = (x16 shr 16).toInt() - 1
+
+      // The horizontal coefficients have 15 fractional bits, from a fraction of 15 bits.
+      val t = (x16 and 0xffff).toInt() shr 1
+      val t2 = (t * t + (1 shl 14)) shr 15
+      val t3 = (t2 * t + (1 shl 14)) shr 15
+      val cubic = 4 * t2 - 3 * t3
+      val v0 = t2 - ((t3 + t) shr 1)
+      val v1 = (((cubic + t2) shr 1) - 0x8000).toShort().toInt()
+      val v2 = (-((cubic + t) shr 1)).toShort().toInt()
+      val v3 = (t3 - t2) shr 1
+
+      for (k in 0 until vectorSize) {
+        // The vertical pass gives 16 bit values with 6 fractional bits.
+        for (j in 0 until 4) {
+          val sourceX = (startX + j).coerceIn(0, inputSizeX - 1)
+          var sum = 0L
+          for (i in 0 until 4) {
+            val sourceY = (startY + i).coerceIn(0, inputSizeY - 1)
+            val pixel = inputArray[(sourceY * inputSizeX + sourceX) * vectorSize + k]
+            val weighted = (pixel.toLong() and 0xff) * rowCoefficients[i]
+            sum += if (i == 0 || i == 3) -weighted else weighted
+          }
+          columns[j] = (sum shr 10).coerceIn(-32768L, 32767L).toInt()
+        }
+        val sum = columns[0].toLong() * v0 - columns[1].toLong() * v1 -
+          columns[2].toLong() * v2 + columns[3].toLong() * v3
+        val value16 = ((sum + (1 shl 14)) shr 15).coerceIn(-32768L, 32767L).toInt()
+        output[(y * outputSizeX + x) * vectorSize + k] =
+          ((value16 + 32) shr 6).coerceIn(0, 255).toByte()
+      }
+    }
+  }
+  return output
+}
+
+/**
+ * The position in the input of the center of output pixel [index], with 16 fractional bits.
+ */
+private fun fixedPosition(index: Int, scale: Float): Long =
+  round(((index + 0.5) * scale - 0.5) * 0x10000).toLong()
@@ -0,0 +1,66 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import kotlin.math.abs
+import kotlin.math.min
+import kotlin.math.sqrt
+
+/**
+ * Applies the lens blur by summing every pixel of the aperture, with clamped edges. It uses the
+ * same aperture and the same float rounding as [RenderScriptToolkit.lensBlur], so the results
+ * should be identical.
+ */
+internal fun referenceLensBlur(
+  inputArray: ByteArray,
+  vectorSize: Int,
+  sizeX: Int,
+  sizeY: Int,
+  radius: Int,
+  shape: LensShape,
+): ByteArray {
+  val halfHeight = if (shape == LensShape.HEXAGON) (radius * 0.8660254f + 0.5f).toInt() else radius
+  val halfWidths = IntArray(2 * halfHeight + 1) { row ->
+    val dy = row - halfHeight
+    val halfWidth = if (shape == LensShape.HEXAGON) {
+      (radius - abs(dy) * 0.57735027f + 0.5f).toInt()
+    } else {
+      val r = radius + 0.5f
+      sqrt(r * r - (dy * dy).toFloat()).toInt()
+    }
+    min(halfWidth, radius)
+  }
+  val scale = 1.0f / halfWidths.sumOf { 2 * it + 1 }
+
+  val output = ByteArray(inputArray.size)
+  for (y in 0 until sizeY) {
+    for (x in 0 until sizeX) {
+      for (c in 0 until vectorSize) {
+        var sum = 0
+        for (dy in -halfHeight..halfHeight) {
+          val halfWidth = halfWidths[dy + halfHeight]
+          val sourceY = (y + dy).coerceIn(0, sizeY - 1)
+          for (dx in -halfWidth..halfWidth) {
+            val sourceX = (x + dx).coerceIn(0, sizeX - 1)
+            sum += inputArray[(sourceY * sizeX + sourceX) * vectorSize + c].toInt() and 0xff
+          }
+        }
+        output[(y * sizeX + x) * vectorSize + c] = (sum * scale + 0.5f).toInt().toByte()
+      }
+    }
+  }
+  return output
+}
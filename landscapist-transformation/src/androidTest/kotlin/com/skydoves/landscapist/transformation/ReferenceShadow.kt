@@ -0,0 +1,77 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+/**
+ * Draws the shadow of an RGBA image in separate steps, as callers did before
+ * [RenderScriptToolkit.shadow]: extracts the alpha channel into an A8 image, blurs it with
+ * transparent edges, then tints it. The A8 image has a margin of [radius] around the output, so
+ * that the input pixels just outside the output still cast their shadow into it.
+ */
+internal fun referenceShadow(
+  inputArray: ByteArray,
+  sizeX: Int,
+  sizeY: Int,
+  radius: Int,
+  color: Int,
+  offsetX: Int,
+  offsetY: Int,
+  outputSizeX: Int,
+  outputSizeY: Int,
+): ByteArray {
+  val alphaSizeX = outputSizeX + 2 * radius
+  val alphaSizeY = outputSizeY + 2 * radius
+  val alpha = ByteArray(alphaSizeX * alphaSizeY)
+  for (y in 0 until sizeY) {
+    val alphaY = y + offsetY + radius
+    if (alphaY !in 0 until alphaSizeY) continue
+    for (x in 0 until sizeX) {
+      val alphaX = x + offsetX + radius
+      if (alphaX !in 0 until alphaSizeX) continue
+      alpha[alphaY * alphaSizeX + alphaX] = inputArray[(y * sizeX + x) * 4 + 3]
+    }
+  }
+
+  val blurred = RenderScriptToolkit.blur(
+    alpha,
+    1,
+    alphaSizeX,
+    alphaSizeY,
+    radius,
+    radius,
+    AlphaType.PREMULTIPLIED,
+    ColorSpace.SRGB,
+    EdgeMode.TRANSPARENT,
+  )
+
+  val colorAlpha = (color ushr 24).toFloat()
+  val red = (color shr 16 and 0xff).toFloat()
+  val green = (color shr 8 and 0xff).toFloat()
+  val blue = (color and 0xff).toFloat()
+  val output = ByteArray(outputSizeX * outputSizeY * 4)
+  for (y in 0 until outputSizeY) {
+    for (x in 0 until outputSizeX) {
+      val blurredAlpha = blurred[(y + radius) * alphaSizeX + x + radius].toInt() and 0xff
+      val coverage = blurredAlpha * colorAlpha / (255f * 255f)
+      val i = (y * outputSizeX + x) * 4
+      output[i] = (red * coverage + 0.5f).toInt().toByte()
+      output[i + 1] = (green * coverage + 0.5f).toInt().toByte()
+      output[i + 2] = (blue * coverage + 0.5f).toInt().toByte()
+      output[i + 3] = (255 * coverage + 0.5f).toInt().toByte()
+    }
+  }
+  return output
+}
@@ -0,0 +1,106 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.MediumTest
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+import kotlin.math.abs
+import kotlin.math.roundToInt
+import kotlin.math.sqrt
+
+@MediumTest
+@RunWith(AndroidJUnit4::class)
+internal class ResizeAlphaTest {
+
+  /**
+   * The transparent pixels of a straight alpha sprite hold pure green, as decoders often leave
+   * them. None of it should bleed into the visible pixels, whose color should stay that of the
+   * sprite up to the rounding of the alpha.
+   */
+  @Test
+  fun resize_unpremultiplied_doesNotBleedTransparentColor() {
+    val input = sprite()
+    for (colorSpace in ColorSpace.entries) {
+      for (filter in ResizeFilter.entries) {
+        for ((outputSizeX, outputSizeY) in OUTPUT_SIZES) {
+          val output = RenderScriptToolkit.resize(
+            input,
+            4,
+            SIZE_X,
+            SIZE_Y,
+            outputSizeX,
+            outputSizeY,
+            filter,
+            AlphaType.UNPREMULTIPLIED,
+            colorSpace,
+          )
+          for (i in 0 until outputSizeX * outputSizeY) {
+            if ((output[i * 4 + 3].toInt() and 0xff) < MIN_ALPHA) continue
+            for (c in 0 until 3) {
+              val difference = abs((output[i * 4 + c].toInt() and 0xff) - SPRITE_COLOR[c])
+              assertTrue(
+                "$colorSpace, $filter, ${outputSizeX}x$outputSizeY, pixel $i, channel $c",
+                difference <= TOLERANCE,
+              )
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * A disc with a soft edge and holes, in [SPRITE_COLOR] where it is visible and in transparent
+   * green elsewhere.
+   */
+  private fun sprite(): ByteArray {
+    val sprite = ByteArray(SIZE_X * SIZE_Y * 4)
+    for (y in 0 until SIZE_Y) {
+      for (x in 0 until SIZE_X) {
+        val dx = x + 0.5 - SIZE_X / 2.0
+        val dy = y + 0.5 - SIZE_Y / 2.0
+        val distance = sqrt(dx * dx + dy * dy)
+        val hole = distance < 10 && (x / 4 + y / 4) % 5 == 0
+        val alpha = when {
+          hole -> 0
+          distance < 12 -> 255
+          distance < 18 -> (255 * (18 - distance) / 6).roundToInt()
+          else -> 0
+        }
+        val color = if (alpha == 0) TRANSPARENT_COLOR else SPRITE_COLOR
+        val i = (y * SIZE_X + x) * 4
+        for (c in 0 until 3) sprite[i + c] = color[c].toByte()
+        sprite[i + 3] = alpha.toByte()
+      }
+    }
+    return sprite
+  }
+
+  private companion object {
+    const val SIZE_X = 64
+    const val SIZE_Y = 48
+    const val MIN_ALPHA = 32
+    const val TOLERANCE = 4
+    val SPRITE_COLOR = intArrayOf(200, 40, 120)
+    val TRANSPARENT_COLOR = intArrayOf(0, 255, 0)
+
+    /** Reductions by 2, 1.5 and 3, and enlargements by 2 and 1.5. */
+    val OUTPUT_SIZES = listOf(32 to 24, 43 to 32, 21 to 16, 128 to 96, 97 to 70)
+  }
+}
@@ -0,0 +1,102 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.MediumTest
+import org.junit.Assert.assertArrayEquals
+import org.junit.Assert.assertEquals
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@MediumTest
+@RunWith(AndroidJUnit4::class)
+internal class ResizeStreamTest {
+
+  /**
+   * The stream uses the resampling of [RenderScriptToolkit.resize], except for the fixed point
+   * SIMD kernels of the Catmull-Rom filter, so it should match resize exactly with the other
+   * filters.
+   */
+  @Test
+  fun resizeStream_matchesResize() {
+    for (filter in ResizeFilter.entries) {
+      if (filter == ResizeFilter.CATMULL_ROM) continue
+      for (vectorSize in 1..4) {
+        for ((index, size) in SIZES.withIndex()) {
+          val (inputSizeX, inputSizeY, outputSizeX, outputSizeY) = size
+          val cellSize = paddedSize(vectorSize)
+          val input = randomImage(cellSize, inputSizeX, inputSizeY, seed = index * 10 + vectorSize)
+          if (vectorSize == 3) {
+            for (i in 3 until input.size step 4) input[i] = 0
+          }
+          val expected = RenderScriptToolkit.resize(
+            input,
+            vectorSize,
+            inputSizeX,
+            inputSizeY,
+            outputSizeX,
+            outputSizeY,
+            filter,
+          )
+
+          val output = ByteArray(expected.size)
+          var outputRowCount = 0
+          RenderScriptToolkit.createResizeStream(
+            vectorSize,
+            inputSizeX,
+            inputSizeY,
+            outputSizeX,
+            outputSizeY,
+            filter,
+          ).use { stream ->
+            val inputRowSize = inputSizeX * cellSize
+            val outputRowSize = outputSizeX * cellSize
+            val outputRows = ByteArray(stream.maxRowsPerPush * outputRowSize)
+            for (y in 0 until inputSizeY) {
+              val inputRow = input.copyOfRange(y * inputRowSize, (y + 1) * inputRowSize)
+              val rows = stream.pushRow(inputRow, outputRows)
+              if (outputRowCount + rows <= outputSizeY) {
+                outputRows.copyInto(output, outputRowCount * outputRowSize, 0, rows * outputRowSize)
+              }
+              outputRowCount += rows
+            }
+          }
+
+          val message = "$filter, vectorSize $vectorSize, " +
+            "${inputSizeX}x$inputSizeY to ${outputSizeX}x$outputSizeY"
+          assertEquals("$message, rows", outputSizeY, outputRowCount)
+          assertArrayEquals(message, expected, output)
+        }
+      }
+    }
+  }
+
+  private companion object {
+    /** The input width and height and the output width and height. */
+    val SIZES = listOf(
+      intArrayOf(97, 61, 40, 30),
+      intArrayOf(97, 61, 60, 40),
+      intArrayOf(97, 61, 150, 100),
+      intArrayOf(200, 150, 13, 7),
+      intArrayOf(64, 64, 64, 64),
+      intArrayOf(1, 1, 5, 3),
+      intArrayOf(7, 5, 1, 1),
+      intArrayOf(300, 9, 100, 30),
+      intArrayOf(9, 300, 30, 100),
+    )
+  }
+}
@@ -0,0 +1,103 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.MediumTest
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import kotlin.math.abs
+
+@MediumTest
+@RunWith(AndroidJUnit4::class)
+internal class ResizeToTensorTest {
+
+  /**
+   * With a scale of 1 and a bias of 0, or -128 for signed bytes, each plane of the tensor holds a
+   * channel of the resized image. The tensor isn't rounded to bytes, and the SIMD kernels of the
+   * Catmull-Rom filter round differently than the float path of the tensors, so the values may
+   * differ by up to 1.
+   */
+  @Test
+  fun resizeToTensor_planesMatchResize() {
+    for (type in TensorType.entries) {
+      val bias = if (type == TensorType.INT8) -128f else 0f
+      for (filter in ResizeFilter.entries) {
+        for ((index, size) in SIZES.withIndex()) {
+          val (inputSizeX, inputSizeY, outputSizeX, outputSizeY) = size
+          // Opaque, so that the values of the tensor, which aren't premultiplied, are the same.
+          val input = randomImage(4, inputSizeX, inputSizeY, seed = index)
+          for (i in 3 until input.size step 4) input[i] = -1
+          val expected = RenderScriptToolkit.resize(
+            input,
+            4,
+            inputSizeX,
+            inputSizeY,
+            outputSizeX,
+            outputSizeY,
+            filter,
+          )
+
+          val planeSize = outputSizeX * outputSizeY
+          val tensor = ByteBuffer.allocateDirect(3 * planeSize * type.size)
+            .order(ByteOrder.nativeOrder())
+          RenderScriptToolkit.resizeToTensor(
+            input,
+            inputSizeX,
+            inputSizeY,
+            outputSizeX,
+            outputSizeY,
+            tensor,
+            floatArrayOf(1f, 1f, 1f),
+            floatArrayOf(bias, bias, bias),
+            type,
+            filter,
+          )
+
+          for (c in 0 until 3) {
+            for (i in 0 until planeSize) {
+              val value = when (type) {
+                TensorType.FLOAT32 -> tensor.getFloat((c * planeSize + i) * 4)
+                TensorType.INT8 -> tensor.get(c * planeSize + i).toFloat()
+              }
+              val difference = abs(value - bias - (expected[i * 4 + c].toInt() and 0xff))
+              assertTrue(
+                "$type, $filter, ${inputSizeX}x$inputSizeY to ${outputSizeX}x$outputSizeY, " +
+                  "channel $c, value $i",
+                difference <= 1f,
+              )
+            }
+          }
+        }
+      }
+    }
+  }
+
+  private companion object {
+    /** The input width and height and the output width and height. */
+    val SIZES = listOf(
+      intArrayOf(97, 61, 40, 30),
+      intArrayOf(97, 61, 60, 40),
+      intArrayOf(97, 61, 150, 100),
+      intArrayOf(640, 480, 224, 224),
+      intArrayOf(1, 1, 5, 3),
+      intArrayOf(300, 9, 100, 30),
+    )
+  }
+}
@@ -0,0 +1,79 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.MediumTest
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+import kotlin.random.Random
+
+@MediumTest
+@RunWith(AndroidJUnit4::class)
+internal class ShadowTest {
+
+  @Test
+  fun shadow_matchesSeparateSteps() {
+    val random = Random(3)
+    for (sizeX in intArrayOf(1, 5, 40, 301)) {
+      for (sizeY in intArrayOf(1, 7, 64)) {
+        for (radius in intArrayOf(1, 5, 25)) {
+          // The padding grows the output on the right and at the bottom, and the offsets move
+          // the input past the left and top edges.
+          for (padding in intArrayOf(0, 3, 30)) {
+            for (shift in intArrayOf(-10, 0, 4)) {
+              val input = random.nextBytes(sizeX * sizeY * 4)
+              val color = (0x80 shl 24) or random.nextInt(0x1000000)
+              val outputSizeX = sizeX + 2 * padding
+              val outputSizeY = sizeY + padding
+              val offsetX = shift + padding
+              val offsetY = shift / 2 + padding / 2
+
+              val fused = RenderScriptToolkit.shadow(
+                input,
+                sizeX,
+                sizeY,
+                radius,
+                color,
+                offsetX,
+                offsetY,
+                outputSizeX,
+                outputSizeY,
+              )
+              val separate = referenceShadow(
+                input,
+                sizeX,
+                sizeY,
+                radius,
+                color,
+                offsetX,
+                offsetY,
+                outputSizeX,
+                outputSizeY,
+              )
+
+              assertTrue(
+                "${sizeX}x$sizeY, radius $radius, padding $padding, shift $shift",
+                maxDifference(separate, fused) <= 1,
+              )
+            }
+          }
+        }
+      }
+    }
+  }
+}
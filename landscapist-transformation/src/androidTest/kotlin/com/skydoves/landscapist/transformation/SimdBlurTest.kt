@@ -0,0 +1,74 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.MediumTest
+import org.junit.After
+import org.junit.Assert.assertTrue
+import org.junit.Test
+import org.junit.runner.RunWith
+
+@MediumTest
+@RunWith(AndroidJUnit4::class)
+internal class SimdBlurTest {
+
+  @After
+  fun restoreSimdLevel() {
+    RenderScriptToolkit.setMaxSimdLevel(SimdLevel.AVX512)
+  }
+
+  @Test
+  fun simdKernels_matchScalarAndBaseline() {
+    for (vectorSize in intArrayOf(1, 4)) {
+      // Widths that leave remainders for every kernel width, from 1 to 16 pixels.
+      for (sizeX in intArrayOf(1, 3, 17, 64, 101, 257)) {
+        for (radius in intArrayOf(1, 2, 5, 13, 25)) {
+          val input = randomImage(vectorSize, sizeX, SIZE_Y, seed = sizeX * radius + vectorSize)
+          val expected = blurWith(SimdLevel.SCALAR, input, vectorSize, sizeX, radius)!!
+          val baseline = blurWith(SimdLevel.BASELINE, input, vectorSize, sizeX, radius)
+          for (level in SimdLevel.entries) {
+            val actual = blurWith(level, input, vectorSize, sizeX, radius) ?: continue
+            val case = "$level, vectorSize $vectorSize, ${sizeX}x$SIZE_Y, radius $radius"
+            // The SIMD kernels round differently, and the wider ones use FMA.
+            assertTrue("$case vs scalar", maxDifference(expected, actual) <= 1)
+            if (baseline != null) {
+              assertTrue("$case vs baseline", maxDifference(baseline, actual) <= 1)
+            }
+          }
+        }
+      }
+    }
+  }
+
+  /**
+   * Blurs with the kernels of [level], or returns null if the processor doesn't support them.
+   */
+  private fun blurWith(
+    level: SimdLevel,
+    input: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    radius: Int,
+  ): ByteArray? {
+    if (RenderScriptToolkit.setMaxSimdLevel(level) != level) return null
+    return RenderScriptToolkit.blur(input, vectorSize, sizeX, SIZE_Y, radius)
+  }
+
+  private companion object {
+    const val SIZE_Y = 23
+  }
+}
@@ -0,0 +1,72 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation
+
+import kotlin.math.abs
+import kotlin.math.cos
+import kotlin.math.sin
+import kotlin.random.Random
+
+/**
+ * A random image, the same for the same seed. Cells of 4 bytes are premultiplied RGBA: each color
+ * channel is at most the alpha of its pixel.
+ */
+internal fun randomImage(vectorSize: Int, sizeX: Int, sizeY: Int, seed: Int): ByteArray {
+  val random = Random(seed)
+  val image = random.nextBytes(sizeX * sizeY * vectorSize)
+  if (vectorSize == 4) {
+    for (i in image.indices step 4) {
+      val alpha = image[i + 3].toInt() and 0xff
+      for (c in 0 until 3) {
+        image[i + c] = ((image[i + c].toInt() and 0xff) * alpha / 255).toByte()
+      }
+    }
+  }
+  return image
+}
+
+/**
+ * An RGBA image that looks more like a photo than noise does: smooth gradients, sharp edges
+ * between squares of 40x40 pixels, and a little noise. It's opaque and the same for the same seed.
+ */
+internal fun syntheticImage(sizeX: Int, sizeY: Int, seed: Int): ByteArray {
+  val random = Random(seed)
+  val image = ByteArray(sizeX * sizeY * 4)
+  for (y in 0 until sizeY) {
+    for (x in 0 until sizeX) {
+      val square = if ((x / 40 + y / 40) % 2 == 1) 20.0 else -20.0
+      for (c in 0 until 3) {
+        val value = 128 + 60 * sin(x * 0.05 + c) + 40 * cos(y * 0.07 * (c + 1)) + square +
+          random.nextInt(-10, 11)
+        image[(y * sizeX + x) * 4 + c] = value.coerceIn(0.0, 255.0).toInt().toByte()
+      }
+      image[(y * sizeX + x) * 4 + 3] = 255.toByte()
+    }
+  }
+  return image
+}
+
+/**
+ * The largest difference between the unsigned bytes at the same index of two arrays.
+ */
+internal fun maxDifference(expected: ByteArray, actual: ByteArray): Int {
+  require(expected.size == actual.size)
+  var max = 0
+  for (i in expected.indices) {
+    max = maxOf(max, abs((expected[i].toInt() and 0xff) - (actual[i].toInt() and 0xff)))
+  }
+  return max
+}
@@ -0,0 +1,71 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import android.util.Log
+import java.util.Locale
+import kotlin.math.log10
+
+/**
+ * Prints a table of measurements, e.g. of quality next to speed, to logcat with the results of
+ * the benchmarks.
+ */
+internal fun reportTable(title: String, header: List<String>, rows: List<List<String>>) {
+  val widths = header.indices.map { column ->
+    maxOf(header[column].length, rows.maxOfOrNull { it[column].length } ?: 0)
+  }
+  val table = buildString {
+    appendLine(title)
+    for (row in listOf(header) + rows) {
+      val cells = row.mapIndexed { column, cell -> cell.padStart(widths[column]) }
+      appendLine(cells.joinToString("  "))
+    }
+  }
+  Log.i("Benchmark", table)
+}
+
+/**
+ * The shortest time [block] takes over [runs] runs, in milliseconds, after a warm-up run. For the
+ * tables that put times next to other measurements; the benchmarks themselves use BenchmarkRule.
+ */
+internal inline fun minMillis(runs: Int = 5, block: () -> Unit): Double {
+  block()
+  var best = Long.MAX_VALUE
+  repeat(runs) {
+    val start = System.nanoTime()
+    block()
+    best = minOf(best, System.nanoTime() - start)
+  }
+  return best / 1e6
+}
+
+/**
+ * The peak signal-to-noise ratio of [actual] against [expected], in dB, for 8 bit values.
+ */
+internal fun psnr(expected: FloatArray, actual: ByteArray): Double {
+  var sum = 0.0
+  for (i in expected.indices) {
+    val difference = (actual[i].toInt() and 0xff) - expected[i].toDouble()
+    sum += difference * difference
+  }
+  return 10 * log10(255.0 * 255.0 * expected.size / sum)
+}
+
+/**
+ * This number with a fixed number of decimals, for the tables.
+ */
+internal fun Double.format(decimals: Int = 1): String =
+  String.format(Locale.US, "%.${decimals}f", this)
@@ -0,0 +1,83 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.Range2d
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.randomImage
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runners.Parameterized
+
+/**
+ * The update of a blurred image after 5% of it changed, against blurring it all again.
+ */
+@LargeTest
+@RunWith(Parameterized::class)
+internal class BlurDirtyRegionsBenchmark(private val vectorSize: Int, private val radius: Int) {
+
+  @get:Rule
+  val benchmarkRule = BenchmarkRule()
+
+  private val input = randomImage(vectorSize, SIZE_X, SIZE_Y, seed = 1)
+
+  @Test
+  fun fullBlur() {
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.blur(input, vectorSize, SIZE_X, SIZE_Y, radius)
+    }
+  }
+
+  @Test
+  fun dirtyRegion() {
+    val output = RenderScriptToolkit.blur(input, vectorSize, SIZE_X, SIZE_Y, radius)
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.blurDirtyRegions(
+        input,
+        output,
+        vectorSize,
+        SIZE_X,
+        SIZE_Y,
+        radius,
+        radius,
+        DIRTY_REGIONS,
+      )
+    }
+  }
+
+  companion object {
+    private const val SIZE_X = 2000
+    private const val SIZE_Y = 1500
+
+    /**
+     * 447x335, 5% of the image.
+     */
+    private val DIRTY_REGIONS = listOf(Range2d(800, 1247, 600, 935))
+
+    @JvmStatic
+    @Parameterized.Parameters(name = "vectorSize{0}_radius{1}")
+    fun parameters(): List<Array<Int>> = listOf(
+      arrayOf(4, 5),
+      arrayOf(4, 25),
+      arrayOf(1, 5),
+      arrayOf(1, 25),
+    )
+  }
+}
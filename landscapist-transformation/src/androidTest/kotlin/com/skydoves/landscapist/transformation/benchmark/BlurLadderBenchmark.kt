@@ -0,0 +1,70 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.BlurQuality
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.randomImage
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runners.Parameterized
+
+/**
+ * A ladder of 8 radii against 8 separate blurs of the same image, with the radii 3 to 24 for the
+ * Gaussian blur and 5 to 40 for the fast blur.
+ */
+@LargeTest
+@RunWith(Parameterized::class)
+internal class BlurLadderBenchmark(private val sizeX: Int, private val quality: BlurQuality) {
+
+  @get:Rule
+  val benchmarkRule = BenchmarkRule()
+
+  private val sizeY = sizeX * 3 / 4
+  private val input = randomImage(4, sizeX, sizeY, seed = 1)
+  private val radii = IntArray(8) { (it + 1) * if (quality == BlurQuality.GAUSSIAN) 3 else 5 }
+
+  @Test
+  fun ladder() {
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.blurLadder(input, 4, sizeX, sizeY, radii, quality)
+    }
+  }
+
+  @Test
+  fun separateBlurs() {
+    benchmarkRule.measureRepeated {
+      for (radius in radii) {
+        RenderScriptToolkit.blur(input, 4, sizeX, sizeY, radius, quality)
+      }
+    }
+  }
+
+  companion object {
+    @JvmStatic
+    @Parameterized.Parameters(name = "sizeX{0}_{1}")
+    fun parameters(): List<Array<Any>> = listOf(
+      arrayOf(1000, BlurQuality.GAUSSIAN),
+      arrayOf(1000, BlurQuality.FAST),
+      arrayOf(2000, BlurQuality.GAUSSIAN),
+      arrayOf(2000, BlurQuality.FAST),
+    )
+  }
+}
@@ -0,0 +1,113 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import android.graphics.RectF
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.randomImage
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runners.Parameterized
+
+/**
+ * Square center-crop thumbnails of a 4000x3000 RGBA picture, as ContentScale.Crop shows them: in
+ * one pass with a source rectangle, by copying the crop out then resizing it, and by resizing the
+ * whole picture then copying the center of the result out.
+ */
+@LargeTest
+@RunWith(Parameterized::class)
+internal class CropResizeBenchmark(private val thumbnailSize: Int) {
+
+  @get:Rule
+  val benchmarkRule = BenchmarkRule()
+
+  private val input = randomImage(4, INPUT_SIZE_X, INPUT_SIZE_Y, seed = 1)
+  private val cropStartX = (INPUT_SIZE_X - INPUT_SIZE_Y) / 2
+
+  @Test
+  fun sourceRect() {
+    val sourceRect = RectF(
+      cropStartX.toFloat(),
+      0f,
+      (cropStartX + INPUT_SIZE_Y).toFloat(),
+      INPUT_SIZE_Y.toFloat(),
+    )
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.resize(
+        input,
+        4,
+        INPUT_SIZE_X,
+        INPUT_SIZE_Y,
+        thumbnailSize,
+        thumbnailSize,
+        sourceRect = sourceRect,
+      )
+    }
+  }
+
+  @Test
+  fun cropThenResize() {
+    benchmarkRule.measureRepeated {
+      val crop = ByteArray(INPUT_SIZE_Y * INPUT_SIZE_Y * 4)
+      for (y in 0 until INPUT_SIZE_Y) {
+        val start = (y * INPUT_SIZE_X + cropStartX) * 4
+        input.copyInto(crop, y * INPUT_SIZE_Y * 4, start, start + INPUT_SIZE_Y * 4)
+      }
+      RenderScriptToolkit.resize(
+        crop,
+        4,
+        INPUT_SIZE_Y,
+        INPUT_SIZE_Y,
+        thumbnailSize,
+        thumbnailSize,
+      )
+    }
+  }
+
+  @Test
+  fun resizeThenCrop() {
+    val scaledSizeX = thumbnailSize * INPUT_SIZE_X / INPUT_SIZE_Y
+    val scaledStartX = (scaledSizeX - thumbnailSize) / 2
+    benchmarkRule.measureRepeated {
+      val scaled = RenderScriptToolkit.resize(
+        input,
+        4,
+        INPUT_SIZE_X,
+        INPUT_SIZE_Y,
+        scaledSizeX,
+        thumbnailSize,
+      )
+      val thumbnail = ByteArray(thumbnailSize * thumbnailSize * 4)
+      for (y in 0 until thumbnailSize) {
+        val start = (y * scaledSizeX + scaledStartX) * 4
+        scaled.copyInto(thumbnail, y * thumbnailSize * 4, start, start + thumbnailSize * 4)
+      }
+    }
+  }
+
+  companion object {
+    private const val INPUT_SIZE_X = 4000
+    private const val INPUT_SIZE_Y = 3000
+
+    @JvmStatic
+    @Parameterized.Parameters(name = "thumbnail{0}")
+    fun parameters(): List<Array<Int>> = listOf(arrayOf(256), arrayOf(1080))
+  }
+}
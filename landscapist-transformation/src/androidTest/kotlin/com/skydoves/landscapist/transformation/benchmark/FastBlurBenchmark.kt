@@ -0,0 +1,110 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.BlurQuality
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.syntheticImage
+import org.junit.Test
+import org.junit.runner.RunWith
+import kotlin.math.exp
+
+/**
+ * The quality and the speed of the fast blur against the Gaussian blur. The quality is the PSNR
+ * against an exact float Gaussian blur. The Gaussian blur only goes up to a radius of 25.
+ */
+@LargeTest
+@RunWith(AndroidJUnit4::class)
+internal class FastBlurBenchmark {
+
+  @Test
+  fun qualityAndSpeed() {
+    val input = syntheticImage(SIZE_X, SIZE_Y, seed = 1)
+    val rows = RADII.map { radius ->
+      val expected = floatGaussianBlur(input, radius)
+      val fast = RenderScriptToolkit.blur(input, 4, SIZE_X, SIZE_Y, radius, BlurQuality.FAST)
+      val fastTime = minMillis {
+        RenderScriptToolkit.blur(input, 4, SIZE_X, SIZE_Y, radius, BlurQuality.FAST)
+      }
+      if (radius <= 25) {
+        val gaussian = RenderScriptToolkit.blur(input, 4, SIZE_X, SIZE_Y, radius)
+        val gaussianTime = minMillis { RenderScriptToolkit.blur(input, 4, SIZE_X, SIZE_Y, radius) }
+        listOf(
+          "$radius",
+          psnr(expected, gaussian).format(),
+          psnr(expected, fast).format(),
+          gaussianTime.format(),
+          fastTime.format(),
+        )
+      } else {
+        listOf("$radius", "-", psnr(expected, fast).format(), "-", fastTime.format())
+      }
+    }
+    reportTable(
+      "Fast blur against Gaussian, ${SIZE_X}x$SIZE_Y RGBA",
+      listOf("radius", "gaussian dB", "fast dB", "gaussian ms", "fast ms"),
+      rows,
+    )
+  }
+
+  /**
+   * Blurs the RGBA [input] in double precision with the kernel of the Gaussian blur: a sigma
+   * of 0.4 * radius + 0.6, cut at the radius, and clamped edges.
+   */
+  private fun floatGaussianBlur(input: ByteArray, radius: Int): FloatArray {
+    val sigma = 0.4 * radius + 0.6
+    val kernel = DoubleArray(2 * radius + 1) {
+      val distance = (it - radius).toDouble()
+      exp(-distance * distance / (2 * sigma * sigma))
+    }
+    val sum = kernel.sum()
+    for (i in kernel.indices) kernel[i] /= sum
+
+    val vertical = FloatArray(input.size)
+    for (y in 0 until SIZE_Y) {
+      for (x in 0 until SIZE_X * 4) {
+        var value = 0.0
+        for (i in -radius..radius) {
+          val sourceY = (y + i).coerceIn(0, SIZE_Y - 1)
+          value += kernel[i + radius] * (input[sourceY * SIZE_X * 4 + x].toInt() and 0xff)
+        }
+        vertical[y * SIZE_X * 4 + x] = value.toFloat()
+      }
+    }
+    val output = FloatArray(input.size)
+    for (y in 0 until SIZE_Y) {
+      for (x in 0 until SIZE_X) {
+        for (c in 0 until 4) {
+          var value = 0.0
+          for (i in -radius..radius) {
+            val sourceX = (x + i).coerceIn(0, SIZE_X - 1)
+            value += kernel[i + radius] * vertical[(y * SIZE_X + sourceX) * 4 + c]
+          }
+          output[(y * SIZE_X + x) * 4 + c] = value.toFloat()
+        }
+      }
+    }
+    return output
+  }
+
+  private companion object {
+    const val SIZE_X = 1024
+    const val SIZE_Y = 768
+    val RADII = intArrayOf(6, 10, 16, 25, 50, 100, 250)
+  }
+}
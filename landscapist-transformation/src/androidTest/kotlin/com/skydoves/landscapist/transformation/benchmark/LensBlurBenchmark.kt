@@ -0,0 +1,71 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.LensShape
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.randomImage
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runners.Parameterized
+
+/**
+ * The lens blur with each aperture against the Gaussian blur of the same radius, on a 2000x1500
+ * RGBA image.
+ */
+@LargeTest
+@RunWith(Parameterized::class)
+internal class LensBlurBenchmark(private val radius: Int) {
+
+  @get:Rule
+  val benchmarkRule = BenchmarkRule()
+
+  private val input = randomImage(4, SIZE_X, SIZE_Y, seed = 1)
+
+  @Test
+  fun gaussian() {
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.blur(input, 4, SIZE_X, SIZE_Y, radius)
+    }
+  }
+
+  @Test
+  fun disc() {
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.lensBlur(input, 4, SIZE_X, SIZE_Y, radius, LensShape.DISC)
+    }
+  }
+
+  @Test
+  fun hexagon() {
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.lensBlur(input, 4, SIZE_X, SIZE_Y, radius, LensShape.HEXAGON)
+    }
+  }
+
+  companion object {
+    private const val SIZE_X = 2000
+    private const val SIZE_Y = 1500
+
+    @JvmStatic
+    @Parameterized.Parameters(name = "radius{0}")
+    fun parameters(): List<Array<Int>> = listOf(arrayOf(5), arrayOf(10), arrayOf(25))
+  }
+}
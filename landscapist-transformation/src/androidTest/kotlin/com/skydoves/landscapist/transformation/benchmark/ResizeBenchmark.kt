@@ -0,0 +1,80 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.randomImage
+import com.skydoves.landscapist.transformation.referenceBicubicResize
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runners.Parameterized
+
+/**
+ * Resizes a 12 MP picture to 1080x810 with the separable resize, and with a port of the former
+ * per-pixel bicubic path for comparison.
+ */
+@LargeTest
+@RunWith(Parameterized::class)
+internal class ResizeBenchmark(private val vectorSize: Int) {
+
+  @get:Rule
+  val benchmarkRule = BenchmarkRule()
+
+  private val input = randomImage(vectorSize, INPUT_SIZE_X, INPUT_SIZE_Y, seed = 1)
+
+  @Test
+  fun separable() {
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.resize(
+        input,
+        vectorSize,
+        INPUT_SIZE_X,
+        INPUT_SIZE_Y,
+        OUTPUT_SIZE_X,
+        OUTPUT_SIZE_Y,
+      )
+    }
+  }
+
+  @Test
+  fun perPixelBicubic() {
+    benchmarkRule.measureRepeated {
+      referenceBicubicResize(
+        input,
+        vectorSize,
+        INPUT_SIZE_X,
+        INPUT_SIZE_Y,
+        OUTPUT_SIZE_X,
+        OUTPUT_SIZE_Y,
+      )
+    }
+  }
+
+  companion object {
+    private const val INPUT_SIZE_X = 4000
+    private const val INPUT_SIZE_Y = 3000
+    private const val OUTPUT_SIZE_X = 1080
+    private const val OUTPUT_SIZE_Y = 810
+
+    @JvmStatic
+    @Parameterized.Parameters(name = "vectorSize{0}")
+    fun parameters(): List<Array<Int>> = listOf(arrayOf(4), arrayOf(1))
+  }
+}
@@ -0,0 +1,78 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.AlphaType
+import com.skydoves.landscapist.transformation.ColorSpace
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.ResizeFilter
+import com.skydoves.landscapist.transformation.randomImage
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runners.Parameterized
+
+/**
+ * The cost of resizing in linear light against resizing the sRGB values directly, reducing a
+ * 1620x1215 RGBA image by 1.5 with the Catmull-Rom filter and by 4 with the area filter.
+ */
+@LargeTest
+@RunWith(Parameterized::class)
+internal class ResizeColorSpaceBenchmark(private val colorSpace: ColorSpace) {
+
+  @get:Rule
+  val benchmarkRule = BenchmarkRule()
+
+  private val input = randomImage(4, INPUT_SIZE_X, INPUT_SIZE_Y, seed = 1)
+
+  @Test
+  fun reduceBy1_5() {
+    benchmarkRule.measureRepeated {
+      resize(INPUT_SIZE_X * 2 / 3, INPUT_SIZE_Y * 2 / 3)
+    }
+  }
+
+  @Test
+  fun reduceBy4() {
+    benchmarkRule.measureRepeated {
+      resize(INPUT_SIZE_X / 4, INPUT_SIZE_Y / 4)
+    }
+  }
+
+  private fun resize(outputSizeX: Int, outputSizeY: Int) = RenderScriptToolkit.resize(
+    input,
+    4,
+    INPUT_SIZE_X,
+    INPUT_SIZE_Y,
+    outputSizeX,
+    outputSizeY,
+    ResizeFilter.CATMULL_ROM,
+    AlphaType.PREMULTIPLIED,
+    colorSpace,
+  )
+
+  companion object {
+    private const val INPUT_SIZE_X = 1620
+    private const val INPUT_SIZE_Y = 1215
+
+    @JvmStatic
+    @Parameterized.Parameters(name = "{0}")
+    fun parameters(): List<Array<ColorSpace>> = ColorSpace.entries.map { arrayOf(it) }
+  }
+}
@@ -0,0 +1,80 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.ResizeFilter
+import com.skydoves.landscapist.transformation.randomImage
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runners.Parameterized
+
+/**
+ * The throughput of each resize filter on RGBA images, enlarging by 2 and reducing by 1.5. From a
+ * reduction of 2, the filters other than nearest switch to the area filter.
+ */
+@LargeTest
+@RunWith(Parameterized::class)
+internal class ResizeFilterBenchmark(private val filter: ResizeFilter) {
+
+  @get:Rule
+  val benchmarkRule = BenchmarkRule()
+
+  private val input = randomImage(4, INPUT_SIZE_X, INPUT_SIZE_Y, seed = 1)
+
+  @Test
+  fun enlarge() {
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.resize(
+        input,
+        4,
+        INPUT_SIZE_X,
+        INPUT_SIZE_Y,
+        INPUT_SIZE_X * 2,
+        INPUT_SIZE_Y * 2,
+        filter,
+      )
+    }
+  }
+
+  @Test
+  fun reduce() {
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.resize(
+        input,
+        4,
+        INPUT_SIZE_X,
+        INPUT_SIZE_Y,
+        INPUT_SIZE_X * 2 / 3,
+        INPUT_SIZE_Y * 2 / 3,
+        filter,
+      )
+    }
+  }
+
+  companion object {
+    private const val INPUT_SIZE_X = 1620
+    private const val INPUT_SIZE_Y = 1215
+
+    @JvmStatic
+    @Parameterized.Parameters(name = "{0}")
+    fun parameters(): List<Array<ResizeFilter>> = ResizeFilter.entries.map { arrayOf(it) }
+  }
+}
@@ -0,0 +1,78 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import android.graphics.Bitmap
+import android.os.Build
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.filters.LargeTest
+import androidx.test.filters.SdkSuppress
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.randomImage
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runners.Parameterized
+
+/**
+ * The resize of 8 bit RGBA pixels against that of RGBA_F16 Bitmaps and of float arrays, reducing
+ * a 1620x1215 image by 1.5 with the Catmull-Rom filter and by 4 with the area filter.
+ */
+@LargeTest
+@RunWith(Parameterized::class)
+internal class ResizeFormatBenchmark(private val outputSizeX: Int) {
+
+  @get:Rule
+  val benchmarkRule = BenchmarkRule()
+
+  private val outputSizeY = outputSizeX * 3 / 4
+  private val input = randomImage(4, INPUT_SIZE_X, INPUT_SIZE_Y, seed = 1)
+
+  @Test
+  fun bytes() {
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.resize(input, 4, INPUT_SIZE_X, INPUT_SIZE_Y, outputSizeX, outputSizeY)
+    }
+  }
+
+  @Test
+  @SdkSuppress(minSdkVersion = Build.VERSION_CODES.O)
+  fun halfFloatBitmap() {
+    val bitmap = Bitmap.createBitmap(INPUT_SIZE_X, INPUT_SIZE_Y, Bitmap.Config.RGBA_F16)
+    bitmap.eraseColor(0x80406080.toInt())
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.resize(bitmap, outputSizeX, outputSizeY)
+    }
+  }
+
+  @Test
+  fun floats() {
+    val floats = FloatArray(input.size) { (input[it].toInt() and 0xff) / 255f }
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.resize(floats, INPUT_SIZE_X, INPUT_SIZE_Y, outputSizeX, outputSizeY)
+    }
+  }
+
+  companion object {
+    private const val INPUT_SIZE_X = 1620
+    private const val INPUT_SIZE_Y = 1215
+
+    @JvmStatic
+    @Parameterized.Parameters(name = "outputSizeX{0}")
+    fun parameters(): List<Array<Int>> = listOf(arrayOf(1080), arrayOf(405))
+  }
+}
@@ -0,0 +1,126 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.randomImage
+import org.junit.Test
+import org.junit.runner.RunWith
+import java.io.File
+
+/**
+ * The peak memory and the speed of shrinking a 12 MP RGBA picture to 1080x810 as its rows are
+ * decoded, with a stream against resizing the whole decoded picture. The decoder is simulated by
+ * copying rows from a small set of random rows.
+ *
+ * The peak memory is the growth of the peak resident set size of the process over a run, read
+ * from /proc/self/status after resetting the peak through /proc/self/clear_refs. Where the
+ * kernel doesn't allow the reset, the table shows "-".
+ */
+@LargeTest
+@RunWith(AndroidJUnit4::class)
+internal class ResizeStreamBenchmark {
+
+  private val sourceRows = randomImage(4, INPUT_SIZE_X, SOURCE_ROW_COUNT, seed = 1)
+
+  @Test
+  fun peakMemoryAndSpeed() {
+    val rows = listOf(
+      measure("stream", ::resizeStream),
+      measure("whole picture", ::resizeWhole),
+    )
+    reportTable(
+      "Resize ${INPUT_SIZE_X}x$INPUT_SIZE_Y to ${OUTPUT_SIZE_X}x$OUTPUT_SIZE_Y RGBA as decoded",
+      listOf("path", "peak RSS growth MB", "ms"),
+      rows,
+    )
+  }
+
+  private fun measure(name: String, run: () -> Unit): List<String> {
+    Runtime.getRuntime().gc()
+    val peakGrowth = if (resetPeak()) {
+      val start = readStatusKb("VmRSS")
+      run()
+      readStatusKb("VmHWM") - start
+    } else {
+      null
+    }
+    val millis = minMillis(runs = 3) { run() }
+    return listOf(name, peakGrowth?.let { (it / 1024.0).format() } ?: "-", millis.format())
+  }
+
+  private fun resizeStream() {
+    val output = ByteArray(OUTPUT_SIZE_X * OUTPUT_SIZE_Y * 4)
+    val inputRow = ByteArray(INPUT_SIZE_X * 4)
+    RenderScriptToolkit.createResizeStream(
+      4,
+      INPUT_SIZE_X,
+      INPUT_SIZE_Y,
+      OUTPUT_SIZE_X,
+      OUTPUT_SIZE_Y,
+    ).use { stream ->
+      val outputRowSize = OUTPUT_SIZE_X * 4
+      val outputRows = ByteArray(stream.maxRowsPerPush * outputRowSize)
+      var outputRowCount = 0
+      for (y in 0 until INPUT_SIZE_Y) {
+        decodeRow(y, inputRow, 0)
+        val count = stream.pushRow(inputRow, outputRows)
+        outputRows.copyInto(output, outputRowCount * outputRowSize, 0, count * outputRowSize)
+        outputRowCount += count
+      }
+    }
+  }
+
+  private fun resizeWhole() {
+    val input = ByteArray(INPUT_SIZE_X * INPUT_SIZE_Y * 4)
+    for (y in 0 until INPUT_SIZE_Y) {
+      decodeRow(y, input, y * INPUT_SIZE_X * 4)
+    }
+    RenderScriptToolkit.resize(
+      input,
+      4,
+      INPUT_SIZE_X,
+      INPUT_SIZE_Y,
+      OUTPUT_SIZE_X,
+      OUTPUT_SIZE_Y,
+    )
+  }
+
+  private fun decodeRow(y: Int, destination: ByteArray, offset: Int) {
+    val rowSize = INPUT_SIZE_X * 4
+    val start = y % SOURCE_ROW_COUNT * rowSize
+    sourceRows.copyInto(destination, offset, start, start + rowSize)
+  }
+
+  private fun resetPeak(): Boolean = runCatching {
+    File("/proc/self/clear_refs").writeText("5")
+  }.isSuccess
+
+  private fun readStatusKb(field: String): Long = File("/proc/self/status").readLines()
+    .first { it.startsWith("$field:") }
+    .split(Regex("\\s+"))[1]
+    .toLong()
+
+  private companion object {
+    const val INPUT_SIZE_X = 4000
+    const val INPUT_SIZE_Y = 3000
+    const val OUTPUT_SIZE_X = 1080
+    const val OUTPUT_SIZE_Y = 810
+    const val SOURCE_ROW_COUNT = 16
+  }
+}
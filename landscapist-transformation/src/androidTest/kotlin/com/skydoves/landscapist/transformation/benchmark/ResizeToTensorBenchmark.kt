@@ -0,0 +1,109 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.TensorType
+import com.skydoves.landscapist.transformation.randomImage
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runners.Parameterized
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+import kotlin.math.roundToInt
+
+/**
+ * Fills the 224x224 input tensor of a classifier from a 1280x960 RGBA picture in one pass, against
+ * a resize followed by the Kotlin loop that converts the pixels to a planar tensor. Float tensors
+ * are normalized with the ImageNet mean and standard deviation, and signed byte ones are shifted
+ * by -128, as quantized models take them.
+ */
+@LargeTest
+@RunWith(Parameterized::class)
+internal class ResizeToTensorBenchmark(private val type: TensorType) {
+
+  @get:Rule
+  val benchmarkRule = BenchmarkRule()
+
+  private val input = randomImage(4, INPUT_SIZE_X, INPUT_SIZE_Y, seed = 1)
+  private val tensor = ByteBuffer.allocateDirect(3 * TENSOR_SIZE * TENSOR_SIZE * type.size)
+    .order(ByteOrder.nativeOrder())
+  private val scale = FloatArray(3) {
+    if (type == TensorType.FLOAT32) 1f / (255f * STD[it]) else 1f
+  }
+  private val bias = FloatArray(3) {
+    if (type == TensorType.FLOAT32) -MEAN[it] / STD[it] else -128f
+  }
+
+  @Test
+  fun fused() {
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.resizeToTensor(
+        input,
+        INPUT_SIZE_X,
+        INPUT_SIZE_Y,
+        TENSOR_SIZE,
+        TENSOR_SIZE,
+        tensor,
+        scale,
+        bias,
+        type,
+      )
+    }
+  }
+
+  @Test
+  fun resizeThenConvert() {
+    val planeSize = TENSOR_SIZE * TENSOR_SIZE
+    benchmarkRule.measureRepeated {
+      val resized = RenderScriptToolkit.resize(
+        input,
+        4,
+        INPUT_SIZE_X,
+        INPUT_SIZE_Y,
+        TENSOR_SIZE,
+        TENSOR_SIZE,
+      )
+      for (c in 0 until 3) {
+        for (i in 0 until planeSize) {
+          val value = (resized[i * 4 + c].toInt() and 0xff) * scale[c] + bias[c]
+          when (type) {
+            TensorType.FLOAT32 -> tensor.putFloat((c * planeSize + i) * 4, value)
+            TensorType.INT8 -> {
+              tensor.put(c * planeSize + i, value.roundToInt().coerceIn(-128, 127).toByte())
+            }
+          }
+        }
+      }
+    }
+  }
+
+  companion object {
+    private const val INPUT_SIZE_X = 1280
+    private const val INPUT_SIZE_Y = 960
+    private const val TENSOR_SIZE = 224
+    private val MEAN = floatArrayOf(0.485f, 0.456f, 0.406f)
+    private val STD = floatArrayOf(0.229f, 0.224f, 0.225f)
+
+    @JvmStatic
+    @Parameterized.Parameters(name = "{0}")
+    fun parameters(): List<Array<TensorType>> = TensorType.entries.map { arrayOf(it) }
+  }
+}
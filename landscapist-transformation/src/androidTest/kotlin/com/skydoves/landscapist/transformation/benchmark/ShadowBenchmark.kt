@@ -0,0 +1,79 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.randomImage
+import com.skydoves.landscapist.transformation.referenceShadow
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runners.Parameterized
+
+/**
+ * The fused shadow against extracting the alpha, blurring it and tinting it separately. The
+ * output is padded by the radius on each side.
+ */
+@LargeTest
+@RunWith(Parameterized::class)
+internal class ShadowBenchmark(private val sizeX: Int, private val radius: Int) {
+
+  @get:Rule
+  val benchmarkRule = BenchmarkRule()
+
+  private val sizeY = sizeX * 3 / 4
+  private val input = randomImage(4, sizeX, sizeY, seed = 1)
+
+  @Test
+  fun fused() {
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.shadow(input, sizeX, sizeY, radius, COLOR)
+    }
+  }
+
+  @Test
+  fun separate() {
+    benchmarkRule.measureRepeated {
+      referenceShadow(
+        input,
+        sizeX,
+        sizeY,
+        radius,
+        COLOR,
+        radius,
+        radius,
+        sizeX + 2 * radius,
+        sizeY + 2 * radius,
+      )
+    }
+  }
+
+  companion object {
+    private const val COLOR = 0x80 shl 24
+
+    @JvmStatic
+    @Parameterized.Parameters(name = "sizeX{0}_radius{1}")
+    fun parameters(): List<Array<Int>> = listOf(
+      arrayOf(1000, 5),
+      arrayOf(1000, 25),
+      arrayOf(4000, 5),
+      arrayOf(4000, 25),
+    )
+  }
+}
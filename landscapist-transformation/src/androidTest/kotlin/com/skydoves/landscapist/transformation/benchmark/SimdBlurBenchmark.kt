@@ -0,0 +1,85 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.benchmark.junit4.BenchmarkRule
+import androidx.benchmark.junit4.measureRepeated
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.SimdLevel
+import com.skydoves.landscapist.transformation.randomImage
+import org.junit.After
+import org.junit.Assume.assumeTrue
+import org.junit.Before
+import org.junit.Rule
+import org.junit.Test
+import org.junit.runner.RunWith
+import org.junit.runners.Parameterized
+
+/**
+ * The throughput of the Gaussian blur with each set of kernels. Levels the processor doesn't
+ * support are skipped.
+ */
+@LargeTest
+@RunWith(Parameterized::class)
+internal class SimdBlurBenchmark(private val level: SimdLevel) {
+
+  @get:Rule
+  val benchmarkRule = BenchmarkRule()
+
+  @Before
+  fun setMaxSimdLevel() {
+    assumeTrue(RenderScriptToolkit.setMaxSimdLevel(level) == level)
+  }
+
+  @After
+  fun restoreSimdLevel() {
+    RenderScriptToolkit.setMaxSimdLevel(SimdLevel.AVX512)
+  }
+
+  @Test
+  fun blurRgba_radius25() {
+    val input = randomImage(4, SIZE_X, SIZE_Y, seed = 1)
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.blur(input, 4, SIZE_X, SIZE_Y, 25)
+    }
+  }
+
+  @Test
+  fun blurRgba_radius5() {
+    val input = randomImage(4, SIZE_X, SIZE_Y, seed = 1)
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.blur(input, 4, SIZE_X, SIZE_Y, 5)
+    }
+  }
+
+  @Test
+  fun blurAlpha_radius25() {
+    val input = randomImage(1, SIZE_X, SIZE_Y, seed = 1)
+    benchmarkRule.measureRepeated {
+      RenderScriptToolkit.blur(input, 1, SIZE_X, SIZE_Y, 25)
+    }
+  }
+
+  companion object {
+    private const val SIZE_X = 2000
+    private const val SIZE_Y = 1500
+
+    @JvmStatic
+    @Parameterized.Parameters(name = "{0}")
+    fun levels(): List<SimdLevel> = SimdLevel.entries
+  }
+}
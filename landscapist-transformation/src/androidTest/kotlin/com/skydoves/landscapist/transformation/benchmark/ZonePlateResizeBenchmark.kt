@@ -0,0 +1,125 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+package com.skydoves.landscapist.transformation.benchmark
+
+import androidx.test.ext.junit.runners.AndroidJUnit4
+import androidx.test.filters.LargeTest
+import com.skydoves.landscapist.transformation.RenderScriptToolkit
+import com.skydoves.landscapist.transformation.ResizeFilter
+import com.skydoves.landscapist.transformation.referenceBicubicResize
+import org.junit.Test
+import org.junit.runner.RunWith
+import kotlin.math.PI
+import kotlin.math.cos
+import kotlin.math.roundToInt
+import kotlin.math.sqrt
+
+/**
+ * The aliasing and the speed of a 4x downscale with each filter and with the former 4-tap
+ * bicubic, which skipped input pixels at such scales.
+ *
+ * The input is a zone plate centered on the top left corner, whose frequency grows with the
+ * distance from it up to the Nyquist frequency of the input. Past twice the Nyquist frequency of
+ * the output, an ideal downscale is flat gray, so the aliasing is the RMS difference from gray
+ * there. The passband error is the RMS difference from the zone plate where its frequency is
+ * below half the Nyquist frequency of the output.
+ */
+@LargeTest
+@RunWith(AndroidJUnit4::class)
+internal class ZonePlateResizeBenchmark {
+
+  @Test
+  fun aliasingAndSpeed() {
+    val input = ByteArray(INPUT_SIZE * INPUT_SIZE)
+    for (y in 0 until INPUT_SIZE) {
+      for (x in 0 until INPUT_SIZE) {
+        input[y * INPUT_SIZE + x] = zonePlate(x + 0.5, y + 0.5).roundToInt().toByte()
+      }
+    }
+
+    fun resize(filter: ResizeFilter) = RenderScriptToolkit.resize(
+      input,
+      1,
+      INPUT_SIZE,
+      INPUT_SIZE,
+      OUTPUT_SIZE,
+      OUTPUT_SIZE,
+      filter,
+    )
+
+    val rows = ResizeFilter.entries.map { filter ->
+      measure(filter.name, resize(filter), minMillis { resize(filter) })
+    }
+    val bicubic = {
+      referenceBicubicResize(input, 1, INPUT_SIZE, INPUT_SIZE, OUTPUT_SIZE, OUTPUT_SIZE)
+    }
+    reportTable(
+      "Zone plate, ${INPUT_SIZE}x$INPUT_SIZE to ${OUTPUT_SIZE}x$OUTPUT_SIZE",
+      listOf("filter", "alias RMS", "passband RMS", "ms"),
+      rows + listOf(measure("4-tap bicubic", bicubic(), minMillis { bicubic() })),
+    )
+  }
+
+  private fun measure(name: String, output: ByteArray, millis: Double): List<String> {
+    val scale = INPUT_SIZE.toDouble() / OUTPUT_SIZE
+    var alias = 0.0
+    var aliasCount = 0
+    var passband = 0.0
+    var passbandCount = 0
+    for (y in 0 until OUTPUT_SIZE) {
+      for (x in 0 until OUTPUT_SIZE) {
+        val inputX = (x + 0.5) * scale
+        val inputY = (y + 0.5) * scale
+        val distance = sqrt(inputX * inputX + inputY * inputY)
+        val value = (output[y * OUTPUT_SIZE + x].toInt() and 0xff).toDouble()
+        if (distance >= ALIAS_START && distance <= ALIAS_END) {
+          alias += (value - 127.5) * (value - 127.5)
+          aliasCount++
+        } else if (distance < PASSBAND_END) {
+          val expected = zonePlate(inputX, inputY)
+          passband += (value - expected) * (value - expected)
+          passbandCount++
+        }
+      }
+    }
+    return listOf(
+      name,
+      sqrt(alias / aliasCount).format(2),
+      sqrt(passband / passbandCount).format(2),
+      millis.format(),
+    )
+  }
+
+  /**
+   * The zone plate at a position in input pixels. Its frequency is the distance times
+   * [ZONE_PLATE_K] / pi cycles per pixel, half a cycle per pixel at a distance of [INPUT_SIZE].
+   */
+  private fun zonePlate(x: Double, y: Double): Double =
+    127.5 + 127.5 * cos(ZONE_PLATE_K * (x * x + y * y))
+
+  private companion object {
+    const val INPUT_SIZE = 2048
+    const val OUTPUT_SIZE = 512
+    const val ZONE_PLATE_K = PI / (2 * INPUT_SIZE)
+
+    /** The distances at which the frequency is twice, and close to four times, the output's. */
+    const val ALIAS_START = 1024.0
+    const val ALIAS_END = 1900.0
+
+    /** The distance at which the frequency is half the Nyquist frequency of the output. */
+    const val PASSBAND_END = 256.0
+  }
+}
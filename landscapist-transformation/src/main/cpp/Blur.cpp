@@ -14,8 +14,12 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <climits>
 #include <cmath>
 #include <cstdint>
+#include <cstring>
+#include <vector>
 
 #include "RenderScriptToolkit.h"
 #include "TaskProcessor.h"
@@ -26,66 +30,16 @@ namespace renderscript {
 #define LOG_TAG "renderscript.toolkit.Blur"
 
 /**
- * Blurs an image or a section of an image.
+ * Computes the coefficients of a one dimensional gaussian blur.
  *
- * Our algorithm does two passes: a vertical blur followed by an horizontal blur.
+ * @param radius The radius of the blur. A radius of 0 gives a single coefficient of 1.
+ * @param fp Receives the floating point coefficients. Must have room for 104 values.
+ * @param ip Receives the 16 bit fixed point coefficients. Must have room for 104 values.
+ * @return The radius in integer format. There are 2 * radius + 1 coefficients.
  */
-class BlurTask : public Task {
-    // The image we're blurring.
-    const uchar* mIn;
-    // Where we store the blurred image.
-    uchar* outArray;
-    // The size of the kernel radius is limited to 25 in ScriptIntrinsicBlur.java.
-    // So, the max kernel size is 51 (= 2 * 25 + 1).
-    // Considering SSSE3 case, which requires the size is multiple of 4,
-    // at least 52 words are necessary. Values outside of the kernel should be 0.
-    float mFp[104];
-    uint16_t mIp[104];
-
-    // Working area to store the result of the vertical blur, to be used by the horizontal pass.
-    // There's one area per thread. Since the needed working area may be too large to put on the
-    // stack, we are allocating it from the heap. To avoid paying the allocation cost for each
-    // tile, we cache the scratch area here.
-    std::vector<void*> mScratch;       // Pointers to the scratch areas, one per thread.
-    std::vector<size_t> mScratchSize;  // The size in bytes of the scratch areas, one per thread.
-
-    // The radius of the blur, in floating point and integer format.
-    float mRadius;
-    int mIradius;
-
-    void kernelU4(void* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
-                  uint32_t threadIndex);
-    void kernelU1(void* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY);
-    void ComputeGaussianWeights();
-
-    // Process a 2D tile of the overall work. threadIndex identifies which thread does the work.
-    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
-                     size_t endY) override;
-
-   public:
-    BlurTask(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY, size_t vectorSize,
-             uint32_t threadCount, float radius, const Restriction* restriction)
-        : Task{sizeX, sizeY, vectorSize, false, restriction},
-          mIn{in},
-          outArray{out},
-          mScratch{threadCount},
-          mScratchSize{threadCount},
-          mRadius{std::min(25.0f, radius)} {
-        ComputeGaussianWeights();
-    }
-
-    ~BlurTask() {
-        for (size_t i = 0; i < mScratch.size(); i++) {
-            if (mScratch[i]) {
-                free(mScratch[i]);
-            }
-        }
-    }
-};
-
-void BlurTask::ComputeGaussianWeights() {
-    memset(mFp, 0, sizeof(mFp));
-    memset(mIp, 0, sizeof(mIp));
+static int ComputeGaussianWeights(float radius, float* fp, uint16_t* ip) {
+    memset(fp, 0, 104 * sizeof(float));
+    memset(ip, 0, 104 * sizeof(uint16_t));
 
     // Compute gaussian weights for the blur
     // e is the euler's number
@@ -100,7 +54,7 @@ void BlurTask::ComputeGaussianWeights() {
     // The larger the radius gets, the more our gaussian blur
     // will resemble a box blur since with large sigma
     // the gaussian curve begins to lose its shape
-    float sigma = 0.4f * mRadius + 0.6f;
+    float sigma = 0.4f * radius + 0.6f;
 
     // Now compute the coefficients. We will store some redundant values to save
     // some math during the blur calculations precompute some values
@@ -110,79 +64,233 @@ void BlurTask::ComputeGaussianWeights() {
     float normalizeFactor = 0.0f;
     float floatR = 0.0f;
     int r;
-    mIradius = (float)ceil(mRadius) + 0.5f;
-    for (r = -mIradius; r <= mIradius; r ++) {
+    int iradius = (float)ceil(radius) + 0.5f;
+    for (r = -iradius; r <= iradius; r ++) {
         floatR = (float)r;
-        mFp[r + mIradius] = coeff1 * powf(e, floatR * floatR * coeff2);
-        normalizeFactor += mFp[r + mIradius];
+        fp[r + iradius] = coeff1 * powf(e, floatR * floatR * coeff2);
+        normalizeFactor += fp[r + iradius];
     }
 
     // Now we need to normalize the weights because all our coefficients need to add up to one
     normalizeFactor = 1.0f / normalizeFactor;
-    for (r = -mIradius; r <= mIradius; r ++) {
-        mFp[r + mIradius] *= normalizeFactor;
-        mIp[r + mIradius] = (uint16_t)(mFp[r + mIradius] * 65536.0f + 0.5f);
+    for (r = -iradius; r <= iradius; r ++) {
+        fp[r + iradius] *= normalizeFactor;
+        ip[r + iradius] = (uint16_t)(fp[r + iradius] * 65536.0f + 0.5f);
     }
+    return iradius;
 }
 
+// The maximum number of coefficients of each pass, for a radius of 25.
+static constexpr int kMaxTaps = 51;
+// The number of cells past the padding of a row that the SIMD kernels may read. Their
+// coefficients are zero there, but the values still need to be initialized.
+static constexpr int kRowOverread = 8;
+
 /**
- * Vertical blur of a uchar4 line.
- *
- * @param sizeY Number of cells of the input array in the vertical direction.
- * @param out Where to place the computed value.
- * @param x Coordinate of the point we're blurring.
- * @param y Coordinate of the point we're blurring.
- * @param ptrIn Start of the input array.
- * @param iStride The size in byte of a row of the input array.
- * @param gPtr The gaussian coefficients.
- * @param iradius The radius of the blur.
+ * The number of bytes of a pixel of the given format.
  */
-static void OneVU4(uint32_t sizeY, float4* out, int32_t x, int32_t y, const uchar* ptrIn,
-                   int iStride, const float* gPtr, int iradius) {
-    const uchar *pi = ptrIn + x*4;
-
-    float4 blurredPixel = 0;
-    for (int r = -iradius; r <= iradius; r ++) {
-        int validY = std::max((y + r), 0);
-        validY = std::min(validY, (int)(sizeY - 1));
-        const uchar4 *pvy = (const uchar4 *)&pi[validY * iStride];
-        float4 pf = convert<float4>(pvy[0]);
-        blurredPixel += pf * gPtr[0];
-        gPtr++;
+static size_t PixelSize(PixelFormat format) {
+    switch (format) {
+        case PixelFormat::RgbaF32:
+            return 16;
+        case PixelFormat::RgbaF16:
+            return 8;
+        case PixelFormat::Rgb565:
+            return 2;
+        case PixelFormat::Rgb888:
+            return 3;
+        case PixelFormat::Rgba8888:
+        case PixelFormat::Rgba1010102:
+            break;
     }
-
-    out[0] = blurredPixel;
+    return 4;
 }
 
 /**
- * Vertical blur of a uchar1 line.
+ * Blurs an image or a section of an image.
  *
- * @param sizeY Number of cells of the input array in the vertical direction.
- * @param out Where to place the computed value.
- * @param x Coordinate of the point we're blurring.
- * @param y Coordinate of the point we're blurring.
- * @param ptrIn Start of the input array.
- * @param iStride The size in byte of a row of the input array.
- * @param gPtr The gaussian coefficients.
- * @param iradius The radius of the blur.
+ * Our algorithm does two passes: a vertical blur followed by an horizontal blur. The two passes
+ * can use different radii. A radius of 0 reduces its pass to a conversion between bytes and
+ * floats.
  */
-static void OneVU1(uint32_t sizeY, float *out, int32_t x, int32_t y,
-                   const uchar *ptrIn, int iStride, const float* gPtr, int iradius) {
+class BlurTask : public Task {
+    // The image we're blurring.
+    const uchar* mIn;
+    // Where we store the blurred image.
+    uchar* outArray;
+    // The size of the kernel radius is limited to 25 in ScriptIntrinsicBlur.java.
+    // So, the max kernel size is 51 (= 2 * 25 + 1).
+    // Considering SSSE3 case, which requires the size is multiple of 4,
+    // at least 52 words are necessary. Values outside of the kernel should be 0.
+    // There's one set of coefficients for the horizontal pass and one for the vertical pass.
+    float mFpX[104];
+    uint16_t mIpX[104];
+    float mFpY[104];
+    uint16_t mIpY[104];
+
+    // Working area to store the result of the vertical blur, to be used by the horizontal pass.
+    // There's one area per thread, shared by the RGBA and U_8 kernels.
+    ScratchBuffers mScratch;
 
-    const uchar *pi = ptrIn + x;
+    // The radii of the blur along each axis, in integer format.
+    int mIradiusX;
+    int mIradiusY;
 
-    float blurredPixel = 0;
-    for (int r = -iradius; r <= iradius; r ++) {
-        int validY = std::max((y + r), 0);
-        validY = std::min(validY, (int)(sizeY - 1));
-        float pf = (float)pi[validY * iStride];
-        blurredPixel += pf * gPtr[0];
-        gPtr++;
+    // How the color channels of the input relate to alpha, and the space they are mixed in.
+    AlphaType mAlphaType;
+    ColorSpace mColorSpace;
+    // How the image extends past its edges.
+    EdgeMode mEdgeMode;
+    // The layout of the pixels, and the number of bytes of each cell.
+    PixelFormat mFormat;
+    size_t mPixelSize;
+
+    // Whether mIn and outArray are the same buffer. The work is then divided into one band of
+    // rows per thread. Each band saves the rows it overwrites while it still needs them, and
+    // reads the rows past its ends from copies made before any band started.
+    bool mInPlace = false;
+    size_t mRowsPerBand = 0;
+    // The copies of the mIradiusY rows before and after each band. mHaloRows[band * 2 *
+    // mIradiusY + i] points to the i-th one, or is null for transparent rows. Rows that map to
+    // the same source row share one copy.
+    std::vector<uchar> mHalo;
+    std::vector<const uchar*> mHaloRows;
+    // The band each thread is working on, and the ring of the last mIradiusY + 1 rows of the
+    // band the thread has read, as they were before being overwritten.
+    struct BandRows {
+        int index;
+        int start;
+        int end;
+        uchar* ring;
+    };
+    std::vector<BandRows> mBandRows;
+    ScratchBuffers mRings;
+
+    // When the pixels are converted, each thread converts each input row once, into a ring of
+    // 2 * mIradiusY + 1 rows of float4 indexed by the virtual row. mConvertedTags holds the
+    // virtual row in each slot of each thread's ring. Each thread works on bands of rows so
+    // that consecutive output rows share most of their input rows.
+    ScratchBuffers mConvertedRows;
+    std::vector<int> mConvertedTags;
+
+    // Whether both passes use the same coefficients, as required by the ARM assembly.
+    bool isSymmetric() const { return mIradiusX == mIradiusY; }
+    // Whether the pixels need to be converted before and after being blurred.
+    bool convertsColors() const {
+        return mFormat != PixelFormat::Rgba8888 ||
+               (mVectorSize == 4 &&
+                (mAlphaType != AlphaType::Premultiplied || mColorSpace != ColorSpace::Srgb));
     }
 
-    out[0] = blurredPixel;
-}
+    void kernelU4(void* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
+                  uint32_t threadIndex);
+    // Picks the kernelU4Converted for the alpha type and color space.
+    template <PixelFormat kFormat>
+    void kernelU4Format(uchar* out, float4* row, uint32_t xstart, uint32_t xend,
+                        uint32_t currentY, uint32_t threadIndex);
+    template <PixelFormat kFormat, bool kUnpremultiplied, bool kLinear>
+    void kernelU4Converted(uchar* out, float4* row, uint32_t xstart, uint32_t xend,
+                           uint32_t currentY, uint32_t threadIndex);
+    void kernelU4Rgb565(uchar* out, float4* row, uint32_t xstart, uint32_t xend,
+                        uint32_t currentY, uint32_t threadIndex);
+
+    // Fills rows and weights with the input rows the vertical pass reads for row y, mapped
+    // according to the edge mode, and their coefficients. Returns how many there are. The
+    // row pointers point at column x.
+    int sourceRows(uint32_t y, uint32_t x, uint32_t threadIndex, const uchar** rows,
+                   float* weights) const;
+    // Returns where to read the input row sourceY, which stands for row virtualY (the two differ
+    // past the edges), when blurring row y.
+    const uchar* inputRow(uint32_t threadIndex, int y, int virtualY, int sourceY) const;
+    // Copies the rows past the ends of each band for an in place blur.
+    void saveHalos(size_t bandCount);
+    // The vertical pass only covers the columns of the image the horizontal pass reads. Returns
+    // them as [x1, x2).
+    void verticalSpan(uint32_t xstart, uint32_t xend, int* x1, int* x2) const;
+    // Fills the cells the horizontal pass reads that are outside of the image, according to the
+    // edge mode, then zeroes the kRowOverread cells that follow. vx1 and vx2 are the columns
+    // covered by the vertical pass. computeCell(x) does the vertical pass for the column x,
+    // for the few cells that map outside of them.
+    template <typename T, typename ComputeCell>
+    void padRow(T* row, uint32_t xstart, uint32_t xend, int vx1, int vx2,
+                ComputeCell computeCell) const;
+    void kernelU1(void* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
+                  uint32_t threadIndex);
+
+    // Process a 2D tile of the overall work. threadIndex identifies which thread does the work.
+    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                     size_t endY) override;
+
+   public:
+    BlurTask(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY, size_t vectorSize,
+             uint32_t threadCount, float radiusX, float radiusY, AlphaType alphaType,
+             ColorSpace colorSpace, EdgeMode edgeMode, const Restriction* restriction,
+             PixelFormat format = PixelFormat::Rgba8888)
+        : Task{sizeX, sizeY, vectorSize, false, restriction},
+          mIn{in},
+          outArray{out},
+          mScratch{threadCount},
+          mAlphaType{alphaType},
+          mColorSpace{colorSpace},
+          mEdgeMode{edgeMode},
+          mFormat{format},
+          mPixelSize{format == PixelFormat::Rgba8888 ? vectorSize : PixelSize(format)},
+          mRings{threadCount},
+          mConvertedRows{threadCount} {
+        mCellSizeInBytes = mPixelSize;
+        mIradiusX = ComputeGaussianWeights(std::min(25.0f, radiusX), mFpX, mIpX);
+        mIradiusY = ComputeGaussianWeights(std::min(25.0f, radiusY), mFpY, mIpY);
+        if (convertsColors()) {
+            mBandCount = threadCount;
+            mConvertedTags.resize(threadCount * (2 * mIradiusY + 1));
+        }
+    }
+
+    // Blurs inOut in place.
+    BlurTask(uint8_t* inOut, size_t sizeX, size_t sizeY, size_t vectorSize, uint32_t threadCount,
+             float radiusX, float radiusY, AlphaType alphaType, ColorSpace colorSpace,
+             EdgeMode edgeMode, PixelFormat format = PixelFormat::Rgba8888)
+        : BlurTask{inOut,   inOut,     sizeX,      sizeY,    vectorSize, threadCount, radiusX,
+                   radiusY, alphaType, colorSpace, edgeMode, nullptr,    format} {
+        mInPlace = true;
+        mBandRows.resize(threadCount);
+        saveHalos(threadCount);
+    }
+};
 
+/**
+ * Maps a coordinate that may fall outside of the image to the cell that replaces it.
+ *
+ * @param i The coordinate to map.
+ * @param size The number of cells along that axis.
+ * @param edgeMode How the image extends past its edges.
+ * @return The coordinate of the replacement cell, or -1 if the cell is transparent.
+ */
+static int MapEdge(int i, int size, EdgeMode edgeMode) {
+    if (i >= 0 && i < size) {
+        return i;
+    }
+    switch (edgeMode) {
+        case EdgeMode::Clamp:
+            return i < 0 ? 0 : size - 1;
+        case EdgeMode::Mirror: {
+            // The image repeats with a period of 2 * size, every other copy being flipped.
+            const int period = 2 * size;
+            int m = i % period;
+            if (m < 0) {
+                m += period;
+            }
+            return m < size ? m : period - 1 - m;
+        }
+        case EdgeMode::Wrap: {
+            const int m = i % size;
+            return m < 0 ? m + size : m;
+        }
+        case EdgeMode::Transparent:
+            break;
+    }
+    return -1;
+}
 
 extern "C" void rsdIntrinsicBlurU1_K(uchar *out, uchar const *in, size_t w, size_t h,
                  size_t p, size_t x, size_t y, size_t count, size_t r, uint16_t const *tab);
@@ -190,145 +298,141 @@ extern "C" void rsdIntrinsicBlurU4_K(uchar4 *out, uchar4 const *in, size_t w, si
                  size_t p, size_t x, size_t y, size_t count, size_t r, uint16_t const *tab);
 
 #if defined(ARCH_X86_HAVE_SSSE3)
-extern void rsdIntrinsicBlurVFU4_K(void *dst, const void *pin, int stride, const void *gptr,
-                                   int rct, int x1, int ct);
+extern void rsdIntrinsicBlurVFU4_K(void *dst, const void *const *rows, const void *gptr, int rct,
+                                   int x1, int ct);
 extern void rsdIntrinsicBlurHFU4_K(void *dst, const void *pin, const void *gptr, int rct, int x1,
                                    int ct);
 extern void rsdIntrinsicBlurHFU1_K(void *dst, const void *pin, const void *gptr, int rct, int x1,
                                    int ct);
+extern void rsdIntrinsicBlurVFU4Avx2_K(void *dst, const void *const *rows, const void *gptr,
+                                       int rct, int x1, int ct);
+extern void rsdIntrinsicBlurHFU4Avx2_K(void *dst, const void *pin, const void *gptr, int rct,
+                                       int x1, int ct);
+extern void rsdIntrinsicBlurHFU1Avx2_K(void *dst, const void *pin, const void *gptr, int rct,
+                                       int x1, int ct);
+extern void rsdIntrinsicBlurVFU4Avx512_K(void *dst, const void *const *rows, const void *gptr,
+                                         int rct, int x1, int ct);
+extern void rsdIntrinsicBlurHFU4Avx512_K(void *dst, const void *pin, const void *gptr, int rct,
+                                         int x1, int ct);
+extern void rsdIntrinsicBlurHFU1Avx512_K(void *dst, const void *pin, const void *gptr, int rct,
+                                         int x1, int ct);
+
+/**
+ * The x86 kernels for each blur pass. The AVX2 and AVX-512 variants have the same signature and
+ * requirements as the SSSE3 ones, so the callers don't need to know which one they are using.
+ */
+struct X86BlurKernels {
+    decltype(&rsdIntrinsicBlurVFU4_K) verticalU4;
+    decltype(&rsdIntrinsicBlurHFU4_K) horizontalU4;
+    decltype(&rsdIntrinsicBlurHFU1_K) horizontalU1;
+};
+
+static X86BlurKernels selectX86BlurKernels(X86Extension extension) {
+    switch (extension) {
+        case X86Extension::Avx512:
+            return {rsdIntrinsicBlurVFU4Avx512_K, rsdIntrinsicBlurHFU4Avx512_K,
+                    rsdIntrinsicBlurHFU1Avx512_K};
+        case X86Extension::Avx2:
+            return {rsdIntrinsicBlurVFU4Avx2_K, rsdIntrinsicBlurHFU4Avx2_K,
+                    rsdIntrinsicBlurHFU1Avx2_K};
+        case X86Extension::None:
+            break;
+    }
+    return {rsdIntrinsicBlurVFU4_K, rsdIntrinsicBlurHFU4_K, rsdIntrinsicBlurHFU1_K};
+}
 #endif
 
 /**
- * Vertical blur of a line of RGBA, knowing that there's enough rows above and below us to avoid
- * dealing with boundary conditions.
+ * Vertical blur of a line of RGBA. The rows to read have already been mapped according to the
+ * edge mode, so there are no boundary conditions to deal with.
  *
  * @param out Where to store the results. This is the input to the horizontal blur.
- * @param ptrIn The input data for this line.
- * @param iStride The width of the input.
+ * @param rows The start of each input row to read, one per coefficient.
  * @param gPtr The gaussian coefficients.
- * @param ct The diameter of the blur.
+ * @param ct The number of rows to read.
  * @param len How many cells to blur.
  * @param usesSimd Whether this processor supports SIMD.
+ * @param extension The widest x86 extension this processor supports.
  */
-static void OneVFU4(float4 *out, const uchar *ptrIn, int iStride, const float* gPtr, int ct,
-                    int x2, bool usesSimd) {
+static void OneVFU4(float4 *out, const uchar* const* rows, const float* gPtr, int ct, int len,
+                    bool usesSimd, X86Extension extension) {
     int x1 = 0;
 #if defined(ARCH_X86_HAVE_SSSE3)
     if (usesSimd) {
-        int t = (x2 - x1);
-        t &= ~1;
+        int t = len & ~1;
         if (t) {
-            rsdIntrinsicBlurVFU4_K(out, ptrIn, iStride, gPtr, ct, x1, x1 + t);
+            selectX86BlurKernels(extension).verticalU4(out, (const void* const*)rows, gPtr, ct,
+                                                       0, t);
         }
-        x1 += t;
-        out += t;
-        ptrIn += t << 2;
+        x1 = t;
     }
 #else
     (void) usesSimd; // Avoid unused parameter warning.
+    (void) extension;
 #endif
-    while(x2 > x1) {
-        const uchar *pi = ptrIn;
+    for (; x1 < len; x1++) {
         float4 blurredPixel = 0;
-        const float* gp = gPtr;
-
         for (int r = 0; r < ct; r++) {
-            float4 pf = convert<float4>(((const uchar4 *)pi)[0]);
-            blurredPixel += pf * gp[0];
-            pi += iStride;
-            gp++;
+            float4 pf = convert<float4>(((const uchar4 *)rows[r])[x1]);
+            blurredPixel += pf * gPtr[r];
         }
-        out->xyzw = blurredPixel;
-        x1++;
-        out++;
-        ptrIn+=4;
+        out[x1] = blurredPixel;
     }
 }
 
 /**
- * Vertical blur of a line of U_8, knowing that there's enough rows above and below us to avoid
- * dealing with boundary conditions.
+ * Vertical blur of a line of U_8. The rows to read have already been mapped according to the
+ * edge mode, so there are no boundary conditions to deal with.
  *
  * @param out Where to store the results. This is the input to the horizontal blur.
- * @param ptrIn The input data for this line.
- * @param iStride The width of the input.
+ * @param rows The start of each input row to read, one per coefficient.
  * @param gPtr The gaussian coefficients.
- * @param ct The diameter of the blur.
+ * @param ct The number of rows to read.
  * @param len How many cells to blur.
  * @param usesSimd Whether this processor supports SIMD.
+ * @param extension The widest x86 extension this processor supports.
  */
-static void OneVFU1(float* out, const uchar* ptrIn, int iStride, const float* gPtr, int ct, int len,
-                    bool usesSimd) {
+static void OneVFU1(float* out, const uchar* const* rows, const float* gPtr, int ct, int len,
+                    bool usesSimd, X86Extension extension) {
     int x1 = 0;
-
-    while((len > x1) && (((uintptr_t)ptrIn) & 0x3)) {
-        const uchar *pi = ptrIn;
-        float blurredPixel = 0;
-        const float* gp = gPtr;
-
-        for (int r = 0; r < ct; r++) {
-            float pf = (float)pi[0];
-            blurredPixel += pf * gp[0];
-            pi += iStride;
-            gp++;
-        }
-        out[0] = blurredPixel;
-        x1++;
-        out++;
-        ptrIn++;
-        len--;
-    }
 #if defined(ARCH_X86_HAVE_SSSE3)
-    if (usesSimd && (len > x1)) {
-        int t = (len - x1) >> 2;
-        t &= ~1;
+    if (usesSimd) {
+        // The RGBA kernel works on groups of four bytes, i.e. four U_8 cells, two groups at a
+        // time.
+        int t = (len >> 2) & ~1;
         if (t) {
-            rsdIntrinsicBlurVFU4_K(out, ptrIn, iStride, gPtr, ct, 0, t );
-            len -= t << 2;
-            ptrIn += t << 2;
-            out += t << 2;
+            selectX86BlurKernels(extension).verticalU4(out, (const void* const*)rows, gPtr, ct,
+                                                       0, t);
         }
+        x1 = t << 2;
     }
 #else
     (void) usesSimd; // Avoid unused parameter warning.
+    (void) extension;
 #endif
-    while(len > 0) {
-        const uchar *pi = ptrIn;
+    for (; x1 < len; x1++) {
         float blurredPixel = 0;
-        const float* gp = gPtr;
-
         for (int r = 0; r < ct; r++) {
-            float pf = (float)pi[0];
-            blurredPixel += pf * gp[0];
-            pi += iStride;
-            gp++;
+            blurredPixel += (float)rows[r][x1] * gPtr[r];
         }
-        out[0] = blurredPixel;
-        len--;
-        out++;
-        ptrIn++;
+        out[x1] = blurredPixel;
     }
 }
 
 /**
  * Horizontal blur of a uchar4 line.
  *
- * @param sizeX Number of cells of the input array in the horizontal direction.
  * @param out Where to place the computed value.
  * @param x Coordinate of the point we're blurring.
- * @param ptrIn The start of the input row from which we're indexing x.
+ * @param ptrIn The start of the padded input row from which we're indexing x.
  * @param gPtr The gaussian coefficients.
  * @param iradius The radius of the blur.
  */
-static void OneHU4(uint32_t sizeX, uchar4* out, int32_t x, const float4* ptrIn, const float* gPtr,
-                   int iradius) {
+static void OneHU4(uchar4* out, int32_t x, const float4* ptrIn, const float* gPtr, int iradius) {
     float4 blurredPixel = 0;
-    for (int r = -iradius; r <= iradius; r ++) {
-        int validX = std::max((x + r), 0);
-        validX = std::min(validX, (int)(sizeX - 1));
-        float4 pf = ptrIn[validX];
-        blurredPixel += pf * gPtr[0];
-        gPtr++;
+    const float4* pi = ptrIn + x - iradius;
+    for (int r = 0; r <= 2 * iradius; r++) {
+        blurredPixel += pi[r] * gPtr[r];
     }
 
     out->xyzw = convert<uchar4>(blurredPixel);
@@ -337,206 +441,1687 @@ static void OneHU4(uint32_t sizeX, uchar4* out, int32_t x, const float4* ptrIn,
 /**
  * Horizontal blur of a uchar line.
  *
- * @param sizeX Number of cells of the input array in the horizontal direction.
  * @param out Where to place the computed value.
  * @param x Coordinate of the point we're blurring.
- * @param ptrIn The start of the input row from which we're indexing x.
+ * @param ptrIn The start of the padded input row from which we're indexing x.
  * @param gPtr The gaussian coefficients.
  * @param iradius The radius of the blur.
  */
-static void OneHU1(uint32_t sizeX, uchar* out, int32_t x, const float* ptrIn, const float* gPtr,
-                   int iradius) {
+static void OneHU1(uchar* out, int32_t x, const float* ptrIn, const float* gPtr, int iradius) {
     float blurredPixel = 0;
-    for (int r = -iradius; r <= iradius; r ++) {
-        int validX = std::max((x + r), 0);
-        validX = std::min(validX, (int)(sizeX - 1));
-        float pf = ptrIn[validX];
-        blurredPixel += pf * gPtr[0];
-        gPtr++;
+    const float* pi = ptrIn + x - iradius;
+    for (int r = 0; r <= 2 * iradius; r++) {
+        blurredPixel += pi[r] * gPtr[r];
     }
 
     out[0] = (uchar)blurredPixel;
 }
 
-/**
- * Full blur of a line of RGBA data.
- *
- * @param outPtr Where to store the results
- * @param xstart The index of the section we're starting to blur.
- * @param xend  The end index of the section.
- * @param currentY The index of the line we're blurring.
- * @param usesSimd Whether this processor supports SIMD.
- */
-void BlurTask::kernelU4(void *outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
-                        uint32_t threadIndex) {
-    float4 stackbuf[2048];
-    float4 *buf = &stackbuf[0];
-    const uint32_t stride = mSizeX * mVectorSize;
-
-    uchar4 *out = (uchar4 *)outPtr;
-    uint32_t x1 = xstart;
-    uint32_t x2 = xend;
-
-#if defined(ARCH_ARM_USE_INTRINSICS)
-    if (mUsesSimd && mSizeX >= 4) {
-      rsdIntrinsicBlurU4_K(out, (uchar4 const *)(mIn + stride * currentY),
-                 mSizeX, mSizeY,
-                 stride, x1, currentY, x2 - x1, mIradius, mIp + mIradius);
-        return;
+int BlurTask::sourceRows(uint32_t y, uint32_t x, uint32_t threadIndex, const uchar** rows,
+                         float* weights) const {
+    int ct = 0;
+    for (int r = -mIradiusY; r <= mIradiusY; r++) {
+        const int sourceY = MapEdge((int)y + r, mSizeY, mEdgeMode);
+        // Transparent rows don't contribute anything.
+        if (sourceY >= 0) {
+            rows[ct] = inputRow(threadIndex, y, (int)y + r, sourceY) + x * mPixelSize;
+            weights[ct] = mFpY[r + mIradiusY];
+            ct++;
+        }
     }
-#endif
+    return ct;
+}
 
-    if (mSizeX > 2048) {
-        if ((mSizeX > mScratchSize[threadIndex]) || !mScratch[threadIndex]) {
-            // Pad the side of the allocation by one unit to allow alignment later
-            mScratch[threadIndex] = realloc(mScratch[threadIndex], (mSizeX + 1) * 16);
-            mScratchSize[threadIndex] = mSizeX;
-        }
-        // realloc only aligns to 8 bytes so we manually align to 16.
-        buf = (float4 *) ((((intptr_t)mScratch[threadIndex]) + 15) & ~0xf);
+const uchar* BlurTask::inputRow(uint32_t threadIndex, int y, int virtualY, int sourceY) const {
+    const size_t stride = mSizeX * mPixelSize;
+    if (!mInPlace) {
+        return mIn + sourceY * stride;
     }
-    float4 *fout = (float4 *)buf;
-    int y = currentY;
-    if ((y > mIradius) && (y < ((int)mSizeY - mIradius))) {
-        const uchar *pi = mIn + (y - mIradius) * stride;
-        OneVFU4(fout, pi, stride, mFp, mIradius * 2 + 1, mSizeX, mUsesSimd);
-    } else {
-        x1 = 0;
-        while(mSizeX > x1) {
-            OneVU4(mSizeY, fout, x1, y, mIn, stride, mFp, mIradius);
-            fout++;
-            x1++;
+    const BandRows& band = mBandRows[threadIndex];
+    const size_t halo = band.index * 2 * mIradiusY;
+    if (virtualY < band.start) {
+        return mHaloRows[halo + virtualY - (band.start - mIradiusY)];
+    }
+    if (virtualY >= band.end) {
+        return mHaloRows[halo + mIradiusY + virtualY - band.end];
+    }
+    // Within the band, the rows before y have already been overwritten.
+    if (virtualY < y) {
+        return band.ring + (virtualY % (mIradiusY + 1)) * stride;
+    }
+    return mIn + virtualY * stride;
+}
+
+void BlurTask::saveHalos(size_t bandCount) {
+    const size_t stride = mSizeX * mPixelSize;
+    mBandCount = bandCount;
+    mRowsPerBand = divideRoundingUp(mSizeY, bandCount);
+    const size_t bands = divideRoundingUp(mSizeY, mRowsPerBand);
+    const int haloSize = 2 * mIradiusY;
+
+    // Find which source rows to copy, sharing the copies within each band.
+    std::vector<int> sources;
+    std::vector<int> copies(bands * haloSize, -1);
+    for (size_t band = 0; band < bands; band++) {
+        const int start = band * mRowsPerBand;
+        const int end = std::min(start + mRowsPerBand, mSizeY);
+        const size_t firstCopy = sources.size();
+        for (int i = 0; i < haloSize; i++) {
+            const int virtualY = i < mIradiusY ? start - mIradiusY + i : end + i - mIradiusY;
+            const int sourceY = MapEdge(virtualY, mSizeY, mEdgeMode);
+            if (sourceY < 0) {
+                continue;
+            }
+            size_t copy = firstCopy;
+            while (copy < sources.size() && sources[copy] != sourceY) {
+                copy++;
+            }
+            if (copy == sources.size()) {
+                sources.push_back(sourceY);
+            }
+            copies[band * haloSize + i] = copy;
         }
     }
 
-    x1 = xstart;
-    while ((x1 < (uint32_t)mIradius) && (x1 < x2)) {
-        OneHU4(mSizeX, out, x1, buf, mFp, mIradius);
-        out++;
-        x1++;
+    mHalo.resize(sources.size() * stride);
+    for (size_t copy = 0; copy < sources.size(); copy++) {
+        memcpy(mHalo.data() + copy * stride, mIn + sources[copy] * stride, stride);
     }
-#if defined(ARCH_X86_HAVE_SSSE3)
-    if (mUsesSimd) {
-        if ((x1 + mIradius) < x2) {
-            rsdIntrinsicBlurHFU4_K(out, buf - mIradius, mFp,
-                                   mIradius * 2 + 1, x1, x2 - mIradius);
-            out += (x2 - mIradius) - x1;
-            x1 = x2 - mIradius;
+    mHaloRows.resize(copies.size());
+    for (size_t i = 0; i < copies.size(); i++) {
+        mHaloRows[i] = copies[i] >= 0 ? mHalo.data() + copies[i] * stride : nullptr;
+    }
+}
+
+void BlurTask::verticalSpan(uint32_t xstart, uint32_t xend, int* x1, int* x2) const {
+    *x1 = std::max((int)xstart - mIradiusX, 0);
+    *x2 = std::min((int)xend + mIradiusX, (int)mSizeX);
+}
+
+template <typename T, typename ComputeCell>
+void BlurTask::padRow(T* row, uint32_t xstart, uint32_t xend, int vx1, int vx2,
+                      ComputeCell computeCell) const {
+    const T zero = 0;
+    auto pad = [&](int x) {
+        const int sourceX = MapEdge(x, mSizeX, mEdgeMode);
+        if (sourceX < 0) {
+            row[x] = zero;
+        } else if (sourceX >= vx1 && sourceX < vx2) {
+            row[x] = row[sourceX];
+        } else {
+            row[x] = computeCell(sourceX);
         }
+    };
+    for (int x = (int)xstart - mIradiusX; x < vx1; x++) {
+        pad(x);
     }
-#endif
-    while(x2 > x1) {
-        OneHU4(mSizeX, out, x1, buf, mFp, mIradius);
-        out++;
-        x1++;
+    for (int x = vx2; x < (int)xend + mIradiusX; x++) {
+        pad(x);
+    }
+    for (int i = 0; i < kRowOverread; i++) {
+        row[xend + mIradiusX + i] = zero;
     }
 }
 
 /**
- * Full blur of a line of U_8 data.
- *
- * @param outPtr Where to store the results
- * @param xstart The index of the section we're starting to blur.
- * @param xend  The end index of the section.
- * @param currentY The index of the line we're blurring.
+ * Reads the pixel x of a row of the given format, as stored, in the [0, 255] range. Rgb565 and
+ * Rgb888 pixels are opaque.
  */
-void BlurTask::kernelU1(void *outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY) {
-    float buf[4 * 2048];
-    const uint32_t stride = mSizeX * mVectorSize;
+template <PixelFormat kFormat>
+static inline float4 unpackPixel(const uchar* row, int x) {
+    float4 f;
+    if constexpr (kFormat == PixelFormat::RgbaF16) {
+        uint16_t h[4];
+        memcpy(h, row + x * 8, sizeof(h));
+        f.x = halfToFloat(h[0]);
+        f.y = halfToFloat(h[1]);
+        f.z = halfToFloat(h[2]);
+        f.w = halfToFloat(h[3]);
+        f *= 255.0f;
+    } else if constexpr (kFormat == PixelFormat::RgbaF32) {
+        memcpy(&f, row + x * 16, sizeof(f));
+        f *= 255.0f;
+    } else if constexpr (kFormat == PixelFormat::Rgb565) {
+        uint16_t v;
+        memcpy(&v, row + x * 2, sizeof(v));
+        f.x = (float)(v >> 11) * (255.0f / 31.0f);
+        f.y = (float)((v >> 5) & 0x3f) * (255.0f / 63.0f);
+        f.z = (float)(v & 0x1f) * (255.0f / 31.0f);
+        f.w = 255.0f;
+    } else if constexpr (kFormat == PixelFormat::Rgb888) {
+        const uchar* p = row + x * 3;
+        f = float4{(float)p[0], (float)p[1], (float)p[2], 255.0f};
+    } else if constexpr (kFormat == PixelFormat::Rgba1010102) {
+        uint32_t v;
+        memcpy(&v, row + x * 4, sizeof(v));
+        f.x = (float)(v & 0x3ff) * (255.0f / 1023.0f);
+        f.y = (float)((v >> 10) & 0x3ff) * (255.0f / 1023.0f);
+        f.z = (float)((v >> 20) & 0x3ff) * (255.0f / 1023.0f);
+        f.w = (float)(v >> 30) * 85.0f;
+    } else {
+        f = convert<float4>(((const uchar4*)row)[x]);
+    }
+    return f;
+}
 
-    uchar *out = (uchar *)outPtr;
-    uint32_t x1 = xstart;
-    uint32_t x2 = xend;
+/**
+ * Writes the pixel x of a row of the given format from values in the [0, 255] range. The alpha
+ * of Rgb565 and Rgb888 is dropped. RgbaF16 and RgbaF32 values aren't clamped.
+ */
+template <PixelFormat kFormat>
+static inline void packPixel(uchar* row, int x, float4 f) {
+    if constexpr (kFormat == PixelFormat::RgbaF16) {
+        f *= 1.0f / 255.0f;
+        const uint16_t h[4] = {floatToHalf(f.x), floatToHalf(f.y), floatToHalf(f.z),
+                               floatToHalf(f.w)};
+        memcpy(row + x * 8, h, sizeof(h));
+    } else if constexpr (kFormat == PixelFormat::RgbaF32) {
+        f *= 1.0f / 255.0f;
+        memcpy(row + x * 16, &f, sizeof(f));
+    } else if constexpr (kFormat == PixelFormat::Rgb565) {
+        const uint16_t v = (uint16_t)((uint32_t)std::min(f.x * (31.0f / 255.0f) + 0.5f, 31.0f)
+                                              << 11 |
+                                      (uint32_t)std::min(f.y * (63.0f / 255.0f) + 0.5f, 63.0f)
+                                              << 5 |
+                                      (uint32_t)std::min(f.z * (31.0f / 255.0f) + 0.5f, 31.0f));
+        memcpy(row + x * 2, &v, sizeof(v));
+    } else if constexpr (kFormat == PixelFormat::Rgb888) {
+        uchar* p = row + x * 3;
+        p[0] = (uchar)std::min(f.x + 0.5f, 255.0f);
+        p[1] = (uchar)std::min(f.y + 0.5f, 255.0f);
+        p[2] = (uchar)std::min(f.z + 0.5f, 255.0f);
+    } else if constexpr (kFormat == PixelFormat::Rgba1010102) {
+        const float scale = 1023.0f / 255.0f;
+        const uint32_t v = (uint32_t)std::min(f.x * scale + 0.5f, 1023.0f) |
+                           (uint32_t)std::min(f.y * scale + 0.5f, 1023.0f) << 10 |
+                           (uint32_t)std::min(f.z * scale + 0.5f, 1023.0f) << 20 |
+                           (uint32_t)std::min(f.w * (3.0f / 255.0f) + 0.5f, 3.0f) << 30;
+        memcpy(row + x * 4, &v, sizeof(v));
+    }
+}
 
-#if defined(ARCH_ARM_USE_INTRINSICS)
-    if (mUsesSimd && mSizeX >= 16) {
-        // The specialisation for r<=8 has an awkward prefill case, which is
-        // fiddly to resolve, where starting close to the right edge can cause
-        // a read beyond the end of input.  So avoid that case here.
-        if (mIradius > 8 || (mSizeX - std::max(0, (int32_t)x1 - 8)) >= 16) {
-            rsdIntrinsicBlurU1_K(out, mIn + stride * currentY, mSizeX, mSizeY,
-                     stride, x1, currentY, x2 - x1, mIradius, mIp + mIradius);
-            return;
+/**
+ * The linear-light value of an sRGB-encoded value, both in the [0, 255] range. Values between
+ * bytes are interpolated in the table.
+ */
+static inline float srgbToLinear(float value, const ColorTables& tables) {
+    const float clamped = std::min(std::max(value, 0.0f), 255.0f);
+    const int i = std::min((int)clamped, 254);
+    const float t = clamped - (float)i;
+    return tables.srgbToLinear[i] + (tables.srgbToLinear[i + 1] - tables.srgbToLinear[i]) * t;
+}
+
+/**
+ * The sRGB-encoded value of a linear-light value, both in the [0, 255] range. Unlike the table,
+ * it keeps the precision of 10 bit channels.
+ */
+static inline float linearToSrgb(float value) {
+    const float l = std::min(std::max(value * (1.0f / 255.0f), 0.0f), 1.0f);
+    const float s = l <= 0.0031308f ? l * 12.92f : 1.055f * powf(l, 1.0f / 2.4f) - 0.055f;
+    return s * 255.0f;
+}
+
+/**
+ * Reads the pixel x of a row and converts it to the space in which it's blurred, like
+ * decodePixel() does for bytes. Rgb565 and Rgb888 pixels are always opaque and RgbaF16 and
+ * RgbaF32 pixels are never converted to linear light, so the callers don't instantiate those
+ * cases.
+ *
+ * @param row The row of pixels, starting at column 0.
+ * @param x The column of the pixel.
+ * @param tables The color lookup tables.
+ */
+template <PixelFormat kFormat, bool kUnpremultiplied, bool kLinear>
+static inline float4 loadPixel(const uchar* row, int x, const ColorTables& tables) {
+    if constexpr (kFormat == PixelFormat::Rgba8888) {
+        return decodePixel<kUnpremultiplied, kLinear>(((const uchar4*)row)[x], tables);
+    } else {
+        float4 f = unpackPixel<kFormat>(row, x);
+        if (kLinear) {
+            if (!kUnpremultiplied) {
+                const float u = f.w > 0.0f ? 255.0f / f.w : 0.0f;
+                f.x *= u;
+                f.y *= u;
+                f.z *= u;
+            }
+            f.x = srgbToLinear(f.x, tables);
+            f.y = srgbToLinear(f.y, tables);
+            f.z = srgbToLinear(f.z, tables);
         }
+        if (kLinear || kUnpremultiplied) {
+            const float a = f.w * (1.0f / 255.0f);
+            f.x *= a;
+            f.y *= a;
+            f.z *= a;
+        }
+        return f;
     }
-#endif
+}
 
-    float *fout = (float *)buf;
-    int y = currentY;
-    if ((y > mIradius) && (y < ((int)mSizeY - mIradius -1))) {
-        const uchar *pi = mIn + (y - mIradius) * stride;
-        OneVFU1(fout, pi, stride, mFp, mIradius * 2 + 1, mSizeX, mUsesSimd);
+/**
+ * Converts a blurred pixel back to the format of the input and writes it to the pixel x of a
+ * row. The inverse of loadPixel().
+ *
+ * @param row The row of pixels, starting at column 0.
+ * @param x The column of the pixel.
+ * @param in The blurred pixel, premultiplied.
+ * @param tables The color lookup tables.
+ */
+template <PixelFormat kFormat, bool kUnpremultiplied, bool kLinear>
+static inline void storePixel(uchar* row, int x, float4 in, const ColorTables& tables) {
+    if constexpr (kFormat == PixelFormat::Rgba8888) {
+        ((uchar4*)row)[x] = encodePixel<kUnpremultiplied, kLinear>(in, tables);
     } else {
-        x1 = 0;
-        while(mSizeX > x1) {
-            OneVU1(mSizeY, fout, x1, y, mIn, stride, mFp, mIradius);
-            fout++;
-            x1++;
+        float4 f = in;
+        // The alpha that is stored. Premultiplied colors are scaled to match it.
+        float alpha = f.w;
+        if constexpr (kFormat == PixelFormat::Rgba1010102) {
+            alpha = std::min(std::floor(f.w * (3.0f / 255.0f) + 0.5f), 3.0f) * 85.0f;
+        }
+        if (kLinear || kUnpremultiplied || alpha != f.w) {
+            const float u = f.w > 0.0f ? 255.0f / f.w : 0.0f;
+            f.x *= u;
+            f.y *= u;
+            f.z *= u;
+        }
+        if (kLinear) {
+            f.x = linearToSrgb(f.x);
+            f.y = linearToSrgb(f.y);
+            f.z = linearToSrgb(f.z);
         }
+        if (!kUnpremultiplied && (kLinear || alpha != f.w)) {
+            const float a = alpha * (1.0f / 255.0f);
+            f.x *= a;
+            f.y *= a;
+            f.z *= a;
+        }
+        f.w = alpha;
+        packPixel<kFormat>(row, x, f);
     }
+}
 
-    x1 = xstart;
-    while ((x1 < x2) &&
-           ((x1 < (uint32_t)mIradius) || (((uintptr_t)out) & 0x3))) {
-        OneHU1(mSizeX, out, x1, buf, mFp, mIradius);
-        out++;
-        x1++;
+/**
+ * Full blur of a line of RGBA data that needs color conversions. The pixels are converted as
+ * they are read by the vertical pass and converted back as they are written by the horizontal
+ * pass, so no other pass over the image is needed.
+ *
+ * The vertical pass goes through the input one row at a time, which keeps the accesses
+ * sequential.
+ *
+ * @param out Where to store the results.
+ * @param row Working area for the result of the vertical pass, with room for the padding.
+ * @param xstart The index of the section we're starting to blur.
+ * @param xend  The end index of the section.
+ * @param currentY The index of the line we're blurring.
+ * @param threadIndex The index of the thread doing the work.
+ */
+template <PixelFormat kFormat, bool kUnpremultiplied, bool kLinear>
+void BlurTask::kernelU4Converted(uchar* out, float4* row, uint32_t xstart, uint32_t xend,
+                                 uint32_t currentY, uint32_t threadIndex) {
+    const ColorTables& tables = ColorTables::get();
+    int vx1, vx2;
+    verticalSpan(xstart, xend, &vx1, &vx2);
+    const int slots = 2 * mIradiusY + 1;
+    float4* converted =
+            (float4*)mConvertedRows.get(threadIndex, slots * mSizeX * sizeof(float4));
+    if (converted == nullptr) {
+        return;
     }
-#if defined(ARCH_X86_HAVE_SSSE3)
-    if (mUsesSimd) {
-        if ((x1 + mIradius) < x2) {
-            uint32_t len = x2 - (x1 + mIradius);
-            len &= ~3;
-
-            // rsdIntrinsicBlurHFU1_K() processes each four float values in |buf| at once, so it
-            // nees to ensure four more values can be accessed in order to avoid accessing
-            // uninitialized buffer.
-            if (len > 4) {
-                len -= 4;
-                rsdIntrinsicBlurHFU1_K(out, ((float *)buf) - mIradius, mFp,
-                                       mIradius * 2 + 1, x1, x1 + len);
-                out += len;
-                x1 += len;
+    int* tags = mConvertedTags.data() + threadIndex * slots;
+    bool first = true;
+    for (int r = -mIradiusY; r <= mIradiusY; r++) {
+        const int virtualY = (int)currentY + r;
+        const int sourceY = MapEdge(virtualY, mSizeY, mEdgeMode);
+        // Transparent rows don't contribute anything.
+        if (sourceY < 0) {
+            continue;
+        }
+        const int slot = (virtualY % slots + slots) % slots;
+        float4* cells = converted + slot * mSizeX;
+        if (tags[slot] != virtualY) {
+            const uchar* in = inputRow(threadIndex, currentY, virtualY, sourceY);
+            for (int x = vx1; x < vx2; x++) {
+                cells[x] = loadPixel<kFormat, kUnpremultiplied, kLinear>(in, x, tables);
+            }
+            tags[slot] = virtualY;
+        }
+        const float w = mFpY[r + mIradiusY];
+        if (first) {
+            for (int x = vx1; x < vx2; x++) {
+                row[x] = cells[x] * w;
+            }
+            first = false;
+        } else {
+            for (int x = vx1; x < vx2; x++) {
+                row[x] += cells[x] * w;
             }
         }
     }
-#endif
-    while(x2 > x1) {
-        OneHU1(mSizeX, out, x1, buf, mFp, mIradius);
-        out++;
-        x1++;
-    }
-}
+    const uchar* rows[kMaxTaps];
+    float weights[kMaxTaps];
+    const int ct = sourceRows(currentY, 0, threadIndex, rows, weights);
+    padRow(row, xstart, xend, vx1, vx2, [&](int x) {
+        float4 blurredPixel = 0;
+        for (int r = 0; r < ct; r++) {
+            blurredPixel +=
+                    loadPixel<kFormat, kUnpremultiplied, kLinear>(rows[r], x, tables) * weights[r];
+        }
+        return blurredPixel;
+    });
 
-void BlurTask::processData(int threadIndex, size_t startX, size_t startY, size_t endX,
-                           size_t endY) {
-    for (size_t y = startY; y < endY; y++) {
-        void* outPtr = outArray + (mSizeX * y + startX) * mVectorSize;
-        if (mVectorSize == 4) {
-            kernelU4(outPtr, startX, endX, y, threadIndex);
-        } else {
-            kernelU1(outPtr, startX, endX, y);
+    for (uint32_t x = xstart; x < xend; x++) {
+        float4 blurredPixel = 0;
+        const float4* pi = row + x - mIradiusX;
+        for (int r = 0; r <= 2 * mIradiusX; r++) {
+            blurredPixel += pi[r] * mFpX[r];
         }
+        storePixel<kFormat, kUnpremultiplied, kLinear>(out, x - xstart, blurredPixel, tables);
     }
 }
 
-void RenderScriptToolkit::blur(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY,
-                               size_t vectorSize, int radius, const Restriction* restriction) {
-#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
-    if (!validRestriction(LOG_TAG, sizeX, sizeY, restriction)) {
+/**
+ * Full blur of a line of Rgb565 pixels mixed in sRGB. Their channels have less than a byte of
+ * precision, so the rows are expanded to RGBA bytes as they are read and go through the kernels
+ * of the RGBA bytes. The result is packed back as it's written.
+ *
+ * @param out Where to store the results.
+ * @param row Working area for the result of the vertical pass, with room for the padding.
+ * @param xstart The index of the section we're starting to blur.
+ * @param xend  The end index of the section.
+ * @param currentY The index of the line we're blurring.
+ * @param threadIndex The index of the thread doing the work.
+ */
+void BlurTask::kernelU4Rgb565(uchar* out, float4* row, uint32_t xstart, uint32_t xend,
+                              uint32_t currentY, uint32_t threadIndex) {
+    int vx1, vx2;
+    verticalSpan(xstart, xend, &vx1, &vx2);
+    // The ring of expanded rows is followed by one row for the result of the horizontal pass.
+    const int slots = 2 * mIradiusY + 1;
+    uchar4* expanded =
+            (uchar4*)mConvertedRows.get(threadIndex, (slots + 1) * mSizeX * sizeof(uchar4));
+    if (expanded == nullptr) {
         return;
     }
-    if (radius <= 0 || radius > 25) {
-        ALOGE("The radius should be between 1 and 25. %d provided.", radius);
+    int* tags = mConvertedTags.data() + threadIndex * slots;
+    const uchar* rows[kMaxTaps];
+    float weights[kMaxTaps];
+    int ct = 0;
+    for (int r = -mIradiusY; r <= mIradiusY; r++) {
+        const int virtualY = (int)currentY + r;
+        const int sourceY = MapEdge(virtualY, mSizeY, mEdgeMode);
+        // Transparent rows don't contribute anything.
+        if (sourceY < 0) {
+            continue;
+        }
+        const int slot = (virtualY % slots + slots) % slots;
+        uchar4* cells = expanded + slot * mSizeX;
+        if (tags[slot] != virtualY) {
+            const ushort* in = (const ushort*)inputRow(threadIndex, currentY, virtualY, sourceY);
+            for (int x = vx1; x < vx2; x++) {
+                const uint32_t v = in[x];
+                const uint32_t red = v >> 11;
+                const uint32_t green = (v >> 5) & 0x3f;
+                const uint32_t blue = v & 0x1f;
+                cells[x] = uchar4{(uchar)(red << 3 | red >> 2), (uchar)(green << 2 | green >> 4),
+                                  (uchar)(blue << 3 | blue >> 2), 255};
+            }
+            tags[slot] = virtualY;
+        }
+        rows[ct] = (const uchar*)(cells + vx1);
+        weights[ct] = mFpY[r + mIradiusY];
+        ct++;
+    }
+    OneVFU4(row + vx1, rows, weights, ct, vx2 - vx1, mUsesSimd, mX86Extension);
+    const uchar* sources[kMaxTaps];
+    const int sourceCount = sourceRows(currentY, 0, threadIndex, sources, weights);
+    padRow(row, xstart, xend, vx1, vx2, [&](int x) {
+        float4 blurredPixel = 0;
+        for (int r = 0; r < sourceCount; r++) {
+            blurredPixel += unpackPixel<PixelFormat::Rgb565>(sources[r], x) * weights[r];
+        }
+        return blurredPixel;
+    });
+
+    uchar4* blurred = expanded + slots * mSizeX;
+    uint32_t x1 = xstart;
+#if defined(ARCH_X86_HAVE_SSSE3)
+    if (mUsesSimd) {
+        selectX86BlurKernels(mX86Extension)
+                .horizontalU4(blurred, row - mIradiusX, mFpX, mIradiusX * 2 + 1, xstart, xend);
+        x1 = xend;
+    }
+#endif
+    for (; x1 < xend; x1++) {
+        OneHU4(blurred + x1 - xstart, x1, row, mFpX, mIradiusX);
+    }
+    ushort* packed = (ushort*)out;
+    for (uint32_t i = 0; i < xend - xstart; i++) {
+        const uchar4 c = blurred[i];
+        packed[i] = (ushort)(((c.x * 31 + 127) / 255) << 11 | ((c.y * 63 + 127) / 255) << 5 |
+                             ((c.z * 31 + 127) / 255));
+    }
+}
+
+template <PixelFormat kFormat>
+void BlurTask::kernelU4Format(uchar* out, float4* row, uint32_t xstart, uint32_t xend,
+                              uint32_t currentY, uint32_t threadIndex) {
+    // Rgb565 and Rgb888 have no alpha, and RgbaF16 and RgbaF32 are blurred as they are stored.
+    const bool unpremultiplied = kFormat != PixelFormat::Rgb565 &&
+                                 kFormat != PixelFormat::Rgb888 &&
+                                 mAlphaType == AlphaType::Unpremultiplied;
+    const bool linear = kFormat != PixelFormat::RgbaF16 && kFormat != PixelFormat::RgbaF32 &&
+                        mColorSpace == ColorSpace::Linear;
+    if (unpremultiplied && linear) {
+        kernelU4Converted<kFormat, true, true>(out, row, xstart, xend, currentY, threadIndex);
+    } else if (unpremultiplied) {
+        kernelU4Converted<kFormat, true, false>(out, row, xstart, xend, currentY, threadIndex);
+    } else if (linear) {
+        kernelU4Converted<kFormat, false, true>(out, row, xstart, xend, currentY, threadIndex);
+    } else {
+        kernelU4Converted<kFormat, false, false>(out, row, xstart, xend, currentY, threadIndex);
+    }
+}
+
+/**
+ * Full blur of a line of RGBA data.
+ *
+ * The result of the vertical pass is padded on both sides according to the edge mode, so the
+ * horizontal pass runs over the whole section without any boundary checks.
+ *
+ * @param outPtr Where to store the results
+ * @param xstart The index of the section we're starting to blur.
+ * @param xend  The end index of the section.
+ * @param currentY The index of the line we're blurring.
+ * @param threadIndex The index of the thread doing the work.
+ */
+void BlurTask::kernelU4(void *outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
+                        uint32_t threadIndex) {
+    uchar4 *out = (uchar4 *)outPtr;
+    uint32_t x1 = xstart;
+    uint32_t x2 = xend;
+
+#if defined(ARCH_ARM_USE_INTRINSICS)
+    // The assembly clamps at the edges and reads its rows from mIn.
+    if (mUsesSimd && mSizeX >= 4 && isSymmetric() && !convertsColors() &&
+        mEdgeMode == EdgeMode::Clamp && !mInPlace) {
+        const uint32_t stride = mSizeX * mVectorSize;
+        rsdIntrinsicBlurU4_K(out, (uchar4 const *)(mIn + stride * currentY),
+                 mSizeX, mSizeY,
+                 stride, x1, currentY, x2 - x1, mIradiusX, mIpX + mIradiusX);
+        return;
+    }
+#endif
+
+    const size_t paddedSizeX = mSizeX + 2 * mIradiusX + kRowOverread;
+    float4 *buf = (float4 *)mScratch.get(threadIndex, paddedSizeX * sizeof(float4));
+    if (buf == nullptr) {
+        return;
+    }
+    // row[x] holds the result of the vertical pass for the column x. The padding goes on both
+    // sides.
+    float4 *row = buf + mIradiusX;
+    if (convertsColors()) {
+        uchar* bytes = (uchar*)outPtr;
+        switch (mFormat) {
+            case PixelFormat::Rgba8888:
+                kernelU4Format<PixelFormat::Rgba8888>(bytes, row, xstart, xend, currentY,
+                                                      threadIndex);
+                break;
+            case PixelFormat::RgbaF16:
+                kernelU4Format<PixelFormat::RgbaF16>(bytes, row, xstart, xend, currentY,
+                                                     threadIndex);
+                break;
+            case PixelFormat::Rgb565:
+                if (mColorSpace == ColorSpace::Srgb) {
+                    kernelU4Rgb565(bytes, row, xstart, xend, currentY, threadIndex);
+                } else {
+                    kernelU4Format<PixelFormat::Rgb565>(bytes, row, xstart, xend, currentY,
+                                                        threadIndex);
+                }
+                break;
+            case PixelFormat::Rgba1010102:
+                kernelU4Format<PixelFormat::Rgba1010102>(bytes, row, xstart, xend, currentY,
+                                                         threadIndex);
+                break;
+            case PixelFormat::Rgb888:
+                kernelU4Format<PixelFormat::Rgb888>(bytes, row, xstart, xend, currentY,
+                                                    threadIndex);
+                break;
+            case PixelFormat::RgbaF32:
+                kernelU4Format<PixelFormat::RgbaF32>(bytes, row, xstart, xend, currentY,
+                                                     threadIndex);
+                break;
+        }
+        return;
+    }
+
+    int vx1, vx2;
+    verticalSpan(xstart, xend, &vx1, &vx2);
+    const uchar* rows[kMaxTaps];
+    float weights[kMaxTaps];
+    const int ct = sourceRows(currentY, vx1, threadIndex, rows, weights);
+    OneVFU4(row + vx1, rows, weights, ct, vx2 - vx1, mUsesSimd, mX86Extension);
+    padRow(row, xstart, xend, vx1, vx2, [&](int x) {
+        float4 blurredPixel = 0;
+        for (int r = 0; r < ct; r++) {
+            blurredPixel += convert<float4>(((const uchar4*)rows[r])[x - vx1]) * weights[r];
+        }
+        return blurredPixel;
+    });
+
+#if defined(ARCH_X86_HAVE_SSSE3)
+    if (mUsesSimd) {
+        selectX86BlurKernels(mX86Extension)
+                .horizontalU4(out, row - mIradiusX, mFpX, mIradiusX * 2 + 1, x1, x2);
+        return;
+    }
+#endif
+    while(x2 > x1) {
+        OneHU4(out, x1, row, mFpX, mIradiusX);
+        out++;
+        x1++;
+    }
+}
+
+/**
+ * Full blur of a line of U_8 data.
+ *
+ * The result of the vertical pass is padded on both sides according to the edge mode, so the
+ * horizontal pass runs over the whole section without any boundary checks.
+ *
+ * @param outPtr Where to store the results
+ * @param xstart The index of the section we're starting to blur.
+ * @param xend  The end index of the section.
+ * @param currentY The index of the line we're blurring.
+ * @param threadIndex The index of the thread doing the work.
+ */
+void BlurTask::kernelU1(void *outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
+                        uint32_t threadIndex) {
+    uchar *out = (uchar *)outPtr;
+    uint32_t x1 = xstart;
+    uint32_t x2 = xend;
+
+#if defined(ARCH_ARM_USE_INTRINSICS)
+    // The assembly clamps at the edges and reads its rows from mIn.
+    if (mUsesSimd && mSizeX >= 16 && isSymmetric() && mEdgeMode == EdgeMode::Clamp &&
+        !mInPlace) {
+        // The specialisation for r<=8 has an awkward prefill case, which is
+        // fiddly to resolve, where starting close to the right edge can cause
+        // a read beyond the end of input.  So avoid that case here.
+        if (mIradiusX > 8 || (mSizeX - std::max(0, (int32_t)x1 - 8)) >= 16) {
+            const uint32_t stride = mSizeX * mVectorSize;
+            rsdIntrinsicBlurU1_K(out, mIn + stride * currentY, mSizeX, mSizeY,
+                     stride, x1, currentY, x2 - x1, mIradiusX, mIpX + mIradiusX);
+            return;
+        }
+    }
+#endif
+
+    const size_t paddedSizeX = mSizeX + 2 * mIradiusX + kRowOverread;
+    float *buf = (float *)mScratch.get(threadIndex, paddedSizeX * sizeof(float));
+    if (buf == nullptr) {
+        return;
+    }
+    // row[x] holds the result of the vertical pass for the column x. The padding goes on both
+    // sides.
+    float *row = buf + mIradiusX;
+
+    int vx1, vx2;
+    verticalSpan(xstart, xend, &vx1, &vx2);
+    const uchar* rows[kMaxTaps];
+    float weights[kMaxTaps];
+    const int ct = sourceRows(currentY, vx1, threadIndex, rows, weights);
+    OneVFU1(row + vx1, rows, weights, ct, vx2 - vx1, mUsesSimd, mX86Extension);
+    padRow(row, xstart, xend, vx1, vx2, [&](int x) {
+        float blurredPixel = 0;
+        for (int r = 0; r < ct; r++) {
+            blurredPixel += (float)rows[r][x - vx1] * weights[r];
+        }
+        return blurredPixel;
+    });
+
+#if defined(ARCH_X86_HAVE_SSSE3)
+    if (mUsesSimd) {
+        // The kernels blur four cells at a time. The padding covers the values they read past
+        // the end of the row.
+        uint32_t len = (x2 - x1) & ~3;
+        if (len) {
+            selectX86BlurKernels(mX86Extension)
+                    .horizontalU1(out, row - mIradiusX, mFpX, mIradiusX * 2 + 1, x1, x1 + len);
+            out += len;
+            x1 += len;
+        }
+    }
+#endif
+    while(x2 > x1) {
+        OneHU1(out, x1, row, mFpX, mIradiusX);
+        out++;
+        x1++;
+    }
+}
+
+void BlurTask::processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                           size_t endY) {
+    const size_t stride = mSizeX * mPixelSize;
+    uchar* ring = nullptr;
+    if (mInPlace) {
+        // The tile is a whole band.
+        ring = (uchar*)mRings.get(threadIndex, (mIradiusY + 1) * stride);
+        if (ring == nullptr) {
+            return;
+        }
+        mBandRows[threadIndex] = {(int)(startY / mRowsPerBand), (int)startY, (int)endY, ring};
+    }
+    if (!mConvertedTags.empty()) {
+        // The tile may cover other columns than the rows converted for the previous one.
+        const int slots = 2 * mIradiusY + 1;
+        std::fill_n(mConvertedTags.begin() + threadIndex * slots, slots, INT_MIN);
+    }
+    for (size_t y = startY; y < endY; y++) {
+        if (mInPlace && mIradiusY > 0) {
+            memcpy(ring + (y % (mIradiusY + 1)) * stride, mIn + y * stride, stride);
+        }
+        void* outPtr = outArray + (mSizeX * y + startX) * mPixelSize;
+        if (mVectorSize == 4) {
+            kernelU4(outPtr, startX, endX, y, threadIndex);
+        } else {
+            kernelU1(outPtr, startX, endX, y, threadIndex);
+        }
+    }
+}
+
+/**
+ * Draws the blurred alpha channel of an RGBA image, tinted and offset, e.g. a drop shadow or a
+ * glow.
+ *
+ * Everything is done in one pass over the output. Each thread works on a band of rows. As it goes
+ * down its band, it extracts the alpha of the input rows it needs into a ring of 2 * radius + 1
+ * rows, so no full size alpha image is made. The alpha is blurred with the U_8 kernels of the
+ * blur. A table then maps each blurred alpha value to the premultiplied tinted pixel. The image
+ * is transparent past its edges.
+ */
+class ShadowTask : public Task {
+    const uchar4* mIn;
+    const int mInSizeX;
+    const int mInSizeY;
+    uchar4* mOut;
+    // Where the top left corner of the input lands in the output.
+    const int mOffsetX;
+    const int mOffsetY;
+
+    // The coefficients of both passes, and the radius in integer format.
+    float mFp[104];
+    uint16_t mIp[104];
+    int mIradius;
+    // The output pixel for each value of the blurred alpha.
+    uchar4 mTint[256];
+
+    // Per thread working areas: the result of the vertical pass, the blurred alpha of a row,
+    // and the ring of extracted alpha rows along with the input row each slot holds.
+    ScratchBuffers mRows;
+    ScratchBuffers mAlpha;
+    ScratchBuffers mRings;
+    std::vector<std::vector<int>> mRingRows;
+
+    // Process a band of the output. threadIndex identifies which thread does the work.
+    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                     size_t endY) override;
+
+   public:
+    ShadowTask(const uint8_t* in, size_t inSizeX, size_t inSizeY, uint8_t* out, size_t outSizeX,
+               size_t outSizeY, uint32_t threadCount, int offsetX, int offsetY, float radius,
+               uint32_t color, const Restriction* restriction)
+        : Task{outSizeX, outSizeY, 4, false, restriction},
+          mIn{(const uchar4*)in},
+          mInSizeX{(int)inSizeX},
+          mInSizeY{(int)inSizeY},
+          mOut{(uchar4*)out},
+          mOffsetX{offsetX},
+          mOffsetY{offsetY},
+          mRows{threadCount},
+          mAlpha{threadCount},
+          mRings{threadCount},
+          mRingRows(threadCount) {
+        mBandCount = threadCount;
+        mIradius = ComputeGaussianWeights(std::min(25.0f, radius), mFp, mIp);
+        const float4 rgb = {(float)((color >> 16) & 0xff), (float)((color >> 8) & 0xff),
+                            (float)(color & 0xff), 255.f};
+        const float colorAlpha = (float)(color >> 24);
+        for (int a = 0; a < 256; a++) {
+            // The alpha of the pixel, from 0 to 1, times that of the color.
+            const float coverage = a * colorAlpha / (255.f * 255.f);
+            mTint[a] = convert<uchar4>(rgb * coverage + 0.5f);
+        }
+    }
+};
+
+void ShadowTask::processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                             size_t endY) {
+    const int ringSize = 2 * mIradius + 1;
+    const int width = endX - startX;
+    const int paddedWidth = width + 2 * mIradius + kRowOverread;
+    uchar* ring = (uchar*)mRings.get(threadIndex, ringSize * mInSizeX);
+    float* row = (float*)mRows.get(threadIndex, paddedWidth * sizeof(float));
+    uchar* alpha = (uchar*)mAlpha.get(threadIndex, width);
+    if (ring == nullptr || row == nullptr || alpha == nullptr) {
+        return;
+    }
+    std::vector<int>& ringRows = mRingRows[threadIndex];
+    ringRows.assign(ringSize, -1);
+
+    // row[i] holds the vertical pass for the input column firstX + i. Only the columns in
+    // [vx1, vx2) are in the image, the others stay transparent.
+    const int firstX = (int)startX - mOffsetX - mIradius;
+    const int vx1 = std::max(firstX, 0);
+    const int vx2 = std::min(firstX + width + 2 * mIradius, mInSizeX);
+    for (int i = 0; i < paddedWidth; i++) {
+        row[i] = 0;
+    }
+
+    for (size_t y = startY; y < endY; y++) {
+        uchar4* out = mOut + y * mSizeX + startX;
+        const int inY = (int)y - mOffsetY;
+        const uchar* rows[kMaxTaps];
+        float weights[kMaxTaps];
+        int ct = 0;
+        for (int r = -mIradius; r <= mIradius; r++) {
+            const int sourceY = inY + r;
+            if (sourceY < 0 || sourceY >= mInSizeY) {
+                continue;
+            }
+            const int slot = sourceY % ringSize;
+            uchar* alphaRow = ring + slot * mInSizeX;
+            if (ringRows[slot] != sourceY) {
+                const uchar4* in = mIn + sourceY * mInSizeX;
+                for (int x = 0; x < mInSizeX; x++) {
+                    alphaRow[x] = in[x].w;
+                }
+                ringRows[slot] = sourceY;
+            }
+            rows[ct] = alphaRow + vx1;
+            weights[ct] = mFp[r + mIradius];
+            ct++;
+        }
+        if (ct == 0 || vx1 >= vx2) {
+            memset(out, 0, width * sizeof(uchar4));
+            continue;
+        }
+
+        OneVFU1(row + vx1 - firstX, rows, weights, ct, vx2 - vx1, mUsesSimd, mX86Extension);
+        int x = 0;
+#if defined(ARCH_X86_HAVE_SSSE3)
+        if (mUsesSimd) {
+            const int len = width & ~3;
+            if (len) {
+                selectX86BlurKernels(mX86Extension)
+                        .horizontalU1(alpha, row, mFp, mIradius * 2 + 1, 0, len);
+            }
+            x = len;
+        }
+#endif
+        for (; x < width; x++) {
+            OneHU1(alpha + x, x, row + mIradius, mFp, mIradius);
+        }
+        for (x = 0; x < width; x++) {
+            out[x] = mTint[alpha[x]];
+        }
+    }
+}
+
+/**
+ * The two passes of the dual filter blur, which approximates a large Gaussian blur for a cost
+ * that doesn't depend on the radius.
+ *
+ * DualFilterDownTask halves the image. Each output pixel mixes the 4x4 input pixels around it,
+ * the center 2x2 weighing five times more than the others. DualFilterUpTask doubles it. Each
+ * output pixel mixes eight bilinear samples of the smaller image spread around it, which comes
+ * down to fixed weights over 4x4 pixels. The edge pixels are repeated. Chaining n halvings with
+ * n doublings spreads a pixel with a variance of DualFilterVariance(n).
+ *
+ * The weights are small integers, so both passes sum 16 bit integers and round exactly. For each
+ * output row, they first weigh the four input rows it reads, then add up neighboring columns of
+ * these sums. Both steps go through the bytes of the rows in order, whatever the vector size,
+ * which lets the compiler vectorize them.
+ */
+class DualFilterDownTask : public Task {
+    const uchar* mIn;
+    const size_t mInSizeX;
+    const size_t mInSizeY;
+    uchar* mOut;
+    // Per thread working area for the sums of a row.
+    ScratchBuffers mSums;
+
+    // Process a 2D tile of the output. threadIndex identifies which thread does the work.
+    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                     size_t endY) override;
+
+   public:
+    DualFilterDownTask(const uint8_t* in, size_t inSizeX, size_t inSizeY, uint8_t* out,
+                       size_t vectorSize, uint32_t threadCount)
+        : Task{(inSizeX + 1) / 2, (inSizeY + 1) / 2, vectorSize, false, nullptr},
+          mIn{in},
+          mInSizeX{inSizeX},
+          mInSizeY{inSizeY},
+          mOut{out},
+          mSums{threadCount} {}
+};
+
+/**
+ * The sums of the input columns [firstX, firstX + width) an output row reads. The columns
+ * outside of the image repeat the edge ones. Computes the range of columns inside the image,
+ * relative to firstX, as [*x1, *x2).
+ */
+static void InsideColumns(int firstX, int width, int sizeX, int* x1, int* x2) {
+    *x1 = std::clamp(-firstX, 0, width);
+    *x2 = std::clamp(sizeX - firstX, 0, width);
+}
+
+/**
+ * Copies the sums of the edge columns x1 and x2 - 1 into the columns of sums before and after
+ * them.
+ */
+static void RepeatEdgeColumns(ushort* sums, int width, int vectorSize, int x1, int x2) {
+    for (int i = 0; i < x1; i++) {
+        memcpy(sums + i * vectorSize, sums + x1 * vectorSize, vectorSize * sizeof(ushort));
+    }
+    for (int i = x2; i < width; i++) {
+        memcpy(sums + i * vectorSize, sums + (x2 - 1) * vectorSize, vectorSize * sizeof(ushort));
+    }
+}
+
+void DualFilterDownTask::processData(int threadIndex, size_t startX, size_t startY,
+                                     size_t endX, size_t endY) {
+    const int vectorSize = mVectorSize;
+    // The output pixel x reads the input columns 2x - 1 to 2x + 2.
+    const int firstX = (int)startX * 2 - 1;
+    const int width = (int)(endX - startX) * 2 + 2;
+    const int n = width * vectorSize;
+    ushort* inner = (ushort*)mSums.get(threadIndex, n * (2 * sizeof(ushort) + 1));
+    if (inner == nullptr) {
+        return;
+    }
+    // The sums of the two center rows, of all four, and the halved pixels starting at each
+    // column, of which we keep every other one.
+    ushort* all = inner + n;
+    uchar* halved = (uchar*)(all + n);
+    int x1, x2;
+    InsideColumns(firstX, width, mInSizeX, &x1, &x2);
+
+    const size_t stride = mInSizeX * vectorSize;
+    const int lastY = mInSizeY - 1;
+    for (size_t y = startY; y < endY; y++) {
+        const uchar* r[4];
+        for (int j = 0; j < 4; j++) {
+            r[j] = mIn + std::clamp((int)y * 2 - 1 + j, 0, lastY) * stride +
+                   (firstX + x1) * vectorSize;
+        }
+        ushort* innerIn = inner + x1 * vectorSize;
+        ushort* allIn = all + x1 * vectorSize;
+        for (int i = 0; i < (x2 - x1) * vectorSize; i++) {
+            innerIn[i] = r[1][i] + r[2][i];
+            allIn[i] = innerIn[i] + r[0][i] + r[3][i];
+        }
+        RepeatEdgeColumns(inner, width, vectorSize, x1, x2);
+        RepeatEdgeColumns(all, width, vectorSize, x1, x2);
+
+        // The center 2x2 pixels weigh 5 / 32, the others 1 / 32.
+        const int vs = vectorSize;
+        for (int i = 0; i < n - 3 * vs; i++) {
+            const int sum = 4 * (inner[i + vs] + inner[i + 2 * vs]) + all[i] + all[i + vs] +
+                            all[i + 2 * vs] + all[i + 3 * vs];
+            halved[i] = (sum + 16) >> 5;
+        }
+
+        if (vectorSize == 4) {
+            uchar4* out = (uchar4*)mOut + y * mSizeX;
+            const uchar4* in = (const uchar4*)halved - startX * 2;
+            for (size_t x = startX; x < endX; x++) {
+                out[x] = in[x * 2];
+            }
+        } else {
+            uchar* out = mOut + y * mSizeX;
+            const uchar* in = halved - startX * 2;
+            for (size_t x = startX; x < endX; x++) {
+                out[x] = in[x * 2];
+            }
+        }
+    }
+}
+
+class DualFilterUpTask : public Task {
+    const uchar* mIn;
+    const size_t mInSizeX;
+    const size_t mInSizeY;
+    uchar* mOut;
+    // Per thread working area for the sums of a row.
+    ScratchBuffers mSums;
+
+    // Process a 2D tile of the output. threadIndex identifies which thread does the work.
+    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                     size_t endY) override;
+
+   public:
+    DualFilterUpTask(const uint8_t* in, size_t inSizeX, size_t inSizeY, uint8_t* out,
+                     size_t outSizeX, size_t outSizeY, size_t vectorSize, uint32_t threadCount,
+                     const Restriction* restriction)
+        : Task{outSizeX, outSizeY, vectorSize, false, restriction},
+          mIn{in},
+          mInSizeX{inSizeX},
+          mInSizeY{inSizeY},
+          mOut{out},
+          mSums{threadCount} {}
+};
+
+/**
+ * The weights, out of 192, of the 4x4 input pixels mixed into an even output pixel 2X by the
+ * doubling, kDualFilterUpWeights[column][row]. The columns are X - 2 to X + 1. The samples are
+ * at (-1, 0), (1, 0), (0, -1), (0, 1) with a weight of 1 and at (+-0.5, +-0.5) with a weight of
+ * 2, relative to where the center of the output pixel falls, X - 0.25. Odd pixels 2X + 1 fall
+ * at X + 0.25, so they use the columns X + 2 down to X - 1 with the same weights. The same goes
+ * for the rows.
+ */
+static constexpr uint16_t kDualFilterUpWeights[4][4] = {
+        {0, 1, 3, 0}, {1, 24, 34, 9}, {3, 34, 38, 17}, {0, 9, 17, 2}};
+
+/**
+ * Writes the output pixels [startX, endX) of a row, taking the even ones from even and the odd
+ * ones from odd. Both start at the pixel startX / 2 * 2.
+ */
+template <typename T>
+static void Interleave(T* out, const T* even, const T* odd, size_t startX, size_t endX) {
+    even -= startX / 2;
+    odd -= startX / 2;
+    size_t x = startX;
+    if (x & 1) {
+        out[x] = odd[x / 2];
+        x++;
+    }
+    for (; x + 1 < endX; x += 2) {
+        out[x] = even[x / 2];
+        out[x + 1] = odd[x / 2];
+    }
+    if (x < endX) {
+        out[x] = even[x / 2];
+    }
+}
+
+void DualFilterUpTask::processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                                   size_t endY) {
+    const int vectorSize = mVectorSize;
+    // The output pixels 2X and 2X + 1 read the input columns X - 2 to X + 2.
+    const int startCenter = startX / 2;
+    const int endCenter = (endX - 1) / 2 + 1;
+    const int firstX = startCenter - 2;
+    const int width = endCenter - startCenter + 4;
+    const int n = width * vectorSize;
+    const int m = (endCenter - startCenter) * vectorSize;
+    ushort* sums = (ushort*)mSums.get(threadIndex, 4 * n * sizeof(ushort) + 2 * m);
+    if (sums == nullptr) {
+        return;
+    }
+    // The even and odd output pixels.
+    uchar* even = (uchar*)(sums + 4 * n);
+    uchar* odd = even + m;
+    int x1, x2;
+    InsideColumns(firstX, width, mInSizeX, &x1, &x2);
+
+    const size_t stride = mInSizeX * vectorSize;
+    const int lastY = mInSizeY - 1;
+    for (size_t y = startY; y < endY; y++) {
+        // Even rows read the rows Y - 2 to Y + 1, odd ones Y + 2 down to Y - 1.
+        const int Y = (int)y / 2;
+        const uchar* r[4];
+        for (int j = 0; j < 4; j++) {
+            const int inY = (y & 1) ? Y + 2 - j : Y - 2 + j;
+            r[j] = mIn + std::clamp(inY, 0, lastY) * stride + (firstX + x1) * vectorSize;
+        }
+        // The k-th n values of sums are the columns weighed as the column k of the weights.
+        for (int k = 0; k < 4; k++) {
+            const uint16_t* w = kDualFilterUpWeights[k];
+            ushort* s = sums + k * n;
+            ushort* sIn = s + x1 * vectorSize;
+            for (int i = 0; i < (x2 - x1) * vectorSize; i++) {
+                sIn[i] = w[0] * r[0][i] + w[1] * r[1][i] + w[2] * r[2][i] + w[3] * r[3][i];
+            }
+            RepeatEdgeColumns(s, width, vectorSize, x1, x2);
+        }
+
+        // Where the column startCenter is in each of the weighed sums.
+        const int vs = vectorSize;
+        const ushort* s0 = sums + 2 * vs;
+        const ushort* s1 = s0 + n;
+        const ushort* s2 = s1 + n;
+        const ushort* s3 = s2 + n;
+        // Divides by 192 = 64 * 3, rounding to nearest. There's one loop for the even pixels and
+        // one for the odd ones as the compiler gives up on vectorizing a loop with more pointers.
+        for (int i = 0; i < m; i++) {
+            const int sum = s0[i - 2 * vs] + s1[i - vs] + s2[i] + s3[i + vs];
+            even[i] = ((sum + 96) >> 6) / 3;
+        }
+        for (int i = 0; i < m; i++) {
+            const int sum = s3[i - vs] + s2[i] + s1[i + vs] + s0[i + 2 * vs];
+            odd[i] = ((sum + 96) >> 6) / 3;
+        }
+
+        if (vectorSize == 4) {
+            Interleave((uchar4*)mOut + y * mSizeX, (const uchar4*)even, (const uchar4*)odd,
+                       startX, endX);
+        } else {
+            Interleave(mOut + y * mSizeX, even, odd, startX, endX);
+        }
+    }
+}
+
+// The most times the dual filter blur halves the image.
+static constexpr int kMaxDualFilterLevels = 8;
+
+/**
+ * The variance along each axis of the dual filter blur with the given number of levels, in
+ * pixels of the full size image. It was measured by running single pixels through the passes.
+ */
+static float DualFilterVariance(int levels) {
+    return 17.f / 18.f * (float)((1 << (2 * levels)) - 1);
+}
+
+/**
+ * The variance of the coefficients ComputeGaussianWeights() computes for a radius. Unlike the
+ * latter, it accepts radii above 25.
+ */
+static float GaussianVariance(float radius) {
+    const float sigma = 0.4f * radius + 0.6f;
+    const int iradius = (float)ceil(radius) + 0.5f;
+    float sum = 0.f;
+    float moment = 0.f;
+    for (int r = -iradius; r <= iradius; r++) {
+        const float w = expf(-(float)(r * r) / (2.f * sigma * sigma));
+        sum += w;
+        moment += w * r * r;
+    }
+    return moment / sum;
+}
+
+/**
+ * The radius up to 25 whose Gaussian coefficients have the given variance, or is the closest.
+ */
+static float GaussianRadiusForVariance(float variance) {
+    float low = 0.f;
+    float high = 25.f;
+    for (int i = 0; i < 24; i++) {
+        const float middle = (low + high) * 0.5f;
+        if (GaussianVariance(middle) < variance) {
+            low = middle;
+        } else {
+            high = middle;
+        }
+    }
+    return high;
+}
+
+// Below this, the variance a rung of a blur ladder lacks is not worth a pass.
+static constexpr float kNegligibleVariance = 0.1f;
+
+/**
+ * Mixes two images, e.g. two rungs of a blur ladder. Each byte of the output is
+ * lower + (upper - lower) * fraction, with the fraction rounded to 1/256.
+ */
+class InterpolateTask : public Task {
+    const uchar* mLower;
+    const uchar* mUpper;
+    uchar* mOut;
+    // The weight of the upper image, out of 256.
+    int mWeight;
+
+    // Process a 2D tile of the overall work. threadIndex identifies which thread does the work.
+    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                     size_t endY) override;
+
+   public:
+    InterpolateTask(const uint8_t* lower, const uint8_t* upper, uint8_t* out, size_t sizeX,
+                    size_t sizeY, size_t vectorSize, float fraction,
+                    const Restriction* restriction)
+        : Task{sizeX, sizeY, vectorSize, true, restriction},
+          mLower{lower},
+          mUpper{upper},
+          mOut{out},
+          mWeight{(int)(fraction * 256.f + 0.5f)} {}
+};
+
+void InterpolateTask::processData(int /* threadIndex */, size_t startX, size_t startY,
+                                  size_t endX, size_t endY) {
+    const int upperWeight = mWeight;
+    const int lowerWeight = 256 - mWeight;
+    for (size_t y = startY; y < endY; y++) {
+        const size_t offset = (y * mSizeX + startX) * mVectorSize;
+        const size_t length = (endX - startX) * mVectorSize;
+        const uchar* lower = mLower + offset;
+        const uchar* upper = mUpper + offset;
+        uchar* out = mOut + offset;
+        for (size_t i = 0; i < length; i++) {
+            out[i] = (lower[i] * lowerWeight + upper[i] * upperWeight + 128) >> 8;
+        }
+    }
+}
+
+/**
+ * The levels of a dual filter blur: their sizes, and where each one starts in the buffer that
+ * holds all of them but the full size one. Level 0 is the full size image.
+ */
+struct DualFilterLevels {
+    int count = 0;
+    size_t sizesX[kMaxDualFilterLevels + 1];
+    size_t sizesY[kMaxDualFilterLevels + 1];
+    size_t offsets[kMaxDualFilterLevels + 1];
+    size_t totalSize = 0;
+
+    DualFilterLevels(size_t sizeX, size_t sizeY, size_t vectorSize, int levelCount)
+        : count{levelCount} {
+        sizesX[0] = sizeX;
+        sizesY[0] = sizeY;
+        offsets[0] = 0;
+        for (int level = 1; level <= count; level++) {
+            sizesX[level] = (sizesX[level - 1] + 1) / 2;
+            sizesY[level] = (sizesY[level - 1] + 1) / 2;
+            offsets[level] = totalSize;
+            const size_t alignment = ScratchBuffers::kAlignment;
+            totalSize += divideRoundingUp(sizesX[level] * sizesY[level] * vectorSize, alignment) *
+                         alignment;
+        }
+    }
+};
+
+/**
+ * Picks how many times the dual filter blur halves the image for a radius: as many as we can
+ * while leaving the Gaussian blur of the smallest level some variance to make up, at least half
+ * a pixel squared of that level. Each level has to be at least 4 pixels wide and high.
+ *
+ * @param residualRadius Receives the radius of the Gaussian blur of the smallest level.
+ * @return The number of levels, or 0 if the radius is too small or the image can't be halved.
+ */
+static int PlanDualFilter(int radius, size_t sizeX, size_t sizeY, float* residualRadius) {
+    const float variance = GaussianVariance(radius);
+    const size_t minSize = std::min(sizeX, sizeY);
+    int levels = 0;
+    while (levels < kMaxDualFilterLevels && (minSize >> (levels + 1)) >= 4 &&
+           variance - DualFilterVariance(levels + 1) >= 0.5f * (float)(1 << (2 * (levels + 1)))) {
+        levels++;
+    }
+    *residualRadius = GaussianRadiusForVariance((variance - DualFilterVariance(levels)) /
+                                                (float)(1 << (2 * levels)));
+    return levels;
+}
+
+/**
+ * Halves in into the levels 1 to levels.count of buffer.
+ */
+static void DualFilterDown(TaskProcessor* processor, const uchar* in, uchar* buffer,
+                           const DualFilterLevels& levels, size_t vectorSize) {
+    for (int level = 1; level <= levels.count; level++) {
+        const uchar* source = level == 1 ? in : buffer + levels.offsets[level - 1];
+        DualFilterDownTask task(source, levels.sizesX[level - 1], levels.sizesY[level - 1],
+                                buffer + levels.offsets[level], vectorSize,
+                                processor->getNumberOfThreads());
+        processor->doTask(&task);
+    }
+}
+
+/**
+ * Blurs the level levelCount of buffer in place with residualRadius, then doubles it back up to
+ * out. The levels in between are overwritten.
+ */
+static void DualFilterUp(TaskProcessor* processor, uchar* buffer, const DualFilterLevels& levels,
+                         int levelCount, float residualRadius, uchar* out, size_t vectorSize,
+                         const Restriction* restriction) {
+    {
+        BlurTask task(buffer + levels.offsets[levelCount], levels.sizesX[levelCount],
+                      levels.sizesY[levelCount], vectorSize, processor->getNumberOfThreads(),
+                      residualRadius, residualRadius, AlphaType::Premultiplied, ColorSpace::Srgb,
+                      EdgeMode::Clamp);
+        processor->doTask(&task);
+    }
+    // Each level is doubled into the one above it, which isn't needed anymore.
+    for (int level = levelCount; level >= 1; level--) {
+        const bool last = level == 1;
+        DualFilterUpTask task(buffer + levels.offsets[level], levels.sizesX[level],
+                              levels.sizesY[level], last ? out : buffer + levels.offsets[level - 1],
+                              levels.sizesX[level - 1], levels.sizesY[level - 1], vectorSize,
+                              processor->getNumberOfThreads(), last ? restriction : nullptr);
+        processor->doTask(&task);
+    }
+}
+
+void RenderScriptToolkit::blur(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY,
+                               size_t vectorSize, int radius, const Restriction* restriction) {
+    blur(in, out, sizeX, sizeY, vectorSize, radius, radius, restriction);
+}
+
+void RenderScriptToolkit::blur(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY,
+                               size_t vectorSize, int radiusX, int radiusY,
+                               const Restriction* restriction) {
+    blur(in, out, sizeX, sizeY, vectorSize, radiusX, radiusY, AlphaType::Premultiplied,
+         ColorSpace::Srgb, EdgeMode::Clamp, restriction);
+}
+
+void RenderScriptToolkit::blur(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY,
+                               size_t vectorSize, int radiusX, int radiusY, AlphaType alphaType,
+                               ColorSpace colorSpace, EdgeMode edgeMode,
+                               const Restriction* restriction) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (!validRestriction(LOG_TAG, sizeX, sizeY, restriction)) {
+        return;
+    }
+    if (radiusX < 0 || radiusX > 25 || radiusY < 0 || radiusY > 25) {
+        ALOGE("The radii should be between 0 and 25. %d and %d provided.", radiusX, radiusY);
+        return;
+    }
+    if (radiusX == 0 && radiusY == 0) {
+        ALOGE("At least one of the radii should be greater than 0.");
+        return;
     }
     if (vectorSize != 1 && vectorSize != 4) {
         ALOGE("The vectorSize should be 1 or 4. %zu provided.", vectorSize);
     }
 #endif
 
-    BlurTask task(in, out, sizeX, sizeY, vectorSize, processor->getNumberOfThreads(), radius,
-                  restriction);
+    BlurTask task(in, out, sizeX, sizeY, vectorSize, processor->getNumberOfThreads(), radiusX,
+                  radiusY, alphaType, colorSpace, edgeMode, restriction);
+    processor->doTask(&task);
+}
+
+void RenderScriptToolkit::blur(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY,
+                               PixelFormat format, int radiusX, int radiusY, AlphaType alphaType,
+                               ColorSpace colorSpace, EdgeMode edgeMode,
+                               const Restriction* restriction) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (!validRestriction(LOG_TAG, sizeX, sizeY, restriction)) {
+        return;
+    }
+    if (radiusX < 0 || radiusX > 25 || radiusY < 0 || radiusY > 25) {
+        ALOGE("The radii should be between 0 and 25. %d and %d provided.", radiusX, radiusY);
+        return;
+    }
+    if (radiusX == 0 && radiusY == 0) {
+        ALOGE("At least one of the radii should be greater than 0.");
+        return;
+    }
+#endif
+
+    BlurTask task(in, out, sizeX, sizeY, 4, processor->getNumberOfThreads(), radiusX, radiusY,
+                  alphaType, colorSpace, edgeMode, restriction, format);
     processor->doTask(&task);
 }
 
+void RenderScriptToolkit::blur(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY,
+                               size_t vectorSize, int radius, BlurQuality quality,
+                               const Restriction* restriction) {
+    if (quality == BlurQuality::Gaussian) {
+        blur(in, out, sizeX, sizeY, vectorSize, radius, radius, restriction);
+        return;
+    }
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (!validRestriction(LOG_TAG, sizeX, sizeY, restriction)) {
+        return;
+    }
+    if (radius <= 0 || radius > 250) {
+        ALOGE("The radius should be between 1 and 250. %d provided.", radius);
+        return;
+    }
+    if (vectorSize != 1 && vectorSize != 4) {
+        ALOGE("The vectorSize should be 1 or 4. %zu provided.", vectorSize);
+    }
+#endif
+
+    float residualRadius;
+    const int levelCount = PlanDualFilter(radius, sizeX, sizeY, &residualRadius);
+    if (levelCount == 0) {
+        blur(in, out, sizeX, sizeY, vectorSize, std::min(radius, 25), std::min(radius, 25),
+             restriction);
+        return;
+    }
+
+    // All the levels but the full size one go in a single buffer.
+    const DualFilterLevels levels(sizeX, sizeY, vectorSize, levelCount);
+    BufferPool* pool = processor->getBufferPool();
+    uchar* buffer = (uchar*)pool->acquire(levels.totalSize);
+    if (buffer == nullptr) {
+        return;
+    }
+    DualFilterDown(processor.get(), in, buffer, levels, vectorSize);
+    DualFilterUp(processor.get(), buffer, levels, levelCount, residualRadius, out, vectorSize,
+                 restriction);
+    pool->release(buffer);
+}
+
+void RenderScriptToolkit::blurLadder(const uint8_t* in, uint8_t* const* out, size_t sizeX,
+                                     size_t sizeY, size_t vectorSize, const int* radii,
+                                     size_t count, BlurQuality quality) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    const int maxRadius = quality == BlurQuality::Fast ? 250 : 50;
+    for (size_t i = 0; i < count; i++) {
+        if (radii[i] < 0 || radii[i] > maxRadius) {
+            ALOGE("The radii should be between 0 and %d. %d provided.", maxRadius, radii[i]);
+            return;
+        }
+        if (i > 0 && radii[i] <= radii[i - 1]) {
+            ALOGE("The radii should be in increasing order. %d follows %d.", radii[i],
+                  radii[i - 1]);
+            return;
+        }
+    }
+    if (vectorSize != 1 && vectorSize != 4) {
+        ALOGE("The vectorSize should be 1 or 4. %zu provided.", vectorSize);
+    }
+#endif
+
+    const size_t size = sizeX * sizeY * vectorSize;
+    if (quality == BlurQuality::Gaussian) {
+        // Each rung blurs the previous one with the variance it lacks, in as many passes as
+        // needed. The first pass from the input uses the radius as is, to match blur().
+        const uchar* source = in;
+        float variance = 0.f;
+        for (size_t i = 0; i < count; i++) {
+            const float target = GaussianVariance(radii[i]);
+            bool blurred = false;
+            while (target - variance > kNegligibleVariance) {
+                const float radius = variance == 0.f ? std::min(radii[i], 25)
+                                                     : GaussianRadiusForVariance(target - variance);
+                if (blurred) {
+                    BlurTask task(out[i], sizeX, sizeY, vectorSize,
+                                  processor->getNumberOfThreads(), radius, radius,
+                                  AlphaType::Premultiplied, ColorSpace::Srgb, EdgeMode::Clamp);
+                    processor->doTask(&task);
+                } else {
+                    BlurTask task(source, out[i], sizeX, sizeY, vectorSize,
+                                  processor->getNumberOfThreads(), radius, radius,
+                                  AlphaType::Premultiplied, ColorSpace::Srgb, EdgeMode::Clamp,
+                                  nullptr);
+                    processor->doTask(&task);
+                }
+                variance += GaussianVariance(radius);
+                blurred = true;
+            }
+            if (!blurred) {
+                memcpy(out[i], source, size);
+            }
+            source = out[i];
+        }
+        return;
+    }
+
+    // The rungs share the halved levels. Each one copies the level it starts from, blurs it,
+    // and doubles it back up in a second set of levels.
+    std::vector<int> levelCounts(count);
+    std::vector<float> residualRadii(count);
+    int maxLevelCount = 0;
+    for (size_t i = 0; i < count; i++) {
+        levelCounts[i] =
+                radii[i] == 0 ? 0 : PlanDualFilter(radii[i], sizeX, sizeY, &residualRadii[i]);
+        maxLevelCount = std::max(maxLevelCount, levelCounts[i]);
+    }
+    const DualFilterLevels levels(sizeX, sizeY, vectorSize, maxLevelCount);
+    BufferPool* pool = processor->getBufferPool();
+    uchar* buffer = nullptr;
+    uchar* work = nullptr;
+    if (maxLevelCount > 0) {
+        buffer = (uchar*)pool->acquire(levels.totalSize * 2);
+        if (buffer == nullptr) {
+            return;
+        }
+        work = buffer + levels.totalSize;
+        DualFilterDown(processor.get(), in, buffer, levels, vectorSize);
+    }
+    for (size_t i = 0; i < count; i++) {
+        const int levelCount = levelCounts[i];
+        if (radii[i] == 0) {
+            memcpy(out[i], in, size);
+        } else if (levelCount == 0) {
+            const int radius = std::min(radii[i], 25);
+            BlurTask task(in, out[i], sizeX, sizeY, vectorSize, processor->getNumberOfThreads(),
+                          radius, radius, AlphaType::Premultiplied, ColorSpace::Srgb,
+                          EdgeMode::Clamp, nullptr);
+            processor->doTask(&task);
+        } else {
+            const size_t offset = levels.offsets[levelCount];
+            memcpy(work + offset, buffer + offset,
+                   levels.sizesX[levelCount] * levels.sizesY[levelCount] * vectorSize);
+            DualFilterUp(processor.get(), work, levels, levelCount, residualRadii[i], out[i],
+                         vectorSize, nullptr);
+        }
+    }
+    if (buffer != nullptr) {
+        pool->release(buffer);
+    }
+}
+
+void RenderScriptToolkit::interpolateBlurLadder(const uint8_t* const* ladder, const int* radii,
+                                                size_t count, uint8_t* out, size_t sizeX,
+                                                size_t sizeY, size_t vectorSize, float radius,
+                                                const Restriction* restriction) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (!validRestriction(LOG_TAG, sizeX, sizeY, restriction)) {
+        return;
+    }
+    if (count == 0) {
+        ALOGE("The ladder should have at least one rung.");
+        return;
+    }
+    if (vectorSize != 1 && vectorSize != 4) {
+        ALOGE("The vectorSize should be 1 or 4. %zu provided.", vectorSize);
+    }
+#endif
+
+    // Find the rungs around the radius. Mixing them in the ratio of the variances gives an
+    // image with the variance of the radius.
+    size_t upper = 0;
+    while (upper < count - 1 && radii[upper] < radius) {
+        upper++;
+    }
+    const size_t lower = upper == 0 ? 0 : upper - 1;
+    float fraction = 1.f;
+    if (lower != upper) {
+        const float lowerVariance = GaussianVariance(radii[lower]);
+        fraction = (GaussianVariance(std::max(radius, 0.f)) - lowerVariance) /
+                   (GaussianVariance(radii[upper]) - lowerVariance);
+    }
+    InterpolateTask task(ladder[lower], ladder[upper], out, sizeX, sizeY, vectorSize,
+                         std::clamp(fraction, 0.f, 1.f), restriction);
+    processor->doTask(&task);
+}
+
+void RenderScriptToolkit::blurInPlace(uint8_t* inOut, size_t sizeX, size_t sizeY,
+                                      size_t vectorSize, int radius) {
+    blurInPlace(inOut, sizeX, sizeY, vectorSize, radius, radius, AlphaType::Premultiplied,
+                ColorSpace::Srgb, EdgeMode::Clamp);
+}
+
+void RenderScriptToolkit::blurInPlace(uint8_t* inOut, size_t sizeX, size_t sizeY,
+                                      size_t vectorSize, int radiusX, int radiusY,
+                                      AlphaType alphaType, ColorSpace colorSpace,
+                                      EdgeMode edgeMode) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (radiusX < 0 || radiusX > 25 || radiusY < 0 || radiusY > 25) {
+        ALOGE("The radii should be between 0 and 25. %d and %d provided.", radiusX, radiusY);
+        return;
+    }
+    if (radiusX == 0 && radiusY == 0) {
+        ALOGE("At least one of the radii should be greater than 0.");
+        return;
+    }
+    if (vectorSize != 1 && vectorSize != 4) {
+        ALOGE("The vectorSize should be 1 or 4. %zu provided.", vectorSize);
+    }
+#endif
+
+    BlurTask task(inOut, sizeX, sizeY, vectorSize, processor->getNumberOfThreads(), radiusX,
+                  radiusY, alphaType, colorSpace, edgeMode);
+    processor->doTask(&task);
+}
+
+void RenderScriptToolkit::blurInPlace(uint8_t* inOut, size_t sizeX, size_t sizeY,
+                                      PixelFormat format, int radiusX, int radiusY,
+                                      AlphaType alphaType, ColorSpace colorSpace,
+                                      EdgeMode edgeMode) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (radiusX < 0 || radiusX > 25 || radiusY < 0 || radiusY > 25) {
+        ALOGE("The radii should be between 0 and 25. %d and %d provided.", radiusX, radiusY);
+        return;
+    }
+    if (radiusX == 0 && radiusY == 0) {
+        ALOGE("At least one of the radii should be greater than 0.");
+        return;
+    }
+#endif
+
+    BlurTask task(inOut, sizeX, sizeY, 4, processor->getNumberOfThreads(), radiusX, radiusY,
+                  alphaType, colorSpace, edgeMode, format);
+    processor->doTask(&task);
+}
+
+void RenderScriptToolkit::shadow(const uint8_t* in, size_t sizeX, size_t sizeY, uint8_t* out,
+                                 size_t outputSizeX, size_t outputSizeY, int radius,
+                                 uint32_t color, int offsetX, int offsetY,
+                                 const Restriction* restriction) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (!validRestriction(LOG_TAG, outputSizeX, outputSizeY, restriction)) {
+        return;
+    }
+    if (radius < 0 || radius > 25) {
+        ALOGE("The radius should be between 0 and 25. %d provided.", radius);
+        return;
+    }
+#endif
+
+    ShadowTask task(in, sizeX, sizeY, out, outputSizeX, outputSizeY,
+                    processor->getNumberOfThreads(), offsetX, offsetY, radius, color,
+                    restriction);
+    processor->doTask(&task);
+}
+
+/**
+ * Computes the output pixels along one axis that change when the input pixels in [start, end)
+ * change, i.e. the range expanded by the radius. With Wrap, the expanded range can go around the
+ * edge of the image, in which case it's split in two.
+ *
+ * @return The number of ranges stored in starts and ends, 1 or 2.
+ */
+static int AffectedRanges(size_t start, size_t end, int radius, size_t size, EdgeMode edgeMode,
+                          size_t* starts, size_t* ends) {
+    const int64_t first = (int64_t)start - radius;
+    const int64_t last = (int64_t)end + radius;
+    const int64_t isize = (int64_t)size;
+    if (edgeMode != EdgeMode::Wrap || (first >= 0 && last <= isize)) {
+        starts[0] = std::max(first, (int64_t)0);
+        ends[0] = std::min(last, isize);
+        return 1;
+    }
+    if (last - first >= isize) {
+        starts[0] = 0;
+        ends[0] = size;
+        return 1;
+    }
+    // The range is shorter than the image so it goes around one edge only.
+    if (first < 0) {
+        starts[0] = 0;
+        ends[0] = last;
+        starts[1] = first + isize;
+        ends[1] = size;
+    } else {
+        starts[0] = first;
+        ends[0] = size;
+        starts[1] = 0;
+        ends[1] = last - isize;
+    }
+    return 2;
+}
+
+static size_t Area(const Restriction& r) {
+    return (r.endX - r.startX) * (r.endY - r.startY);
+}
+
+/**
+ * Replaces pairs of regions by their bounding box when that box isn't larger than the two
+ * regions combined, e.g. when they overlap a lot or are side by side.
+ */
+static void MergeRegions(std::vector<Restriction>* regions) {
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < regions->size() && !merged; i++) {
+            for (size_t j = i + 1; j < regions->size() && !merged; j++) {
+                Restriction& a = (*regions)[i];
+                const Restriction& b = (*regions)[j];
+                const Restriction box{std::min(a.startX, b.startX), std::max(a.endX, b.endX),
+                                      std::min(a.startY, b.startY), std::max(a.endY, b.endY)};
+                if (Area(box) <= Area(a) + Area(b)) {
+                    a = box;
+                    regions->erase(regions->begin() + j);
+                    merged = true;
+                }
+            }
+        }
+    }
+}
+
+void RenderScriptToolkit::blurDirtyRegions(const uint8_t* in, uint8_t* out, size_t sizeX,
+                                           size_t sizeY, size_t vectorSize, int radius,
+                                           const Restriction* dirtyRegions,
+                                           size_t dirtyRegionCount) {
+    blurDirtyRegions(in, out, sizeX, sizeY, vectorSize, radius, radius,
+                     AlphaType::Premultiplied, ColorSpace::Srgb, EdgeMode::Clamp, dirtyRegions,
+                     dirtyRegionCount);
+}
+
+void RenderScriptToolkit::blurDirtyRegions(const uint8_t* in, uint8_t* out, size_t sizeX,
+                                           size_t sizeY, size_t vectorSize, int radiusX,
+                                           int radiusY, AlphaType alphaType,
+                                           ColorSpace colorSpace, EdgeMode edgeMode,
+                                           const Restriction* dirtyRegions,
+                                           size_t dirtyRegionCount) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    for (size_t i = 0; i < dirtyRegionCount; i++) {
+        if (!validRestriction(LOG_TAG, sizeX, sizeY, &dirtyRegions[i])) {
+            return;
+        }
+    }
+    if (radiusX < 0 || radiusX > 25 || radiusY < 0 || radiusY > 25) {
+        ALOGE("The radii should be between 0 and 25. %d and %d provided.", radiusX, radiusY);
+        return;
+    }
+    if (radiusX == 0 && radiusY == 0) {
+        ALOGE("At least one of the radii should be greater than 0.");
+        return;
+    }
+    if (vectorSize != 1 && vectorSize != 4) {
+        ALOGE("The vectorSize should be 1 or 4. %zu provided.", vectorSize);
+    }
+    if (in == out) {
+        ALOGE("The input and output buffers should be different.");
+        return;
+    }
+#endif
+
+    std::vector<Restriction> regions;
+    for (size_t i = 0; i < dirtyRegionCount; i++) {
+        const Restriction& dirty = dirtyRegions[i];
+        size_t startX[2], endX[2], startY[2], endY[2];
+        const int countX = AffectedRanges(dirty.startX, dirty.endX, radiusX, sizeX, edgeMode,
+                                          startX, endX);
+        const int countY = AffectedRanges(dirty.startY, dirty.endY, radiusY, sizeY, edgeMode,
+                                          startY, endY);
+        for (int y = 0; y < countY; y++) {
+            for (int x = 0; x < countX; x++) {
+                regions.push_back({startX[x], endX[x], startY[y], endY[y]});
+            }
+        }
+    }
+    MergeRegions(&regions);
+
+    // Each region is a restricted blur. The tasks read the halo around their region from the
+    // input, so the regions don't depend on each other.
+    for (const Restriction& region : regions) {
+        BlurTask task(in, out, sizeX, sizeY, vectorSize, processor->getNumberOfThreads(), radiusX,
+                      radiusY, alphaType, colorSpace, edgeMode, &region);
+        processor->doTask(&task);
+    }
+}
+
 }  // namespace renderscript
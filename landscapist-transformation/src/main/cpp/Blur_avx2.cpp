@@ -0,0 +1,134 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <x86intrin.h>
+
+namespace renderscript {
+
+/* AVX2 versions of the SSSE3 blur kernels in x86.cpp. They take the same arguments and have the
+ * same alignment and count requirements. The main loops handle four pixels at a time; whatever
+ * remains is left to the SSSE3 kernels.
+ */
+
+extern void rsdIntrinsicBlurVFU4_K(void *dst, const void *const *rows, const void *gptr, int rct,
+                                   int x1, int x2);
+extern void rsdIntrinsicBlurHFU4_K(void *dst, const void *pin, const void *gptr, int rct, int x1,
+                                   int x2);
+extern void rsdIntrinsicBlurHFU1_K(void *dst, const void *pin, const void *gptr, int rct, int x1,
+                                   int x2);
+
+/* Rounds the four RGBA float pixels held in lo and hi to bytes, keeping them in order. */
+static inline __m128i packPixelsU4(__m256 lo, __m256 hi) {
+    /* Within each 128 bit lane, packus interleaves lo and hi. We end up with pixels 0, 2, 1, 3. */
+    __m256i p16 = _mm256_packus_epi32(_mm256_cvtps_epi32(lo), _mm256_cvtps_epi32(hi));
+    __m128i p8 = _mm_packus_epi16(_mm256_castsi256_si128(p16), _mm256_extracti128_si256(p16, 1));
+    return _mm_shuffle_epi32(p8, _MM_SHUFFLE(3, 1, 2, 0));
+}
+
+void rsdIntrinsicBlurVFU4Avx2_K(void *dst,
+                                const void *const *rows, const void *gptr,
+                                int rct, int x1, int x2) {
+    const float *g = (const float *)gptr;
+    const char *pi;
+    __m128i p;
+    __m256 w, bp0, bp1;
+    int r;
+
+    for (; x1 + 4 <= x2; x1 += 4) {
+        bp0 = _mm256_setzero_ps();
+        bp1 = _mm256_setzero_ps();
+
+        for (r = 0; r < rct; ++r) {
+            w = _mm256_broadcast_ss(g + r);
+            pi = (const char *)rows[r] + (x1 << 2);
+            p = _mm_loadu_si128((const __m128i *)pi);
+
+            bp0 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(p)), w, bp0);
+            bp1 = _mm256_fmadd_ps(_mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_srli_si128(p, 8))),
+                                  w, bp1);
+        }
+
+        _mm256_storeu_ps((float *)dst, bp0);
+        _mm256_storeu_ps((float *)dst + 8, bp1);
+        dst = (char *)dst + 64;
+    }
+
+    if (x1 < x2) {
+        rsdIntrinsicBlurVFU4_K(dst, rows, gptr, rct, x1, x2);
+    }
+}
+
+void rsdIntrinsicBlurHFU4Avx2_K(void *dst,
+                                const void *pin, const void *gptr,
+                                int rct, int x1, int x2) {
+    const float *g = (const float *)gptr;
+    const float *pi;
+    __m256 w, bp0, bp1;
+    int r;
+
+    for (; x1 + 4 <= x2; x1 += 4) {
+        pi = (const float *)pin + (x1 << 2);
+        bp0 = _mm256_setzero_ps();
+        bp1 = _mm256_setzero_ps();
+
+        /* Each accumulator holds two neighboring pixels. */
+        for (r = 0; r < rct; ++r) {
+            w = _mm256_broadcast_ss(g + r);
+            bp0 = _mm256_fmadd_ps(w, _mm256_loadu_ps(pi + (r << 2)), bp0);
+            bp1 = _mm256_fmadd_ps(w, _mm256_loadu_ps(pi + (r << 2) + 8), bp1);
+        }
+
+        _mm_storeu_si128((__m128i *)dst, packPixelsU4(bp0, bp1));
+        dst = (char *)dst + 16;
+    }
+
+    if (x1 < x2) {
+        rsdIntrinsicBlurHFU4_K(dst, pin, gptr, rct, x1, x2);
+    }
+}
+
+void rsdIntrinsicBlurHFU1Avx2_K(void *dst,
+                                const void *pin, const void *gptr,
+                                int rct, int x1, int x2) {
+    const float *g = (const float *)gptr;
+    const float *pi;
+    __m256 w, bp;
+    __m256i o;
+    __m128i o16;
+    int r;
+
+    for (; x1 + 8 <= x2; x1 += 8) {
+        pi = (const float *)pin + x1;
+        bp = _mm256_setzero_ps();
+
+        for (r = 0; r < rct; ++r) {
+            w = _mm256_broadcast_ss(g + r);
+            bp = _mm256_fmadd_ps(w, _mm256_loadu_ps(pi + r), bp);
+        }
+
+        o = _mm256_cvtps_epi32(bp);
+        o16 = _mm_packus_epi32(_mm256_castsi256_si128(o), _mm256_extracti128_si256(o, 1));
+        _mm_storel_epi64((__m128i *)dst, _mm_packus_epi16(o16, o16));
+        dst = (char *)dst + 8;
+    }
+
+    if (x1 < x2) {
+        rsdIntrinsicBlurHFU1_K(dst, pin, gptr, rct, x1, x2);
+    }
+}
+
+}  // namespace renderscript
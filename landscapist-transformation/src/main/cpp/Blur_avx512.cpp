@@ -0,0 +1,124 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <x86intrin.h>
+
+namespace renderscript {
+
+/* AVX-512 versions of the SSSE3 blur kernels in x86.cpp. They take the same arguments and have
+ * the same alignment and count requirements. The main loops handle eight or sixteen pixels at a
+ * time; whatever remains is left to the AVX2 kernels.
+ */
+
+extern void rsdIntrinsicBlurVFU4Avx2_K(void *dst, const void *const *rows, const void *gptr,
+                                       int rct, int x1, int x2);
+extern void rsdIntrinsicBlurHFU4Avx2_K(void *dst, const void *pin, const void *gptr, int rct,
+                                       int x1, int x2);
+extern void rsdIntrinsicBlurHFU1Avx2_K(void *dst, const void *pin, const void *gptr, int rct,
+                                       int x1, int x2);
+
+void rsdIntrinsicBlurVFU4Avx512_K(void *dst,
+                                  const void *const *rows, const void *gptr,
+                                  int rct, int x1, int x2) {
+    const float *g = (const float *)gptr;
+    const char *pi;
+    __m512 w, bp0, bp1;
+    int r;
+
+    for (; x1 + 8 <= x2; x1 += 8) {
+        bp0 = _mm512_setzero_ps();
+        bp1 = _mm512_setzero_ps();
+
+        for (r = 0; r < rct; ++r) {
+            w = _mm512_set1_ps(g[r]);
+            pi = (const char *)rows[r] + (x1 << 2);
+            bp0 = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                                          _mm_loadu_si128((const __m128i *)pi))),
+                                  w, bp0);
+            bp1 = _mm512_fmadd_ps(_mm512_cvtepi32_ps(_mm512_cvtepu8_epi32(
+                                          _mm_loadu_si128((const __m128i *)pi + 1))),
+                                  w, bp1);
+        }
+
+        _mm512_storeu_ps((float *)dst, bp0);
+        _mm512_storeu_ps((float *)dst + 16, bp1);
+        dst = (char *)dst + 128;
+    }
+
+    if (x1 < x2) {
+        rsdIntrinsicBlurVFU4Avx2_K(dst, rows, gptr, rct, x1, x2);
+    }
+}
+
+void rsdIntrinsicBlurHFU4Avx512_K(void *dst,
+                                  const void *pin, const void *gptr,
+                                  int rct, int x1, int x2) {
+    const float *g = (const float *)gptr;
+    const float *pi;
+    __m512 w, bp0, bp1;
+    int r;
+
+    for (; x1 + 8 <= x2; x1 += 8) {
+        pi = (const float *)pin + (x1 << 2);
+        bp0 = _mm512_setzero_ps();
+        bp1 = _mm512_setzero_ps();
+
+        /* Each accumulator holds four neighboring pixels. */
+        for (r = 0; r < rct; ++r) {
+            w = _mm512_set1_ps(g[r]);
+            bp0 = _mm512_fmadd_ps(w, _mm512_loadu_ps(pi + (r << 2)), bp0);
+            bp1 = _mm512_fmadd_ps(w, _mm512_loadu_ps(pi + (r << 2) + 16), bp1);
+        }
+
+        /* The blur weights add up to one so the values are never negative. */
+        _mm_storeu_si128((__m128i *)dst, _mm512_cvtusepi32_epi8(_mm512_cvtps_epi32(bp0)));
+        _mm_storeu_si128((__m128i *)dst + 1, _mm512_cvtusepi32_epi8(_mm512_cvtps_epi32(bp1)));
+        dst = (char *)dst + 32;
+    }
+
+    if (x1 < x2) {
+        rsdIntrinsicBlurHFU4Avx2_K(dst, pin, gptr, rct, x1, x2);
+    }
+}
+
+void rsdIntrinsicBlurHFU1Avx512_K(void *dst,
+                                  const void *pin, const void *gptr,
+                                  int rct, int x1, int x2) {
+    const float *g = (const float *)gptr;
+    const float *pi;
+    __m512 w, bp;
+    int r;
+
+    for (; x1 + 16 <= x2; x1 += 16) {
+        pi = (const float *)pin + x1;
+        bp = _mm512_setzero_ps();
+
+        for (r = 0; r < rct; ++r) {
+            w = _mm512_set1_ps(g[r]);
+            bp = _mm512_fmadd_ps(w, _mm512_loadu_ps(pi + r), bp);
+        }
+
+        _mm_storeu_si128((__m128i *)dst, _mm512_cvtusepi32_epi8(_mm512_cvtps_epi32(bp)));
+        dst = (char *)dst + 16;
+    }
+
+    if (x1 < x2) {
+        rsdIntrinsicBlurHFU1Avx2_K(dst, pin, gptr, rct, x1, x2);
+    }
+}
+
+}  // namespace renderscript
@@ -17,6 +17,8 @@
 #include <android/bitmap.h>
 #include <cassert>
 #include <jni.h>
+#include <memory>
+#include <vector>
 
 #include "RenderScriptToolkit.h"
 #include "Utils.h"
@@ -110,6 +112,11 @@ public:
     float *get() { return reinterpret_cast<float *>(data); }
 };
 
+/**
+ * Locks the pixels of a Bitmap. Only RGBA_8888 and A_8 Bitmaps are accepted, unless
+ * acceptsPixelFormats is set, in which case the RGBA_F16, RGB_565 and RGBA_1010102 ones are too.
+ * See pixelFormat().
+ */
 class BitmapGuard {
 private:
     JNIEnv *env;
@@ -120,24 +127,34 @@ private:
     bool valid;
 
 public:
-    BitmapGuard(JNIEnv *env, jobject jBitmap) : env{env}, bitmap{jBitmap}, bytes{nullptr} {
+    BitmapGuard(JNIEnv *env, jobject jBitmap, bool acceptsPixelFormats = false)
+        : env{env}, bitmap{jBitmap}, bytes{nullptr} {
         valid = false;
         if (AndroidBitmap_getInfo(env, bitmap, &info) != ANDROID_BITMAP_RESULT_SUCCESS) {
             ALOGE("AndroidBitmap_getInfo failed");
             return;
         }
-        if (info.format != ANDROID_BITMAP_FORMAT_RGBA_8888 &&
-            info.format != ANDROID_BITMAP_FORMAT_A_8) {
+        const bool hasBytes = info.format == ANDROID_BITMAP_FORMAT_RGBA_8888 ||
+                              info.format == ANDROID_BITMAP_FORMAT_A_8;
+        const bool hasPixelFormat = info.format == ANDROID_BITMAP_FORMAT_RGBA_F16 ||
+                                    info.format == ANDROID_BITMAP_FORMAT_RGB_565 ||
+                                    info.format == ANDROID_BITMAP_FORMAT_RGBA_1010102;
+        if (!hasBytes && !(acceptsPixelFormats && hasPixelFormat)) {
             ALOGE("AndroidBitmap in the wrong format");
             return;
         }
         bytesPerPixel = info.stride / info.width;
-        if (bytesPerPixel != 1 && bytesPerPixel != 4) {
+        if (hasBytes && bytesPerPixel != 1 && bytesPerPixel != 4) {
             ALOGE("Expected a vector size of 1 or 4. Got %d. Extra padding per line not currently "
                   "supported",
                   bytesPerPixel);
             return;
         }
+        if (hasPixelFormat && info.stride != info.width * pixelSize()) {
+            ALOGE("Expected %u bytes per pixel. Extra padding per line not currently supported",
+                  pixelSize());
+            return;
+        }
         if (AndroidBitmap_lockPixels(env, bitmap, &bytes) != ANDROID_BITMAP_RESULT_SUCCESS) {
             ALOGE("AndroidBitmap_lockPixels failed");
             return;
@@ -161,6 +178,41 @@ public:
     int height() const { return info.height; }
 
     int vectorSize() const { return bytesPerPixel; }
+
+    /**
+     * Whether the channels are bytes, i.e. an RGBA_8888 or A_8 Bitmap, which the ops take with
+     * vectorSize(). The other formats are described by pixelFormat().
+     */
+    bool hasByteChannels() const {
+        return info.format == ANDROID_BITMAP_FORMAT_RGBA_8888 ||
+               info.format == ANDROID_BITMAP_FORMAT_A_8;
+    }
+
+    PixelFormat pixelFormat() const {
+        switch (info.format) {
+            case ANDROID_BITMAP_FORMAT_RGBA_F16:
+                return PixelFormat::RgbaF16;
+            case ANDROID_BITMAP_FORMAT_RGB_565:
+                return PixelFormat::Rgb565;
+            case ANDROID_BITMAP_FORMAT_RGBA_1010102:
+                return PixelFormat::Rgba1010102;
+            default:
+                return PixelFormat::Rgba8888;
+        }
+    }
+
+private:
+    // The number of bytes of a pixel of the formats pixelFormat() describes.
+    uint32_t pixelSize() const {
+        switch (info.format) {
+            case ANDROID_BITMAP_FORMAT_RGB_565:
+                return 2;
+            case ANDROID_BITMAP_FORMAT_RGBA_F16:
+                return 8;
+            default:
+                return 4;
+        }
+    }
 };
 
 /**
@@ -198,6 +250,152 @@ public:
     Restriction *get() { return isNull ? nullptr : &restriction; }
 };
 
+/**
+ * Reads a nullable Android RectF into a RectF, which covers the whole image when it's null.
+ */
+class SourceRectParameter {
+private:
+    RectF rect;
+
+public:
+    SourceRectParameter(JNIEnv *env, jobject jRect, int sizeX, int sizeY)
+        : rect{0.0f, static_cast<float>(sizeX), 0.0f, static_cast<float>(sizeY)} {
+        if (jRect == nullptr) {
+            return;
+        }
+        jclass rectClass = env->FindClass("android/graphics/RectF");
+        if (rectClass == nullptr) {
+            ALOGE("RenderScriptToolit. Internal error. Could not find the RectF class.");
+            return;
+        }
+        jfieldID leftId = env->GetFieldID(rectClass, "left", "F");
+        jfieldID topId = env->GetFieldID(rectClass, "top", "F");
+        jfieldID rightId = env->GetFieldID(rectClass, "right", "F");
+        jfieldID bottomId = env->GetFieldID(rectClass, "bottom", "F");
+        rect.startX = env->GetFloatField(jRect, leftId);
+        rect.startY = env->GetFloatField(jRect, topId);
+        rect.endX = env->GetFloatField(jRect, rightId);
+        rect.endY = env->GetFloatField(jRect, bottomId);
+    }
+
+    const RectF &get() const { return rect; }
+};
+
+/**
+ * Copies the startX, endX, startY, endY quadruplets of a Kotlin IntArray into Restrictions.
+ */
+class RestrictionListParameter {
+private:
+    std::vector<Restriction> restrictions;
+
+public:
+    RestrictionListParameter(JNIEnv *env, jintArray jRegions) {
+        const jsize count = env->GetArrayLength(jRegions) / 4;
+        IntArrayGuard regions{env, jRegions};
+        const int *values = regions.get();
+        restrictions.resize(count);
+        for (jsize i = 0; i < count; i++) {
+            restrictions[i].startX = values[i * 4];
+            restrictions[i].endX = values[i * 4 + 1];
+            restrictions[i].startY = values[i * 4 + 2];
+            restrictions[i].endY = values[i * 4 + 3];
+        }
+    }
+
+    const Restriction *get() const { return restrictions.data(); }
+
+    size_t size() const { return restrictions.size(); }
+};
+
+/**
+ * Gives access to the data of each byte array of a Kotlin Array<ByteArray>.
+ */
+class ByteArrayListGuard {
+private:
+    std::vector<std::unique_ptr<ByteArrayGuard>> guards;
+    std::vector<uint8_t *> data;
+
+public:
+    ByteArrayListGuard(JNIEnv *env, jobjectArray jArrays) {
+        const jsize count = env->GetArrayLength(jArrays);
+        for (jsize i = 0; i < count; i++) {
+            auto array = static_cast<jbyteArray>(env->GetObjectArrayElement(jArrays, i));
+            guards.push_back(std::make_unique<ByteArrayGuard>(env, array));
+            data.push_back(guards.back()->get());
+        }
+    }
+
+    uint8_t *const *get() const { return data.data(); }
+
+    size_t size() const { return data.size(); }
+};
+
+/**
+ * Gives access to the pixels of each bitmap of a Kotlin Array<Bitmap>. The bitmaps are expected
+ * to have the same size and format.
+ */
+class BitmapListGuard {
+private:
+    std::vector<std::unique_ptr<BitmapGuard>> guards;
+    std::vector<uint8_t *> data;
+
+public:
+    BitmapListGuard(JNIEnv *env, jobjectArray jBitmaps) {
+        const jsize count = env->GetArrayLength(jBitmaps);
+        for (jsize i = 0; i < count; i++) {
+            guards.push_back(
+                    std::make_unique<BitmapGuard>(env, env->GetObjectArrayElement(jBitmaps, i)));
+            data.push_back(guards.back()->get());
+        }
+    }
+
+    uint8_t *const *get() const { return data.data(); }
+
+    size_t size() const { return data.size(); }
+};
+
+/**
+ * Splits a Kotlin IntArray of width and height pairs into the widths and the heights.
+ */
+class OutputSizesParameter {
+private:
+    std::vector<size_t> sizesX;
+    std::vector<size_t> sizesY;
+
+public:
+    OutputSizesParameter(JNIEnv *env, jintArray jSizes) {
+        const jsize count = env->GetArrayLength(jSizes) / 2;
+        IntArrayGuard values{env, jSizes};
+        for (jsize i = 0; i < count; i++) {
+            sizesX.push_back(values.get()[i * 2]);
+            sizesY.push_back(values.get()[i * 2 + 1]);
+        }
+    }
+
+    const size_t *getX() const { return sizesX.data(); }
+
+    const size_t *getY() const { return sizesY.data(); }
+};
+
+/**
+ * Gets the address of a direct ByteBuffer, e.g. the input tensor of a model, so that an op writes
+ * into it without copies. The Kotlin layer checks that the buffer is direct.
+ */
+class DirectBufferParameter {
+private:
+    void *address;
+
+public:
+    DirectBufferParameter(JNIEnv *env, jobject jBuffer)
+        : address{env->GetDirectBufferAddress(jBuffer)} {
+        if (address == nullptr) {
+            ALOGE("RenderScriptToolkit. The ByteBuffer should be direct.");
+        }
+    }
+
+    void *get() const { return address; }
+};
+
 extern "C" JNIEXPORT jlong JNICALL
 Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_createNative(JNIEnv * /*env*/,
                                                                               jobject /*thiz*/) {
@@ -211,54 +409,497 @@ Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_destroyNative(
     delete toolkit;
 }
 
+extern "C" JNIEXPORT jint JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeSetMaxSimdLevel(
+        JNIEnv * /*env*/, jobject /*thiz*/, jlong native_handle, jint level) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    return static_cast<jint>(toolkit->setMaxSimdLevel(static_cast<SimdLevel>(level)));
+}
+
 extern "C" JNIEXPORT void JNICALL
 Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeBlur(
         JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_array, jint vectorSize,
-        jint size_x, jint size_y, jint radius, jbyteArray output_array, jobject restriction) {
+        jint size_x, jint size_y, jint radius_x, jint radius_y, jint alpha_type, jint color_space,
+        jint edge_mode, jbyteArray output_array, jobject restriction) {
     RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
     RestrictionParameter restrict{env, restriction};
     ByteArrayGuard input{env, input_array};
     ByteArrayGuard output{env, output_array};
 
-    toolkit->blur(input.get(), output.get(), size_x, size_y, vectorSize, radius, restrict.get());
+    toolkit->blur(input.get(), output.get(), size_x, size_y, vectorSize, radius_x, radius_y,
+                  static_cast<AlphaType>(alpha_type), static_cast<ColorSpace>(color_space),
+                  static_cast<EdgeMode>(edge_mode), restrict.get());
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeBlurBitmap(
         JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject input_bitmap,
-        jobject output_bitmap, jint radius, jobject restriction) {
+        jobject output_bitmap, jint radius_x, jint radius_y, jint alpha_type, jint color_space,
+        jint edge_mode, jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    BitmapGuard input{env, input_bitmap, true};
+    BitmapGuard output{env, output_bitmap, true};
+
+    if (!input.hasByteChannels()) {
+        toolkit->blur(input.get(), output.get(), input.width(), input.height(),
+                      input.pixelFormat(), radius_x, radius_y, static_cast<AlphaType>(alpha_type),
+                      static_cast<ColorSpace>(color_space), static_cast<EdgeMode>(edge_mode),
+                      restrict.get());
+        return;
+    }
+    toolkit->blur(input.get(), output.get(), input.width(), input.height(), input.vectorSize(),
+                  radius_x, radius_y, static_cast<AlphaType>(alpha_type),
+                  static_cast<ColorSpace>(color_space), static_cast<EdgeMode>(edge_mode),
+                  restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeBlurFloat(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jfloatArray input_array, jint size_x,
+        jint size_y, jint radius_x, jint radius_y, jint alpha_type, jint edge_mode,
+        jfloatArray output_array, jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    FloatArrayGuard input{env, input_array};
+    FloatArrayGuard output{env, output_array};
+
+    toolkit->blur(reinterpret_cast<const uint8_t *>(input.get()),
+                  reinterpret_cast<uint8_t *>(output.get()), size_x, size_y,
+                  PixelFormat::RgbaF32, radius_x, radius_y, static_cast<AlphaType>(alpha_type),
+                  ColorSpace::Srgb, static_cast<EdgeMode>(edge_mode), restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeBlurWithQuality(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_array, jint vectorSize,
+        jint size_x, jint size_y, jint radius, jint quality, jbyteArray output_array,
+        jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    ByteArrayGuard input{env, input_array};
+    ByteArrayGuard output{env, output_array};
+
+    toolkit->blur(input.get(), output.get(), size_x, size_y, vectorSize, radius,
+                  static_cast<BlurQuality>(quality), restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeBlurWithQualityBitmap(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject input_bitmap,
+        jobject output_bitmap, jint radius, jint quality, jobject restriction) {
     RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
     RestrictionParameter restrict{env, restriction};
     BitmapGuard input{env, input_bitmap};
     BitmapGuard output{env, output_bitmap};
 
     toolkit->blur(input.get(), output.get(), input.width(), input.height(), input.vectorSize(),
-                  radius, restrict.get());
+                  radius, static_cast<BlurQuality>(quality), restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeBlurLadder(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_array, jint vectorSize,
+        jint size_x, jint size_y, jintArray radii_array, jint quality,
+        jobjectArray output_arrays) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    ByteArrayGuard input{env, input_array};
+    IntArrayGuard radii{env, radii_array};
+    ByteArrayListGuard outputs{env, output_arrays};
+
+    toolkit->blurLadder(input.get(), outputs.get(), size_x, size_y, vectorSize, radii.get(),
+                        outputs.size(), static_cast<BlurQuality>(quality));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeBlurLadderBitmap(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject input_bitmap,
+        jintArray radii_array, jint quality, jobjectArray output_bitmaps) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    BitmapGuard input{env, input_bitmap};
+    IntArrayGuard radii{env, radii_array};
+    BitmapListGuard outputs{env, output_bitmaps};
+
+    toolkit->blurLadder(input.get(), outputs.get(), input.width(), input.height(),
+                        input.vectorSize(), radii.get(), outputs.size(),
+                        static_cast<BlurQuality>(quality));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeInterpolateBlurLadder(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobjectArray ladder_arrays,
+        jintArray radii_array, jint vectorSize, jint size_x, jint size_y, jfloat radius,
+        jbyteArray output_array, jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    ByteArrayListGuard ladder{env, ladder_arrays};
+    IntArrayGuard radii{env, radii_array};
+    ByteArrayGuard output{env, output_array};
+
+    toolkit->interpolateBlurLadder(ladder.get(), radii.get(), ladder.size(), output.get(), size_x,
+                                   size_y, vectorSize, radius, restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeInterpolateBlurLadderBitmap(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobjectArray ladder_bitmaps,
+        jintArray radii_array, jfloat radius, jobject output_bitmap, jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    BitmapListGuard ladder{env, ladder_bitmaps};
+    IntArrayGuard radii{env, radii_array};
+    BitmapGuard output{env, output_bitmap};
+
+    toolkit->interpolateBlurLadder(ladder.get(), radii.get(), ladder.size(), output.get(),
+                                   output.width(), output.height(), output.vectorSize(), radius,
+                                   restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeBlurInPlace(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray in_out_array,
+        jint vectorSize, jint size_x, jint size_y, jint radius_x, jint radius_y, jint alpha_type,
+        jint color_space, jint edge_mode) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    ByteArrayGuard inOut{env, in_out_array};
+
+    toolkit->blurInPlace(inOut.get(), size_x, size_y, vectorSize, radius_x, radius_y,
+                         static_cast<AlphaType>(alpha_type), static_cast<ColorSpace>(color_space),
+                         static_cast<EdgeMode>(edge_mode));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeBlurInPlaceBitmap(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject in_out_bitmap, jint radius_x,
+        jint radius_y, jint alpha_type, jint color_space, jint edge_mode) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    BitmapGuard inOut{env, in_out_bitmap, true};
+
+    if (!inOut.hasByteChannels()) {
+        toolkit->blurInPlace(inOut.get(), inOut.width(), inOut.height(), inOut.pixelFormat(),
+                             radius_x, radius_y, static_cast<AlphaType>(alpha_type),
+                             static_cast<ColorSpace>(color_space),
+                             static_cast<EdgeMode>(edge_mode));
+        return;
+    }
+    toolkit->blurInPlace(inOut.get(), inOut.width(), inOut.height(), inOut.vectorSize(),
+                         radius_x, radius_y, static_cast<AlphaType>(alpha_type),
+                         static_cast<ColorSpace>(color_space), static_cast<EdgeMode>(edge_mode));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeBlurDirtyRegions(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_array, jint vectorSize,
+        jint size_x, jint size_y, jint radius_x, jint radius_y, jint alpha_type, jint color_space,
+        jint edge_mode, jbyteArray output_array, jintArray dirty_regions) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionListParameter regions{env, dirty_regions};
+    ByteArrayGuard input{env, input_array};
+    ByteArrayGuard output{env, output_array};
+
+    toolkit->blurDirtyRegions(input.get(), output.get(), size_x, size_y, vectorSize, radius_x,
+                              radius_y, static_cast<AlphaType>(alpha_type),
+                              static_cast<ColorSpace>(color_space),
+                              static_cast<EdgeMode>(edge_mode), regions.get(), regions.size());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeBlurDirtyRegionsBitmap(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject input_bitmap,
+        jobject output_bitmap, jint radius_x, jint radius_y, jint alpha_type, jint color_space,
+        jint edge_mode, jintArray dirty_regions) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionListParameter regions{env, dirty_regions};
+    BitmapGuard input{env, input_bitmap};
+    BitmapGuard output{env, output_bitmap};
+
+    toolkit->blurDirtyRegions(input.get(), output.get(), input.width(), input.height(),
+                              input.vectorSize(), radius_x, radius_y,
+                              static_cast<AlphaType>(alpha_type),
+                              static_cast<ColorSpace>(color_space),
+                              static_cast<EdgeMode>(edge_mode), regions.get(), regions.size());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeShadow(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_array, jint size_x,
+        jint size_y, jbyteArray output_array, jint output_size_x, jint output_size_y, jint radius,
+        jint color, jint offset_x, jint offset_y, jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    ByteArrayGuard input{env, input_array};
+    ByteArrayGuard output{env, output_array};
+
+    toolkit->shadow(input.get(), size_x, size_y, output.get(), output_size_x, output_size_y,
+                    radius, static_cast<uint32_t>(color), offset_x, offset_y, restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeShadowBitmap(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject input_bitmap,
+        jobject output_bitmap, jint radius, jint color, jint offset_x, jint offset_y,
+        jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    BitmapGuard input{env, input_bitmap};
+    BitmapGuard output{env, output_bitmap};
+
+    toolkit->shadow(input.get(), input.width(), input.height(), output.get(), output.width(),
+                    output.height(), radius, static_cast<uint32_t>(color), offset_x, offset_y,
+                    restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeMotionBlur(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_array, jint vectorSize,
+        jint size_x, jint size_y, jint radius, jfloat angle, jbyteArray output_array,
+        jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    ByteArrayGuard input{env, input_array};
+    ByteArrayGuard output{env, output_array};
+
+    toolkit->motionBlur(input.get(), output.get(), size_x, size_y, vectorSize, radius, angle,
+                        restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeMotionBlurBitmap(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject input_bitmap,
+        jobject output_bitmap, jint radius, jfloat angle, jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    BitmapGuard input{env, input_bitmap};
+    BitmapGuard output{env, output_bitmap};
+
+    toolkit->motionBlur(input.get(), output.get(), input.width(), input.height(),
+                        input.vectorSize(), radius, angle, restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeLensBlur(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_array, jint vectorSize,
+        jint size_x, jint size_y, jint radius, jint shape, jbyteArray output_array,
+        jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    ByteArrayGuard input{env, input_array};
+    ByteArrayGuard output{env, output_array};
+
+    toolkit->lensBlur(input.get(), output.get(), size_x, size_y, vectorSize, radius,
+                      static_cast<LensShape>(shape), restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeLensBlurBitmap(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject input_bitmap,
+        jobject output_bitmap, jint radius, jint shape, jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    BitmapGuard input{env, input_bitmap};
+    BitmapGuard output{env, output_bitmap};
+
+    toolkit->lensBlur(input.get(), output.get(), input.width(), input.height(),
+                      input.vectorSize(), radius, static_cast<LensShape>(shape), restrict.get());
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeResize(
         JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_array,
-        jint vector_size, jint input_size_x, jint input_size_y, jbyteArray output_array,
-        jint output_size_x, jint output_size_y, jobject restriction) {
+        jint vector_size, jboolean packed_rgb, jint input_size_x, jint input_size_y,
+        jbyteArray output_array, jint output_size_x, jint output_size_y, jint filter,
+        jint alpha_type, jint color_space, jobject source_rect, jobject restriction) {
     RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
     RestrictionParameter restrict{env, restriction};
+    SourceRectParameter source{env, source_rect, input_size_x, input_size_y};
     ByteArrayGuard input{env, input_array};
     ByteArrayGuard output{env, output_array};
 
+    if (packed_rgb) {
+        toolkit->resize(input.get(), output.get(), input_size_x, input_size_y,
+                        PixelFormat::Rgb888, source.get(), output_size_x, output_size_y,
+                        static_cast<ResizeFilter>(filter), static_cast<AlphaType>(alpha_type),
+                        static_cast<ColorSpace>(color_space), restrict.get());
+        return;
+    }
     toolkit->resize(input.get(), output.get(), input_size_x, input_size_y, vector_size,
-                    output_size_x, output_size_y, restrict.get());
+                    source.get(), output_size_x, output_size_y, static_cast<ResizeFilter>(filter),
+                    static_cast<AlphaType>(alpha_type), static_cast<ColorSpace>(color_space),
+                    restrict.get());
 }
 
 extern "C" JNIEXPORT void JNICALL
 Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeResizeBitmap(
         JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject input_bitmap,
-        jobject output_bitmap, jobject restriction) {
+        jobject output_bitmap, jint filter, jint alpha_type, jint color_space,
+        jobject source_rect, jobject restriction) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    RestrictionParameter restrict{env, restriction};
+    BitmapGuard input{env, input_bitmap, true};
+    BitmapGuard output{env, output_bitmap, true};
+    SourceRectParameter source{env, source_rect, input.width(), input.height()};
+
+    if (!input.hasByteChannels()) {
+        toolkit->resize(input.get(), output.get(), input.width(), input.height(),
+                        input.pixelFormat(), source.get(), output.width(), output.height(),
+                        static_cast<ResizeFilter>(filter), static_cast<AlphaType>(alpha_type),
+                        static_cast<ColorSpace>(color_space), restrict.get());
+        return;
+    }
+    toolkit->resize(input.get(), output.get(), input.width(), input.height(), input.vectorSize(),
+                    source.get(), output.width(), output.height(), static_cast<ResizeFilter>(filter),
+                    static_cast<AlphaType>(alpha_type), static_cast<ColorSpace>(color_space),
+                    restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeResizeFloat(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jfloatArray input_array,
+        jint input_size_x, jint input_size_y, jfloatArray output_array, jint output_size_x,
+        jint output_size_y, jint filter, jint alpha_type, jobject source_rect,
+        jobject restriction) {
     RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
     RestrictionParameter restrict{env, restriction};
+    SourceRectParameter source{env, source_rect, input_size_x, input_size_y};
+    FloatArrayGuard input{env, input_array};
+    FloatArrayGuard output{env, output_array};
+
+    toolkit->resize(reinterpret_cast<const uint8_t *>(input.get()),
+                    reinterpret_cast<uint8_t *>(output.get()), input_size_x, input_size_y,
+                    PixelFormat::RgbaF32, source.get(), output_size_x, output_size_y,
+                    static_cast<ResizeFilter>(filter), static_cast<AlphaType>(alpha_type),
+                    ColorSpace::Srgb, restrict.get());
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeResizeToTensor(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_array,
+        jint input_size_x, jint input_size_y, jobject output_buffer, jint output_size_x,
+        jint output_size_y, jint type, jfloatArray scale_array, jfloatArray bias_array,
+        jint filter, jint alpha_type, jobject source_rect) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    SourceRectParameter source{env, source_rect, input_size_x, input_size_y};
+    DirectBufferParameter output{env, output_buffer};
+    if (output.get() == nullptr) {
+        return;
+    }
+    ByteArrayGuard input{env, input_array};
+    FloatArrayGuard scale{env, scale_array};
+    FloatArrayGuard bias{env, bias_array};
+
+    toolkit->resizeToTensor(input.get(), output.get(), input_size_x, input_size_y, source.get(),
+                            output_size_x, output_size_y, static_cast<TensorType>(type),
+                            scale.get(), bias.get(), static_cast<ResizeFilter>(filter),
+                            static_cast<AlphaType>(alpha_type));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeResizeToTensorBitmap(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject input_bitmap,
+        jobject output_buffer, jint output_size_x, jint output_size_y, jint type,
+        jfloatArray scale_array, jfloatArray bias_array, jint filter, jint alpha_type,
+        jobject source_rect) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    DirectBufferParameter output{env, output_buffer};
+    if (output.get() == nullptr) {
+        return;
+    }
     BitmapGuard input{env, input_bitmap};
-    BitmapGuard output{env, output_bitmap};
+    SourceRectParameter source{env, source_rect, input.width(), input.height()};
+    FloatArrayGuard scale{env, scale_array};
+    FloatArrayGuard bias{env, bias_array};
+
+    toolkit->resizeToTensor(input.get(), output.get(), input.width(), input.height(),
+                            source.get(), output_size_x, output_size_y,
+                            static_cast<TensorType>(type), scale.get(), bias.get(),
+                            static_cast<ResizeFilter>(filter), static_cast<AlphaType>(alpha_type));
+}
 
-    toolkit->resize(input.get(), output.get(), input.width(), input.height(), input.vectorSize(),
-                    output.width(), output.height(), restrict.get());
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeResizeMultiple(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_array,
+        jint vector_size, jint input_size_x, jint input_size_y, jintArray output_sizes,
+        jint filter, jboolean cascade, jobjectArray output_arrays) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    OutputSizesParameter sizes{env, output_sizes};
+    ByteArrayGuard input{env, input_array};
+    ByteArrayListGuard outputs{env, output_arrays};
+
+    toolkit->resizeMultiple(input.get(), outputs.get(), input_size_x, input_size_y, vector_size,
+                            sizes.getX(), sizes.getY(), outputs.size(),
+                            static_cast<ResizeFilter>(filter), cascade);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeResizeMultipleBitmap(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject input_bitmap,
+        jintArray output_sizes, jint filter, jboolean cascade, jobjectArray output_bitmaps) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    OutputSizesParameter sizes{env, output_sizes};
+    BitmapGuard input{env, input_bitmap};
+    BitmapListGuard outputs{env, output_bitmaps};
+
+    toolkit->resizeMultiple(input.get(), outputs.get(), input.width(), input.height(),
+                            input.vectorSize(), sizes.getX(), sizes.getY(), outputs.size(),
+                            static_cast<ResizeFilter>(filter), cascade);
+}
+
+extern "C" JNIEXPORT jlong JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeCreateResizeStream(
+        JNIEnv * /*env*/, jobject /*thiz*/, jlong native_handle, jint vector_size,
+        jint input_size_x, jint input_size_y, jint output_size_x, jint output_size_y,
+        jint filter) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    std::unique_ptr<ResizeStream> stream =
+            toolkit->createResizeStream(input_size_x, input_size_y, vector_size, output_size_x,
+                                        output_size_y, static_cast<ResizeFilter>(filter));
+    return reinterpret_cast<jlong>(stream.release());
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_skydoves_landscapist_transformation_ResizeStream_nativeMaxRowsPerPush(
+        JNIEnv * /*env*/, jobject /*thiz*/, jlong native_handle) {
+    ResizeStream *stream = reinterpret_cast<ResizeStream *>(native_handle);
+    return static_cast<jint>(stream->maxRowsPerPush());
+}
+
+extern "C" JNIEXPORT jint JNICALL
+Java_com_skydoves_landscapist_transformation_ResizeStream_nativePushRow(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_row,
+        jbyteArray output_rows) {
+    ResizeStream *stream = reinterpret_cast<ResizeStream *>(native_handle);
+    ByteArrayGuard input{env, input_row};
+    ByteArrayGuard output{env, output_rows};
+
+    return static_cast<jint>(stream->pushRow(input.get(), output.get()));
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_ResizeStream_nativeDestroy(
+        JNIEnv * /*env*/, jobject /*thiz*/, jlong native_handle) {
+    ResizeStream *stream = reinterpret_cast<ResizeStream *>(native_handle);
+    delete stream;
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeGenerateMipmaps(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jbyteArray input_array,
+        jint vector_size, jint size_x, jint size_y, jint level_count, jbyteArray output_array) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    ByteArrayGuard input{env, input_array};
+    ByteArrayGuard output{env, output_array};
+
+    toolkit->generateMipmaps(input.get(), output.get(), size_x, size_y, vector_size, level_count);
+}
+
+extern "C" JNIEXPORT void JNICALL
+Java_com_skydoves_landscapist_transformation_RenderScriptToolkit_nativeGenerateMipmapsBitmap(
+        JNIEnv *env, jobject /*thiz*/, jlong native_handle, jobject input_bitmap,
+        jint level_count, jbyteArray output_array) {
+    RenderScriptToolkit *toolkit = reinterpret_cast<RenderScriptToolkit *>(native_handle);
+    BitmapGuard input{env, input_bitmap};
+    ByteArrayGuard output{env, output_array};
+
+    toolkit->generateMipmaps(input.get(), output.get(), input.width(), input.height(),
+                             input.vectorSize(), level_count);
 }
@@ -0,0 +1,215 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include "RenderScriptToolkit.h"
+#include "TaskProcessor.h"
+#include "Utils.h"
+
+namespace renderscript {
+
+#define LOG_TAG "renderscript.toolkit.LensBlur"
+
+/**
+ * Blurs an image with a flat kernel shaped like the aperture of a lens, i.e. a disc or a hexagon.
+ * A bright pixel spreads into a uniform copy of the shape, the bokeh of out of focus highlights.
+ *
+ * The shape is described as one horizontal span per kernel row. The sum of a span is the
+ * difference of two entries of the prefix sums of the source row, so a pixel costs one
+ * subtraction per kernel row, about what the vertical pass of the Gaussian costs. The work is
+ * divided in bands of whole rows and each thread keeps a ring of the prefix sums of the rows its
+ * band needs, so each one is computed once per band.
+ *
+ * The prefix sums are kept in 16 bits and wrap around. The sum of a span is at most
+ * 255 * (2 * 100 + 1), which fits, so the difference of two wrapped prefix sums is still exact.
+ */
+class LensBlurTask : public Task {
+    // The image we're blurring.
+    const uchar* mIn;
+    // Where we store the blurred image.
+    uchar* mOut;
+    // The largest half width of the spans, i.e. how far the prefix sums extend past the tile.
+    int mRadius;
+    // How many kernel rows are above, and below, the center row.
+    int mHalfHeight;
+    // The half width of the span of each kernel row, from the top one.
+    std::vector<int> mHalfWidths;
+    // The inverse of the number of pixels in the kernel.
+    float mScale;
+
+    // The ring of prefix sums of each thread, 2 * mHalfHeight + 1 rows indexed by the virtual
+    // row. mRingTags holds the virtual row in each slot. All the bands cover the same columns, so
+    // a thread that does several bands can reuse the rows they share.
+    ScratchBuffers mRings;
+    std::vector<int> mRingTags;
+    // Working area to accumulate the spans of a row. There's one area per thread.
+    ScratchBuffers mScratch;
+
+    template <typename InVector, typename PrefixVector>
+    void kernel(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
+                int threadIndex, PrefixVector* ring, uint* acc);
+
+    // Process a 2D tile of the overall work. threadIndex identifies which thread does the work.
+    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                     size_t endY) override;
+
+   public:
+    LensBlurTask(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY, size_t vectorSize,
+                 uint32_t threadCount, int radius, LensShape shape,
+                 const Restriction* restriction)
+        : Task{sizeX, sizeY, vectorSize, false, restriction},
+          mIn{in},
+          mOut{out},
+          mRadius{radius},
+          mRings{threadCount},
+          mScratch{threadCount} {
+        // The hexagon has its flat sides at the top and bottom, at sqrt(3) / 2 of its radius.
+        if (shape == LensShape::Hexagon) {
+            mHalfHeight = (int)(radius * 0.8660254f + 0.5f);
+        } else {
+            mHalfHeight = radius;
+        }
+        int pixels = 0;
+        for (int dy = -mHalfHeight; dy <= mHalfHeight; dy++) {
+            int halfWidth;
+            if (shape == LensShape::Hexagon) {
+                halfWidth = (int)(radius - std::abs(dy) * 0.57735027f + 0.5f);
+            } else {
+                // The extra half pixel rounds off the top and bottom of the disc.
+                const float r = radius + 0.5f;
+                halfWidth = (int)sqrtf(r * r - (float)(dy * dy));
+            }
+            halfWidth = std::min(halfWidth, radius);
+            mHalfWidths.push_back(halfWidth);
+            pixels += 2 * halfWidth + 1;
+        }
+        mScale = 1.0f / pixels;
+        mBandCount = threadCount;
+        mRingTags.resize(threadCount * (2 * mHalfHeight + 1), INT_MIN);
+    }
+};
+
+static inline ushort widen(uchar v) { return v; }
+static inline ushort4 widen(uchar4 v) { return convert<ushort4>(v); }
+
+/**
+ * Blur one row of the tile.
+ *
+ * @param outPtr Where to store the results.
+ * @param xstart The index of the section we're starting to blur.
+ * @param xend The end index of the section.
+ * @param currentY The index of the line we're blurring.
+ * @param threadIndex The index of the thread doing the work.
+ * @param ring The ring of prefix sums of the thread.
+ * @param acc A working area large enough for xend - xstart cells.
+ */
+template <typename InVector, typename PrefixVector>
+void LensBlurTask::kernel(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
+                          int threadIndex, PrefixVector* ring, uint* acc) {
+    const InVector* in = (const InVector*)mIn;
+    const int maxX = mSizeX - 1;
+    const int maxY = mSizeY - 1;
+    const int count = xend - xstart;
+    // The prefix sums cover the columns from xstart - mRadius to xend + mRadius, clamped to the
+    // image. Entry i is the sum of the first i of these pixels.
+    const int prefixCount = count + 2 * mRadius + 1;
+    const int slots = 2 * mHalfHeight + 1;
+    int* tags = mRingTags.data() + threadIndex * slots;
+
+    // Past the prefix sums, the channels are independent, so we go through them as flat arrays
+    // of count * mVectorSize values. It makes for loops the compiler can vectorize.
+    const int values = count * mVectorSize;
+    for (int i = 0; i < values; i++) {
+        acc[i] = 0;
+    }
+    for (int dy = -mHalfHeight; dy <= mHalfHeight; dy++) {
+        const int virtualY = (int)currentY + dy;
+        const int slot = (virtualY % slots + slots) % slots;
+        PrefixVector* prefix = ring + slot * prefixCount;
+        if (tags[slot] != virtualY) {
+            const InVector* row = in + mSizeX * clamp(virtualY, 0, maxY);
+            const int first = (int)xstart - mRadius;
+            PrefixVector sum = 0;
+            prefix[0] = sum;
+            for (int i = 1; i < prefixCount; i++) {
+                sum += widen(row[clamp(first + i - 1, 0, maxX)]);
+                prefix[i] = sum;
+            }
+            tags[slot] = virtualY;
+        }
+        const int halfWidth = mHalfWidths[dy + mHalfHeight];
+        const ushort* high = (const ushort*)(prefix + mRadius + halfWidth + 1);
+        const ushort* low = (const ushort*)(prefix + mRadius - halfWidth);
+        for (int i = 0; i < values; i++) {
+            acc[i] += (ushort)(high[i] - low[i]);
+        }
+    }
+
+    for (int i = 0; i < values; i++) {
+        outPtr[i] = (uchar)(acc[i] * mScale + 0.5f);
+    }
+}
+
+void LensBlurTask::processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                               size_t endY) {
+    const size_t slots = 2 * mHalfHeight + 1;
+    const size_t prefixCount = endX - startX + 2 * mRadius + 1;
+    // We size for 4 channels even for one byte cells. It keeps the scratch logic simple.
+    void* ring = mRings.get(threadIndex, slots * prefixCount * sizeof(ushort4));
+    void* acc = mScratch.get(threadIndex, (endX - startX) * sizeof(uint4));
+    if (ring == nullptr || acc == nullptr) {
+        return;
+    }
+
+    for (size_t y = startY; y < endY; y++) {
+        uchar* outPtr = mOut + (mSizeX * y + startX) * mVectorSize;
+        if (mVectorSize == 4) {
+            kernel<uchar4, ushort4>(outPtr, startX, endX, y, threadIndex, (ushort4*)ring,
+                                    (uint*)acc);
+        } else {
+            kernel<uchar, ushort>(outPtr, startX, endX, y, threadIndex, (ushort*)ring, (uint*)acc);
+        }
+    }
+}
+
+void RenderScriptToolkit::lensBlur(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY,
+                                   size_t vectorSize, int radius, LensShape shape,
+                                   const Restriction* restriction) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (!validRestriction(LOG_TAG, sizeX, sizeY, restriction)) {
+        return;
+    }
+    if (radius <= 0 || radius > 100) {
+        ALOGE("The radius should be between 1 and 100. %d provided.", radius);
+        return;
+    }
+    if (vectorSize != 1 && vectorSize != 4) {
+        ALOGE("The vectorSize should be 1 or 4. %zu provided.", vectorSize);
+        return;
+    }
+#endif
+
+    LensBlurTask task(in, out, sizeX, sizeY, vectorSize, processor->getNumberOfThreads(), radius,
+                      shape, restriction);
+    processor->doTask(&task);
+}
+
+}  // namespace renderscript
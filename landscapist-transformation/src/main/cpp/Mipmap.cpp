@@ -0,0 +1,247 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <cstdint>
+
+#include "RenderScriptToolkit.h"
+#include "TaskProcessor.h"
+#include "Utils.h"
+
+namespace renderscript {
+
+#define LOG_TAG "renderscript.toolkit.Mipmap"
+
+#if defined(ARCH_X86_HAVE_SSSE3)
+extern void rsdIntrinsicHalveU_K(void* dst, const void* row0, const void* row1, int cellSize,
+                                 int count);
+extern void rsdIntrinsicHalveUAvx2_K(void* dst, const void* row0, const void* row1,
+                                     int cellSize, int count);
+#endif
+
+// The most levels a mipmap chain can have below the full size image, for images of up to 2^31
+// pixels on a side.
+static constexpr int kMaxMipmapLevels = 31;
+
+// How many levels MipmapTask computes from each strip of the level it reads. The strip is
+// 2^kMipmapStripLevels rows high, and what the first level writes is still in cache when the
+// next one reads it.
+static constexpr int kMipmapStripLevels = 4;
+
+/**
+ * The levels of a mipmap chain: their sizes, and where each one starts in the buffer that holds
+ * all of them but the full size one, back to back. Level 0 is the full size image. As OpenGL
+ * expects, each level is half the size of the one above it, rounded down, and at least 1.
+ */
+struct MipmapLevels {
+    int count = 0;
+    size_t sizesX[kMaxMipmapLevels + 1];
+    size_t sizesY[kMaxMipmapLevels + 1];
+    size_t offsets[kMaxMipmapLevels + 1];
+
+    MipmapLevels(size_t sizeX, size_t sizeY, size_t cellSize, int levelCount)
+        : count{levelCount} {
+        sizesX[0] = sizeX;
+        sizesY[0] = sizeY;
+        offsets[0] = 0;
+        size_t offset = 0;
+        for (int level = 1; level <= count; level++) {
+            sizesX[level] = std::max(sizeX >> level, (size_t)1);
+            sizesY[level] = std::max(sizeY >> level, (size_t)1);
+            offsets[level] = offset;
+            offset += sizesX[level] * sizesY[level] * cellSize;
+        }
+    }
+};
+
+/**
+ * Halves two rows into one: each output cell is the rounded average of the 2x2 cells it covers.
+ * The loop goes through the bytes of the rows in order, which lets the compiler vectorize it.
+ */
+template <int kCellSize>
+static void HalveRow(uchar* out, const uchar* row0, const uchar* row1, size_t count) {
+    for (size_t i = 0; i < count * kCellSize; i++) {
+        const size_t x = i / kCellSize * 2 * kCellSize + i % kCellSize;
+        out[i] = (row0[x] + row0[x + kCellSize] + row1[x] + row1[x + kCellSize] + 2) >> 2;
+    }
+}
+
+/**
+ * Halves two rows of count cells of cellSize bytes into one without SIMD, see HalveRow. Also
+ * used by resizeMultiple.
+ */
+void HalveRowScalar(uchar* out, const uchar* row0, const uchar* row1, size_t cellSize,
+                    size_t count) {
+    switch (cellSize) {
+        case 4:
+            HalveRow<4>(out, row0, row1, count);
+            break;
+        case 2:
+            HalveRow<2>(out, row0, row1, count);
+            break;
+        default:
+            HalveRow<1>(out, row0, row1, count);
+            break;
+    }
+}
+
+/**
+ * Computes the levels first + 1 to first + levelCount of a mipmap chain from level first, in a
+ * single pass over the latter.
+ *
+ * The work is divided along the cells of the last level, each of which covers a square of
+ * 2^levelCount cells of the first one. A tile goes through its rows of the last level one by
+ * one, and computes all the levels of the strip of rows above each. The strip of a level is
+ * read by the next one while it's still in cache. The strips are independent as each level is
+ * exactly half of the one above it, rounded down. The rows and columns that rounding leaves
+ * over below or right of the last level's are done with the last strip or tile.
+ *
+ * This holds as long as the levels above the last one are at least 2 cells wide and high. See
+ * HalveClamped for the others.
+ */
+class MipmapTask : public Task {
+    const uchar* mIn;
+    uchar* mOut;
+    const MipmapLevels& mLevels;
+    const int mFirst;
+    const int mLevelCount;
+    const size_t mCellSize;
+
+    void halveRows(int level, size_t startX, size_t endX, size_t startY, size_t endY);
+
+    // Process a 2D tile of the last level. threadIndex identifies which thread does the work.
+    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                     size_t endY) override;
+
+   public:
+    MipmapTask(const uchar* in, uchar* out, size_t vectorSize, const MipmapLevels& levels,
+               int first, int levelCount)
+        : Task{levels.sizesX[first + levelCount], levels.sizesY[first + levelCount], vectorSize,
+               false, nullptr},
+          mIn{in},
+          mOut{out},
+          mLevels{levels},
+          mFirst{first},
+          mLevelCount{levelCount},
+          mCellSize{paddedSize(vectorSize)} {}
+};
+
+/**
+ * Computes the rows [startY, endY) of a level, over the columns [startX, endX), from the level
+ * above it.
+ */
+void MipmapTask::halveRows(int level, size_t startX, size_t endX, size_t startY, size_t endY) {
+    const uchar* above = level == 1 ? mIn : mOut + mLevels.offsets[level - 1];
+    const size_t strideAbove = mLevels.sizesX[level - 1] * mCellSize;
+    const size_t stride = mLevels.sizesX[level] * mCellSize;
+    const size_t count = endX - startX;
+#if defined(ARCH_X86_HAVE_SSSE3)
+    const auto halve = mX86Extension == X86Extension::None ? rsdIntrinsicHalveU_K
+                                                           : rsdIntrinsicHalveUAvx2_K;
+#endif
+    for (size_t y = startY; y < endY; y++) {
+        uchar* out = mOut + mLevels.offsets[level] + y * stride + startX * mCellSize;
+        const uchar* row0 = above + 2 * y * strideAbove + 2 * startX * mCellSize;
+        const uchar* row1 = row0 + strideAbove;
+#if defined(ARCH_X86_HAVE_SSSE3)
+        if (mUsesSimd) {
+            halve(out, row0, row1, mCellSize, count);
+            continue;
+        }
+#endif
+        HalveRowScalar(out, row0, row1, mCellSize, count);
+    }
+}
+
+void MipmapTask::processData(int /* threadIndex */, size_t startX, size_t startY, size_t endX,
+                             size_t endY) {
+    for (size_t y = startY; y < endY; y++) {
+        for (int i = 1; i <= mLevelCount; i++) {
+            const int level = mFirst + i;
+            const int shift = mLevelCount - i;
+            const size_t levelStartX = startX << shift;
+            const size_t levelEndX = endX == mSizeX ? mLevels.sizesX[level] : endX << shift;
+            const size_t levelStartY = y << shift;
+            const size_t levelEndY = y + 1 == mSizeY ? mLevels.sizesY[level] : (y + 1) << shift;
+            halveRows(level, levelStartX, levelEndX, levelStartY, levelEndY);
+        }
+    }
+}
+
+/**
+ * Computes a level of a mipmap chain from the one above it, which is 1 cell wide or high. Along
+ * that axis, the level is 1 cell too and each cell averages the same cell twice.
+ */
+static void HalveClamped(uchar* out, const uchar* in, size_t sizeX, size_t sizeY,
+                         size_t cellSize) {
+    const size_t outSizeX = std::max(sizeX / 2, (size_t)1);
+    const size_t outSizeY = std::max(sizeY / 2, (size_t)1);
+    const size_t stride = sizeX * cellSize;
+    const size_t stepX = sizeX > 1 ? cellSize : 0;
+    const size_t stepY = sizeY > 1 ? stride : 0;
+    for (size_t y = 0; y < outSizeY; y++) {
+        const uchar* row = in + (sizeY > 1 ? 2 * y : 0) * stride;
+        for (size_t x = 0; x < outSizeX; x++) {
+            const uchar* p = row + (sizeX > 1 ? 2 * x : 0) * cellSize;
+            for (size_t c = 0; c < cellSize; c++) {
+                *out++ = (p[c] + p[c + stepX] + p[c + stepY] + p[c + stepX + stepY] + 2) >> 2;
+            }
+        }
+    }
+}
+
+void RenderScriptToolkit::generateMipmaps(const uint8_t* in, uint8_t* out, size_t sizeX,
+                                          size_t sizeY, size_t vectorSize, int levelCount) {
+    // The number of levels below the full size image, until both sides are 1.
+    int maxLevels = 0;
+    while ((std::max(sizeX, sizeY) >> (maxLevels + 1)) > 0) {
+        maxLevels++;
+    }
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (vectorSize < 1 || vectorSize > 4) {
+        ALOGE("The vectorSize should be between 1 and 4. %zu provided.", vectorSize);
+        return;
+    }
+    if (levelCount < 1 || levelCount > maxLevels) {
+        ALOGE("The levelCount should be between 1 and %d for a %zux%zu image. %d provided.",
+              maxLevels, sizeX, sizeY, levelCount);
+        return;
+    }
+#endif
+
+    const size_t cellSize = paddedSize(vectorSize);
+    const MipmapLevels levels(sizeX, sizeY, cellSize, levelCount);
+    // The levels that are halves of a level at least 2 cells wide and high go through
+    // MipmapTask, a few at a time.
+    int level = 0;
+    while (level < levelCount && levels.sizesX[level] >= 2 && levels.sizesY[level] >= 2) {
+        int count = 1;
+        while (count < kMipmapStripLevels && level + count < levelCount &&
+               levels.sizesX[level + count] >= 2 && levels.sizesY[level + count] >= 2) {
+            count++;
+        }
+        MipmapTask task(in, out, vectorSize, levels, level, count);
+        processor->doTask(&task);
+        level += count;
+    }
+    for (; level < levelCount; level++) {
+        const uchar* above = level == 0 ? in : out + levels.offsets[level];
+        HalveClamped(out + levels.offsets[level + 1], above, levels.sizesX[level],
+                     levels.sizesY[level], cellSize);
+    }
+}
+
+}  // namespace renderscript
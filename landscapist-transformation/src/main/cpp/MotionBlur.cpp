@@ -0,0 +1,195 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cmath>
+#include <cstdint>
+
+#include "RenderScriptToolkit.h"
+#include "TaskProcessor.h"
+#include "Utils.h"
+
+namespace renderscript {
+
+#define LOG_TAG "renderscript.toolkit.MotionBlur"
+
+/**
+ * Blurs an image along a straight line, as if the camera moved while the shutter was open.
+ *
+ * Each output pixel is the average of 2 * radius + 1 samples taken one pixel apart on a line
+ * going through it. For a given sample, every pixel of an output row is offset by the same
+ * amount, so the sample is a bilinear blend of two source rows shifted horizontally. We
+ * accumulate these shifted rows in a floating point row buffer, one output row at a time.
+ */
+class MotionBlurTask : public Task {
+    // The image we're blurring.
+    const uchar* mIn;
+    // Where we store the blurred image.
+    uchar* mOut;
+
+    /**
+     * One sample along the line. (dx, dy) is the integer part of the offset of the sample from
+     * the pixel being blurred. The four weights are those of the pixels at (dx, dy),
+     * (dx + 1, dy), (dx, dy + 1), and (dx + 1, dy + 1). They include the averaging.
+     */
+    struct Tap {
+        int dx;
+        int dy;
+        float w00;
+        float w10;
+        float w01;
+        float w11;
+    };
+    std::vector<Tap> mTaps;
+
+    // Working area to accumulate the samples of a row. There's one area per thread.
+    ScratchBuffers mScratch;
+
+    template <typename InVector, typename FloatVector>
+    void kernel(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
+                FloatVector* acc);
+
+    // Process a 2D tile of the overall work. threadIndex identifies which thread does the work.
+    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                     size_t endY) override;
+
+   public:
+    MotionBlurTask(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY,
+                   size_t vectorSize, uint32_t threadCount, int radius, float angle,
+                   const Restriction* restriction)
+        : Task{sizeX, sizeY, vectorSize, false, restriction},
+          mIn{in},
+          mOut{out},
+          mScratch{threadCount} {
+        // The angle is counterclockwise while our Y axis points down.
+        const float radians = angle * 3.1415926535897932f / 180.0f;
+        const float stepX = cosf(radians);
+        const float stepY = -sinf(radians);
+        const float weight = 1.0f / (2 * radius + 1);
+        for (int t = -radius; t <= radius; t++) {
+            float offsetX = t * stepX;
+            float offsetY = t * stepY;
+            float floorX = floorf(offsetX);
+            float floorY = floorf(offsetY);
+            float fx = offsetX - floorX;
+            float fy = offsetY - floorY;
+            mTaps.push_back({(int)floorX, (int)floorY, (1.0f - fx) * (1.0f - fy) * weight,
+                             fx * (1.0f - fy) * weight, (1.0f - fx) * fy * weight,
+                             fx * fy * weight});
+        }
+    }
+};
+
+/**
+ * Blur one row of the tile.
+ *
+ * @param outPtr Where to store the results.
+ * @param xstart The index of the section we're starting to blur.
+ * @param xend The end index of the section.
+ * @param currentY The index of the line we're blurring.
+ * @param acc A working area large enough for xend - xstart vectors.
+ */
+template <typename InVector, typename FloatVector>
+void MotionBlurTask::kernel(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
+                            FloatVector* acc) {
+    const InVector* in = (const InVector*)mIn;
+    const int maxX = mSizeX - 1;
+    const int maxY = mSizeY - 1;
+    const int start = xstart;
+    const int end = xend;
+
+    for (int x = start; x < end; x++) {
+        acc[x - start] = 0;
+    }
+    for (const Tap& tap : mTaps) {
+        const InVector* row0 = in + mSizeX * clamp((int)currentY + tap.dy, 0, maxY);
+        const InVector* row1 = in + mSizeX * clamp((int)currentY + tap.dy + 1, 0, maxY);
+        // Only the columns in [first, last) have both their samples inside the image.
+        const int first = clamp(-tap.dx, start, end);
+        const int last = std::max(first, clamp(maxX - tap.dx, start, end));
+        int x = start;
+        for (; x < first; x++) {
+            int x0 = clamp(x + tap.dx, 0, maxX);
+            int x1 = clamp(x + tap.dx + 1, 0, maxX);
+            acc[x - start] += tap.w00 * convert<FloatVector>(row0[x0]) +
+                              tap.w10 * convert<FloatVector>(row0[x1]) +
+                              tap.w01 * convert<FloatVector>(row1[x0]) +
+                              tap.w11 * convert<FloatVector>(row1[x1]);
+        }
+        const InVector* p0 = row0 + tap.dx;
+        const InVector* p1 = row1 + tap.dx;
+        for (; x < last; x++) {
+            acc[x - start] += tap.w00 * convert<FloatVector>(p0[x]) +
+                              tap.w10 * convert<FloatVector>(p0[x + 1]) +
+                              tap.w01 * convert<FloatVector>(p1[x]) +
+                              tap.w11 * convert<FloatVector>(p1[x + 1]);
+        }
+        for (; x < end; x++) {
+            int x0 = clamp(x + tap.dx, 0, maxX);
+            int x1 = clamp(x + tap.dx + 1, 0, maxX);
+            acc[x - start] += tap.w00 * convert<FloatVector>(row0[x0]) +
+                              tap.w10 * convert<FloatVector>(row0[x1]) +
+                              tap.w01 * convert<FloatVector>(row1[x0]) +
+                              tap.w11 * convert<FloatVector>(row1[x1]);
+        }
+    }
+
+    InVector* out = (InVector*)outPtr;
+    for (int x = start; x < end; x++) {
+        out[x - start] = convert<InVector>(acc[x - start] + 0.5f);
+    }
+}
+
+void MotionBlurTask::processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                                 size_t endY) {
+    // We accumulate in float4 even for one byte cells. It keeps the scratch logic simple.
+    void* acc = mScratch.get(threadIndex, (endX - startX) * sizeof(float4));
+    if (acc == nullptr) {
+        return;
+    }
+
+    for (size_t y = startY; y < endY; y++) {
+        uchar* outPtr = mOut + (mSizeX * y + startX) * mVectorSize;
+        if (mVectorSize == 4) {
+            kernel<uchar4, float4>(outPtr, startX, endX, y, (float4*)acc);
+        } else {
+            kernel<uchar, float>(outPtr, startX, endX, y, (float*)acc);
+        }
+    }
+}
+
+void RenderScriptToolkit::motionBlur(const uint8_t* in, uint8_t* out, size_t sizeX, size_t sizeY,
+                                     size_t vectorSize, int radius, float angle,
+                                     const Restriction* restriction) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (!validRestriction(LOG_TAG, sizeX, sizeY, restriction)) {
+        return;
+    }
+    if (radius <= 0 || radius > 100) {
+        ALOGE("The radius should be between 1 and 100. %d provided.", radius);
+        return;
+    }
+    if (vectorSize != 1 && vectorSize != 4) {
+        ALOGE("The vectorSize should be 1 or 4. %zu provided.", vectorSize);
+        return;
+    }
+#endif
+
+    MotionBlurTask task(in, out, sizeX, sizeY, vectorSize, processor->getNumberOfThreads(), radius,
+                        angle, restriction);
+    processor->doTask(&task);
+}
+
+}  // namespace renderscript
@@ -33,4 +33,23 @@ RenderScriptToolkit::~RenderScriptToolkit() {
     // in RenderScriptToolkit.h.
 }
 
+SimdLevel RenderScriptToolkit::setMaxSimdLevel(SimdLevel level) {
+    const X86Extension maxExtension = level == SimdLevel::Avx512 ? X86Extension::Avx512
+                                      : level == SimdLevel::Avx2 ? X86Extension::Avx2
+                                                                 : X86Extension::None;
+    processor->limitSimd(level != SimdLevel::Scalar, maxExtension);
+    if (!processor->usesSimd()) {
+        return SimdLevel::Scalar;
+    }
+    switch (processor->x86Extension()) {
+        case X86Extension::Avx512:
+            return SimdLevel::Avx512;
+        case X86Extension::Avx2:
+            return SimdLevel::Avx2;
+        case X86Extension::None:
+            break;
+    }
+    return SimdLevel::Baseline;
+}
+
 }  // namespace renderscript
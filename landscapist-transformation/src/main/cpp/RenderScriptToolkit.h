@@ -42,12 +42,186 @@ struct Restriction {
     size_t endY;
 };
 
+/**
+ * A rectangle of an image, in pixels. Pixel (x, y) covers the area from x to x + 1 and from y to
+ * y + 1, so the edges of the rectangle can fall anywhere within the pixels.
+ *
+ * @property startX Where the rectangle starts on the X axis.
+ * @property endX Where the rectangle ends on the X axis.
+ * @property startY Where the rectangle starts on the Y axis.
+ * @property endY Where the rectangle ends on the Y axis.
+ */
+struct RectF {
+    float startX;
+    float endX;
+    float startY;
+    float endY;
+};
+
+/**
+ * How the color channels of a pixel relate to its alpha channel.
+ *
+ * Android Bitmaps are premultiplied, i.e. each color channel has already been multiplied by the
+ * alpha of the pixel. Images decoded straight from PNG files usually aren't. Filtering
+ * unpremultiplied pixels as if they were premultiplied lets the color of transparent pixels
+ * bleed into their neighbors, which shows up as dark halos around transparent edges.
+ */
+enum class AlphaType {
+    Premultiplied = 0,
+    Unpremultiplied = 1,
+};
+
+/**
+ * The color space in which the pixels are mixed.
+ *
+ * The bytes of the images are sRGB encoded. Srgb mixes these encoded values directly, which is
+ * fast but darkens the transitions between bright and dark areas. Linear converts each channel
+ * to linear light before mixing and back to sRGB afterwards, which matches how light combines.
+ */
+enum class ColorSpace {
+    Srgb = 0,
+    Linear = 1,
+};
+
+/**
+ * How an image extends past its edges, i.e. which values replace the pixels that are out of
+ * boundary.
+ *
+ * Clamp repeats the edge pixels. Mirror and Wrap repeat the whole image, the first flipping every
+ * other copy so that adjacent copies seam, the second not. They are the right choices for tiled
+ * backgrounds. Transparent uses fully transparent pixels.
+ */
+enum class EdgeMode {
+    Clamp = 0,
+    Mirror = 1,
+    Wrap = 2,
+    Transparent = 3,
+};
+
+/**
+ * The algorithm used to blur an image.
+ *
+ * Gaussian convolves the image with a Gaussian kernel, one axis at a time. Its cost grows with the
+ * radius. Fast is a dual filter blur: the image is halved a few times, then doubled back to its
+ * size, each pass mixing the pixels of a 4x4 neighborhood. Its cost stays close to that of a
+ * small Gaussian blur whatever the radius, at the price of a result that is close to, but not
+ * exactly, a Gaussian blur. It suits large radii, e.g. frosted glass backgrounds.
+ */
+enum class BlurQuality {
+    Gaussian = 0,
+    Fast = 1,
+};
+
+/**
+ * The layout of the pixels of an image, for the ops that accept more than bytes.
+ *
+ * Rgba8888 has one byte per channel, in the order R, G, B, A. RgbaF16 has one half float per
+ * channel in the same order, usually in linear light and possibly outside of [0, 1] for wide
+ * gamut or HDR content. Rgb565 packs R, G and B in 5, 6 and 5 bits of a 16 bit value, R in the
+ * top bits, and has no alpha. Rgba1010102 packs R, G, B and A in 10, 10, 10 and 2 bits of a 32
+ * bit value, R in the bottom bits. The multi-byte values are little endian, as in Android
+ * Bitmaps. Rgb888 has one byte per channel, in the order R, G, B, with no alpha and no padding,
+ * as JPEG decoders return it. RgbaF32 is RgbaF16 with 32 bit floats, e.g. for HDR images or the
+ * input of a neural network.
+ */
+enum class PixelFormat {
+    Rgba8888 = 0,
+    RgbaF16 = 1,
+    Rgb565 = 2,
+    Rgba1010102 = 3,
+    Rgb888 = 4,
+    RgbaF32 = 5,
+};
+
+/**
+ * The shape of the aperture simulated by lensBlur. Disc is the round aperture of a wide open
+ * lens. Hexagon is that of a lens stopped down with six blades; it has flat top and bottom sides.
+ */
+enum class LensShape {
+    Disc = 0,
+    Hexagon = 1,
+};
+
+/**
+ * The filter used by resize to compute each output pixel from the input pixels around it.
+ *
+ * Nearest copies the closest input pixel, the fastest choice, e.g. for placeholders. Bilinear
+ * mixes the 2x2 closest pixels. CatmullRom is the bicubic of RenderScript; it's sharp but rings a
+ * little around edges. Mitchell is a cubic that rings less, at the price of a little blur.
+ * Lanczos3 mixes the 6x6 closest pixels, keeping the most detail, e.g. for detail views, at the
+ * highest cost. When downscaling, Lanczos3 widens to cover as many input pixels as needed, while
+ * Bilinear, CatmullRom and Mitchell average areas along an axis reduced by a factor of 2 or more.
+ */
+enum class ResizeFilter {
+    Nearest = 0,
+    Bilinear = 1,
+    CatmullRom = 2,
+    Mitchell = 3,
+    Lanczos3 = 4,
+};
+
+/**
+ * The type of the values of the tensors RenderScriptToolkit::resizeToTensor fills, as models
+ * take them. Float32 is a float per value. Int8 is a signed byte per value, rounded to the
+ * nearest and saturated, for quantized models.
+ */
+enum class TensorType {
+    Float32 = 0,
+    Int8 = 1,
+};
+
+/**
+ * The sets of kernels the Toolkit picks from, from the least to the most capable. Scalar is the
+ * plain C++ code. Baseline adds the NEON kernels on ARM and the SSSE3 ones on x86. Avx2 and
+ * Avx512 add the wider x86 kernels. See RenderScriptToolkit::setMaxSimdLevel.
+ */
+enum class SimdLevel {
+    Scalar = 0,
+    Baseline = 1,
+    Avx2 = 2,
+    Avx512 = 3,
+};
+
+/**
+ * Resizes an image whose rows arrive one at a time, in order, e.g. from a decoder, so that the
+ * whole input never has to be in memory. Create it with RenderScriptToolkit::createResizeStream.
+ *
+ * Each output row is produced as soon as the last input row it needs is pushed. Only the few
+ * input rows that the output rows still to come need are kept, in a ring, so the memory used
+ * is a few rows, however tall the image. The output is the same as that of resize, except
+ * where resize uses the SIMD bicubic kernels. The work is done on the thread that pushes the
+ * rows. A stream is not thread safe, but several streams can run on different threads.
+ */
+class ResizeStream {
+   public:
+    virtual ~ResizeStream() = default;
+
+    /**
+     * The most output rows a single call to pushRow can produce, i.e. how many rows its out
+     * buffer needs room for.
+     */
+    virtual size_t maxRowsPerPush() const = 0;
+
+    /**
+     * Pushes the next input row and writes the output rows it completes, if any.
+     *
+     * @param in The input row, inputSizeX cells.
+     * @param out The buffer that receives the completed output rows, back to back. It should
+     * be large enough for maxRowsPerPush() rows of outputSizeX cells.
+     * @return The number of output rows written to out. All the output rows have been written
+     * once the last input row is pushed. The rows pushed after it are ignored.
+     */
+    virtual size_t pushRow(const uint8_t* _Nonnull in, uint8_t* _Nonnull out) = 0;
+};
+
 /**
  * A collection of high-performance graphic utility functions like blur and blend.
  *
- * This toolkit provides ten image manipulation functions: blend, blur, color matrix, convolve,
- * histogram, histogramDot, lut, lut3d, resize, and YUV to RGB. These functions execute
- * multithreaded on the CPU.
+ * This toolkit provides image manipulation functions: blend, blur, blurDirtyRegions, blurLadder
+ * and interpolateBlurLadder, color matrix, convolve, generateMipmaps, histogram, histogramDot,
+ * lensBlur, lut, lut3d, motionBlur, resize, resizeMultiple, resizeToTensor, createResizeStream,
+ * shadow, and YUV to RGB. These functions execute multithreaded on the CPU, except for the
+ * resize streams, which work on the thread that pushes the rows.
  *
  * These functions work over raw byte arrays. You'll need to specify the width and height of
  * the data to be processed, as well as the number of bytes per pixel. For most use cases,
@@ -65,8 +239,9 @@ struct Restriction {
  *
  * This toolkit can be used as a replacement for most RenderScript Intrinsic functions. Compared
  * to RenderScript, it's simpler to use and more than twice as fast on the CPU. However RenderScript
- * Intrinsics allow more flexibility for the type of allocation supported. In particular, this
- * toolkit does not support allocations of floats.
+ * Intrinsics allow more flexibility for the type of allocation supported. Only blur and resize
+ * accept floats, as RgbaF16 and RgbaF32 pixels, and resizeToTensor writes float tensors. All the
+ * other functions take bytes only.
  */
 class RenderScriptToolkit {
     /** Each Toolkit method call is converted to a Task. The processor owns the thread pool. It
@@ -87,6 +262,17 @@ class RenderScriptToolkit {
      */
     ~RenderScriptToolkit();
 
+    /**
+     * Caps the kernels used by the following calls, e.g. to check that the SIMD kernels agree
+     * with each other and with the scalar code, or to compare their speed. By default, the
+     * Toolkit uses the most capable kernels the processor supports.
+     *
+     * @param level The most capable kernels to use. Levels the processor doesn't support are
+     * lowered to the most capable one it does.
+     * @return The level actually used.
+     */
+    SimdLevel setMaxSimdLevel(SimdLevel level);
+
     /**
      * Blur an image.
      *
@@ -118,10 +304,363 @@ class RenderScriptToolkit {
     void blur(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t sizeX, size_t sizeY,
               size_t vectorSize, int radius, const Restriction* _Nullable restriction = nullptr);
 
+    /**
+     * Blur an image with different radii along the X and Y axes.
+     *
+     * Same as the blur method above, except that the horizontal and vertical passes each have
+     * their own radius. Each radius accepts values between 0 and 25, but they can't both be 0.
+     * A radius of 0 skips the blur along that axis, e.g. radiusY = 0 gives a horizontal-only
+     * blur for about half the cost of a full one.
+     *
+     * @param in The buffer of the image to be blurred.
+     * @param out The buffer that receives the blurred image.
+     * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+     * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+     * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+     * @param radiusX The radius of the blur along the X axis.
+     * @param radiusY The radius of the blur along the Y axis.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void blur(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t sizeX, size_t sizeY,
+              size_t vectorSize, int radiusX, int radiusY,
+              const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Blur an image, controlling how the pixels are mixed.
+     *
+     * Same as the blur method above, with three more options. When alphaType is Unpremultiplied,
+     * the pixels are premultiplied as they are read and unpremultiplied as they are written, so
+     * the output is unpremultiplied too. When colorSpace is Linear, the blur is done in linear
+     * light. Both conversions are done with lookup tables inside the blur passes, not as
+     * separate passes over the image. The edgeMode determines which values replace the pixels
+     * that are out of boundary.
+     *
+     * The color options only apply to RGBA images. Alpha only images are blurred the same way
+     * whatever their values. The edgeMode applies to both.
+     *
+     * @param in The buffer of the image to be blurred.
+     * @param out The buffer that receives the blurred image.
+     * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+     * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+     * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+     * @param radiusX The radius of the blur along the X axis.
+     * @param radiusY The radius of the blur along the Y axis.
+     * @param alphaType Whether the color channels of the input are premultiplied by alpha.
+     * @param colorSpace The color space in which the pixels are mixed.
+     * @param edgeMode How the image extends past its edges.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void blur(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t sizeX, size_t sizeY,
+              size_t vectorSize, int radiusX, int radiusY, AlphaType alphaType,
+              ColorSpace colorSpace, EdgeMode edgeMode,
+              const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Blur an RGBA image whose pixels are in another format than bytes.
+     *
+     * Same as the blur method above. The pixels are converted to floats as the vertical pass
+     * reads them and back to their format as the horizontal pass writes them, so there's no
+     * extra pass over the image nor any intermediate image.
+     *
+     * RgbaF16 and RgbaF32 pixels are blurred as they are, without clamping, so colorSpace
+     * doesn't apply to them; they are usually linear already. Rgb565 and Rgb888 have no alpha
+     * so alphaType doesn't apply to them; with the Transparent edge mode, the edges fade to
+     * black. When the alpha of an Rgba1010102 pixel is rounded to 2 bits, its color is scaled
+     * along.
+     *
+     * @param in The buffer of the image to be blurred.
+     * @param out The buffer that receives the blurred image.
+     * @param sizeX The width of both buffers, as a number of pixels.
+     * @param sizeY The height of both buffers, as a number of pixels.
+     * @param format The format of the pixels of both buffers.
+     * @param radiusX The radius of the blur along the X axis.
+     * @param radiusY The radius of the blur along the Y axis.
+     * @param alphaType Whether the color channels of the input are premultiplied by alpha.
+     * @param colorSpace The color space in which the pixels are mixed.
+     * @param edgeMode How the image extends past its edges.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void blur(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t sizeX, size_t sizeY,
+              PixelFormat format, int radiusX, int radiusY, AlphaType alphaType,
+              ColorSpace colorSpace, EdgeMode edgeMode,
+              const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Blur an image with the chosen algorithm.
+     *
+     * Same as the first blur method above when quality is Gaussian. When it is Fast, the radius
+     * can be up to 250. The number of times the image is halved is picked so that the spread of
+     * the blur matches that of the Gaussian of the same radius, and a small Gaussian blur of the
+     * smallest level makes up the difference. The intermediate levels are kept in one buffer
+     * that is reused from one call to the next. Radii below 5, and images too small to be
+     * halved, fall back to the Gaussian blur, with the radius limited to 25. Likewise, small
+     * images can't be halved enough for the largest radii, which then blur less than asked.
+     *
+     * Fast only supports premultiplied sRGB pixels and repeats the edge pixels past the edges.
+     * The restriction only applies to the last pass, the smaller levels are always computed in
+     * full.
+     *
+     * @param in The buffer of the image to be blurred.
+     * @param out The buffer that receives the blurred image.
+     * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+     * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+     * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+     * @param radius The radius of the pixels used to blur.
+     * @param quality The algorithm used to blur.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void blur(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t sizeX, size_t sizeY,
+              size_t vectorSize, int radius, BlurQuality quality,
+              const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Blur an image with several radii at once, e.g. to animate a blur or to pick its strength
+     * later with interpolateBlurLadder.
+     *
+     * Each rung of the ladder is computed from the work done for the previous ones instead of
+     * from scratch. With Gaussian, each rung blurs the previous one just enough to reach its own
+     * radius, which takes a single small pass for closely spaced radii. The first rung matches
+     * the blur method above. Radii above 25 take several passes. With Fast, the image is halved
+     * once for all the rungs, and each rung only does its own Gaussian pass and its doubling.
+     *
+     * The radii should be in increasing order. A radius of 0 copies the input. They can be up to
+     * 50 with Gaussian and up to 250 with Fast. Only premultiplied sRGB pixels are supported and
+     * the edge pixels are repeated past the edges.
+     *
+     * @param in The buffer of the image to be blurred.
+     * @param out One buffer per radius, each receiving the image blurred with that radius.
+     * @param sizeX The width of all the buffers, as a number of 1 or 4 byte cells.
+     * @param sizeY The height of all the buffers, as a number of 1 or 4 byte cells.
+     * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+     * @param radii The radii of the rungs, in increasing order.
+     * @param count The number of radii and of output buffers.
+     * @param quality The algorithm used to blur.
+     */
+    void blurLadder(const uint8_t* _Nonnull in, uint8_t* _Nonnull const* _Nonnull out,
+                    size_t sizeX, size_t sizeY, size_t vectorSize, const int* _Nonnull radii,
+                    size_t count, BlurQuality quality = BlurQuality::Gaussian);
+
+    /**
+     * Approximates the blur of an image with any radius from a ladder made by blurLadder.
+     *
+     * The two rungs around the radius are mixed so that the spread of the result matches that of
+     * the radius. Below the first rung or above the last, that rung is copied. This costs far
+     * less than a blur, e.g. to change the strength of a blur every frame.
+     *
+     * @param ladder The buffers of the rungs.
+     * @param radii The radii of the rungs, in increasing order.
+     * @param count The number of rungs.
+     * @param out The buffer that receives the blurred image.
+     * @param sizeX The width of all the buffers, as a number of 1 or 4 byte cells.
+     * @param sizeY The height of all the buffers, as a number of 1 or 4 byte cells.
+     * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+     * @param radius The radius of the blur to approximate.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void interpolateBlurLadder(const uint8_t* _Nonnull const* _Nonnull ladder,
+                               const int* _Nonnull radii, size_t count, uint8_t* _Nonnull out,
+                               size_t sizeX, size_t sizeY, size_t vectorSize, float radius,
+                               const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Blur an image in place.
+     *
+     * Same as the blur method above, except that the result overwrites the input so no second
+     * buffer is needed. Each thread blurs a band of rows. Before starting, the rows around the
+     * ends of the bands are copied, and each band keeps the last radiusY + 1 rows it read in a
+     * ring as it overwrites them. The extra memory is a few rows per thread instead of a whole
+     * image.
+     *
+     * @param inOut The buffer of the image to be blurred, which receives the blurred image.
+     * @param sizeX The width of the buffer, as a number of 1 or 4 byte cells.
+     * @param sizeY The height of the buffer, as a number of 1 or 4 byte cells.
+     * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+     * @param radius The radius of the pixels used to blur.
+     */
+    void blurInPlace(uint8_t* _Nonnull inOut, size_t sizeX, size_t sizeY, size_t vectorSize,
+                     int radius);
+
+    /**
+     * Blur an image in place, with the options of the full blur method above.
+     *
+     * @param inOut The buffer of the image to be blurred, which receives the blurred image.
+     * @param sizeX The width of the buffer, as a number of 1 or 4 byte cells.
+     * @param sizeY The height of the buffer, as a number of 1 or 4 byte cells.
+     * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+     * @param radiusX The radius of the blur along the X axis.
+     * @param radiusY The radius of the blur along the Y axis.
+     * @param alphaType Whether the color channels of the input are premultiplied by alpha.
+     * @param colorSpace The color space in which the pixels are mixed.
+     * @param edgeMode How the image extends past its edges.
+     */
+    void blurInPlace(uint8_t* _Nonnull inOut, size_t sizeX, size_t sizeY, size_t vectorSize,
+                     int radiusX, int radiusY, AlphaType alphaType, ColorSpace colorSpace,
+                     EdgeMode edgeMode);
+
+    /**
+     * Blur an RGBA image whose pixels are in another format than bytes, in place. See the blur
+     * method that takes a PixelFormat.
+     *
+     * @param inOut The buffer of the image to be blurred, which receives the blurred image.
+     * @param sizeX The width of the buffer, as a number of pixels.
+     * @param sizeY The height of the buffer, as a number of pixels.
+     * @param format The format of the pixels of the buffer.
+     * @param radiusX The radius of the blur along the X axis.
+     * @param radiusY The radius of the blur along the Y axis.
+     * @param alphaType Whether the color channels of the input are premultiplied by alpha.
+     * @param colorSpace The color space in which the pixels are mixed.
+     * @param edgeMode How the image extends past its edges.
+     */
+    void blurInPlace(uint8_t* _Nonnull inOut, size_t sizeX, size_t sizeY, PixelFormat format,
+                     int radiusX, int radiusY, AlphaType alphaType, ColorSpace colorSpace,
+                     EdgeMode edgeMode);
+
+    /**
+     * Update a blurred image after some pixels of the original changed.
+     *
+     * out holds the blur of a previous version of the input, made with the same options. Only
+     * the pixels of out that depend on the dirty regions of in are recomputed: each region is
+     * expanded by the radius, overlapping or adjacent regions are merged, and each result is
+     * blurred as a restriction that reads its halo from in. The cost is proportional to the
+     * expanded area, e.g. about a tenth of a full blur when 5% of a large image changed.
+     *
+     * The result is the same as blurring the whole input again, give or take one for the pixels
+     * that the SIMD and scalar code paths round differently. in and out must be different
+     * buffers.
+     *
+     * @param in The buffer of the image to be blurred.
+     * @param out The buffer that holds the previous blurred image and receives the new one.
+     * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+     * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+     * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+     * @param radius The radius of the pixels used to blur.
+     * @param dirtyRegions The regions of in that changed since out was computed.
+     * @param dirtyRegionCount The number of dirty regions.
+     */
+    void blurDirtyRegions(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t sizeX,
+                          size_t sizeY, size_t vectorSize, int radius,
+                          const Restriction* _Nonnull dirtyRegions, size_t dirtyRegionCount);
+
+    /**
+     * Update a blurred image after some pixels of the original changed, with the options of
+     * the full blur method above.
+     *
+     * @param in The buffer of the image to be blurred.
+     * @param out The buffer that holds the previous blurred image and receives the new one.
+     * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+     * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+     * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+     * @param radiusX The radius of the blur along the X axis.
+     * @param radiusY The radius of the blur along the Y axis.
+     * @param alphaType Whether the color channels of the input are premultiplied by alpha.
+     * @param colorSpace The color space in which the pixels are mixed.
+     * @param edgeMode How the image extends past its edges.
+     * @param dirtyRegions The regions of in that changed since out was computed.
+     * @param dirtyRegionCount The number of dirty regions.
+     */
+    void blurDirtyRegions(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t sizeX,
+                          size_t sizeY, size_t vectorSize, int radiusX, int radiusY,
+                          AlphaType alphaType, ColorSpace colorSpace, EdgeMode edgeMode,
+                          const Restriction* _Nonnull dirtyRegions, size_t dirtyRegionCount);
+
+    /**
+     * Draw the shadow or the glow of an RGBA image.
+     *
+     * The alpha channel of the input is blurred, tinted with the color, and drawn at the offset
+     * in the output. The output pixels are premultiplied. This is done in a single pass, without
+     * an intermediate alpha image, and is about the cost of blurring an alpha only image of the
+     * size of the output. The input is transparent past its edges, so the shadow fades out there.
+     *
+     * The output can be larger than the input to leave room for the shadow to spread, e.g. with a
+     * size of sizeX + 2 * radius by sizeY + 2 * radius and an offset of (radius, radius).
+     *
+     * An optional range parameter can be set to restrict the operation to a rectangular subset
+     * of the output. If provided, the range must be wholly contained with the dimensions
+     * described by outputSizeX and outputSizeY.
+     *
+     * @param in The buffer of the RGBA image that casts the shadow.
+     * @param sizeX The width of the input, in pixels.
+     * @param sizeY The height of the input, in pixels.
+     * @param out The buffer that receives the RGBA shadow.
+     * @param outputSizeX The width of the output, in pixels.
+     * @param outputSizeY The height of the output, in pixels.
+     * @param radius The radius of the blur, from 0 to 25.
+     * @param color The color of the shadow as 0xAARRGGBB, not premultiplied.
+     * @param offsetX Where the left edge of the input lands in the output.
+     * @param offsetY Where the top edge of the input lands in the output.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void shadow(const uint8_t* _Nonnull in, size_t sizeX, size_t sizeY, uint8_t* _Nonnull out,
+                size_t outputSizeX, size_t outputSizeY, int radius, uint32_t color, int offsetX,
+                int offsetY, const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Blur an image along a line, i.e. a directional motion blur.
+     *
+     * Each output pixel is the average of 2 * radius + 1 pixels sampled at unit steps along a
+     * line of the given angle going through it. Samples that fall between pixels are
+     * bilinearly interpolated. When the line extends past the edge, the edge pixel will be used
+     * as replacement for the pixel that's out of boundary.
+     *
+     * The radius accepts values between 1 and 100. The cost grows linearly with the radius.
+     *
+     * Each input pixel can either be represented by four bytes (RGBA format) or one byte
+     * for the less common blurring of alpha channel only image.
+     *
+     * An optional range parameter can be set to restrict the operation to a rectangular subset
+     * of each buffer. If provided, the range must be wholly contained with the dimensions
+     * described by sizeX and sizeY.
+     *
+     * @param in The buffer of the image to be blurred.
+     * @param out The buffer that receives the blurred image.
+     * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+     * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+     * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+     * @param radius Half the length of the line, in pixels.
+     * @param angle The direction of the line in degrees, counterclockwise from the X axis.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void motionBlur(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t sizeX,
+                    size_t sizeY, size_t vectorSize, int radius, float angle,
+                    const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Blur an image the way an out of focus lens does.
+     *
+     * Each output pixel is the average of the pixels inside a disc or a hexagon of the given
+     * radius centered on it, so bright spots spread into evenly lit copies of the shape. When the
+     * shape extends past the edge, the edge pixel will be used as replacement for the pixel
+     * that's out of boundary.
+     *
+     * The radius accepts values between 1 and 100. The cost grows linearly with the radius, and
+     * is within a few times that of a Gaussian blur of the same radius.
+     *
+     * Each input pixel can either be represented by four bytes (RGBA format) or one byte
+     * for the less common blurring of alpha channel only image.
+     *
+     * An optional range parameter can be set to restrict the operation to a rectangular subset
+     * of each buffer. If provided, the range must be wholly contained with the dimensions
+     * described by sizeX and sizeY.
+     *
+     * @param in The buffer of the image to be blurred.
+     * @param out The buffer that receives the blurred image.
+     * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+     * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+     * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+     * @param radius The radius of the shape, in pixels.
+     * @param shape The shape of the aperture.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void lensBlur(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t sizeX, size_t sizeY,
+                  size_t vectorSize, int radius, LensShape shape,
+                  const Restriction* _Nullable restriction = nullptr);
+
     /**
      * Resize an image.
      *
-     * Resizes an image using bicubic interpolation.
+     * Resizes an image using bicubic interpolation. Along an axis that is reduced by a factor
+     * of 2 or more, each output pixel is instead the average of the input area it covers, which
+     * keeps fine detail from aliasing, e.g. when making thumbnails of camera pictures.
      *
      * This method supports cells of 1 to 4 bytes in length. Each byte of the cell is
      * interpolated independently from the others.
@@ -146,6 +685,228 @@ class RenderScriptToolkit {
     void resize(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t inputSizeX,
                 size_t inputSizeY, size_t vectorSize, size_t outputSizeX, size_t outputSizeY,
                 const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Resize an image with the chosen filter.
+     *
+     * Same as the resize method above when filter is CatmullRom. See ResizeFilter for the
+     * trade-offs of each filter.
+     *
+     * @param in The buffer of the image to be resized.
+     * @param out The buffer that receives the resized image.
+     * @param inputSizeX The width of the input buffer, as a number of 1-4 byte cells.
+     * @param inputSizeY The height of the input buffer, as a number of 1-4 byte cells.
+     * @param vectorSize The number of bytes in each cell of both buffers. A value from 1 to 4.
+     * @param outputSizeX The width of the output buffer, as a number of 1-4 byte cells.
+     * @param outputSizeY The height of the output buffer, as a number of 1-4 byte cells.
+     * @param filter The filter used to compute the output pixels.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void resize(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t inputSizeX,
+                size_t inputSizeY, size_t vectorSize, size_t outputSizeX, size_t outputSizeY,
+                ResizeFilter filter, const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Resize an image with the chosen filter, in the chosen alpha type and color space.
+     *
+     * Same as the resize method above when alphaType is Premultiplied and colorSpace is Srgb.
+     * Cells of 4 bytes are RGBA. When they are Unpremultiplied, as decoders often return them,
+     * they are premultiplied as the horizontal pass reads them and unpremultiplied as the
+     * vertical pass writes them, which keeps the color of transparent pixels from bleeding into
+     * their neighbors. With Linear, the color channels are likewise converted to linear light
+     * and back to sRGB. Cells of 3 bytes are opaque RGB, and alphaType doesn't apply to them.
+     * Cells of 1 and 2 bytes are mixed as they are. There's no extra pass over the image, but
+     * these conversions are slower, as they can't use the fixed point kernels.
+     *
+     * @param in The buffer of the image to be resized.
+     * @param out The buffer that receives the resized image.
+     * @param inputSizeX The width of the input buffer, as a number of 1-4 byte cells.
+     * @param inputSizeY The height of the input buffer, as a number of 1-4 byte cells.
+     * @param vectorSize The number of bytes in each cell of both buffers. A value from 1 to 4.
+     * @param outputSizeX The width of the output buffer, as a number of 1-4 byte cells.
+     * @param outputSizeY The height of the output buffer, as a number of 1-4 byte cells.
+     * @param filter The filter used to compute the output pixels.
+     * @param alphaType Whether the color channels of the input are premultiplied by alpha. The
+     * output has the same alpha type.
+     * @param colorSpace The color space in which the pixels are mixed.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void resize(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t inputSizeX,
+                size_t inputSizeY, size_t vectorSize, size_t outputSizeX, size_t outputSizeY,
+                ResizeFilter filter, AlphaType alphaType, ColorSpace colorSpace,
+                const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Resize a rectangle of an image, e.g. to crop and scale it in one pass.
+     *
+     * Same as the resize method above, except that the output covers the source rectangle of
+     * the input rather than all of it. Its edges can fall between pixels, and the output pixels
+     * are sampled at their exact positions within it. Only the input pixels under the filter are
+     * read, which includes those just outside the rectangle, as if the whole image had been
+     * resized and the rectangle cut out of it.
+     *
+     * @param in The buffer of the image to be resized.
+     * @param out The buffer that receives the resized image.
+     * @param inputSizeX The width of the input buffer, as a number of 1-4 byte cells.
+     * @param inputSizeY The height of the input buffer, as a number of 1-4 byte cells.
+     * @param vectorSize The number of bytes in each cell of both buffers. A value from 1 to 4.
+     * @param source The rectangle of the input to resize. It must not be empty, and must be
+     * within the input.
+     * @param outputSizeX The width of the output buffer, as a number of 1-4 byte cells.
+     * @param outputSizeY The height of the output buffer, as a number of 1-4 byte cells.
+     * @param filter The filter used to compute the output pixels.
+     * @param alphaType Whether the color channels of the input are premultiplied by alpha. The
+     * output has the same alpha type.
+     * @param colorSpace The color space in which the pixels are mixed.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void resize(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t inputSizeX,
+                size_t inputSizeY, size_t vectorSize, const RectF& source, size_t outputSizeX,
+                size_t outputSizeY, ResizeFilter filter = ResizeFilter::CatmullRom,
+                AlphaType alphaType = AlphaType::Premultiplied,
+                ColorSpace colorSpace = ColorSpace::Srgb,
+                const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Resize a rectangle of an image whose pixels have the given format.
+     *
+     * Same as the resize method above with a vectorSize of 4 when format is Rgba8888. With
+     * Rgb888, the pixels of both buffers take 3 bytes rather than being padded to 4, so a third
+     * less memory is read and written, and the RGB images of decoders don't have to be expanded
+     * first. They are opaque, so alphaType doesn't apply to them. RgbaF16 and RgbaF32 pixels,
+     * e.g. of HDR images or of the inputs of models, are mixed in float as they are, without
+     * clamping, so colorSpace doesn't apply to them. Other formats aren't supported.
+     *
+     * @param in The buffer of the image to be resized.
+     * @param out The buffer that receives the resized image.
+     * @param inputSizeX The width of the input buffer, as a number of pixels.
+     * @param inputSizeY The height of the input buffer, as a number of pixels.
+     * @param format The format of the pixels of both buffers, Rgba8888, Rgb888, RgbaF16 or
+     * RgbaF32.
+     * @param source The rectangle of the input to resize. It must not be empty, and must be
+     * within the input.
+     * @param outputSizeX The width of the output buffer, as a number of pixels.
+     * @param outputSizeY The height of the output buffer, as a number of pixels.
+     * @param filter The filter used to compute the output pixels.
+     * @param alphaType Whether the color channels of the input are premultiplied by alpha. The
+     * output has the same alpha type.
+     * @param colorSpace The color space in which the pixels are mixed.
+     * @param restriction When not null, restricts the operation to a 2D range of pixels.
+     */
+    void resize(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t inputSizeX,
+                size_t inputSizeY, PixelFormat format, const RectF& source, size_t outputSizeX,
+                size_t outputSizeY, ResizeFilter filter = ResizeFilter::CatmullRom,
+                AlphaType alphaType = AlphaType::Premultiplied,
+                ColorSpace colorSpace = ColorSpace::Srgb,
+                const Restriction* _Nullable restriction = nullptr);
+
+    /**
+     * Resize an image to several sizes at once, e.g. a thumbnail, a tile and a preview.
+     *
+     * Each input row is read once for all the outputs, while it's in cache, rather than once
+     * per call to resize. When cascade is true, an output that is at most half as large as
+     * another one on both axes is resized from the rows of the latter as they're computed,
+     * which takes far less work than resizing it from a large input. It is then a little
+     * blurrier than when resized from the input. Each output is otherwise the same as that of a
+     * stream made by createResizeStream. Cells of 3 bytes are padded to occupy 4.
+     *
+     * @param in The buffer of the image to be resized.
+     * @param out One buffer per output size, each receiving the image resized to that size.
+     * @param inputSizeX The width of the input buffer, as a number of 1-4 byte cells.
+     * @param inputSizeY The height of the input buffer, as a number of 1-4 byte cells.
+     * @param vectorSize The number of bytes in each cell of all the buffers. A value from 1 to 4.
+     * @param outputSizesX The width of each output buffer, as a number of 1-4 byte cells.
+     * @param outputSizesY The height of each output buffer, as a number of 1-4 byte cells.
+     * @param count The number of output sizes and of output buffers.
+     * @param filter The filter used to compute the output pixels.
+     * @param cascade Whether the smaller outputs can be resized from the larger ones.
+     */
+    void resizeMultiple(const uint8_t* _Nonnull in, uint8_t* _Nonnull const* _Nonnull out,
+                        size_t inputSizeX, size_t inputSizeY, size_t vectorSize,
+                        const size_t* _Nonnull outputSizesX, const size_t* _Nonnull outputSizesY,
+                        size_t count, ResizeFilter filter = ResizeFilter::CatmullRom,
+                        bool cascade = false);
+
+    /**
+     * Resize an RGBA image into the input tensor of a model, e.g. a 224x224 classifier.
+     *
+     * The output is planar, as models with an NCHW layout take it: the outputSizeX *
+     * outputSizeY values of R, then those of G, then those of B. Each value is the channel of
+     * the resized pixel, in the [0, 255] range, times the scale of its channel plus its bias.
+     * The values are computed as each resized row is stored, so there's no intermediate RGBA
+     * image nor pass over the tensor to convert it. To normalize the channels by a mean and a
+     * standard deviation computed on [0, 1] values, pass a scale of 1 / (255 * std) and a bias
+     * of -mean / std.
+     *
+     * The pixels are otherwise those resize computes in the sRGB color space, though they
+     * aren't rounded to bytes when it mixes them in float. Unpremultiplied pixels are resized
+     * without bleeding the color of transparent pixels into their neighbors, and their tensor
+     * values are unpremultiplied. Alpha isn't stored.
+     *
+     * @param in The buffer of the RGBA image to be resized.
+     * @param out The tensor, of 3 * outputSizeX * outputSizeY values of the given type.
+     * @param inputSizeX The width of the input buffer, as a number of pixels.
+     * @param inputSizeY The height of the input buffer, as a number of pixels.
+     * @param source The rectangle of the input to resize, e.g. the center square of a photo.
+     * It must not be empty, and must be within the input.
+     * @param outputSizeX The width of the tensor, as a number of values.
+     * @param outputSizeY The height of the tensor, as a number of values.
+     * @param type The type of the values of the tensor.
+     * @param scale The scale of the R, G and B channels.
+     * @param bias The bias of the R, G and B channels.
+     * @param filter The filter used to compute the output pixels.
+     * @param alphaType Whether the color channels of the input are premultiplied by alpha.
+     */
+    void resizeToTensor(const uint8_t* _Nonnull in, void* _Nonnull out, size_t inputSizeX,
+                        size_t inputSizeY, const RectF& source, size_t outputSizeX,
+                        size_t outputSizeY, TensorType type, const float* _Nonnull scale,
+                        const float* _Nonnull bias, ResizeFilter filter = ResizeFilter::CatmullRom,
+                        AlphaType alphaType = AlphaType::Premultiplied);
+
+    /**
+     * Create a stream that resizes an image row by row, as the rows arrive. See ResizeStream.
+     *
+     * Same as resize, except that the input is pushed one row at a time. Cells of 3 bytes are
+     * padded to occupy 4, in both the input and the output rows.
+     *
+     * @param inputSizeX The width of the input, as a number of 1-4 byte cells.
+     * @param inputSizeY The height of the input, as a number of 1-4 byte cells.
+     * @param vectorSize The number of bytes in each cell of both images. A value from 1 to 4.
+     * @param outputSizeX The width of the output, as a number of 1-4 byte cells.
+     * @param outputSizeY The height of the output, as a number of 1-4 byte cells.
+     * @param filter The filter used to compute the output pixels.
+     * @return The stream, or null if the arguments are invalid or its buffers can't be allocated.
+     */
+    std::unique_ptr<ResizeStream> createResizeStream(
+            size_t inputSizeX, size_t inputSizeY, size_t vectorSize, size_t outputSizeX,
+            size_t outputSizeY, ResizeFilter filter = ResizeFilter::CatmullRom);
+
+    /**
+     * Generate the mipmap chain of an image, e.g. to upload it as a texture.
+     *
+     * Each level is half the size of the one above it, rounded down, and at least 1 cell, as
+     * OpenGL expects. Each cell is the rounded average of the 2x2 cells it covers in the level
+     * above; an odd last row or column of the latter is left out. Along an axis that's down to
+     * 1 cell, the level averages pairs of cells along the other axis only. Level 0 is the input.
+     *
+     * The levels 1 to levelCount are written back to back in out, without padding, from level
+     * 1. Level k is max(sizeX >> k, 1) by max(sizeY >> k, 1) cells. The levels are computed a
+     * few at a time in a single pass over the level they start from, so the input is read once
+     * and each level is read back while it's still in cache. A level can also be the input of
+     * another resize, e.g. to reduce an image by a large factor with few taps.
+     *
+     * This method supports cells of 1 to 4 bytes in length. Each byte of the cell is averaged
+     * independently from the others. Like resize, cells of 3 bytes are padded to occupy 4.
+     *
+     * @param in The buffer of the image.
+     * @param out The buffer that receives the levels.
+     * @param sizeX The width of the input buffer, as a number of 1-4 byte cells.
+     * @param sizeY The height of the input buffer, as a number of 1-4 byte cells.
+     * @param vectorSize The number of bytes in each cell of the buffers. A value from 1 to 4.
+     * @param levelCount The number of levels to generate, from 1 until both sides are 1 cell.
+     */
+    void generateMipmaps(const uint8_t* _Nonnull in, uint8_t* _Nonnull out, size_t sizeX,
+                         size_t sizeY, size_t vectorSize, int levelCount);
 };
 
 }  // namespace renderscript
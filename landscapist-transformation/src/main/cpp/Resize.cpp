@@ -16,206 +16,272 @@
 
 #include <math.h>
 
+#include <algorithm>
+#include <climits>
 #include <cstdint>
+#include <cstring>
+#include <memory>
+#include <vector>
 
 #include "RenderScriptToolkit.h"
 #include "TaskProcessor.h"
 #include "Utils.h"
 
-#if defined(ARCH_X86_HAVE_AVX2)
-#include <stdint.h>
-#include <x86intrin.h>
-#include <xmmintrin.h>
-#endif
-
 #define LOG_TAG "renderscript.toolkit.Resize"
 
 namespace renderscript {
 
-class ResizeTask : public Task {
-    const uchar* mIn;
-    uchar* mOut;
-    float mScaleX;
-    float mScaleY;
-    size_t mInputSizeX;
-    size_t mInputSizeY;
+/**
+ * The taps of a resize along one axis. Output pixel i is the weighted sum of the input pixels
+ * first[i] to first[i] + taps - 1, weighted by weights[i * taps] to weights[i * taps + taps - 1].
+ * The taps that would fall past the edges of the input are folded onto the edge pixels, so the
+ * indices are always valid and there's no clamping left to do when resampling.
+ */
+struct ResampleTable {
+    int taps = 0;
+    std::vector<int> first;
+    std::vector<float> weights;
+    // The weights in fixed point, scaled by 1 << kFixedWeightBits, for the filters that have no
+    // negative lobes. Empty for the others.
+    std::vector<ushort> fixedWeights;
+};
 
-    void kernelU1(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY);
-    void kernelU2(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY);
-    void kernelU4(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY);
-#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_SUPPORTS_FLOAT
-    void kernelF1(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY);
-    void kernelF2(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY);
-    void kernelF4(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY);
-#endif  // ANDROID_RENDERSCRIPT_TOOLKIT_SUPPORTS_FLOAT
+/**
+ * The number of fractional bits of the fixed point weights. The weights of an output pixel add
+ * up to exactly 1 << kFixedWeightBits.
+ */
+static constexpr int kFixedWeightBits = 14;
 
-    // Process a 2D tile of the overall work. threadIndex identifies which thread does the work.
-    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
-                     size_t endY) override;
+/**
+ * The scale from which an axis is downscaled by averaging the area of the input pixels each
+ * output pixel covers rather than by sampling the bicubic. Past it, the 4 taps of the bicubic
+ * skip input pixels, which aliases fine detail.
+ */
+static constexpr float kAreaScale = 2.0f;
 
-   public:
-    ResizeTask(const uchar* input, uchar* output, size_t inputSizeX, size_t inputSizeY,
-               size_t vectorSize, size_t outputSizeX, size_t outputSizeY,
-               const Restriction* restriction)
-        : Task{outputSizeX, outputSizeY, vectorSize, false, restriction},
-          mIn{input},
-          mOut{output},
-          mInputSizeX{inputSizeX},
-          mInputSizeY{inputSizeY} {
-        mScaleX = static_cast<float>(inputSizeX) / outputSizeX;
-        mScaleY = static_cast<float>(inputSizeY) / outputSizeY;
+/**
+ * The bicubic filter of RenderScript, i.e. the Catmull-Rom spline. It's zero past 2.
+ */
+static float CatmullRom(float x) {
+    x = fabsf(x);
+    if (x < 1.0f) {
+        return (1.5f * x - 2.5f) * x * x + 1.0f;
     }
-};
+    if (x < 2.0f) {
+        return ((-0.5f * x + 2.5f) * x - 4.0f) * x + 2.0f;
+    }
+    return 0.0f;
+}
 
-void ResizeTask::processData(int /* threadIndex */, size_t startX, size_t startY, size_t endX,
-                             size_t endY) {
-    typedef void (ResizeTask::*KernelFunction)(uchar*, uint32_t, uint32_t, uint32_t);
+/**
+ * The tent filter of bilinear interpolation. It's zero past 1.
+ */
+static float Triangle(float x) {
+    x = fabsf(x);
+    return x < 1.0f ? 1.0f - x : 0.0f;
+}
 
-    KernelFunction kernel;
-    switch (mVectorSize) {
-        case 4:
-            kernel = &ResizeTask::kernelU4;
-            break;
-        case 3:
-            kernel = &ResizeTask::kernelU4;
-            break;
-        case 2:
-            kernel = &ResizeTask::kernelU2;
-            break;
-        case 1:
-            kernel = &ResizeTask::kernelU1;
-            break;
-        default:
-            ALOGE("Bad vector size %zd", mVectorSize);
+/**
+ * The Mitchell-Netravali cubic with B = C = 1/3. It rings less than the Catmull-Rom spline, at
+ * the price of a little blur. It's zero past 2.
+ */
+static float Mitchell(float x) {
+    x = fabsf(x);
+    if (x < 1.0f) {
+        return ((7.0f / 6.0f) * x - 2.0f) * x * x + 8.0f / 9.0f;
     }
-
-    for (size_t y = startY; y < endY; y++) {
-        size_t offset = (mSizeX * y + startX) * paddedSize(mVectorSize);
-        uchar* out = mOut + offset;
-        std::invoke(kernel, this, out, startX, endX, y);
+    if (x < 2.0f) {
+        return (((-7.0f / 18.0f) * x + 2.0f) * x - 10.0f / 3.0f) * x + 16.0f / 9.0f;
     }
+    return 0.0f;
 }
 
-static float4 cubicInterpolate(float4 p0, float4 p1, float4 p2, float4 p3, float x) {
-    return p1 + 0.5f * x * (p2 - p0 + x * (2.f * p0 - 5.f * p1 + 4.f * p2 - p3
-            + x * (3.f * (p1 - p2) + p3 - p0)));
+/**
+ * The sinc windowed by the central lobe of a sinc three times as wide. It's zero past 3.
+ */
+static float Lanczos3(float x) {
+    x = fabsf(x);
+    if (x < 1e-6f) {
+        return 1.0f;
+    }
+    if (x >= 3.0f) {
+        return 0.0f;
+    }
+    const float px = 3.1415926535897932f * x;
+    return 3.0f * sinf(px) * sinf(px / 3.0f) / (px * px);
 }
 
-static float2 cubicInterpolate(float2 p0,float2 p1,float2 p2,float2 p3, float x) {
-    return p1 + 0.5f * x * (p2 - p0 + x * (2.f * p0 - 5.f * p1 + 4.f * p2 - p3
-            + x * (3.f * (p1 - p2) + p3 - p0)));
+/**
+ * Fills in the fixed point weights of a table whose weights are all positive. They are the
+ * differences of the rounded running sums of the weights, so they add up to exactly
+ * 1 << kFixedWeightBits and flat areas stay flat.
+ */
+static void BuildFixedWeights(ResampleTable* table) {
+    const int taps = table->taps;
+    const size_t outputSize = table->first.size();
+    table->fixedWeights.assign(outputSize * taps, 0);
+    for (size_t i = 0; i < outputSize; i++) {
+        const float* weights = &table->weights[i * taps];
+        ushort* fixedWeights = &table->fixedWeights[i * taps];
+        double total = 0;
+        for (int k = 0; k < taps; k++) {
+            total += weights[k];
+        }
+        double sumSoFar = 0;
+        long roundedSoFar = 0;
+        for (int k = 0; k < taps; k++) {
+            sumSoFar += weights[k];
+            const long rounded = lrint(sumSoFar / total * (1 << kFixedWeightBits));
+            fixedWeights[k] = (ushort)(rounded - roundedSoFar);
+            roundedSoFar = rounded;
+        }
+    }
 }
 
+/**
+ * Computes the taps that resample the input pixels from start to start + length along an axis
+ * to outputSize pixels. The centers of the pixels are aligned, i.e. output pixel i samples the
+ * input at start + (i + 0.5) * scale - 0.5. The taps reach past the range into the rest of the
+ * axis, and are clamped to its edges. The weights of each output pixel are normalized to add up
+ * to 1. When they are all positive, the fixed point weights are filled in too.
+ *
+ * @param table The table to fill.
+ * @param inputSize The number of input pixels along the axis.
+ * @param start Where the resampled range starts, in input pixels.
+ * @param length The length of the resampled range, in input pixels.
+ * @param outputSize The number of output pixels along the axis.
+ * @param filter The filter, as a function of the distance to the sample in input pixels.
+ * @param support The distance past which the filter is zero.
+ * @param stretch How much wider than the filter the taps are spread, e.g. the scale when
+ * downscaling so that the filter covers output pixels rather than input ones.
+ */
+static void BuildResampleTable(ResampleTable* table, size_t inputSize, float start, float length,
+                               size_t outputSize, float (*filter)(float), int support,
+                               float stretch) {
+    const float scale = length / outputSize;
+    const int reach = (int)ceilf(support * stretch);
+    const int inputTaps = 2 * reach;
+    const int taps = std::min(inputTaps, (int)inputSize);
+    table->taps = taps;
+    table->first.resize(outputSize);
+    table->weights.assign(outputSize * taps, 0.0f);
+    bool allPositive = true;
+    for (size_t i = 0; i < outputSize; i++) {
+        const float center = start + ((i + 0.5f) * scale - 0.5f);
+        const int left = (int)floorf(center) - reach + 1;
+        const int first = clamp(left, 0, (int)inputSize - taps);
+        float* weights = &table->weights[i * taps];
+        float total = 0.0f;
+        for (int k = 0; k < inputTaps; k++) {
+            const int source = clamp(left + k, 0, (int)inputSize - 1);
+            const float weight = filter((left + k - center) / stretch);
+            weights[source - first] += weight;
+            total += weight;
+        }
+        for (int k = 0; k < taps; k++) {
+            weights[k] /= total;
+            allPositive = allPositive && weights[k] >= 0.0f;
+        }
+        table->first[i] = first;
+    }
+    if (allPositive) {
+        BuildFixedWeights(table);
+    }
+}
 
-#if defined(ARCH_X86_HAVE_AVX2)
-static float cubicInterpolate(float p0,float p1,float p2,float p3 , float x) {
-   return p1 + 0.5f * x * (p2 - p0 + x * (2.f * p0 - 5.f * p1 +
-           _mm_cvtss_f32(_mm_fmsub_ss(_mm_set1_ps(4.f), _mm_set1_ps(p2),_mm_set1_ps(p3)))
-           + x * (_mm_cvtss_f32(_mm_fmadd_ss (_mm_set1_ps(3.f),_mm_set1_ps(p1 - p2),
-                                              _mm_set1_ps(p3 - p0))))));
-
+/**
+ * Computes the taps that downscale the input pixels from start to start + length along an axis
+ * to outputSize pixels by averaging areas. Output pixel i covers the input from
+ * start + i * scale to start + (i + 1) * scale, and each input pixel is weighted by how much of
+ * it is covered. Also fills in the fixed point weights.
+ *
+ * @param table The table to fill.
+ * @param inputSize The number of input pixels along the axis.
+ * @param start Where the resampled range starts, in input pixels.
+ * @param length The length of the resampled range, in input pixels.
+ * @param outputSize The number of output pixels along the axis, at most length.
+ */
+static void BuildAreaTable(ResampleTable* table, size_t inputSize, float start, float length,
+                           size_t outputSize) {
+    const double scale = static_cast<double>(length) / outputSize;
+    const int taps = std::min((int)ceil(scale) + 1, (int)inputSize);
+    table->taps = taps;
+    table->first.resize(outputSize);
+    table->weights.assign(outputSize * taps, 0.0f);
+    for (size_t i = 0; i < outputSize; i++) {
+        const double left = start + i * scale;
+        const double right = std::min(start + (i + 1) * scale, (double)inputSize);
+        const int first = std::min((int)left, (int)inputSize - taps);
+        float* weights = &table->weights[i * taps];
+        for (int k = 0; k < taps; k++) {
+            const int j = first + k;
+            const double covered = std::min(right, j + 1.0) - std::max(left, (double)j);
+            if (covered > 0) {
+                weights[k] = covered / scale;
+            }
+        }
+        table->first[i] = first;
+    }
+    BuildFixedWeights(table);
 }
-#else
-static float cubicInterpolate(float p0,float p1,float p2,float p3 , float x) {
-    //ALOGI("CP, %f, %f, %f, %f, %f", p0, p1, p2, p3, x);
-    return p1 + 0.5f * x * (p2 - p0 + x * (2.f * p0 - 5.f * p1 + 4.f * p2 - p3
-            + x * (3.f * (p1 - p2) + p3 - p0)));
+
+/**
+ * Computes the single tap of each output pixel of the nearest neighbor filter, the input pixel
+ * under the center of the output pixel.
+ *
+ * @param table The table to fill.
+ * @param inputSize The number of input pixels along the axis.
+ * @param start Where the resampled range starts, in input pixels.
+ * @param length The length of the resampled range, in input pixels.
+ * @param outputSize The number of output pixels along the axis.
+ */
+static void BuildNearestTable(ResampleTable* table, size_t inputSize, float start, float length,
+                              size_t outputSize) {
+    const double scale = static_cast<double>(length) / outputSize;
+    table->taps = 1;
+    table->first.resize(outputSize);
+    table->weights.assign(outputSize, 1.0f);
+    table->fixedWeights.assign(outputSize, 1 << kFixedWeightBits);
+    for (size_t i = 0; i < outputSize; i++) {
+        table->first[i] = std::min((int)(start + (i + 0.5) * scale), (int)inputSize - 1);
+    }
 }
-#endif
 
-static uchar4 OneBiCubic(const uchar4 *yp0, const uchar4 *yp1, const uchar4 *yp2, const uchar4 *yp3,
-                         float xf, float yf, int width) {
-    int startx = (int) floor(xf - 1);
-    xf = xf - floor(xf);
-    int maxx = width - 1;
-    int xs0 = std::max(0, startx + 0);
-    int xs1 = std::max(0, startx + 1);
-    int xs2 = std::min(maxx, startx + 2);
-    int xs3 = std::min(maxx, startx + 3);
-
-    float4 p0  = cubicInterpolate(convert<float4>(yp0[xs0]),
-                                  convert<float4>(yp0[xs1]),
-                                  convert<float4>(yp0[xs2]),
-                                  convert<float4>(yp0[xs3]), xf);
-
-    float4 p1  = cubicInterpolate(convert<float4>(yp1[xs0]),
-                                  convert<float4>(yp1[xs1]),
-                                  convert<float4>(yp1[xs2]),
-                                  convert<float4>(yp1[xs3]), xf);
-
-    float4 p2  = cubicInterpolate(convert<float4>(yp2[xs0]),
-                                  convert<float4>(yp2[xs1]),
-                                  convert<float4>(yp2[xs2]),
-                                  convert<float4>(yp2[xs3]), xf);
-
-    float4 p3  = cubicInterpolate(convert<float4>(yp3[xs0]),
-                                  convert<float4>(yp3[xs1]),
-                                  convert<float4>(yp3[xs2]),
-                                  convert<float4>(yp3[xs3]), xf);
-
-    float4 p  = cubicInterpolate(p0, p1, p2, p3, yf);
-    p = clamp(p + 0.5f, 0.f, 255.f);
-    return convert<uchar4>(p);
-}
-
-static uchar2 OneBiCubic(const uchar2 *yp0, const uchar2 *yp1, const uchar2 *yp2, const uchar2 *yp3,
-                         float xf, float yf, int width) {
-    int startx = (int) floor(xf - 1);
-    xf = xf - floor(xf);
-    int maxx = width - 1;
-    int xs0 = std::max(0, startx + 0);
-    int xs1 = std::max(0, startx + 1);
-    int xs2 = std::min(maxx, startx + 2);
-    int xs3 = std::min(maxx, startx + 3);
-
-    float2 p0  = cubicInterpolate(convert<float2>(yp0[xs0]),
-                                  convert<float2>(yp0[xs1]),
-                                  convert<float2>(yp0[xs2]),
-                                  convert<float2>(yp0[xs3]), xf);
-
-    float2 p1  = cubicInterpolate(convert<float2>(yp1[xs0]),
-                                  convert<float2>(yp1[xs1]),
-                                  convert<float2>(yp1[xs2]),
-                                  convert<float2>(yp1[xs3]), xf);
-
-    float2 p2  = cubicInterpolate(convert<float2>(yp2[xs0]),
-                                  convert<float2>(yp2[xs1]),
-                                  convert<float2>(yp2[xs2]),
-                                  convert<float2>(yp2[xs3]), xf);
-
-    float2 p3  = cubicInterpolate(convert<float2>(yp3[xs0]),
-                                  convert<float2>(yp3[xs1]),
-                                  convert<float2>(yp3[xs2]),
-                                  convert<float2>(yp3[xs3]), xf);
-
-    float2 p  = cubicInterpolate(p0, p1, p2, p3, yf);
-    p = clamp(p + 0.5f, 0.f, 255.f);
-    return convert<uchar2>(p);
-}
-
-static uchar OneBiCubic(const uchar *yp0, const uchar *yp1, const uchar *yp2, const uchar *yp3,
-                        float xf, float yf, int width) {
-    int startx = (int) floor(xf - 1);
-    xf = xf - floor(xf);
-    int maxx = width - 1;
-    int xs0 = std::max(0, startx + 0);
-    int xs1 = std::max(0, startx + 1);
-    int xs2 = std::min(maxx, startx + 2);
-    int xs3 = std::min(maxx, startx + 3);
-
-    float p0  = cubicInterpolate((float)yp0[xs0], (float)yp0[xs1],
-                                 (float)yp0[xs2], (float)yp0[xs3], xf);
-    float p1  = cubicInterpolate((float)yp1[xs0], (float)yp1[xs1],
-                                 (float)yp1[xs2], (float)yp1[xs3], xf);
-    float p2  = cubicInterpolate((float)yp2[xs0], (float)yp2[xs1],
-                                 (float)yp2[xs2], (float)yp2[xs3], xf);
-    float p3  = cubicInterpolate((float)yp3[xs0], (float)yp3[xs1],
-                                 (float)yp3[xs2], (float)yp3[xs3], xf);
-
-    float p  = cubicInterpolate(p0, p1, p2, p3, yf);
-    p = clamp(p + 0.5f, 0.f, 255.f);
-    //ALOGI("CUC,%f,%u", p, (uchar)p);
-    return (uchar)p;
+/**
+ * Computes the taps of one axis for the filter, over the input pixels from start to
+ * start + length. Lanczos3 is stretched over the output pixels when downscaling. Nearest always
+ * samples a single pixel. The other filters switch to the area filter from kAreaScale on, as
+ * their few taps would skip input pixels.
+ */
+static void BuildFilterTable(ResampleTable* table, size_t inputSize, float start, float length,
+                             size_t outputSize, ResizeFilter filter) {
+    const float scale = length / outputSize;
+    switch (filter) {
+        case ResizeFilter::Nearest:
+            BuildNearestTable(table, inputSize, start, length, outputSize);
+            return;
+        case ResizeFilter::Lanczos3:
+            BuildResampleTable(table, inputSize, start, length, outputSize, Lanczos3, 3,
+                               std::max(scale, 1.0f));
+            return;
+        default:
+            break;
+    }
+    if (scale >= kAreaScale) {
+        BuildAreaTable(table, inputSize, start, length, outputSize);
+        return;
+    }
+    switch (filter) {
+        case ResizeFilter::Bilinear:
+            BuildResampleTable(table, inputSize, start, length, outputSize, Triangle, 1, 1.0f);
+            break;
+        case ResizeFilter::Mitchell:
+            BuildResampleTable(table, inputSize, start, length, outputSize, Mitchell, 2, 1.0f);
+            break;
+        default:
+            BuildResampleTable(table, inputSize, start, length, outputSize, CatmullRom, 2, 1.0f);
+            break;
+    }
 }
 
 extern "C" uint64_t rsdIntrinsicResize_oscctl_K(uint32_t xinc);
@@ -263,6 +329,80 @@ extern "C" void rsdIntrinsicResizeB1_K(
             int32_t const *yr);
 
 #if defined(ARCH_ARM_USE_INTRINSICS)
+/**
+ * The arguments of the assembly kernels that resize a row of 1, 2 or 4 byte cells.
+ */
+template <typename InVector>
+using AssemblyResizeKernel = void (*)(InVector*, size_t, uint32_t, uint32_t, InVector const*,
+                                      InVector const*, InVector const*, InVector const*, size_t,
+                                      size_t, uint64_t, int32_t const*);
+#endif
+
+#if defined(ARCH_X86_HAVE_SSSE3)
+extern void rsdIntrinsicResizeVU_K(void* dst, const void* const* rows, const void* coefficients,
+                                   int count);
+extern void rsdIntrinsicResizeHU4_K(void* dst, const void* row, const int* taps,
+                                    const void* coefficients, int count);
+extern void rsdIntrinsicResizeHU3_K(void* dst, const void* row, const int* taps,
+                                    const void* coefficients, int count);
+extern void rsdIntrinsicResizeHU2_K(void* dst, const void* row, const int* taps,
+                                    const void* coefficients, int count);
+extern void rsdIntrinsicResizeHU1_K(void* dst, const void* row, const int* taps,
+                                    const void* coefficients, int count);
+extern void rsdIntrinsicResizeVUAvx2_K(void* dst, const void* const* rows,
+                                       const void* coefficients, int count);
+extern void rsdIntrinsicResizeHU4Avx2_K(void* dst, const void* row, const int* taps,
+                                        const void* coefficients, int count);
+extern void rsdIntrinsicResizeHU3Avx2_K(void* dst, const void* row, const int* taps,
+                                        const void* coefficients, int count);
+extern void rsdIntrinsicResizeHU2Avx2_K(void* dst, const void* row, const int* taps,
+                                        const void* coefficients, int count);
+extern void rsdIntrinsicResizeHU1Avx2_K(void* dst, const void* row, const int* taps,
+                                        const void* coefficients, int count);
+extern void rsdIntrinsicHalveU_K(void* dst, const void* row0, const void* row1, int cellSize,
+                                 int count);
+extern void rsdIntrinsicHalveUAvx2_K(void* dst, const void* row0, const void* row1,
+                                     int cellSize, int count);
+
+/**
+ * The x86 kernels of the fixed point bicubic. The AVX2 variants have the same signature and
+ * results as the SSSE3 ones. There are no AVX-512 variants; the AVX2 ones are used instead.
+ */
+struct X86ResizeKernels {
+    decltype(&rsdIntrinsicResizeVU_K) vertical;
+    decltype(&rsdIntrinsicResizeHU4_K) horizontalU4;
+    decltype(&rsdIntrinsicResizeHU3_K) horizontalU3;
+    decltype(&rsdIntrinsicResizeHU2_K) horizontalU2;
+    decltype(&rsdIntrinsicResizeHU1_K) horizontalU1;
+};
+
+static X86ResizeKernels selectX86ResizeKernels(X86Extension extension) {
+    if (extension == X86Extension::None) {
+        return {rsdIntrinsicResizeVU_K, rsdIntrinsicResizeHU4_K, rsdIntrinsicResizeHU3_K,
+                rsdIntrinsicResizeHU2_K, rsdIntrinsicResizeHU1_K};
+    }
+    return {rsdIntrinsicResizeVUAvx2_K, rsdIntrinsicResizeHU4Avx2_K, rsdIntrinsicResizeHU3Avx2_K,
+            rsdIntrinsicResizeHU2Avx2_K, rsdIntrinsicResizeHU1Avx2_K};
+}
+#endif
+
+#if defined(ARCH_ARM_USE_INTRINSICS) || defined(ARCH_X86_HAVE_SSSE3)
+/**
+ * Where output pixel x samples the input along an axis, as the index of the input pixel and
+ * the fraction past it in 1/65536 of a pixel, i.e. in the 16.16 fixed point of the bicubic
+ * kernels. The output starts at origin in the input. It's computed in double, where the
+ * product and the subtraction are exact, so that the result doesn't depend on whether the
+ * compiler fuses them.
+ */
+static int64_t FixedPointPosition(uint32_t x, float scale, float origin) {
+    return llrint((origin + ((x + 0.5) * scale - 0.5)) * 0x10000);
+}
+
+/**
+ * The coefficients of the vertical taps of the fixed point bicubic, for a sample that is
+ * fraction of a pixel past the second tap. They are unsigned 16 bit fixed point. The first and
+ * last taps are negative; the kernels subtract them.
+ */
 static void mkYCoeff(int32_t *yr, float yf) {
     int32_t yf1 = rint(yf * 0x10000);
     int32_t yf2 = rint(yf * yf * 0x10000);
@@ -273,482 +413,1494 @@ static void mkYCoeff(int32_t *yr, float yf) {
     yr[2] = (-3 * yf3 + 4 * yf2 + yf1) >> 1;
     yr[3] = -(yf3 - yf2) >> 1;
 }
+
+/**
+ * The 4 input rows of the vertical taps of the fixed point bicubic for output row y, clamped to
+ * the image, and their coefficients.
+ */
+static void FixedPointRows(uint32_t y, float scale, float origin, size_t inputSize, int* rows,
+                           int32_t* yr) {
+    const int64_t y16 = FixedPointPosition(y, scale, origin);
+    const int start = (int)(y16 >> 16) - 1;
+    for (int k = 0; k < 4; k++) {
+        rows[k] = clamp(start + k, 0, (int)inputSize - 1);
+    }
+    mkYCoeff(yr, (y16 & 0xffff) / 65536.0f);
+}
 #endif
 
-#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_SUPPORTS_FLOAT
-static float4 OneBiCubic(const float4 *yp0, const float4 *yp1, const float4 *yp2, const float4 *yp3,
-                         float xf, float yf, int width) {
-    int startx = (int) floor(xf - 1);
-    xf = xf - floor(xf);
-    int maxx = width - 1;
-    int xs0 = std::max(0, startx + 0);
-    int xs1 = std::max(0, startx + 1);
-    int xs2 = std::min(maxx, startx + 2);
-    int xs3 = std::min(maxx, startx + 3);
-
-    float4 p0  = cubicInterpolate(yp0[xs0], yp0[xs1],
-                                  yp0[xs2], yp0[xs3], xf);
-    float4 p1  = cubicInterpolate(yp1[xs0], yp1[xs1],
-                                  yp1[xs2], yp1[xs3], xf);
-    float4 p2  = cubicInterpolate(yp2[xs0], yp2[xs1],
-                                  yp2[xs2], yp2[xs3], xf);
-    float4 p3  = cubicInterpolate(yp3[xs0], yp3[xs1],
-                                  yp3[xs2], yp3[xs3], xf);
-
-    float4 p  = cubicInterpolate(p0, p1, p2, p3, yf);
-    return p;
-}
-
-static float2 OneBiCubic(const float2 *yp0, const float2 *yp1, const float2 *yp2, const float2 *yp3,
-                         float xf, float yf, int width) {
-    int startx = (int) floor(xf - 1);
-    xf = xf - floor(xf);
-    int maxx = width - 1;
-    int xs0 = std::max(0, startx + 0);
-    int xs1 = std::max(0, startx + 1);
-    int xs2 = std::min(maxx, startx + 2);
-    int xs3 = std::min(maxx, startx + 3);
-
-    float2 p0  = cubicInterpolate(yp0[xs0], yp0[xs1],
-                                  yp0[xs2], yp0[xs3], xf);
-    float2 p1  = cubicInterpolate(yp1[xs0], yp1[xs1],
-                                  yp1[xs2], yp1[xs3], xf);
-    float2 p2  = cubicInterpolate(yp2[xs0], yp2[xs1],
-                                  yp2[xs2], yp2[xs3], xf);
-    float2 p3  = cubicInterpolate(yp3[xs0], yp3[xs1],
-                                  yp3[xs2], yp3[xs3], xf);
-
-    float2 p  = cubicInterpolate(p0, p1, p2, p3, yf);
-    return p;
-}
-
-static float OneBiCubic(const float *yp0, const float *yp1, const float *yp2, const float *yp3,
-                        float xf, float yf, int width) {
-    int startx = (int) floor(xf - 1);
-    xf = xf - floor(xf);
-    int maxx = width - 1;
-    int xs0 = std::max(0, startx + 0);
-    int xs1 = std::max(0, startx + 1);
-    int xs2 = std::min(maxx, startx + 2);
-    int xs3 = std::min(maxx, startx + 3);
-
-    float p0  = cubicInterpolate(yp0[xs0], yp0[xs1],
-                                 yp0[xs2], yp0[xs3], xf);
-    float p1  = cubicInterpolate(yp1[xs0], yp1[xs1],
-                                 yp1[xs2], yp1[xs3], xf);
-    float p2  = cubicInterpolate(yp2[xs0], yp2[xs1],
-                                 yp2[xs2], yp2[xs3], xf);
-    float p3  = cubicInterpolate(yp3[xs0], yp3[xs1],
-                                 yp3[xs2], yp3[xs3], xf);
-
-    float p  = cubicInterpolate(p0, p1, p2, p3, yf);
-    return p;
+#if defined(ARCH_X86_HAVE_SSSE3)
+/**
+ * The coefficients of the horizontal taps of the fixed point bicubic, computed the way the
+ * assembly kernels of ARM do, for a sample that is fraction / 65536 of a pixel past the second
+ * tap. They are signed 16 bit fixed point with 15 fractional bits, stored in the order the x86
+ * kernels use them, i.e. for taps 0, 3, 1 and 2. Those of taps 1 and 2 are negated and the
+ * kernels subtract them, which keeps a coefficient of 1 within 16 bits, as -1.
+ */
+static void FixedBicubicCoefficients(uint32_t fraction, short* coefficients) {
+    const int t = (fraction & 0xffff) >> 1;
+    const int t2 = (t * t + (1 << 14)) >> 15;
+    const int t3 = (t2 * t + (1 << 14)) >> 15;
+    const int a = 4 * t2 - 3 * t3;
+    coefficients[0] = (short)(t2 - ((t3 + t) >> 1));
+    coefficients[1] = (short)((t3 - t2) >> 1);
+    coefficients[2] = (short)(((a + t2) >> 1) - 0x8000);
+    coefficients[3] = (short)-((a + t) >> 1);
 }
 #endif
 
-void ResizeTask::kernelU4(uchar *outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY) {
-    const uchar *pin = mIn;
-    const int srcHeight = mInputSizeY;
-    const int srcWidth = mInputSizeX;
-    const size_t stride = mInputSizeX * paddedSize(mVectorSize);
+// Cells of packed RGB, of half floats and of floats, for the copies of copyNearest. Unlike the
+// vector types, they only need the alignment of their channels.
+struct PackedRgb {
+    uchar r, g, b;
+};
+struct PackedRgbaF16 {
+    uint16_t r, g, b, a;
+};
+struct PackedRgbaF32 {
+    float r, g, b, a;
+};
 
+/**
+ * The model input tensor a ResizeTask fills rather than an image, see resizeToTensor: planes of
+ * R, G and B, one after the other, of mSizeX * mSizeY values each.
+ */
+struct TensorOutput {
+    TensorType type;
+    float scale[3];
+    float bias[3];
+};
 
-#if defined(ARCH_X86_HAVE_AVX2)
-    float yf = _mm_cvtss_f32(_mm_fmsub_ss(_mm_set1_ps(currentY + 0.5f),
-                                          _mm_set1_ps(scaleY), _mm_set1_ps(0.5f)));
-#else
-    float yf = (currentY + 0.5f) * mScaleY - 0.5f;
-#endif
+/**
+ * The number of bytes of each cell of a ResizeTask, see its constructor.
+ */
+static size_t CellSize(PixelFormat format, size_t vectorSize) {
+    switch (format) {
+        case PixelFormat::Rgb888:
+            return 3;
+        case PixelFormat::RgbaF16:
+            return 8;
+        case PixelFormat::RgbaF32:
+            return 16;
+        default:
+            return paddedSize(vectorSize);
+    }
+}
 
+/**
+ * Resizes an image with a separable filter. Each source row that contributes to the output is
+ * first resampled horizontally, once, into a ring of rows kept by each thread. The output rows
+ * are then the weighted sums of the rows of the ring. As the output rows of a band go down, the
+ * source rows they need only move down, so each one is resampled once per band.
+ *
+ * The taps depend on the filter, see BuildFilterTable. When the weights of both axes are all
+ * positive, the passes are done in fixed point, see resampleRowsFixed. When both axes have a
+ * single tap, the output pixels are copies of input pixels, see copyNearest. With SIMD, the
+ * Catmull-Rom filter is computed by the fixed point bicubic kernels, see kernelAssembly and
+ * resampleRowsX86. Pixels that are unpremultiplied or mixed in linear light always take the
+ * float path, see resampleRowsDecoded, unless they are copied.
+ *
+ * Cells of 3 bytes are either padded to 4, as in RenderScript, or packed, as decoders return
+ * RGB. Packed cells go through the same passes with 3 channels, except that the float path
+ * expands them to 4 as it reads them, and that there are no ARM assembly kernels for them.
+ *
+ * Cells of RgbaF16 and RgbaF32 always take the float path, which mixes their values as they
+ * are, without clamping them, or copy their pixels.
+ *
+ * When the output is a tensor, the pixels are stored in its planes rather than encoded, see
+ * StoreTensorPlanes. They take the fixed point passes, whose output rows are stored in the
+ * planes as they're resampled, or the float path otherwise, which stores them before they are
+ * rounded.
+ */
+class ResizeTask : public Task {
+    const uchar* mIn;
+    uchar* mOut;
+    // How many input pixels each output pixel spans, and where the output starts in the input.
+    float mScaleX;
+    float mScaleY;
+    float mOriginX;
+    float mOriginY;
+    size_t mInputSizeX;
+    size_t mInputSizeY;
+    // The number of bytes of each cell, 3 when they are packed RGB, 8 and 16 for half floats and
+    // floats.
+    size_t mCellSize;
+    // Whether the cells are RgbaF16 or RgbaF32.
+    bool mFloats;
+    // When not null, the output is this tensor rather than an image of the format of the input.
+    const TensorOutput* mTensor;
+    ResizeFilter mFilter;
+    // Whether the cells are unpremultiplied RGBA, which is premultiplied to be mixed. Only for
+    // cells of 4 bytes.
+    bool mUnpremultiplied;
+    // Whether the color channels are mixed in linear light. Only for cells of 3 and 4 bytes.
+    // Float cells are mixed as they are.
+    bool mLinear;
+    // The taps of the horizontal and of the vertical pass.
+    ResampleTable mTableX;
+    ResampleTable mTableY;
+    // Whether both passes have fixed point weights.
+    bool mUsesFixedPoint;
+    // The ring of each thread, mTableY.taps horizontally resampled source rows indexed by the
+    // source row, followed by a row to accumulate the vertical pass. mRingTags holds the source
+    // row in each slot. All the bands cover the same columns, so a thread that does several
+    // bands can reuse the rows they share.
+    ScratchBuffers mRings;
+    std::vector<int> mRingTags;
 
-    int starty = (int) floor(yf - 1);
-    yf = yf - floor(yf);
-    int maxy = srcHeight - 1;
-    int ys0 = std::max(0, starty + 0);
-    int ys1 = std::max(0, starty + 1);
-    int ys2 = std::min(maxy, starty + 2);
-    int ys3 = std::min(maxy, starty + 3);
+#if defined(ARCH_ARM_USE_INTRINSICS)
+    template <typename InVector>
+    void kernelAssembly(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
+                        AssemblyResizeKernel<InVector> kernel);
+#endif
 
-    const uchar4 *yp0 = (const uchar4 *)(pin + stride * ys0);
-    const uchar4 *yp1 = (const uchar4 *)(pin + stride * ys1);
-    const uchar4 *yp2 = (const uchar4 *)(pin + stride * ys2);
-    const uchar4 *yp3 = (const uchar4 *)(pin + stride * ys3);
+    template <typename InVector, typename FloatVector>
+    void resampleRows(int threadIndex, size_t startX, size_t startY, size_t endX, size_t endY);
+    template <bool kOpaque, bool kUnpremultiplied, bool kLinear,
+              PixelFormat kFormat = PixelFormat::Rgba8888>
+    void resampleRowsDecoded(int threadIndex, size_t startX, size_t startY, size_t endX,
+                             size_t endY);
+    template <int kChannels>
+    void resampleRowsFixed(int threadIndex, size_t startX, size_t startY, size_t endX,
+                           size_t endY);
+    template <typename InVector>
+    void copyNearest(size_t startX, size_t startY, size_t endX, size_t endY);
+#if defined(ARCH_X86_HAVE_SSSE3)
+    void resampleRowsX86(int threadIndex, size_t startX, size_t startY, size_t endX, size_t endY);
+#endif
 
-    uchar4 *out = ((uchar4 *)outPtr);
-    uint32_t x1 = xstart;
-    uint32_t x2 = xend;
+    // Process a 2D tile of the overall work. threadIndex identifies which thread does the work.
+    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                     size_t endY) override;
 
+   public:
+    /**
+     * With format Rgba8888, the cells are vectorSize bytes padded as in RenderScript. With
+     * Rgb888, they are packed RGB, and with RgbaF16 and RgbaF32, RGBA floats. vectorSize is
+     * then 3 or 4, the number of channels. When tensor is not null, the input is RGBA and the
+     * output is the tensor.
+     */
+    ResizeTask(const uchar* input, uchar* output, size_t inputSizeX, size_t inputSizeY,
+               size_t vectorSize, PixelFormat format, const RectF& source, size_t outputSizeX,
+               size_t outputSizeY, ResizeFilter filter, AlphaType alphaType,
+               ColorSpace colorSpace, uint32_t threadCount, const Restriction* restriction,
+               const TensorOutput* tensor = nullptr)
+        : Task{outputSizeX, outputSizeY, vectorSize, false, restriction},
+          mIn{input},
+          mOut{output},
+          mInputSizeX{inputSizeX},
+          mInputSizeY{inputSizeY},
+          mCellSize{CellSize(format, vectorSize)},
+          mFloats{format == PixelFormat::RgbaF16 || format == PixelFormat::RgbaF32},
+          mTensor{tensor},
+          mFilter{filter},
+          mUnpremultiplied{alphaType == AlphaType::Unpremultiplied && vectorSize == 4},
+          mLinear{colorSpace == ColorSpace::Linear && paddedSize(vectorSize) == 4 && !mFloats},
+          mRings{threadCount} {
+        mCellSizeInBytes = mCellSize;
+        const float lengthX = source.endX - source.startX;
+        const float lengthY = source.endY - source.startY;
+        mScaleX = lengthX / outputSizeX;
+        mScaleY = lengthY / outputSizeY;
+        mOriginX = source.startX;
+        mOriginY = source.startY;
+        BuildFilterTable(&mTableX, mInputSizeX, source.startX, lengthX, outputSizeX, mFilter);
+        BuildFilterTable(&mTableY, mInputSizeY, source.startY, lengthY, outputSizeY, mFilter);
+        // The converted values need more precision than the fixed point passes keep.
+        mUsesFixedPoint = !mUnpremultiplied && !mLinear && !mFloats &&
+                          !mTableX.fixedWeights.empty() && !mTableY.fixedWeights.empty();
+        mBandCount = threadCount;
+        mRingTags.resize(threadCount * mTableY.taps, INT_MIN);
+    }
+};
+
+void ResizeTask::processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                             size_t endY) {
+#if defined(ARCH_ARM_USE_INTRINSICS) || defined(ARCH_X86_HAVE_SSSE3)
+    // The assembly kernels compute the bicubic directly in fixed point, so we only use them
+    // for the Catmull-Rom filter when neither axis uses the area filter. The x86 kernels match
+    // their results bit for bit.
+    const bool usesFixedBicubic = mUsesSimd && !mUnpremultiplied && !mLinear && !mFloats &&
+                                  mTensor == nullptr && mFilter == ResizeFilter::CatmullRom &&
+                                  mScaleX < kAreaScale && mScaleY < kAreaScale;
+#endif
 #if defined(ARCH_ARM_USE_INTRINSICS)
-    if (mUsesSimd && x2 > x1 && mScaleX < 4.0f) {
-        float xf = (x1 + 0.5f) * mScaleX - 0.5f;
-        long xf16 = rint(xf * 0x10000);
-        uint32_t xinc16 = rint(mScaleX * 0x10000);
+    if (usesFixedBicubic && mCellSize != 3) {
+        for (size_t y = startY; y < endY; y++) {
+            uchar* out = mOut + (mSizeX * y + startX) * mCellSize;
+            switch (mVectorSize) {
+                case 4:
+                case 3:
+                    kernelAssembly<uchar4>(out, startX, endX, y, rsdIntrinsicResizeB4_K);
+                    break;
+                case 2:
+                    kernelAssembly<uchar2>(out, startX, endX, y, rsdIntrinsicResizeB2_K);
+                    break;
+                default:
+                    kernelAssembly<uchar>(out, startX, endX, y, rsdIntrinsicResizeB1_K);
+                    break;
+            }
+        }
+        return;
+    }
+#endif
+#if defined(ARCH_X86_HAVE_SSSE3)
+    if (usesFixedBicubic) {
+        resampleRowsX86(threadIndex, startX, startY, endX, endY);
+        return;
+    }
+#endif
 
-        int xoff = (xf16 >> 16) - 1;
-        int xclip = std::max(0, xoff) - xoff;
-        int len = x2 - x1;
+    if (mTableX.taps == 1 && mTableY.taps == 1 && mTensor == nullptr) {
+        switch (mCellSize) {
+            case 16:
+                copyNearest<PackedRgbaF32>(startX, startY, endX, endY);
+                break;
+            case 8:
+                copyNearest<PackedRgbaF16>(startX, startY, endX, endY);
+                break;
+            case 4:
+                copyNearest<uchar4>(startX, startY, endX, endY);
+                break;
+            case 3:
+                copyNearest<PackedRgb>(startX, startY, endX, endY);
+                break;
+            case 2:
+                copyNearest<uchar2>(startX, startY, endX, endY);
+                break;
+            default:
+                copyNearest<uchar>(startX, startY, endX, endY);
+                break;
+        }
+        return;
+    }
 
-        int32_t yr[4];
-        uint64_t osc_ctl = rsdIntrinsicResize_oscctl_K(xinc16);
-        mkYCoeff(yr, yf);
+    if (mUsesFixedPoint) {
+        switch (mCellSize) {
+            case 4:
+                resampleRowsFixed<4>(threadIndex, startX, startY, endX, endY);
+                break;
+            case 3:
+                resampleRowsFixed<3>(threadIndex, startX, startY, endX, endY);
+                break;
+            case 2:
+                resampleRowsFixed<2>(threadIndex, startX, startY, endX, endY);
+                break;
+            default:
+                resampleRowsFixed<1>(threadIndex, startX, startY, endX, endY);
+                break;
+        }
+        return;
+    }
+
+    if (mTensor != nullptr) {
+        // The tensor has no alpha, so premultiplied pixels are mixed as they are, like opaque
+        // ones.
+        if (mUnpremultiplied) {
+            resampleRowsDecoded<false, true, false>(threadIndex, startX, startY, endX, endY);
+        } else {
+            resampleRowsDecoded<true, false, false>(threadIndex, startX, startY, endX, endY);
+        }
+        return;
+    }
+    constexpr PixelFormat kRgb888 = PixelFormat::Rgb888;
+    constexpr PixelFormat kRgbaF16 = PixelFormat::RgbaF16;
+    constexpr PixelFormat kRgbaF32 = PixelFormat::RgbaF32;
+    if (mCellSize == 3) {
+        if (mLinear) {
+            resampleRowsDecoded<true, false, true, kRgb888>(threadIndex, startX, startY, endX,
+                                                            endY);
+        } else {
+            resampleRowsDecoded<true, false, false, kRgb888>(threadIndex, startX, startY, endX,
+                                                             endY);
+        }
+        return;
+    }
+    if (mFloats) {
+        const bool halves = mCellSize == 8;
+        if (mUnpremultiplied && halves) {
+            resampleRowsDecoded<false, true, false, kRgbaF16>(threadIndex, startX, startY, endX,
+                                                              endY);
+        } else if (mUnpremultiplied) {
+            resampleRowsDecoded<false, true, false, kRgbaF32>(threadIndex, startX, startY, endX,
+                                                              endY);
+        } else if (halves) {
+            resampleRowsDecoded<false, false, false, kRgbaF16>(threadIndex, startX, startY, endX,
+                                                               endY);
+        } else {
+            resampleRowsDecoded<false, false, false, kRgbaF32>(threadIndex, startX, startY, endX,
+                                                               endY);
+        }
+        return;
+    }
+    switch (mVectorSize) {
+        case 4:
+            if (mUnpremultiplied && mLinear) {
+                resampleRowsDecoded<false, true, true>(threadIndex, startX, startY, endX, endY);
+            } else if (mUnpremultiplied) {
+                resampleRowsDecoded<false, true, false>(threadIndex, startX, startY, endX, endY);
+            } else if (mLinear) {
+                resampleRowsDecoded<false, false, true>(threadIndex, startX, startY, endX, endY);
+            } else {
+                resampleRows<uchar4, float4>(threadIndex, startX, startY, endX, endY);
+            }
+            break;
+        case 3:
+            if (mLinear) {
+                resampleRowsDecoded<true, false, true>(threadIndex, startX, startY, endX, endY);
+            } else {
+                resampleRows<uchar4, float4>(threadIndex, startX, startY, endX, endY);
+            }
+            break;
+        case 2:
+            resampleRows<uchar2, float2>(threadIndex, startX, startY, endX, endY);
+            break;
+        case 1:
+            resampleRows<uchar, float>(threadIndex, startX, startY, endX, endY);
+            break;
+        default:
+            ALOGE("Bad vector size %zd", mVectorSize);
+    }
+}
 
-        xoff += xclip;
+/**
+ * Resample one source row horizontally.
+ *
+ * @param in The source row.
+ * @param out Where to store the xend - xstart resampled pixels.
+ * @param table The taps of the horizontal pass.
+ * @param xstart The index of the first output pixel.
+ * @param xend The end index of the output pixels.
+ */
+template <typename InVector, typename FloatVector>
+static void ResampleRow(const InVector* in, FloatVector* out, const ResampleTable& table,
+                        size_t xstart, size_t xend) {
+    const int taps = table.taps;
+    if (taps == 4) {
+        // The bicubic filter, which most resizes use, unrolled.
+        for (size_t x = xstart; x < xend; x++) {
+            const InVector* p = in + table.first[x];
+            const float* weights = &table.weights[x * 4];
+            out[x - xstart] = weights[0] * convert<FloatVector>(p[0]) +
+                              weights[1] * convert<FloatVector>(p[1]) +
+                              weights[2] * convert<FloatVector>(p[2]) +
+                              weights[3] * convert<FloatVector>(p[3]);
+        }
+        return;
+    }
+    for (size_t x = xstart; x < xend; x++) {
+        const InVector* p = in + table.first[x];
+        const float* weights = &table.weights[x * taps];
+        FloatVector sum = 0;
+        for (int k = 0; k < taps; k++) {
+            sum += weights[k] * convert<FloatVector>(p[k]);
+        }
+        out[x - xstart] = sum;
+    }
+}
 
-        rsdIntrinsicResizeB4_K(
-                out, len,
-                xf16 & 0xffff, xinc16,
-                yp0 + xoff, yp1 + xoff, yp2 + xoff, yp3 + xoff,
-                xclip, srcWidth - xoff + xclip,
-                osc_ctl, yr);
-        out += len;
-        x1 += len;
+template <typename InVector, typename FloatVector>
+void ResizeTask::resampleRows(int threadIndex, size_t startX, size_t startY, size_t endX,
+                              size_t endY) {
+    const size_t count = endX - startX;
+    const int slots = mTableY.taps;
+    FloatVector* ring =
+            (FloatVector*)mRings.get(threadIndex, (slots + 1) * count * sizeof(FloatVector));
+    if (ring == nullptr) {
+        return;
     }
-#endif
+    FloatVector* acc = ring + slots * count;
+    int* tags = mRingTags.data() + threadIndex * slots;
+    const InVector* in = (const InVector*)mIn;
 
-    while(x1 < x2) {
-#if defined(ARCH_X86_HAVE_AVX2)
-        float xf = _mm_cvtss_f32(_mm_fmsub_ss(_mm_set1_ps(x1 + 0.5f) , _mm_set1_ps(scaleX) ,
-                                              _mm_set1_ps(0.5f)));
-#else
-        float xf = (x1 + 0.5f) * mScaleX - 0.5f;
-#endif
-        *out = OneBiCubic(yp0, yp1, yp2, yp3, xf, yf, srcWidth);
-        out++;
-        x1++;
+    for (size_t y = startY; y < endY; y++) {
+        const int first = mTableY.first[y];
+        const float* weights = &mTableY.weights[y * slots];
+        for (int k = 0; k < slots; k++) {
+            const int sourceY = first + k;
+            const int slot = sourceY % slots;
+            FloatVector* row = ring + slot * count;
+            if (tags[slot] != sourceY) {
+                ResampleRow(in + mInputSizeX * sourceY, row, mTableX, startX, endX);
+                tags[slot] = sourceY;
+            }
+            const float weight = weights[k];
+            if (k == 0) {
+                for (size_t x = 0; x < count; x++) {
+                    acc[x] = weight * row[x];
+                }
+            } else {
+                for (size_t x = 0; x < count; x++) {
+                    acc[x] += weight * row[x];
+                }
+            }
+        }
+        InVector* out = (InVector*)(mOut + (mSizeX * y + startX) * mCellSize);
+        for (size_t x = 0; x < count; x++) {
+            out[x] = convert<InVector>(clamp(acc[x] + 0.5f, 0.f, 255.f));
+        }
     }
 }
 
-void ResizeTask::kernelU2(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY) {
-    const uchar *pin = mIn;
-    const int srcHeight = mInputSizeY;
-    const int srcWidth = mInputSizeX;
-    const size_t stride = mInputSizeX * mVectorSize;
+/**
+ * Reads the cell x of a row and converts it to the space it's mixed in, see resampleRowsDecoded.
+ * Packed RGB is expanded to 4 channels. RgbaF16 and RgbaF32 are read as they are, and only
+ * premultiplied when kUnpremultiplied is set.
+ */
+template <bool kOpaque, bool kUnpremultiplied, bool kLinear, PixelFormat kFormat>
+static inline float4 DecodeCell(const uchar* row, int x, const ColorTables& tables) {
+    if constexpr (kFormat == PixelFormat::RgbaF16 || kFormat == PixelFormat::RgbaF32) {
+        float4 f;
+        if constexpr (kFormat == PixelFormat::RgbaF16) {
+            uint16_t h[4];
+            memcpy(h, row + x * 8, sizeof(h));
+            f = float4{halfToFloat(h[0]), halfToFloat(h[1]), halfToFloat(h[2]),
+                       halfToFloat(h[3])};
+        } else {
+            memcpy(&f, row + x * 16, sizeof(f));
+        }
+        if (kUnpremultiplied) {
+            f.x *= f.w;
+            f.y *= f.w;
+            f.z *= f.w;
+        }
+        return f;
+    } else {
+        uchar4 pixel;
+        if constexpr (kFormat == PixelFormat::Rgb888) {
+            const uchar* p = row + x * 3;
+            pixel = uchar4{p[0], p[1], p[2], 255};
+        } else {
+            pixel = ((const uchar4*)row)[x];
+        }
+        if (kOpaque) {
+            pixel.w = 255;
+        }
+        return decodePixel<kOpaque || kUnpremultiplied, kLinear>(pixel, tables);
+    }
+}
 
+/**
+ * Converts a mixed pixel back to the cell x of a row, see DecodeCell. The alpha of packed RGB is
+ * dropped. RgbaF16 and RgbaF32 aren't clamped, and a pixel with no alpha is unpremultiplied to
+ * transparent black.
+ */
+template <bool kOpaque, bool kUnpremultiplied, bool kLinear, PixelFormat kFormat>
+static inline void EncodeCell(uchar* row, size_t x, float4 pixel, const ColorTables& tables) {
+    if constexpr (kFormat == PixelFormat::RgbaF16 || kFormat == PixelFormat::RgbaF32) {
+        if (kUnpremultiplied) {
+            const float inverse = pixel.w != 0.f ? 1.f / pixel.w : 0.f;
+            pixel.x *= inverse;
+            pixel.y *= inverse;
+            pixel.z *= inverse;
+        }
+        if constexpr (kFormat == PixelFormat::RgbaF16) {
+            const uint16_t h[4] = {floatToHalf(pixel.x), floatToHalf(pixel.y),
+                                   floatToHalf(pixel.z), floatToHalf(pixel.w)};
+            memcpy(row + x * 8, h, sizeof(h));
+        } else {
+            memcpy(row + x * 16, &pixel, sizeof(pixel));
+        }
+    } else {
+        // The filters with negative weights overshoot. Scaling the pixels whose alpha is above
+        // 255 down, rather than clamping each channel, keeps their color.
+        if (pixel.w > 255.f) {
+            pixel *= 255.f / pixel.w;
+        }
+        const uchar4 encoded =
+                encodePixel<kOpaque || kUnpremultiplied, kLinear>(clamp(pixel, 0.f, 255.f), tables);
+        if constexpr (kFormat == PixelFormat::Rgb888) {
+            row[x * 3] = encoded.x;
+            row[x * 3 + 1] = encoded.y;
+            row[x * 3 + 2] = encoded.z;
+        } else {
+            ((uchar4*)row)[x] = encoded;
+        }
+    }
+}
 
-#if defined(ARCH_X86_HAVE_AVX2)
-    float yf = _mm_cvtss_f32(
-            _mm_fmsub_ss(_mm_set1_ps(currentY + 0.5f), _mm_set1_ps(scaleY), _mm_set1_ps(0.5f)));
-#else
-    float yf = (currentY + 0.5f) * mScaleY - 0.5f;
-#endif
+/**
+ * Stores a row of pixels in the planes of a tensor, see TensorOutput.
+ *
+ * @param tensor The type of the values of the tensor and how they're computed.
+ * @param out The tensor.
+ * @param planeSize The number of values of each plane.
+ * @param offset Where the row starts in each plane.
+ * @param pixels The pixels, uchar4 or float4 in the [0, 255] range.
+ * @param count The number of pixels.
+ */
+template <typename Vector>
+static void StoreTensorPlanes(const TensorOutput& tensor, uchar* out, size_t planeSize,
+                              size_t offset, const Vector* pixels, size_t count) {
+    // One plane at a time, so that the loops over the values vectorize.
+    for (int c = 0; c < 3; c++) {
+        const float scale = tensor.scale[c];
+        const float bias = tensor.bias[c];
+        if (tensor.type == TensorType::Float32) {
+            float* plane = (float*)out + c * planeSize + offset;
+            for (size_t x = 0; x < count; x++) {
+                plane[x] = pixels[x][c] * scale + bias;
+            }
+        } else {
+            int8_t* plane = (int8_t*)out + c * planeSize + offset;
+            for (size_t x = 0; x < count; x++) {
+                plane[x] = (int8_t)clamp((int)lrintf(pixels[x][c] * scale + bias), -128, 127);
+            }
+        }
+    }
+}
 
-    int starty = (int) floor(yf - 1);
-    yf = yf - floor(yf);
-    int maxy = srcHeight - 1;
-    int ys0 = std::max(0, starty + 0);
-    int ys1 = std::max(0, starty + 1);
-    int ys2 = std::min(maxy, starty + 2);
-    int ys3 = std::min(maxy, starty + 3);
+/**
+ * Stores a row of mixed pixels in the planes of a tensor, see StoreTensorPlanes. They are
+ * clamped as EncodeCell does, but not rounded to bytes.
+ *
+ * @param pixels The pixels, premultiplied when kUnpremultiplied is set, which are clamped in
+ * place.
+ */
+template <bool kUnpremultiplied>
+static void StoreTensorRow(const TensorOutput& tensor, uchar* out, size_t planeSize,
+                           size_t offset, float4* pixels, size_t count) {
+    for (size_t x = 0; x < count; x++) {
+        float4 pixel = pixels[x];
+        if (pixel.w > 255.f) {
+            pixel *= 255.f / pixel.w;
+        }
+        pixel = clamp(pixel, 0.f, 255.f);
+        if (kUnpremultiplied) {
+            const float factor = pixel.w > 0.f ? 255.f / pixel.w : 0.f;
+            pixel = clamp(pixel * factor, 0.f, 255.f);
+        }
+        pixels[x] = pixel;
+    }
+    StoreTensorPlanes(tensor, out, planeSize, offset, pixels, count);
+}
 
-    const uchar2 *yp0 = (const uchar2 *)(pin + stride * ys0);
-    const uchar2 *yp1 = (const uchar2 *)(pin + stride * ys1);
-    const uchar2 *yp2 = (const uchar2 *)(pin + stride * ys2);
-    const uchar2 *yp3 = (const uchar2 *)(pin + stride * ys3);
+/**
+ * Same as resampleRows, for cells of 4 bytes that are converted to be mixed: premultiplied when
+ * kUnpremultiplied is set, so that the color of transparent pixels doesn't bleed into their
+ * neighbors, and in linear light when kLinear is set. The columns of a source row that the band
+ * reads are converted by decodePixel() as the row enters the ring, and the output pixels are
+ * converted back by encodePixel(), which unpremultiplies them with a table of reciprocals, as
+ * they are stored. No pass goes over the whole image to convert it.
+ *
+ * With kOpaque, the cells are opaque RGB padded to 4 bytes. Their padding is read as 255. With
+ * kFormat Rgb888 too, they are packed RGB of 3 bytes. With kFormat RgbaF16 or RgbaF32, they are
+ * RGBA floats, which are only premultiplied. See DecodeCell and EncodeCell.
+ */
+template <bool kOpaque, bool kUnpremultiplied, bool kLinear, PixelFormat kFormat>
+void ResizeTask::resampleRowsDecoded(int threadIndex, size_t startX, size_t startY, size_t endX,
+                                     size_t endY) {
+    const size_t count = endX - startX;
+    const int slots = mTableY.taps;
+    const int firstColumn = mTableX.first[startX];
+    const int endColumn = mTableX.first[endX - 1] + mTableX.taps;
+    float4* ring = (float4*)mRings.get(
+            threadIndex, ((slots + 1) * count + endColumn - firstColumn) * sizeof(float4));
+    if (ring == nullptr) {
+        return;
+    }
+    float4* acc = ring + slots * count;
+    float4* decoded = acc + count;
+    int* tags = mRingTags.data() + threadIndex * slots;
+    const ColorTables& tables = ColorTables::get();
 
-    uchar2 *out = ((uchar2 *)outPtr);
-    uint32_t x1 = xstart;
-    uint32_t x2 = xend;
+    for (size_t y = startY; y < endY; y++) {
+        const int first = mTableY.first[y];
+        const float* weights = &mTableY.weights[y * slots];
+        for (int k = 0; k < slots; k++) {
+            const int sourceY = first + k;
+            const int slot = sourceY % slots;
+            float4* row = ring + slot * count;
+            if (tags[slot] != sourceY) {
+                const uchar* in = mIn + mInputSizeX * sourceY * mCellSize;
+                for (int x = firstColumn; x < endColumn; x++) {
+                    decoded[x - firstColumn] =
+                            DecodeCell<kOpaque, kUnpremultiplied, kLinear, kFormat>(in, x, tables);
+                }
+                ResampleRow(decoded - firstColumn, row, mTableX, startX, endX);
+                tags[slot] = sourceY;
+            }
+            const float weight = weights[k];
+            if (k == 0) {
+                for (size_t x = 0; x < count; x++) {
+                    acc[x] = weight * row[x];
+                }
+            } else {
+                for (size_t x = 0; x < count; x++) {
+                    acc[x] += weight * row[x];
+                }
+            }
+        }
+        if (mTensor != nullptr) {
+            StoreTensorRow<kUnpremultiplied>(*mTensor, mOut, mSizeX * mSizeY,
+                                             mSizeX * y + startX, acc, count);
+            continue;
+        }
+        uchar* out = mOut + (mSizeX * y + startX) * mCellSize;
+        for (size_t x = 0; x < count; x++) {
+            EncodeCell<kOpaque, kUnpremultiplied, kLinear, kFormat>(out, x, acc[x], tables);
+        }
+    }
+}
 
-#if defined(ARCH_ARM_USE_INTRINSICS)
-    if (mUsesSimd && x2 > x1 && mScaleX < 4.0f) {
-        float xf = (x1 + 0.5f) * mScaleX - 0.5f;
-        long xf16 = rint(xf * 0x10000);
-        uint32_t xinc16 = rint(mScaleX * 0x10000);
+/**
+ * Resample one row horizontally, in fixed point.
+ *
+ * @param in The row, which starts at column firstColumn. Its values have 8 fractional bits.
+ * @param out Where to store the xend - xstart resampled pixels.
+ * @param table The taps of the horizontal pass.
+ * @param xstart The index of the first output pixel.
+ * @param xend The end index of the output pixels.
+ * @param firstColumn The column of the first pixel of the row.
+ */
+template <int kChannels>
+static void ResampleRowFixed(const ushort* in, uchar* out, const ResampleTable& table,
+                             size_t xstart, size_t xend, int firstColumn) {
+    constexpr int kShift = kFixedWeightBits + 8;
+    const int taps = table.taps;
+    for (size_t x = xstart; x < xend; x++) {
+        const ushort* p = in + (table.first[x] - firstColumn) * kChannels;
+        const ushort* weights = &table.fixedWeights[x * taps];
+        uint32_t sum[kChannels] = {};
+        for (int k = 0; k < taps; k++) {
+            for (int c = 0; c < kChannels; c++) {
+                sum[c] += weights[k] * p[k * kChannels + c];
+            }
+        }
+        for (int c = 0; c < kChannels; c++) {
+            out[(x - xstart) * kChannels + c] = (sum[c] + (1u << (kShift - 1))) >> kShift;
+        }
+    }
+}
 
-        int xoff = (xf16 >> 16) - 1;
-        int xclip = std::max(0, xoff) - xoff;
-        int len = x2 - x1;
+/**
+ * The vertical pass of the fixed point resize. Sums the input rows, weighted by the fixed point
+ * weights, into a row of values with 8 fractional bits.
+ *
+ * @param rows The input rows, one per tap.
+ * @param weights The fixed point weights of the rows.
+ * @param taps The number of rows.
+ * @param values The number of values of each row that are summed.
+ * @param acc A buffer for the sums, of values elements.
+ * @param out Where to store the resampled values.
+ */
+static void ResampleColumnsFixed(const uchar* const* rows, const ushort* weights, int taps,
+                                 size_t values, uint32_t* acc, ushort* out) {
+    constexpr int kShift = kFixedWeightBits - 8;
+    for (int k = 0; k < taps; k++) {
+        const uchar* source = rows[k];
+        const uint32_t weight = weights[k];
+        if (k == 0) {
+            for (size_t i = 0; i < values; i++) {
+                acc[i] = weight * source[i];
+            }
+        } else {
+            for (size_t i = 0; i < values; i++) {
+                acc[i] += weight * source[i];
+            }
+        }
+    }
+    for (size_t i = 0; i < values; i++) {
+        out[i] = (acc[i] + (1u << (kShift - 1))) >> kShift;
+    }
+}
 
-        int32_t yr[4];
-        uint64_t osc_ctl = rsdIntrinsicResize_oscctl_K(xinc16);
-        mkYCoeff(yr, yf);
+/**
+ * Same as resampleRows, in fixed point and with the vertical pass first. An input row only
+ * contributes to one or two output rows when downscaling by 2 or more, and the filters with
+ * positive weights have few taps otherwise, so there's little to gain from keeping rows around,
+ * while the vertical pass over whole rows makes for loops the compiler can vectorize. The rows
+ * it produces have 8 fractional bits, i.e. they are at most 255 << 8, and the weights of the
+ * horizontal pass add up to 1 << kFixedWeightBits, so the sums fit in 32 bits.
+ */
+template <int kChannels>
+void ResizeTask::resampleRowsFixed(int threadIndex, size_t startX, size_t startY, size_t endX,
+                                   size_t endY) {
+    // The input columns the output columns of the band need.
+    const int firstColumn = mTableX.first[startX];
+    const int endColumn = mTableX.first[endX - 1] + mTableX.taps;
+    const size_t values = (endColumn - firstColumn) * kChannels;
+    const int taps = mTableY.taps;
+    // A tensor takes the output rows once they're resampled, see StoreTensorPlanes.
+    const size_t count = endX - startX;
+    const size_t pixelsSize = mTensor != nullptr ? count * kChannels : 0;
+    const uchar** rows = (const uchar**)mRings.get(
+            threadIndex, taps * sizeof(const uchar*) + values * sizeof(uint32_t) + pixelsSize +
+                                 values * sizeof(ushort));
+    if (rows == nullptr) {
+        return;
+    }
+    uint32_t* acc = (uint32_t*)(rows + taps);
+    uchar* pixels = (uchar*)(acc + values);
+    ushort* row = (ushort*)(pixels + pixelsSize);
+    const size_t stride = mInputSizeX * kChannels;
 
-        xoff += xclip;
+    for (size_t y = startY; y < endY; y++) {
+        const uchar* in = mIn + mTableY.first[y] * stride + firstColumn * kChannels;
+        for (int k = 0; k < taps; k++) {
+            rows[k] = in + k * stride;
+        }
+        ResampleColumnsFixed(rows, &mTableY.fixedWeights[y * taps], taps, values, acc, row);
+        if (mTensor != nullptr) {
+            ResampleRowFixed<kChannels>(row, pixels, mTableX, startX, endX, firstColumn);
+            StoreTensorPlanes(*mTensor, mOut, mSizeX * mSizeY, mSizeX * y + startX,
+                              (const uchar4*)pixels, count);
+            continue;
+        }
+        uchar* out = mOut + (mSizeX * y + startX) * kChannels;
+        ResampleRowFixed<kChannels>(row, out, mTableX, startX, endX, firstColumn);
+    }
+}
 
-        rsdIntrinsicResizeB2_K(
-                out, len,
-                xf16 & 0xffff, xinc16,
-                yp0 + xoff, yp1 + xoff, yp2 + xoff, yp3 + xoff,
-                xclip, srcWidth - xoff + xclip,
-                osc_ctl, yr);
-        out += len;
-        x1 += len;
+/**
+ * Resize with a single tap per axis, i.e. each output pixel is a copy of an input pixel.
+ */
+template <typename InVector>
+void ResizeTask::copyNearest(size_t startX, size_t startY, size_t endX, size_t endY) {
+    const int* columns = mTableX.first.data();
+    for (size_t y = startY; y < endY; y++) {
+        const InVector* in = (const InVector*)mIn + mInputSizeX * mTableY.first[y];
+        InVector* out = (InVector*)(mOut + (mSizeX * y + startX) * mCellSize);
+        for (size_t x = startX; x < endX; x++) {
+            out[x - startX] = in[columns[x]];
+        }
     }
-#endif
+}
 
-    while(x1 < x2) {
+#if defined(ARCH_X86_HAVE_SSSE3)
+/**
+ * Same as kernelAssembly, bit for bit, with the x86 kernels. For each output row, the vertical
+ * pass covers the input columns the taps of the band need, into 16 bit values with 14 fractional
+ * bits. The columns past the edges of the image are copies of the edge columns, as in the
+ * assembly. The horizontal pass then applies the 4 taps of each output pixel. Like the
+ * assembly, the positions of the output pixels advance by a fixed point step from the first
+ * one. They are the same for all the rows of the band, so their taps and coefficients are
+ * computed once.
+ */
+void ResizeTask::resampleRowsX86(int threadIndex, size_t startX, size_t startY, size_t endX,
+                                 size_t endY) {
+    const X86ResizeKernels kernels = selectX86ResizeKernels(mX86Extension);
+    const int channels = mCellSize;
+    const int count = endX - startX;
+    const int64_t xf16 = FixedPointPosition(startX, mScaleX, mOriginX);
+    const uint32_t xinc16 = rint(mScaleX * 0x10000);
+    // The columns covered by the taps, and the part of them that's inside the image.
+    const int firstColumn = (int)(xf16 >> 16) - 1;
+    const int endColumn = (int)((xf16 + (int64_t)(count - 1) * xinc16) >> 16) + 3;
+    const int firstInside = std::max(firstColumn, 0);
+    const int endInside = std::min(endColumn, (int)mInputSizeX);
+
+    const size_t rowSize = (endColumn - firstColumn) * channels * sizeof(short);
+    const size_t alignedRowSize = (rowSize + 15) & ~(size_t)15;
+    uint8_t* scratch = (uint8_t*)mRings.get(
+            threadIndex, alignedRowSize + count * (sizeof(int) + 4 * sizeof(short)));
+    if (scratch == nullptr) {
+        return;
+    }
+    short* row = (short*)scratch;
+    int* taps = (int*)(scratch + alignedRowSize);
+    short* coefficients = (short*)(taps + count);
+    for (int x = 0; x < count; x++) {
+        const int64_t x16 = xf16 + (int64_t)x * xinc16;
+        taps[x] = (int)(x16 >> 16) - 1 - firstColumn;
+        FixedBicubicCoefficients(x16 & 0xffff, coefficients + 4 * x);
+    }
 
-#if defined(ARCH_X86_HAVE_AVX2)
-        float xf = _mm_cvtss_f32(_mm_fmsub_ss(_mm_set1_ps(x1 + 0.5f) , _mm_set1_ps(scaleX) ,
-                                              _mm_set1_ps(0.5f)));
-#else
-        float xf = (x1 + 0.5f) * mScaleX - 0.5f;
-#endif
-        *out = OneBiCubic(yp0, yp1, yp2, yp3, xf, yf, srcWidth);
-        out++;
-        x1++;
+    const size_t stride = mInputSizeX * channels;
+    short* inside = row + (firstInside - firstColumn) * channels;
+    short* last = row + (endInside - 1 - firstColumn) * channels;
+    short* end = row + (endColumn - firstColumn) * channels;
+    for (size_t y = startY; y < endY; y++) {
+        int ys[4];
+        int32_t yr[4];
+        FixedPointRows(y, mScaleY, mOriginY, mInputSizeY, ys, yr);
+        // The assembly saturates the coefficients to 16 bits, which only matters for 0x10000.
+        ushort coefficientsY[4];
+        const uchar* rows[4];
+        for (int k = 0; k < 4; k++) {
+            coefficientsY[k] = clamp(yr[k], 0, 0xffff);
+            rows[k] = mIn + stride * ys[k] + firstInside * channels;
+        }
+        kernels.vertical(inside, (const void* const*)rows, coefficientsY,
+                         (endInside - firstInside) * channels);
+        for (short* p = row; p < inside; p++) {
+            *p = inside[(p - row) % channels];
+        }
+        for (short* p = last + channels; p < end; p++) {
+            *p = last[(p - last) % channels];
+        }
+
+        uchar* out = mOut + (mSizeX * y + startX) * channels;
+        switch (channels) {
+            case 4:
+                kernels.horizontalU4(out, row, taps, coefficients, count);
+                break;
+            case 3:
+                kernels.horizontalU3(out, row, taps, coefficients, count);
+                break;
+            case 2:
+                kernels.horizontalU2(out, row, taps, coefficients, count);
+                break;
+            default:
+                kernels.horizontalU1(out, row, taps, coefficients, count);
+                break;
+        }
     }
 }
+#endif
 
-void ResizeTask::kernelU1(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY) {
-    //ALOGI("TK kernelU1 xstart %u, xend %u, outstep %u", xstart, xend);
+#if defined(ARCH_ARM_USE_INTRINSICS)
+/**
+ * Resize one row of the tile with the assembly kernels.
+ *
+ * @param outPtr Where to store the results.
+ * @param xstart The index of the section we're starting to resize.
+ * @param xend The end index of the section.
+ * @param currentY The index of the output row.
+ * @param kernel The assembly kernel for the size of the cells.
+ */
+template <typename InVector>
+void ResizeTask::kernelAssembly(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY,
+                                AssemblyResizeKernel<InVector> kernel) {
     const uchar *pin = mIn;
-    const int srcHeight = mInputSizeY;
     const int srcWidth = mInputSizeX;
-    const size_t stride = mInputSizeX * mVectorSize;
+    const size_t stride = mInputSizeX * mCellSize;
 
-    // ALOGI("Toolkit   ResizeU1 (%ux%u) by (%f,%f), xstart:%u to %u, stride %zu, out %p", srcWidth,
-    // srcHeight, scaleX, scaleY, xstart, xend, stride, outPtr);
+    int ys[4];
+    int32_t yr[4];
+    FixedPointRows(currentY, mScaleY, mOriginY, mInputSizeY, ys, yr);
 
-#if defined(ARCH_X86_HAVE_AVX2)
-    float yf = _mm_cvtss_f32(
-            _mm_fmsub_ss(_mm_set1_ps(currentY + 0.5f), _mm_set1_ps(scaleY), _mm_set1_ps(0.5f)));
-#else
-    float yf = (currentY + 0.5f) * mScaleY - 0.5f;
-#endif
+    const InVector *yp0 = (const InVector *)(pin + stride * ys[0]);
+    const InVector *yp1 = (const InVector *)(pin + stride * ys[1]);
+    const InVector *yp2 = (const InVector *)(pin + stride * ys[2]);
+    const InVector *yp3 = (const InVector *)(pin + stride * ys[3]);
 
-    int starty = (int) floor(yf - 1);
-    yf = yf - floor(yf);
-    int maxy = srcHeight - 1;
-    int ys0 = std::max(0, starty + 0);
-    int ys1 = std::min(maxy, std::max(0, starty + 1));
-    int ys2 = std::min(maxy, starty + 2);
-    int ys3 = std::min(maxy, starty + 3);
+    int64_t xf16 = FixedPointPosition(xstart, mScaleX, mOriginX);
+    uint32_t xinc16 = rint(mScaleX * 0x10000);
 
-    const uchar *yp0 = pin + stride * ys0;
-    const uchar *yp1 = pin + stride * ys1;
-    const uchar *yp2 = pin + stride * ys2;
-    const uchar *yp3 = pin + stride * ys3;
+    int xoff = (xf16 >> 16) - 1;
+    int xclip = std::max(0, xoff) - xoff;
+    int len = xend - xstart;
 
-    uchar *out = ((uchar *)outPtr);
-    uint32_t x1 = xstart;
-    uint32_t x2 = xend;
+    uint64_t osc_ctl = rsdIntrinsicResize_oscctl_K(xinc16);
 
-#if defined(ARCH_ARM_USE_INTRINSICS)
-    if (mUsesSimd && x2 > x1 && mScaleX < 4.0f) {
-        float xf = (x1 + 0.5f) * mScaleX - 0.5f;
-        long xf16 = rint(xf * 0x10000);
-        uint32_t xinc16 = rint(mScaleX * 0x10000);
+    xoff += xclip;
 
-        int xoff = (xf16 >> 16) - 1;
-        int xclip = std::max(0, xoff) - xoff;
-        int len = x2 - x1;
+    kernel((InVector *)outPtr, len,
+           xf16 & 0xffff, xinc16,
+           yp0 + xoff, yp1 + xoff, yp2 + xoff, yp3 + xoff,
+           xclip, srcWidth - xoff + xclip,
+           osc_ctl, yr);
+}
+#endif
 
-        int32_t yr[4];
-        uint64_t osc_ctl = rsdIntrinsicResize_oscctl_K(xinc16);
-        mkYCoeff(yr, yf);
-
-        // ALOGI("ys0 %d, ys1 %d, ys2 %d, ys3 %d, x1 %u, x2 %u, xf %f, xf16 %ld, xinc16 %u, xoff %d,
-        // xclip %d, len %d, osc_ctl %lu)",
-        //       ys0, ys1, ys2, ys3, x1, x2, xf, xf16, xinc16, xoff, xclip, len, (unsigned long)
-        //       osc_ctl);
-        // ALOGI("TK scaleX %f, xf %f, xf16 %ld, xinc16 %d, xoff %d, xclip %d, len %d", scaleX, xf,
-        // xf16, xinc16, xoff, xclip, len); ALOGI("TK xf16 & 0xffff %ld, ys0 %u, ys1 %u, ys2 %u, ys3
-        // %u, srcWidth - xoff + xclip %d", xf16 & 0xffff, ys0, ys1, ys2, ys3, srcWidth - xoff);
-
-        xoff += xclip;
-
-        rsdIntrinsicResizeB1_K(
-                out, len,
-                xf16 & 0xffff, xinc16,
-                yp0 + xoff, yp1 + xoff, yp2 + xoff, yp3 + xoff,
-                xclip, srcWidth - xoff + xclip,
-                osc_ctl, yr);
-        out += len;
-        x1 += len;
+/**
+ * The ResizeStream returned by createResizeStream. It keeps a ring of mTableY.taps rows indexed
+ * by the input row, like the rings of ResizeTask. When both passes have fixed point weights,
+ * the ring holds the input rows themselves, and the output rows go through the passes of
+ * resampleRowsFixed. Otherwise, it holds the horizontally resampled input rows, and the output
+ * rows are summed as in resampleRows. The output rows only move down, so when an input row
+ * completes an output row, the latter only needs the last mTableY.taps input rows.
+ *
+ * A stream can also produce only a range of the output rows, for MultiResizeTask. Its input
+ * then starts at firstInputRow(), and the output rows are taken one at a time with addRow,
+ * hasOutputRow and produceNextRow. When the input rows outlive the stream, the fixed point
+ * passes read them where they are instead of copying them into the ring.
+ */
+class ResizeStreamImpl : public ResizeStream {
+    const size_t mCellSize;
+    const size_t mOutputSizeX;
+    ResampleTable mTableX;
+    ResampleTable mTableY;
+    bool mUsesFixedPoint;
+    size_t mMaxRowsPerPush = 0;
+    // The next input row to be pushed, and the last one added.
+    size_t mNextInputRow = 0;
+    int mLastInputRow = -1;
+    // The output rows [mNextOutputRow, mEndOutputRow) are still to be produced.
+    size_t mNextOutputRow;
+    const size_t mEndOutputRow;
+    // Whether the input rows outlive the stream.
+    const bool mBorrowsRows;
+    // The buffer of the ring and of the passes. The fixed point passes need the pointers to the
+    // rows in the ring, or to the borrowed ones, those to the rows of a vertical pass, its sums
+    // and its result. The float ones need a row to sum into.
+    ScratchBuffers mBuffers{1};
+    uchar* mRing = nullptr;
+    // The size of a row of the ring, in bytes.
+    size_t mRowSize;
+    const uchar** mSlots = nullptr;
+    const uchar** mRows = nullptr;
+    void* mAcc = nullptr;
+    ushort* mFixedRow = nullptr;
+
+    void keepRow(int sourceY, const uchar* in);
+    void produceRow(size_t y, uchar* out);
+    template <typename InVector, typename FloatVector>
+    void sumRows(size_t y, uchar* out);
+
+   public:
+    /**
+     * Creates a stream that produces the output rows [startOutputRow, endOutputRow). The range
+     * should not be empty. borrowsRows tells whether the input rows outlive the stream.
+     */
+    ResizeStreamImpl(size_t inputSizeX, size_t inputSizeY, size_t vectorSize, size_t outputSizeX,
+                     size_t outputSizeY, ResizeFilter filter, size_t startOutputRow,
+                     size_t endOutputRow, bool borrowsRows);
+
+    bool allocated() const { return mAcc != nullptr; }
+    size_t maxRowsPerPush() const override { return mMaxRowsPerPush; }
+    size_t pushRow(const uint8_t* in, uint8_t* out) override;
+
+    // The input rows [firstInputRow(), endInputRow()) are those the output rows need.
+    int firstInputRow() const { return mTableY.first[mNextOutputRow]; }
+    int endInputRow() const { return mTableY.first[mEndOutputRow - 1] + mTableY.taps; }
+    // Adds input row sourceY, which should follow the last one added.
+    void addRow(int sourceY, const uchar* in);
+    // Whether the input rows added so far complete the next output row.
+    bool hasOutputRow() const {
+        return mNextOutputRow < mEndOutputRow &&
+               mTableY.first[mNextOutputRow] + mTableY.taps - 1 <= mLastInputRow;
     }
-#endif
+    size_t nextOutputRow() const { return mNextOutputRow; }
+    // Writes the next output row to out, once hasOutputRow().
+    void produceNextRow(uchar* out) { produceRow(mNextOutputRow++, out); }
+};
 
-    while(x1 < x2) {
+ResizeStreamImpl::ResizeStreamImpl(size_t inputSizeX, size_t inputSizeY, size_t vectorSize,
+                                   size_t outputSizeX, size_t outputSizeY, ResizeFilter filter,
+                                   size_t startOutputRow, size_t endOutputRow, bool borrowsRows)
+    : mCellSize{paddedSize(vectorSize)},
+      mOutputSizeX{outputSizeX},
+      mNextOutputRow{startOutputRow},
+      mEndOutputRow{endOutputRow},
+      mBorrowsRows{borrowsRows} {
+    BuildFilterTable(&mTableX, inputSizeX, 0.0f, inputSizeX, outputSizeX, filter);
+    BuildFilterTable(&mTableY, inputSizeY, 0.0f, inputSizeY, outputSizeY, filter);
+    mUsesFixedPoint = !mTableX.fixedWeights.empty() && !mTableY.fixedWeights.empty();
+    const int taps = mTableY.taps;
+
+    // The output rows that the same input row completes are next to each other.
+    size_t run = 0;
+    for (size_t y = 0; y < outputSizeY; y++) {
+        const bool sameLastRow = y > 0 && mTableY.first[y] == mTableY.first[y - 1];
+        run = sameLastRow ? run + 1 : 1;
+        mMaxRowsPerPush = std::max(mMaxRowsPerPush, run);
+    }
 
-#if defined(ARCH_X86_HAVE_AVX2)
-        float xf = _mm_cvtss_f32(_mm_fmsub_ss(_mm_set1_ps(x1 + 0.5f) , _mm_set1_ps(scaleX) ,
-                                              _mm_set1_ps(0.5f)));
-#else
-        float xf = (x1 + 0.5f) * mScaleX - 0.5f;
-#endif
+    if (mUsesFixedPoint) {
+        // Only the input columns the output columns need are kept.
+        mRowSize = (mTableX.first[outputSizeX - 1] + mTableX.taps - mTableX.first[0]) * mCellSize;
+        const size_t ringSize = mBorrowsRows ? 0 : taps * mRowSize;
+        const size_t bytes = 2 * taps * sizeof(const uchar*) + mRowSize * sizeof(uint32_t) +
+                             mRowSize * sizeof(ushort) + ringSize;
+        mSlots = (const uchar**)mBuffers.get(0, bytes);
+        if (mSlots != nullptr) {
+            mRows = mSlots + taps;
+            mAcc = mRows + taps;
+            mFixedRow = (ushort*)((uint32_t*)mAcc + mRowSize);
+            mRing = (uchar*)(mFixedRow + mRowSize);
+        }
+    } else {
+        mRowSize = outputSizeX * mCellSize * sizeof(float);
+        mRing = (uchar*)mBuffers.get(0, (taps + 1) * mRowSize);
+        if (mRing != nullptr) {
+            mAcc = mRing + taps * mRowSize;
+        }
+    }
+}
 
-        *out = OneBiCubic(yp0, yp1, yp2, yp3, xf, yf, srcWidth);
-        out++;
-        x1++;
+/**
+ * Puts an input row in its slot of the ring, resampled horizontally unless the passes are in
+ * fixed point.
+ */
+void ResizeStreamImpl::keepRow(int sourceY, const uchar* in) {
+    const int index = sourceY % mTableY.taps;
+    uchar* slot = mRing + index * mRowSize;
+    if (mUsesFixedPoint) {
+        const uchar* columns = in + mTableX.first[0] * mCellSize;
+        if (mBorrowsRows) {
+            mSlots[index] = columns;
+        } else {
+            memcpy(slot, columns, mRowSize);
+            mSlots[index] = slot;
+        }
+        return;
+    }
+    switch (mCellSize) {
+        case 4:
+            ResampleRow((const uchar4*)in, (float4*)slot, mTableX, 0, mOutputSizeX);
+            break;
+        case 2:
+            ResampleRow((const uchar2*)in, (float2*)slot, mTableX, 0, mOutputSizeX);
+            break;
+        default:
+            ResampleRow(in, (float*)slot, mTableX, 0, mOutputSizeX);
+            break;
     }
 }
 
-#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_SUPPORTS_FLOAT
-void ResizeTask::kernelF4(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY) {
-    const uchar *pin = mIn;
-    const int srcHeight = inputSizeY;
-    const int srcWidth = inputSizeX;
-    const size_t stride = sizeX * vectorSize;
-
-#if defined(ARCH_X86_HAVE_AVX2)
-    float yf = _mm_cvtss_f32(
-            _mm_fmsub_ss(_mm_set1_ps(currentY + 0.5f), _mm_set1_ps(scaleY), _mm_set1_ps(0.5f)));
-#else
-    float yf = (currentY + 0.5f) * scaleY - 0.5f;
-#endif
+/**
+ * Sums the horizontally resampled rows of the ring that output row y needs, as resampleRows
+ * does.
+ */
+template <typename InVector, typename FloatVector>
+void ResizeStreamImpl::sumRows(size_t y, uchar* out) {
+    const int slots = mTableY.taps;
+    const int first = mTableY.first[y];
+    const float* weights = &mTableY.weights[y * slots];
+    FloatVector* acc = (FloatVector*)mAcc;
+    for (int k = 0; k < slots; k++) {
+        const FloatVector* row = (const FloatVector*)(mRing + (first + k) % slots * mRowSize);
+        const float weight = weights[k];
+        if (k == 0) {
+            for (size_t x = 0; x < mOutputSizeX; x++) {
+                acc[x] = weight * row[x];
+            }
+        } else {
+            for (size_t x = 0; x < mOutputSizeX; x++) {
+                acc[x] += weight * row[x];
+            }
+        }
+    }
+    InVector* outVector = (InVector*)out;
+    for (size_t x = 0; x < mOutputSizeX; x++) {
+        outVector[x] = convert<InVector>(clamp(acc[x] + 0.5f, 0.f, 255.f));
+    }
+}
 
-    int starty = (int) floor(yf - 1);
-    yf = yf - floor(yf);
-    int maxy = srcHeight - 1;
-    int ys0 = std::max(0, starty + 0);
-    int ys1 = std::max(0, starty + 1);
-    int ys2 = std::min(maxy, starty + 2);
-    int ys3 = std::min(maxy, starty + 3);
-
-    const float4 *yp0 = (const float4 *)(pin + stride * ys0);
-    const float4 *yp1 = (const float4 *)(pin + stride * ys1);
-    const float4 *yp2 = (const float4 *)(pin + stride * ys2);
-    const float4 *yp3 = (const float4 *)(pin + stride * ys3);
-
-    float4 *out = ((float4 *)outPtr);
-    uint32_t x1 = xstart;
-    uint32_t x2 = xend;
-
-    while(x1 < x2) {
-
-#if defined(ARCH_X86_HAVE_AVX2)
-        float xf = _mm_cvtss_f32(_mm_fmsub_ss(_mm_set1_ps(x1 + 0.5f) , _mm_set1_ps(scaleX) ,
-                                              _mm_set1_ps(0.5f)));
-#else
-        float xf = (x1 + 0.5f) * scaleX - 0.5f;
+void ResizeStreamImpl::produceRow(size_t y, uchar* out) {
+    if (!mUsesFixedPoint) {
+        switch (mCellSize) {
+            case 4:
+                sumRows<uchar4, float4>(y, out);
+                break;
+            case 2:
+                sumRows<uchar2, float2>(y, out);
+                break;
+            default:
+                sumRows<uchar, float>(y, out);
+                break;
+        }
+        return;
+    }
+    const int taps = mTableY.taps;
+    const int first = mTableY.first[y];
+    for (int k = 0; k < taps; k++) {
+        mRows[k] = mSlots[(first + k) % taps];
+    }
+    ResampleColumnsFixed(mRows, &mTableY.fixedWeights[y * taps], taps, mRowSize,
+                         (uint32_t*)mAcc, mFixedRow);
+    const int firstColumn = mTableX.first[0];
+    switch (mCellSize) {
+        case 4:
+            ResampleRowFixed<4>(mFixedRow, out, mTableX, 0, mOutputSizeX, firstColumn);
+            break;
+        case 2:
+            ResampleRowFixed<2>(mFixedRow, out, mTableX, 0, mOutputSizeX, firstColumn);
+            break;
+        default:
+            ResampleRowFixed<1>(mFixedRow, out, mTableX, 0, mOutputSizeX, firstColumn);
+            break;
+    }
+}
+
+void ResizeStreamImpl::addRow(int sourceY, const uchar* in) {
+    mLastInputRow = sourceY;
+    // The rows above the next output row, e.g. those the nearest filter skips, aren't needed,
+    // nor are those added once all the output rows are done.
+    if (mNextOutputRow < mEndOutputRow && sourceY >= mTableY.first[mNextOutputRow]) {
+        keepRow(sourceY, in);
+    }
+}
+
+size_t ResizeStreamImpl::pushRow(const uint8_t* in, uint8_t* out) {
+    addRow((int)mNextInputRow++, in);
+    size_t count = 0;
+    while (hasOutputRow()) {
+        produceNextRow(out + count * mOutputSizeX * mCellSize);
+        count++;
+    }
+    return count;
+}
+
+std::unique_ptr<ResizeStream> RenderScriptToolkit::createResizeStream(
+        size_t inputSizeX, size_t inputSizeY, size_t vectorSize, size_t outputSizeX,
+        size_t outputSizeY, ResizeFilter filter) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (vectorSize < 1 || vectorSize > 4) {
+        ALOGE("The vectorSize should be between 1 and 4. %zu provided.", vectorSize);
+        return nullptr;
+    }
+    if (inputSizeX == 0 || inputSizeY == 0 || outputSizeX == 0 || outputSizeY == 0) {
+        ALOGE("The sizes should not be 0. %zux%zu to %zux%zu provided.", inputSizeX, inputSizeY,
+              outputSizeX, outputSizeY);
+        return nullptr;
+    }
 #endif
 
-        *out = OneBiCubic(yp0, yp1, yp2, yp3, xf, yf, srcWidth);
-        out++;
-        x1++;
+    auto stream = std::make_unique<ResizeStreamImpl>(inputSizeX, inputSizeY, vectorSize,
+                                                     outputSizeX, outputSizeY, filter, 0,
+                                                     outputSizeY, false);
+    if (!stream->allocated()) {
+        ALOGE("Failed to allocate the buffers of a resize stream.");
+        return nullptr;
     }
+    return stream;
 }
 
-void ResizeTask::kernelF2(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY) {
-    const uchar *pin = mIn;
-    const int srcHeight = inputSizeY;
-    const int srcWidth = inputSizeX;
-    const size_t stride = sizeX * vectorSize;
+extern void HalveRowScalar(uchar* out, const uchar* row0, const uchar* row1, size_t cellSize,
+                           size_t count);
 
+/**
+ * An output of MultiResizeTask, the output it's resized from, or -1 for the input, and whether
+ * it's exactly half of it.
+ */
+struct MultiResizeOutput {
+    uchar* out;
+    size_t sizeX;
+    size_t sizeY;
+    int source;
+    bool halves;
+};
 
-#if defined(ARCH_X86_HAVE_AVX2)
-    float yf = _mm_cvtss_f32(_mm_fmsub_ss(_mm_set1_ps(currentY + 0.5f),
-                                          _mm_set1_ps(scaleY), _mm_set1_ps(0.5f)));
-#else
-    float yf = (currentY + 0.5f) * scaleY - 0.5f;
-#endif
+/**
+ * Resizes an image to several sizes in one pass over it, see resizeMultiple. The outputs are
+ * sorted largest first, so that an output is only resized from the ones before it. The work is
+ * divided into bands of the rows of the first output, and each band covers the same share of
+ * the rows of the other outputs. A thread goes once down the input rows its band needs, and
+ * feeds each of them to a ResizeStreamImpl per output resized from the input. The rows such a
+ * stream produces feed the streams of the outputs resized from it in turn. When those need rows
+ * of the band next to it, the stream computes them again, into scratch rows. All the rows stay
+ * in place for the whole band, so the streams don't copy them. As in resize, the outputs that
+ * are exactly half of their source are instead the 2x2 boxes of the first mipmap level, and
+ * each pair of source rows is halved into a row at once.
+ */
+class MultiResizeTask : public Task {
+    const uchar* mIn;
+    const size_t mInputSizeX;
+    const size_t mInputSizeY;
+    const ResizeFilter mFilter;
+    const std::vector<MultiResizeOutput>& mOutputs;
+    ScratchBuffers mScratch;
+
+    // The state of the band a thread works on.
+    struct Band {
+        // The stream of each output that has rows to compute and doesn't halve its source, and
+        // whether each one has rows to compute.
+        std::vector<std::unique_ptr<ResizeStreamImpl>> streams;
+        std::vector<bool> computes;
+        // The even row each halving output last got, to be halved with the next one.
+        std::vector<const uchar*> evenRows;
+        // The share of the band in the rows of each output.
+        std::vector<size_t> startRows;
+        std::vector<size_t> endRows;
+        // The rows of each output that the band computes, its share and those above and below
+        // it that the outputs resized from it need. The latter go to scratch rows.
+        std::vector<size_t> startComputed;
+        std::vector<size_t> endComputed;
+        std::vector<uchar*> scratchRows;
+    };
+
+    uchar* rowOf(Band& band, size_t index, size_t y);
+    void halveRow(uchar* out, const uchar* row0, const uchar* row1, size_t count);
+    void feedRow(Band& band, size_t index, int y, const uchar* row);
+    void passRow(Band& band, size_t index, size_t y, const uchar* row);
+
+    // Process a 2D tile of the overall work. threadIndex identifies which thread does the work.
+    void processData(int threadIndex, size_t startX, size_t startY, size_t endX,
+                     size_t endY) override;
+
+   public:
+    MultiResizeTask(const uchar* input, size_t inputSizeX, size_t inputSizeY, size_t vectorSize,
+                    const std::vector<MultiResizeOutput>& outputs, ResizeFilter filter,
+                    uint32_t threadCount)
+        : Task{outputs[0].sizeX, outputs[0].sizeY, vectorSize, false, nullptr},
+          mIn{input},
+          mInputSizeX{inputSizeX},
+          mInputSizeY{inputSizeY},
+          mFilter{filter},
+          mOutputs{outputs},
+          mScratch{threadCount} {
+        mBandCount = threadCount;
+    }
+};
+
+/**
+ * Where row y of an output goes: the output itself within the share of the band, and the
+ * scratch rows above and below it.
+ */
+uchar* MultiResizeTask::rowOf(Band& band, size_t index, size_t y) {
+    const MultiResizeOutput& output = mOutputs[index];
+    const size_t rowSize = output.sizeX * paddedSize(mVectorSize);
+    if (y >= band.startRows[index] && y < band.endRows[index]) {
+        return output.out + y * rowSize;
+    }
+    const size_t above = band.startRows[index] - band.startComputed[index];
+    const size_t scratchRow = y < band.startRows[index] ? y - band.startComputed[index]
+                                                        : above + y - band.endRows[index];
+    return band.scratchRows[index] + scratchRow * rowSize;
+}
 
-    int starty = (int) floor(yf - 1);
-    yf = yf - floor(yf);
-    int maxy = srcHeight - 1;
-    int ys0 = std::max(0, starty + 0);
-    int ys1 = std::max(0, starty + 1);
-    int ys2 = std::min(maxy, starty + 2);
-    int ys3 = std::min(maxy, starty + 3);
-
-    const float2 *yp0 = (const float2 *)(pin + stride * ys0);
-    const float2 *yp1 = (const float2 *)(pin + stride * ys1);
-    const float2 *yp2 = (const float2 *)(pin + stride * ys2);
-    const float2 *yp3 = (const float2 *)(pin + stride * ys3);
-
-    float2 *out = ((float2 *)outPtr);
-    uint32_t x1 = xstart;
-    uint32_t x2 = xend;
-
-    while(x1 < x2) {
-
-#if defined(ARCH_X86_HAVE_AVX2)
-        float xf = _mm_cvtss_f32(_mm_fmsub_ss(_mm_set1_ps(x1 + 0.5f) , _mm_set1_ps(scaleX) ,
-                                              _mm_set1_ps(0.5f)));
-#else
-        float xf = (x1 + 0.5f) * scaleX - 0.5f;
+void MultiResizeTask::halveRow(uchar* out, const uchar* row0, const uchar* row1, size_t count) {
+#if defined(ARCH_X86_HAVE_SSSE3)
+    if (mUsesSimd) {
+        const auto halve = mX86Extension == X86Extension::None ? rsdIntrinsicHalveU_K
+                                                               : rsdIntrinsicHalveUAvx2_K;
+        halve(out, row0, row1, paddedSize(mVectorSize), count);
+        return;
+    }
 #endif
+    HalveRowScalar(out, row0, row1, paddedSize(mVectorSize), count);
+}
 
-        *out = OneBiCubic(yp0, yp1, yp2, yp3, xf, yf, srcWidth);
-        out++;
-        x1++;
+/**
+ * Gives row y of the image output index is resized from to that output, and passes on the rows
+ * of the output it completes.
+ */
+void MultiResizeTask::feedRow(Band& band, size_t index, int y, const uchar* row) {
+    const MultiResizeOutput& output = mOutputs[index];
+    if (output.halves) {
+        const size_t outputY = y / 2;
+        if (outputY < band.startComputed[index] || outputY >= band.endComputed[index]) {
+            return;
+        }
+        if (y % 2 == 0) {
+            band.evenRows[index] = row;
+            return;
+        }
+        uchar* out = rowOf(band, index, outputY);
+        halveRow(out, band.evenRows[index], row, output.sizeX);
+        passRow(band, index, outputY, out);
+        return;
+    }
+    ResizeStreamImpl* stream = band.streams[index].get();
+    stream->addRow(y, row);
+    while (stream->hasOutputRow()) {
+        const size_t outputY = stream->nextOutputRow();
+        uchar* out = rowOf(band, index, outputY);
+        stream->produceNextRow(out);
+        passRow(band, index, outputY, out);
     }
 }
 
-void ResizeTask::kernelF1(uchar* outPtr, uint32_t xstart, uint32_t xend, uint32_t currentY) {
-    const uchar *pin = mIn;
-    const int srcHeight = inputSizeY;
-    const int srcWidth = inputSizeX;
-    const size_t stride = sizeX * vectorSize;
+/**
+ * Feeds row y of an output to the outputs resized from it.
+ */
+void MultiResizeTask::passRow(Band& band, size_t index, size_t y, const uchar* row) {
+    for (size_t i = index + 1; i < mOutputs.size(); i++) {
+        if (mOutputs[i].source == (int)index && band.computes[i]) {
+            feedRow(band, i, y, row);
+        }
+    }
+}
 
+void MultiResizeTask::processData(int threadIndex, size_t /* startX */, size_t startY,
+                                  size_t /* endX */, size_t endY) {
+    const size_t count = mOutputs.size();
+    const size_t cellSize = paddedSize(mVectorSize);
+    Band band;
+    band.streams.resize(count);
+    band.computes.resize(count, false);
+    band.evenRows.resize(count);
+    band.startRows.resize(count);
+    band.endRows.resize(count);
+    band.scratchRows.resize(count);
+    for (size_t i = 0; i < count; i++) {
+        band.startRows[i] = startY * mOutputs[i].sizeY / mSizeY;
+        band.endRows[i] = endY * mOutputs[i].sizeY / mSizeY;
+    }
 
-#if defined(ARCH_X86_HAVE_AVX2)
-    float yf = _mm_cvtss_f32(_mm_fmsub_ss(_mm_set1_ps(currentY + 0.5f),
-                                          _mm_set1_ps(scaleY), _mm_set1_ps(0.5f)));
-#else
-    float yf = (currentY + 0.5f) * scaleY - 0.5f;
-#endif
+    // The outputs resized from an output come after it, so the rows they need from it are
+    // known by going backwards.
+    std::vector<size_t>& startComputed = band.startComputed;
+    std::vector<size_t>& endComputed = band.endComputed;
+    startComputed = band.startRows;
+    endComputed = band.endRows;
+    int startInput = INT_MAX;
+    int endInput = INT_MIN;
+    for (size_t i = count; i-- > 0;) {
+        const MultiResizeOutput& output = mOutputs[i];
+        if (startComputed[i] >= endComputed[i]) {
+            continue;
+        }
+        band.computes[i] = true;
+        const bool fromInput = output.source < 0;
+        size_t first = 2 * startComputed[i];
+        size_t end = 2 * endComputed[i];
+        if (!output.halves) {
+            const size_t sourceSizeX = fromInput ? mInputSizeX : mOutputs[output.source].sizeX;
+            const size_t sourceSizeY = fromInput ? mInputSizeY : mOutputs[output.source].sizeY;
+            band.streams[i] = std::make_unique<ResizeStreamImpl>(
+                    sourceSizeX, sourceSizeY, mVectorSize, output.sizeX, output.sizeY, mFilter,
+                    startComputed[i], endComputed[i], true);
+            if (!band.streams[i]->allocated()) {
+                ALOGE("Failed to allocate the buffers of a resize stream.");
+                return;
+            }
+            first = band.streams[i]->firstInputRow();
+            end = band.streams[i]->endInputRow();
+        }
+        if (fromInput) {
+            startInput = std::min(startInput, (int)first);
+            endInput = std::max(endInput, (int)end);
+        } else if (startComputed[output.source] < endComputed[output.source]) {
+            startComputed[output.source] = std::min(startComputed[output.source], first);
+            endComputed[output.source] = std::max(endComputed[output.source], end);
+        } else {
+            startComputed[output.source] = first;
+            endComputed[output.source] = end;
+        }
+    }
 
-    int starty = (int) floor(yf - 1);
-    yf = yf - floor(yf);
-    int maxy = srcHeight - 1;
-    int ys0 = std::max(0, starty + 0);
-    int ys1 = std::max(0, starty + 1);
-    int ys2 = std::min(maxy, starty + 2);
-    int ys3 = std::min(maxy, starty + 3);
-
-    const float *yp0 = (const float *)(pin + stride * ys0);
-    const float *yp1 = (const float *)(pin + stride * ys1);
-    const float *yp2 = (const float *)(pin + stride * ys2);
-    const float *yp3 = (const float *)(pin + stride * ys3);
-
-    float *out = ((float *)outPtr);
-    uint32_t x1 = xstart;
-    uint32_t x2 = xend;
-
-    while(x1 < x2) {
-
-#if defined(ARCH_X86_HAVE_AVX2)
-        float xf = _mm_cvtss_f32(_mm_fmsub_ss(_mm_set1_ps(x1 + 0.5f) , _mm_set1_ps(scaleX) ,
-                                              _mm_set1_ps(0.5f)));
-#else
-        float xf = (x1 + 0.5f) * scaleX - 0.5f;
-#endif
+    std::vector<size_t> scratchRowCounts(count, 0);
+    size_t scratchSize = 0;
+    for (size_t i = 0; i < count; i++) {
+        if (band.computes[i]) {
+            // An empty share is moved to the first computed row, so that all of them are below.
+            if (band.startRows[i] == band.endRows[i]) {
+                band.startRows[i] = band.endRows[i] = startComputed[i];
+            }
+            const size_t share = band.endRows[i] - band.startRows[i];
+            scratchRowCounts[i] = endComputed[i] - startComputed[i] - share;
+            scratchSize += scratchRowCounts[i] * mOutputs[i].sizeX * cellSize;
+        }
+    }
+    uchar* scratch = (uchar*)mScratch.get(threadIndex, std::max(scratchSize, (size_t)1));
+    if (scratch == nullptr) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        band.scratchRows[i] = scratch;
+        scratch += scratchRowCounts[i] * mOutputs[i].sizeX * cellSize;
+    }
 
-        *out = OneBiCubic(yp0, yp1, yp2, yp3, xf, yf, srcWidth);
-        out++;
-        x1++;
+    const size_t stride = mInputSizeX * cellSize;
+    for (int y = startInput; y < endInput; y++) {
+        for (size_t i = 0; i < count; i++) {
+            if (mOutputs[i].source < 0 && band.computes[i]) {
+                feedRow(band, i, y, mIn + y * stride);
+            }
+        }
     }
 }
 
-void ResizeTask::preLaunch(uint32_t slot, const RsScriptCall *sc)
-{
-
-    //check the data type to determine F or U.
-    if (mAlloc->getType()->getElement()->getType() == RS_TYPE_UNSIGNED_8) {
-        switch(mAlloc->getType()->getElement()->getVectorSize()) {
-        case 1:
-            mRootPtr = &kernelU1;
-            break;
-        case 2:
-            mRootPtr = &kernelU2;
-            break;
-        case 3:
-        case 4:
-            mRootPtr = &kernelU4;
-            break;
+void RenderScriptToolkit::resizeMultiple(const uint8_t* in, uint8_t* const* out,
+                                         size_t inputSizeX, size_t inputSizeY, size_t vectorSize,
+                                         const size_t* outputSizesX, const size_t* outputSizesY,
+                                         size_t count, ResizeFilter filter, bool cascade) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (vectorSize < 1 || vectorSize > 4) {
+        ALOGE("The vectorSize should be between 1 and 4. %zu provided.", vectorSize);
+        return;
+    }
+    if (count == 0) {
+        ALOGE("There should be at least one output.");
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (outputSizesX[i] == 0 || outputSizesY[i] == 0) {
+            ALOGE("The output sizes should not be 0. %zux%zu provided for output %zu.",
+                  outputSizesX[i], outputSizesY[i], i);
+            return;
         }
-    } else {
-        switch(mAlloc->getType()->getElement()->getVectorSize()) {
-        case 1:
-            mRootPtr = &kernelF1;
-            break;
-        case 2:
-            mRootPtr = &kernelF2;
-            break;
-        case 3:
-        case 4:
-            mRootPtr = &kernelF4;
-            break;
+    }
+#endif
+
+    std::vector<size_t> order(count);
+    for (size_t i = 0; i < count; i++) {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+        const size_t areaA = outputSizesX[a] * outputSizesY[a];
+        const size_t areaB = outputSizesX[b] * outputSizesY[b];
+        return areaA != areaB ? areaA > areaB : a < b;
+    });
+    std::vector<MultiResizeOutput> outputs(count);
+    for (size_t i = 0; i < count; i++) {
+        const size_t k = order[i];
+        outputs[i] = {out[k], outputSizesX[k], outputSizesY[k], -1, false};
+        size_t sourceSizeX = inputSizeX;
+        size_t sourceSizeY = inputSizeY;
+        if (cascade) {
+            // The smallest of the larger outputs that's at least kAreaScale times as large on
+            // both axes. The output is a reduction of it, which loses the detail the extra step
+            // blurs.
+            for (size_t j = 0; j < i; j++) {
+                if (outputs[j].sizeX >= kAreaScale * outputs[i].sizeX &&
+                    outputs[j].sizeY >= kAreaScale * outputs[i].sizeY) {
+                    outputs[i].source = (int)j;
+                    sourceSizeX = outputs[j].sizeX;
+                    sourceSizeY = outputs[j].sizeY;
+                }
+            }
         }
+        // The same results as the filter, as in resize.
+        outputs[i].halves = filter != ResizeFilter::Nearest && filter != ResizeFilter::Lanczos3 &&
+                            sourceSizeX == 2 * outputs[i].sizeX &&
+                            sourceSizeY == 2 * outputs[i].sizeY;
     }
+
+    MultiResizeTask task((const uchar*)in, inputSizeX, inputSizeY, vectorSize, outputs, filter,
+                         processor->getNumberOfThreads());
+    processor->doTask(&task);
 }
-#endif  // ANDROID_RENDERSCRIPT_TOOLKIT_SUPPORTS_FLOAT
+
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+/**
+ * Checks that the source rectangle of a resize is within the input, and not empty. Written so
+ * that NaN coordinates fail too.
+ */
+static bool ValidSource(size_t inputSizeX, size_t inputSizeY, const RectF& source) {
+    if (!(source.startX >= 0.0f && source.startX < source.endX &&
+          source.endX <= inputSizeX)) {
+        ALOGE("The source rectangle should be within 0 and %zu on the X axis, and not empty. "
+              "%f and %f were provided respectively.",
+              inputSizeX, source.startX, source.endX);
+        return false;
+    }
+    if (!(source.startY >= 0.0f && source.startY < source.endY &&
+          source.endY <= inputSizeY)) {
+        ALOGE("The source rectangle should be within 0 and %zu on the Y axis, and not empty. "
+              "%f and %f were provided respectively.",
+              inputSizeY, source.startY, source.endY);
+        return false;
+    }
+    return true;
+}
+#endif
 
 void RenderScriptToolkit::resize(const uint8_t* input, uint8_t* output, size_t inputSizeX,
                                  size_t inputSizeY, size_t vectorSize, size_t outputSizeX,
                                  size_t outputSizeY, const Restriction* restriction) {
+    resize(input, output, inputSizeX, inputSizeY, vectorSize, outputSizeX, outputSizeY,
+           ResizeFilter::CatmullRom, restriction);
+}
+
+void RenderScriptToolkit::resize(const uint8_t* input, uint8_t* output, size_t inputSizeX,
+                                 size_t inputSizeY, size_t vectorSize, size_t outputSizeX,
+                                 size_t outputSizeY, ResizeFilter filter,
+                                 const Restriction* restriction) {
+    resize(input, output, inputSizeX, inputSizeY, vectorSize, outputSizeX, outputSizeY, filter,
+           AlphaType::Premultiplied, ColorSpace::Srgb, restriction);
+}
+
+void RenderScriptToolkit::resize(const uint8_t* input, uint8_t* output, size_t inputSizeX,
+                                 size_t inputSizeY, size_t vectorSize, size_t outputSizeX,
+                                 size_t outputSizeY, ResizeFilter filter,
+                                 AlphaType alphaType, ColorSpace colorSpace,
+                                 const Restriction* restriction) {
+    const RectF source{0.0f, static_cast<float>(inputSizeX), 0.0f,
+                       static_cast<float>(inputSizeY)};
+    resize(input, output, inputSizeX, inputSizeY, vectorSize, source, outputSizeX, outputSizeY,
+           filter, alphaType, colorSpace, restriction);
+}
+
+void RenderScriptToolkit::resize(const uint8_t* input, uint8_t* output, size_t inputSizeX,
+                                 size_t inputSizeY, size_t vectorSize, const RectF& source,
+                                 size_t outputSizeX, size_t outputSizeY, ResizeFilter filter,
+                                 AlphaType alphaType, ColorSpace colorSpace,
+                                 const Restriction* restriction) {
 #ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
     if (!validRestriction(LOG_TAG, outputSizeX, outputSizeY, restriction)) {
         return;
@@ -757,10 +1909,85 @@ void RenderScriptToolkit::resize(const uint8_t* input, uint8_t* output, size_t i
         ALOGE("The vectorSize should be between 1 and 4. %zu provided.", vectorSize);
         return;
     }
+    if (!ValidSource(inputSizeX, inputSizeY, source)) {
+        return;
+    }
 #endif
 
+    // Averaging the area of an exact 2x reduction is the 2x2 box of the first mipmap level, which
+    // has its own kernels. The results are the same for pixels mixed as they are.
+    const bool wholeImage = source.startX == 0.0f && source.endX == inputSizeX &&
+                            source.startY == 0.0f && source.endY == inputSizeY;
+    if (restriction == nullptr && wholeImage && alphaType == AlphaType::Premultiplied &&
+        colorSpace == ColorSpace::Srgb && filter != ResizeFilter::Nearest &&
+        filter != ResizeFilter::Lanczos3 && inputSizeX == 2 * outputSizeX &&
+        inputSizeY == 2 * outputSizeY) {
+        generateMipmaps(input, output, inputSizeX, inputSizeY, vectorSize, 1);
+        return;
+    }
+
     ResizeTask task((const uchar*)input, (uchar*)output, inputSizeX, inputSizeY, vectorSize,
-                    outputSizeX, outputSizeY, restriction);
+                    PixelFormat::Rgba8888, source, outputSizeX, outputSizeY, filter, alphaType,
+                    colorSpace, processor->getNumberOfThreads(), restriction);
+    processor->doTask(&task);
+}
+
+void RenderScriptToolkit::resize(const uint8_t* input, uint8_t* output, size_t inputSizeX,
+                                 size_t inputSizeY, PixelFormat format, const RectF& source,
+                                 size_t outputSizeX, size_t outputSizeY, ResizeFilter filter,
+                                 AlphaType alphaType, ColorSpace colorSpace,
+                                 const Restriction* restriction) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (format != PixelFormat::Rgba8888 && format != PixelFormat::Rgb888 &&
+        format != PixelFormat::RgbaF16 && format != PixelFormat::RgbaF32) {
+        ALOGE("The format should be Rgba8888, Rgb888, RgbaF16 or RgbaF32. %d provided.",
+              static_cast<int>(format));
+        return;
+    }
+#endif
+    if (format == PixelFormat::Rgba8888) {
+        resize(input, output, inputSizeX, inputSizeY, 4, source, outputSizeX, outputSizeY, filter,
+               alphaType, colorSpace, restriction);
+        return;
+    }
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (!validRestriction(LOG_TAG, outputSizeX, outputSizeY, restriction)) {
+        return;
+    }
+    if (!ValidSource(inputSizeX, inputSizeY, source)) {
+        return;
+    }
+#endif
+
+    // Rgb888 pixels are opaque, so alphaType doesn't apply to them. Floats are mixed as they are,
+    // so colorSpace doesn't apply to them.
+    const bool packed = format == PixelFormat::Rgb888;
+    ResizeTask task((const uchar*)input, (uchar*)output, inputSizeX, inputSizeY, packed ? 3 : 4,
+                    format, source, outputSizeX, outputSizeY, filter,
+                    packed ? AlphaType::Premultiplied : alphaType, colorSpace,
+                    processor->getNumberOfThreads(), restriction);
+    processor->doTask(&task);
+}
+
+void RenderScriptToolkit::resizeToTensor(const uint8_t* input, void* output, size_t inputSizeX,
+                                         size_t inputSizeY, const RectF& source,
+                                         size_t outputSizeX, size_t outputSizeY, TensorType type,
+                                         const float* scale, const float* bias,
+                                         ResizeFilter filter, AlphaType alphaType) {
+#ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
+    if (type != TensorType::Float32 && type != TensorType::Int8) {
+        ALOGE("The type should be Float32 or Int8. %d provided.", static_cast<int>(type));
+        return;
+    }
+    if (!ValidSource(inputSizeX, inputSizeY, source)) {
+        return;
+    }
+#endif
+
+    TensorOutput tensor{type, {scale[0], scale[1], scale[2]}, {bias[0], bias[1], bias[2]}};
+    ResizeTask task((const uchar*)input, (uchar*)output, inputSizeX, inputSizeY, 4,
+                    PixelFormat::Rgba8888, source, outputSizeX, outputSizeY, filter, alphaType,
+                    ColorSpace::Srgb, processor->getNumberOfThreads(), nullptr, &tensor);
     processor->doTask(&task);
 }
 
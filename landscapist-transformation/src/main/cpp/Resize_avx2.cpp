@@ -0,0 +1,306 @@
+/*
+ * Designed and developed by 2020-2023 skydoves (Jaewoong Eum)
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdint.h>
+#include <x86intrin.h>
+
+namespace renderscript {
+
+/* AVX2 versions of the SSSE3 fixed point resize and halving kernels in x86.cpp. They take the
+ * same arguments and compute the same results. Whatever remains past the main loops is left to
+ * the SSSE3 kernels.
+ */
+
+extern void rsdIntrinsicResizeVU_K(void *dst, const void *const *rows, const void *coefficients,
+                                   int count);
+extern void rsdIntrinsicResizeHU4_K(void *dst, const void *row, const int *taps,
+                                    const void *coefficients, int count);
+extern void rsdIntrinsicResizeHU3_K(void *dst, const void *row, const int *taps,
+                                    const void *coefficients, int count);
+extern void rsdIntrinsicResizeHU2_K(void *dst, const void *row, const int *taps,
+                                    const void *coefficients, int count);
+extern void rsdIntrinsicResizeHU1_K(void *dst, const void *row, const int *taps,
+                                    const void *coefficients, int count);
+extern void rsdIntrinsicHalveU_K(void *dst, const void *row0, const void *row1, int cellSize,
+                                 int count);
+
+static inline void mulU16(__m256i p, __m256i c, __m256i *lo, __m256i *hi) {
+    __m256i l = _mm256_mullo_epi16(p, c);
+    __m256i h = _mm256_mulhi_epu16(p, c);
+    *lo = _mm256_unpacklo_epi16(l, h);
+    *hi = _mm256_unpackhi_epi16(l, h);
+}
+
+static inline __m256i loadU16(const uint8_t *p) {
+    return _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)p));
+}
+
+void rsdIntrinsicResizeVUAvx2_K(void *dst, const void *const *rows, const void *coefficients,
+                                int count) {
+    const uint16_t *c = (const uint16_t *)coefficients;
+    const uint8_t *r0 = (const uint8_t *)rows[0];
+    const uint8_t *r1 = (const uint8_t *)rows[1];
+    const uint8_t *r2 = (const uint8_t *)rows[2];
+    const uint8_t *r3 = (const uint8_t *)rows[3];
+    int16_t *out = (int16_t *)dst;
+    const __m256i c0 = _mm256_set1_epi16(c[0]);
+    const __m256i c1 = _mm256_set1_epi16(c[1]);
+    const __m256i c2 = _mm256_set1_epi16(c[2]);
+    const __m256i c3 = _mm256_set1_epi16(c[3]);
+    __m256i lo, hi, tlo, thi;
+    int x = 0;
+
+    for (; x + 16 <= count; x += 16) {
+        mulU16(loadU16(r1 + x), c1, &lo, &hi);
+        mulU16(loadU16(r0 + x), c0, &tlo, &thi);
+        lo = _mm256_sub_epi32(lo, tlo);
+        hi = _mm256_sub_epi32(hi, thi);
+        mulU16(loadU16(r2 + x), c2, &tlo, &thi);
+        lo = _mm256_add_epi32(lo, tlo);
+        hi = _mm256_add_epi32(hi, thi);
+        mulU16(loadU16(r3 + x), c3, &tlo, &thi);
+        lo = _mm256_sub_epi32(lo, tlo);
+        hi = _mm256_sub_epi32(hi, thi);
+        /* The unpacks and the pack are both within lanes, so the values come back in order. */
+        _mm256_storeu_si256((__m256i *)(out + x), _mm256_packs_epi32(_mm256_srai_epi32(lo, 10),
+                                                                     _mm256_srai_epi32(hi, 10)));
+    }
+
+    if (x < count) {
+        const void *tail[4] = {r0 + x, r1 + x, r2 + x, r3 + x};
+        rsdIntrinsicResizeVU_K(out + x, tail, coefficients, count - x);
+    }
+}
+
+/* Rounds the 32 bit sums of a and b to bytes, as the SSSE3 kernels do. The results are those of
+ * the low lane of a, its high lane, then those of b. Within each 128 bit lane, packs interleaves
+ * a and b, so the 64 bit quarters come back as 0, 2, 1, 3 and are put back in order.
+ */
+static inline __m128i roundResizeSums(__m256i a, __m256i b) {
+    const __m256i half = _mm256_set1_epi32(1 << 14);
+    __m256i v = _mm256_packs_epi32(_mm256_srai_epi32(_mm256_add_epi32(a, half), 15),
+                                   _mm256_srai_epi32(_mm256_add_epi32(b, half), 15));
+    v = _mm256_permute4x64_epi64(v, _MM_SHUFFLE(3, 1, 2, 0));
+    v = _mm256_srai_epi16(_mm256_adds_epi16(v, _mm256_set1_epi16(1 << 5)), 6);
+    return _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+}
+
+static inline __m256i loadPair(const int16_t *p0, const int16_t *p1) {
+    return _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)p0)),
+                                   _mm_loadu_si128((const __m128i *)p1), 1);
+}
+
+/* The sums of the four channels of output cells x and x + 1, one per lane. */
+static inline __m256i resizeSumsU4(const int16_t *row, const int *taps, const int16_t *c, int x) {
+    const int16_t *p0 = row + (taps[x] << 2);
+    const int16_t *p1 = row + (taps[x + 1] << 2);
+    __m256i lo = loadPair(p0, p1);
+    __m256i hi = loadPair(p0 + 8, p1 + 8);
+    __m256i w = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(c + (x << 2))));
+    __m256i outer = _mm256_madd_epi16(
+            _mm256_unpacklo_epi16(lo, _mm256_srli_si256(hi, 8)),
+            _mm256_permutevar8x32_epi32(w, _mm256_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2)));
+    __m256i inner = _mm256_madd_epi16(
+            _mm256_unpacklo_epi16(_mm256_srli_si256(lo, 8), hi),
+            _mm256_permutevar8x32_epi32(w, _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3)));
+    return _mm256_sub_epi32(outer, inner);
+}
+
+void rsdIntrinsicResizeHU4Avx2_K(void *dst, const void *row, const int *taps,
+                                 const void *coefficients, int count) {
+    const int16_t *r = (const int16_t *)row;
+    const int16_t *c = (const int16_t *)coefficients;
+    uint8_t *out = (uint8_t *)dst;
+    int x = 0;
+
+    for (; x + 4 <= count; x += 4) {
+        _mm_storeu_si128((__m128i *)(out + (x << 2)),
+                         roundResizeSums(resizeSumsU4(r, taps, c, x),
+                                         resizeSumsU4(r, taps, c, x + 2)));
+    }
+
+    if (x < count) {
+        rsdIntrinsicResizeHU4_K(out + (x << 2), row, taps + x, c + (x << 2), count - x);
+    }
+}
+
+/* The sums of the three channels of output cells x and x + 1, then 0, one per lane. As in the
+ * SSSE3 kernel, the taps of the packed RGB cells are spread out to the layout of resizeSumsU4.
+ */
+static inline __m256i resizeSumsU3(const int16_t *row, const int *taps, const int16_t *c, int x) {
+    const __m256i M0 = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1,
+                                        0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1);
+    const __m256i M1 = _mm256_setr_epi8(4, 5, 6, 7, 8, 9, -1, -1, 10, 11, 12, 13, 14, 15, -1, -1,
+                                        4, 5, 6, 7, 8, 9, -1, -1, 10, 11, 12, 13, 14, 15, -1, -1);
+    const int16_t *p0 = row + taps[x] * 3;
+    const int16_t *p1 = row + taps[x + 1] * 3;
+    __m256i lo = _mm256_shuffle_epi8(loadPair(p0, p1), M0);
+    __m256i hi = _mm256_shuffle_epi8(loadPair(p0 + 4, p1 + 4), M1);
+    __m256i w = _mm256_castsi128_si256(_mm_loadu_si128((const __m128i *)(c + (x << 2))));
+    __m256i outer = _mm256_madd_epi16(
+            _mm256_unpacklo_epi16(lo, _mm256_srli_si256(hi, 8)),
+            _mm256_permutevar8x32_epi32(w, _mm256_setr_epi32(0, 0, 0, 0, 2, 2, 2, 2)));
+    __m256i inner = _mm256_madd_epi16(
+            _mm256_unpacklo_epi16(_mm256_srli_si256(lo, 8), hi),
+            _mm256_permutevar8x32_epi32(w, _mm256_setr_epi32(1, 1, 1, 1, 3, 3, 3, 3)));
+    return _mm256_sub_epi32(outer, inner);
+}
+
+void rsdIntrinsicResizeHU3Avx2_K(void *dst, const void *row, const int *taps,
+                                 const void *coefficients, int count) {
+    /* Drops the fourth byte of each cell. */
+    const __m128i M = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const int16_t *r = (const int16_t *)row;
+    const int16_t *c = (const int16_t *)coefficients;
+    uint8_t *out = (uint8_t *)dst;
+    int x = 0;
+
+    for (; x + 4 <= count; x += 4) {
+        __m128i v = _mm_shuffle_epi8(roundResizeSums(resizeSumsU3(r, taps, c, x),
+                                                     resizeSumsU3(r, taps, c, x + 2)),
+                                     M);
+        _mm_storel_epi64((__m128i *)(out + x * 3), v);
+        *(int32_t *)(out + x * 3 + 8) = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+    }
+
+    if (x < count) {
+        rsdIntrinsicResizeHU3_K(out + x * 3, row, taps + x, c + (x << 2), count - x);
+    }
+}
+
+/* The outer and inner sums of the two channels of output cells x0 and x1, one per lane. w holds
+ * the coefficients of x0 and x1, each twice.
+ */
+static inline __m256i resizeSumsU2(const int16_t *row, const int *taps, __m256i w, int x0,
+                                   int x1) {
+    const __m256i M = _mm256_setr_epi8(0, 1, 12, 13, 4, 5, 8, 9, 2, 3, 14, 15, 6, 7, 10, 11,
+                                       0, 1, 12, 13, 4, 5, 8, 9, 2, 3, 14, 15, 6, 7, 10, 11);
+    __m256i p = loadPair(row + (taps[x0] << 1), row + (taps[x1] << 1));
+    return _mm256_madd_epi16(_mm256_shuffle_epi8(p, M), w);
+}
+
+/* The sums of the two channels of output cells x to x + 3, in order. */
+static inline __m256i resizeDifferencesU2(const int16_t *row, const int *taps, const int16_t *c,
+                                          int x) {
+    __m256i w = _mm256_loadu_si256((const __m256i *)(c + (x << 2)));
+    return _mm256_hsub_epi32(
+            resizeSumsU2(row, taps, _mm256_permute4x64_epi64(w, _MM_SHUFFLE(2, 2, 0, 0)), x,
+                         x + 2),
+            resizeSumsU2(row, taps, _mm256_permute4x64_epi64(w, _MM_SHUFFLE(3, 3, 1, 1)), x + 1,
+                         x + 3));
+}
+
+void rsdIntrinsicResizeHU2Avx2_K(void *dst, const void *row, const int *taps,
+                                 const void *coefficients, int count) {
+    const int16_t *r = (const int16_t *)row;
+    const int16_t *c = (const int16_t *)coefficients;
+    uint8_t *out = (uint8_t *)dst;
+    int x = 0;
+
+    for (; x + 8 <= count; x += 8) {
+        _mm_storeu_si128((__m128i *)(out + (x << 1)),
+                         roundResizeSums(resizeDifferencesU2(r, taps, c, x),
+                                         resizeDifferencesU2(r, taps, c, x + 4)));
+    }
+
+    if (x < count) {
+        rsdIntrinsicResizeHU2_K(out + (x << 1), row, taps + x, c + (x << 2), count - x);
+    }
+}
+
+/* The outer and inner sums of output cells x0, x0 + 1, x1 and x1 + 1, two per lane. */
+static inline __m256i resizeSumsU1(const int16_t *row, const int *taps, const int16_t *c, int x0,
+                                   int x1) {
+    const __m256i M = _mm256_setr_epi8(0, 1, 6, 7, 2, 3, 4, 5, 8, 9, 14, 15, 10, 11, 12, 13,
+                                       0, 1, 6, 7, 2, 3, 4, 5, 8, 9, 14, 15, 10, 11, 12, 13);
+    __m128i p0 = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)(row + taps[x0])),
+                                    _mm_loadl_epi64((const __m128i *)(row + taps[x0 + 1])));
+    __m128i p1 = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)(row + taps[x1])),
+                                    _mm_loadl_epi64((const __m128i *)(row + taps[x1 + 1])));
+    __m256i p = _mm256_inserti128_si256(_mm256_castsi128_si256(p0), p1, 1);
+    __m256i w = loadPair(c + (x0 << 2), c + (x1 << 2));
+    return _mm256_madd_epi16(_mm256_shuffle_epi8(p, M), w);
+}
+
+/* The sums of output cells x to x + 7, in order. */
+static inline __m256i resizeDifferencesU1(const int16_t *row, const int *taps, const int16_t *c,
+                                          int x) {
+    return _mm256_hsub_epi32(resizeSumsU1(row, taps, c, x, x + 4),
+                             resizeSumsU1(row, taps, c, x + 2, x + 6));
+}
+
+void rsdIntrinsicResizeHU1Avx2_K(void *dst, const void *row, const int *taps,
+                                 const void *coefficients, int count) {
+    const int16_t *r = (const int16_t *)row;
+    const int16_t *c = (const int16_t *)coefficients;
+    uint8_t *out = (uint8_t *)dst;
+    int x = 0;
+
+    for (; x + 16 <= count; x += 16) {
+        _mm_storeu_si128((__m128i *)(out + x),
+                         roundResizeSums(resizeDifferencesU1(r, taps, c, x),
+                                         resizeDifferencesU1(r, taps, c, x + 8)));
+    }
+
+    if (x < count) {
+        rsdIntrinsicResizeHU1_K(out + x, row, taps + x, c + (x << 2), count - x);
+    }
+}
+
+/* The sums of the 2x2 cells of 16 output bytes, from the 32 bytes at p0 and at p1. */
+static inline __m256i halveSums(const uint8_t *p0, const uint8_t *p1, __m256i M) {
+    const __m256i ones = _mm256_set1_epi8(1);
+    return _mm256_add_epi16(
+            _mm256_maddubs_epi16(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)p0), M),
+                                 ones),
+            _mm256_maddubs_epi16(_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)p1), M),
+                                 ones));
+}
+
+void rsdIntrinsicHalveUAvx2_K(void *dst, const void *row0, const void *row1, int cellSize,
+                              int count) {
+    const uint8_t *r0 = (const uint8_t *)row0;
+    const uint8_t *r1 = (const uint8_t *)row1;
+    uint8_t *out = (uint8_t *)dst;
+    const __m256i M = cellSize == 4
+            ? _mm256_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15,
+                               0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15)
+            : cellSize == 2
+                    ? _mm256_setr_epi8(0, 2, 1, 3, 4, 6, 5, 7, 8, 10, 9, 11, 12, 14, 13, 15,
+                                       0, 2, 1, 3, 4, 6, 5, 7, 8, 10, 9, 11, 12, 14, 13, 15)
+                    : _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15,
+                                       0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m256i two = _mm256_set1_epi16(2);
+    const int bytes = count * cellSize;
+    __m256i lo, hi;
+    int i = 0;
+
+    for (; i + 32 <= bytes; i += 32) {
+        lo = _mm256_srli_epi16(_mm256_add_epi16(halveSums(r0 + 2 * i, r1 + 2 * i, M), two), 2);
+        hi = _mm256_srli_epi16(
+                _mm256_add_epi16(halveSums(r0 + 2 * i + 32, r1 + 2 * i + 32, M), two), 2);
+        /* packus works within lanes, which leaves the 64 bit quarters as 0, 2, 1, 3. */
+        _mm256_storeu_si256((__m256i *)(out + i),
+                            _mm256_permute4x64_epi64(_mm256_packus_epi16(lo, hi),
+                                                     _MM_SHUFFLE(3, 1, 2, 0)));
+    }
+
+    if (i < bytes) {
+        rsdIntrinsicHalveU_K(out + i, r0 + 2 * i, r1 + 2 * i, cellSize, (bytes - i) / cellSize);
+    }
+}
+
+}  // namespace renderscript
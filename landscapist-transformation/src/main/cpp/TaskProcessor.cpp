@@ -16,7 +16,9 @@
 
 #include "TaskProcessor.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstdlib>
 #include <sys/prctl.h>
 
 #include "RenderScriptToolkit.h"
@@ -26,11 +28,81 @@
 
 namespace renderscript {
 
+ScratchBuffers::~ScratchBuffers() {
+    for (void* buffer : mBuffers) {
+        free(buffer);
+    }
+}
+
+void* ScratchBuffers::get(int threadIndex, size_t sizeInBytes) {
+    if (sizeInBytes > mSizes[threadIndex] || mBuffers[threadIndex] == nullptr) {
+        free(mBuffers[threadIndex]);
+        void* buffer = nullptr;
+        if (posix_memalign(&buffer, kAlignment, std::max(sizeInBytes, kAlignment)) != 0) {
+            ALOGE("Could not allocate %zu bytes of scratch memory.", sizeInBytes);
+            buffer = nullptr;
+        }
+        mBuffers[threadIndex] = buffer;
+        mSizes[threadIndex] = buffer != nullptr ? sizeInBytes : 0;
+    }
+    return mBuffers[threadIndex];
+}
+
+BufferPool::~BufferPool() {
+    for (const Buffer& buffer : mFree) {
+        free(buffer.data);
+    }
+    for (const Buffer& buffer : mInUse) {
+        free(buffer.data);
+    }
+}
+
+void* BufferPool::acquire(size_t sizeInBytes) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    auto best = mFree.end();
+    for (auto it = mFree.begin(); it != mFree.end(); ++it) {
+        if (it->size >= sizeInBytes && (best == mFree.end() || it->size < best->size)) {
+            best = it;
+        }
+    }
+    if (best != mFree.end()) {
+        mInUse.push_back(*best);
+        mFree.erase(best);
+        return mInUse.back().data;
+    }
+
+    void* data = nullptr;
+    const size_t alignment = ScratchBuffers::kAlignment;
+    if (posix_memalign(&data, alignment, std::max(sizeInBytes, alignment)) != 0) {
+        ALOGE("Could not allocate %zu bytes for an intermediate image.", sizeInBytes);
+        return nullptr;
+    }
+    mInUse.push_back({data, sizeInBytes});
+    return data;
+}
+
+void BufferPool::release(void* buffer) {
+    std::lock_guard<std::mutex> lock(mMutex);
+    for (auto it = mInUse.begin(); it != mInUse.end(); ++it) {
+        if (it->data == buffer) {
+            mFree.push_back(*it);
+            mInUse.erase(it);
+            break;
+        }
+    }
+    if (mFree.size() > kMaxFreeBuffers) {
+        auto smallest = std::min_element(
+                mFree.begin(), mFree.end(),
+                [](const Buffer& a, const Buffer& b) { return a.size < b.size; });
+        free(smallest->data);
+        mFree.erase(smallest);
+    }
+}
+
 int Task::setTiling(unsigned int targetTileSizeInBytes) {
     // Empirically, values smaller than 1000 are unlikely to give good performance.
     targetTileSizeInBytes = std::max(1000u, targetTileSizeInBytes);
-    const size_t cellSizeInBytes =
-            mVectorSize;  // If we add float support, vectorSize * 4 for that.
+    const size_t cellSizeInBytes = mCellSizeInBytes != 0 ? mCellSizeInBytes : mVectorSize;
     const size_t targetCellsPerTile = targetTileSizeInBytes / cellSizeInBytes;
     assert(targetCellsPerTile > 0);
 
@@ -46,6 +118,14 @@ int Task::setTiling(unsigned int targetTileSizeInBytes) {
         cellsToProcessY = mRestriction->endY - mRestriction->startY;
     }
 
+    if (mBandCount != 0) {
+        mTilesPerRow = 1;
+        mCellsPerTileX = cellsToProcessX;
+        mCellsPerTileY = divideRoundingUp(cellsToProcessY, mBandCount);
+        mTilesPerColumn = divideRoundingUp(cellsToProcessY, mCellsPerTileY);
+        return mTilesPerColumn;
+    }
+
     // We want rows as large as possible, as the SIMD code we have is more efficient with
     // large rows.
     mTilesPerRow = divideRoundingUp(cellsToProcessX, targetCellsPerTile);
@@ -98,7 +178,10 @@ void Task::processTile(unsigned int threadIndex, size_t tileIndex) {
 }
 
 TaskProcessor::TaskProcessor(unsigned int numThreads)
-    : mUsesSimd{cpuSupportsSimd()},
+    : mCpuUsesSimd{cpuSupportsSimd()},
+      mCpuX86Extension{cpuX86Extension()},
+      mUsesSimd{mCpuUsesSimd},
+      mX86Extension{mCpuX86Extension},
       /* If the requested number of threads is 0, we'll decide based on the number of cores.
        * Through empirical testing, we've found that using more than 6 threads does not help.
        * There may be more optimal choices to make depending on the SoC but we'll stick to
@@ -180,6 +263,7 @@ void TaskProcessor::processTilesOfWork(int threadIndex, bool returnWhenNoWork) {
 void TaskProcessor::doTask(Task* task) {
     std::lock_guard<std::mutex> lockGuard(mTaskMutex);
     task->setUsesSimd(mUsesSimd);
+    task->setX86Extension(mX86Extension);
     mCurrentTask = task;
     // Notify the thread pool of available work.
     startWork(task);
@@ -190,6 +274,12 @@ void TaskProcessor::doTask(Task* task) {
     mCurrentTask = nullptr;
 }
 
+void TaskProcessor::limitSimd(bool usesSimd, X86Extension maxExtension) {
+    std::lock_guard<std::mutex> lockGuard(mTaskMutex);
+    mUsesSimd = mCpuUsesSimd && usesSimd;
+    mX86Extension = mUsesSimd ? std::min(mCpuX86Extension, maxExtension) : X86Extension::None;
+}
+
 void TaskProcessor::startWork(Task* task) {
     /**
      * The size in bytes that we're hoping each tile will be. If this value is too small,
@@ -26,8 +26,85 @@
 #include <thread>
 #include <vector>
 
+#include "Utils.h"
+
 namespace renderscript {
 
+/**
+ * Working memory that each thread keeps from one tile to the next, e.g. to hold the intermediate
+ * row of a separable filter. Allocating it from the heap lets the rows be of any width without
+ * putting large arrays on the pool threads' stacks. The buffers only grow, so a task pays for
+ * the allocation once per thread rather than once per tile.
+ */
+class ScratchBuffers {
+   public:
+    /**
+     * The alignment of the buffers, enough for the widest SIMD loads we do.
+     */
+    static constexpr size_t kAlignment = 64;
+
+    explicit ScratchBuffers(size_t threadCount)
+        : mBuffers(threadCount, nullptr), mSizes(threadCount, 0) {}
+    ~ScratchBuffers();
+
+    ScratchBuffers(const ScratchBuffers&) = delete;
+    ScratchBuffers& operator=(const ScratchBuffers&) = delete;
+
+    /**
+     * Returns the buffer of a thread, making sure it has room for at least sizeInBytes. The
+     * content is not preserved when the buffer grows.
+     *
+     * @param threadIndex The index of the thread that will use the buffer.
+     * @param sizeInBytes The minimum size of the buffer.
+     * @return A buffer aligned to kAlignment, or nullptr if the allocation failed.
+     */
+    void* get(int threadIndex, size_t sizeInBytes);
+
+   private:
+    std::vector<void*> mBuffers;  // One buffer per thread.
+    std::vector<size_t> mSizes;   // The size in bytes of each buffer.
+};
+
+/**
+ * Large buffers kept from one Toolkit call to the next, e.g. for the intermediate images of a
+ * multi-pass op. An op that runs every frame then doesn't allocate and free megabytes each time.
+ * The pool keeps at most kMaxFreeBuffers buffers when they're not in use; they're freed with the
+ * pool. It can be used from several threads at once.
+ */
+class BufferPool {
+   public:
+    static constexpr size_t kMaxFreeBuffers = 2;
+
+    BufferPool() = default;
+    ~BufferPool();
+
+    BufferPool(const BufferPool&) = delete;
+    BufferPool& operator=(const BufferPool&) = delete;
+
+    /**
+     * Returns a buffer of at least sizeInBytes, reusing the smallest free one that's large
+     * enough. Each buffer should be given back with release().
+     *
+     * @return A buffer aligned to ScratchBuffers::kAlignment, or nullptr if the allocation failed.
+     */
+    void* acquire(size_t sizeInBytes);
+
+    /**
+     * Gives back a buffer returned by acquire(). If the pool already holds kMaxFreeBuffers, the
+     * smallest one is freed.
+     */
+    void release(void* buffer);
+
+   private:
+    struct Buffer {
+        void* data;
+        size_t size;
+    };
+    std::mutex mMutex;
+    std::vector<Buffer> mFree /*GUARDED_BY(mMutex)*/;
+    std::vector<Buffer> mInUse /*GUARDED_BY(mMutex)*/;
+};
+
 /**
  * Description of the data to be processed for one Toolkit method call, e.g. one blur or one
  * blend operation.
@@ -41,8 +118,8 @@ namespace renderscript {
  *    BlurTask task(in, out, sizeX, sizeY, vectorSize, etc);
  *    processor->doTask(&task);
  *
- * The TaskProcessor should call setTiling() and setUsesSimd() once, before calling processTile().
- * Other classes should not call setTiling(), setUsesSimd(), and processTile().
+ * The TaskProcessor should call setTiling(), setUsesSimd(), and setX86Extension() once, before
+ * calling processTile(). Other classes should not call these methods.
  */
 class Task {
    protected:
@@ -72,6 +149,23 @@ class Task {
      * Whether the processor we're working on supports SIMD operations.
      */
     bool mUsesSimd = false;
+    /**
+     * The widest x86 extension beyond SSSE3 the processor supports. Only meaningful if mUsesSimd.
+     */
+    X86Extension mX86Extension = X86Extension::None;
+    /**
+     * When not 0, setTiling() divides the work into this many horizontal bands of whole rows
+     * instead of tiles of the target size, e.g. for tasks that overwrite their input and have to
+     * know which rows their neighbors read. Band i starts at row i * divideRoundingUp(rows,
+     * mBandCount). Derived classes set it in their constructor.
+     */
+    size_t mBandCount = 0;
+    /**
+     * When not 0, the number of bytes of each cell, for tasks whose cells aren't vectorSize
+     * bytes, e.g. cells of floats. setTiling() sizes the tiles in bytes with it. Derived classes
+     * set it in their constructor.
+     */
+    size_t mCellSizeInBytes = 0;
 
    private:
     /**
@@ -119,6 +213,8 @@ class Task {
 
     void setUsesSimd(bool uses) { mUsesSimd = uses; }
 
+    void setX86Extension(X86Extension extension) { mX86Extension = extension; }
+
     /**
      * Divide the work into a number of tiles that can be distributed to the various threads.
      * A tile will be a rectangular region. To be robust, we'll want to handle regular cases
@@ -160,7 +256,19 @@ class TaskProcessor {
     /**
      * Does this processor support SIMD-like instructions?
      */
-    const bool mUsesSimd;
+    const bool mCpuUsesSimd;
+    /**
+     * Which wider x86 extension, if any, this processor supports.
+     */
+    const X86Extension mCpuX86Extension;
+    /**
+     * Whether the tasks use the SIMD kernels. mCpuUsesSimd unless lowered by limitSimd().
+     */
+    bool mUsesSimd /*GUARDED_BY(mTaskMutex)*/;
+    /**
+     * The wider x86 kernels the tasks use. mCpuX86Extension unless lowered by limitSimd().
+     */
+    X86Extension mX86Extension /*GUARDED_BY(mTaskMutex)*/;
     /**
      * The number of separate threads we'll spawn. It's one less than the number of threads that
      * do the work as the client thread that starts the work will also be used.
@@ -209,6 +317,10 @@ class TaskProcessor {
      * mNumberOfPoolThreads + 1.
      */
     int mTilesInProcess /*GUARDED_BY(mQueueMutex)*/ = 0;
+    /**
+     * The intermediate images of the ops that need them.
+     */
+    BufferPool mBufferPool;
 
     /**
      * Determines how we'll tile the work and signals the thread pool of available work.
@@ -250,11 +362,38 @@ class TaskProcessor {
      */
     void doTask(Task* task);
 
+    /**
+     * Limits the kernels used by the following tasks, e.g. to compare the SIMD kernels with
+     * the scalar code. The kernels the processor doesn't support stay off whatever is asked.
+     * Waits for the current task, if any, to complete.
+     *
+     * @param usesSimd Whether the tasks may use the SIMD kernels.
+     * @param maxExtension The widest x86 kernels the tasks may use.
+     */
+    void limitSimd(bool usesSimd, X86Extension maxExtension);
+
+    /**
+     * Whether the tasks use the SIMD kernels, and which wider x86 kernels. See limitSimd().
+     */
+    bool usesSimd() {
+        std::lock_guard<std::mutex> lockGuard(mTaskMutex);
+        return mUsesSimd;
+    }
+    X86Extension x86Extension() {
+        std::lock_guard<std::mutex> lockGuard(mTaskMutex);
+        return mX86Extension;
+    }
+
     /**
      * Some Tasks need to allocate temporary storage for each worker thread.
      * This provides the number of threads.
      */
     unsigned int getNumberOfThreads() const { return mNumberOfPoolThreads + 1; }
+
+    /**
+     * The pool of buffers for the intermediate images of the ops.
+     */
+    BufferPool* getBufferPool() { return &mBufferPool; }
 };
 
 }  // namespace renderscript
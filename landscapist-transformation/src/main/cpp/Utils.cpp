@@ -17,6 +17,7 @@
 #include "Utils.h"
 
 #include <cpu-features.h>
+#include <cmath>
 
 #include "RenderScriptToolkit.h"
 
@@ -43,6 +44,54 @@ bool cpuSupportsSimd() {
     return false;
 }
 
+X86Extension cpuX86Extension() {
+#if defined(__i386__) || defined(__x86_64__)
+    AndroidCpuFamily family = android_getCpuFamily();
+    uint64_t features = android_getCpuFeatures();
+
+    if ((family != ANDROID_CPU_FAMILY_X86 && family != ANDROID_CPU_FAMILY_X86_64) ||
+        !(features & ANDROID_CPU_X86_FEATURE_AVX2)) {
+        return X86Extension::None;
+    }
+    // The AVX2 and AVX-512 kernels are built with FMA, which some CPUs and VMs turn off
+    // separately. cpufeatures reports neither, so the compiler runtime checks them. It also
+    // checks that the OS saves the ZMM registers on context switches.
+    if (!__builtin_cpu_supports("fma")) {
+        return X86Extension::None;
+    }
+    if (__builtin_cpu_supports("avx512f")) {
+        return X86Extension::Avx512;
+    }
+    return X86Extension::Avx2;
+#else
+    return X86Extension::None;
+#endif
+}
+
+static float decodeSrgb(float v) {
+    return v <= 0.04045f ? v / 12.92f : powf((v + 0.055f) / 1.055f, 2.4f);
+}
+
+static float encodeSrgb(float v) {
+    return v <= 0.0031308f ? v * 12.92f : 1.055f * powf(v, 1.0f / 2.4f) - 0.055f;
+}
+
+const ColorTables& ColorTables::get() {
+    static const ColorTables* tables = [] {
+        ColorTables* t = new ColorTables;
+        for (int i = 0; i < 256; i++) {
+            t->srgbToLinear[i] = 255.0f * decodeSrgb(i / 255.0f);
+            t->unpremultiply[i] = i == 0 ? 0.0f : 255.0f / i;
+        }
+        for (int i = 0; i <= kLinearSteps; i++) {
+            t->linearToSrgb[i] =
+                    (uint8_t)(255.0f * encodeSrgb((float)i / kLinearSteps) + 0.5f);
+        }
+        return t;
+    }();
+    return *tables;
+}
+
 #ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
 bool validRestriction(const char* tag, size_t sizeX, size_t sizeY, const Restriction* restriction) {
     if (restriction == nullptr) {
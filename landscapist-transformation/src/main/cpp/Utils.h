@@ -17,19 +17,14 @@
 #ifndef ANDROID_RENDERSCRIPT_TOOLKIT_UTILS_H
 #define ANDROID_RENDERSCRIPT_TOOLKIT_UTILS_H
 
+#include <algorithm>
 #include <android/log.h>
+#include <math.h>
 #include <stddef.h>
+#include <string.h>
 
 namespace renderscript {
 
-/* The Toolkit does not support floating point buffers but the original RenderScript Intrinsics
- * did for some operations. That code was preserved and protected by
- * ANDROID_RENDERSCRIPT_TOOLKIT_SUPPORTS_FLOAT.
- */
-// TODO: On final packaging, decide whether this should be define in the build file, and for which
-// config.
-// #define ANDROID_RENDERSCRIPT_TOOLKIT_SUPPORTS_FLOAT
-
 /* If we release the Toolkit as a C++ API, we'll want to enable validation at the C++ level
  * by uncommenting this define.
  *
@@ -130,6 +125,69 @@ inline float clamp(float amount, float low, float high) {
     return amount < low ? low : (amount > high ? high : amount);
 }
 
+/**
+ * Converts an IEEE 754 half precision value, e.g. a channel of an RGBA_F16 Bitmap, to a float.
+ */
+inline float halfToFloat(uint16_t half) {
+#if defined(__aarch64__)
+    // ARMv8 converts halves in hardware.
+    __fp16 value;
+    memcpy(&value, &half, sizeof(value));
+    return value;
+#else
+    const uint32_t sign = (uint32_t)(half & 0x8000) << 16;
+    const uint32_t exponent = (half >> 10) & 0x1f;
+    const uint32_t mantissa = half & 0x3ff;
+    uint32_t bits;
+    if (exponent == 0) {
+        // Zero or subnormal, i.e. mantissa * 2^-24.
+        const float value = (float)mantissa * (1.0f / 16777216.0f);
+        return sign ? -value : value;
+    } else if (exponent == 0x1f) {
+        bits = sign | 0x7f800000 | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 112) << 23) | (mantissa << 13);
+    }
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+#endif
+}
+
+/**
+ * Converts a float to the nearest IEEE 754 half precision value, rounding ties to even.
+ */
+inline uint16_t floatToHalf(float value) {
+#if defined(__aarch64__)
+    const __fp16 rounded = value;
+    uint16_t half;
+    memcpy(&half, &rounded, sizeof(half));
+    return half;
+#else
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    const uint32_t sign = (bits >> 16) & 0x8000;
+    uint32_t magnitude = bits & 0x7fffffff;
+    if (magnitude >= 0x7f800000) {
+        // Infinity or NaN.
+        return sign | 0x7c00 | (magnitude > 0x7f800000 ? 0x200 : 0);
+    }
+    if (magnitude >= 0x477ff000) {
+        // Rounds to a value past the largest half.
+        return sign | 0x7c00;
+    }
+    if (magnitude < 0x38800000) {
+        // Below the smallest normal half, 2^-14.
+        float absolute;
+        memcpy(&absolute, &magnitude, sizeof(absolute));
+        return sign | (uint16_t)lrintf(absolute * 16777216.0f);
+    }
+    // Rebias the exponent from 127 to 15 and round the 13 bits that are dropped.
+    magnitude += 0xc8000fff + ((magnitude >> 13) & 1);
+    return sign | (magnitude >> 13);
+#endif
+}
+
 #ifdef ANDROID_RENDERSCRIPT_TOOLKIT_VALIDATE
 struct Restriction;
 
@@ -142,6 +200,101 @@ bool validRestriction(const char* tag, size_t sizeX, size_t sizeY, const Restric
  */
 bool cpuSupportsSimd();
 
+/**
+ * The x86 vector extensions we have kernels for on top of the SSSE3 baseline checked by
+ * cpuSupportsSimd(). Ordered from the least to the most capable.
+ */
+enum class X86Extension { None, Avx2, Avx512 };
+
+/**
+ * Returns the most capable x86 extension supported by both the processor and the OS. Always
+ * returns X86Extension::None on other architectures.
+ */
+X86Extension cpuX86Extension();
+
+/**
+ * Lookup tables to convert color channels between sRGB-encoded and linear-light values, and to
+ * unpremultiply them. All the float values are kept in the [0, 255] range so that they mix
+ * freely with values converted straight from bytes.
+ */
+struct ColorTables {
+    // The number of steps used to quantize linear values when converting them back to sRGB.
+    // Fine enough that every sRGB byte can be reached, even the darkest ones.
+    static constexpr int kLinearSteps = 4096;
+
+    // The linear-light value of each sRGB-encoded byte.
+    float srgbToLinear[256];
+    // The sRGB-encoded byte of linear values quantized to kLinearSteps steps.
+    uint8_t linearToSrgb[kLinearSteps + 1];
+    // 255 / alpha for each alpha value, and 0 for a fully transparent pixel.
+    float unpremultiply[256];
+
+    /**
+     * Returns the tables, computing them the first time this is called.
+     */
+    static const ColorTables& get();
+};
+
+/**
+ * Converts an input pixel to the space in which it's filtered, i.e. premultiplied, and in linear
+ * light if kLinear is set. The values are kept in the [0, 255] range.
+ *
+ * @param in The pixel to convert.
+ * @param tables The color lookup tables.
+ */
+template <bool kUnpremultiplied, bool kLinear>
+inline float4 decodePixel(uchar4 in, const ColorTables& tables) {
+    float4 f = convert<float4>(in);
+    if (kLinear) {
+        if (!kUnpremultiplied) {
+            // The sRGB curve applies to the unpremultiplied color.
+            const float u = tables.unpremultiply[in.w];
+            in.x = (uchar)std::min(f.x * u + 0.5f, 255.0f);
+            in.y = (uchar)std::min(f.y * u + 0.5f, 255.0f);
+            in.z = (uchar)std::min(f.z * u + 0.5f, 255.0f);
+        }
+        f.x = tables.srgbToLinear[in.x];
+        f.y = tables.srgbToLinear[in.y];
+        f.z = tables.srgbToLinear[in.z];
+    }
+    const float a = f.w * (1.0f / 255.0f);
+    f.x *= a;
+    f.y *= a;
+    f.z *= a;
+    return f;
+}
+
+/**
+ * Converts a filtered pixel back to the format of the input. The inverse of decodePixel().
+ *
+ * @param in The filtered pixel, premultiplied, with values in the [0, 255] range.
+ * @param tables The color lookup tables.
+ */
+template <bool kUnpremultiplied, bool kLinear>
+inline uchar4 encodePixel(float4 in, const ColorTables& tables) {
+    uchar4 out;
+    out.w = (uchar)std::min(in.w + 0.5f, 255.0f);
+    const float4 c = in * tables.unpremultiply[out.w];
+    if (kLinear) {
+        const float scale = ColorTables::kLinearSteps / 255.0f;
+        const float last = ColorTables::kLinearSteps;
+        out.x = tables.linearToSrgb[(int)std::min(c.x * scale + 0.5f, last)];
+        out.y = tables.linearToSrgb[(int)std::min(c.y * scale + 0.5f, last)];
+        out.z = tables.linearToSrgb[(int)std::min(c.z * scale + 0.5f, last)];
+    } else {
+        out.x = (uchar)std::min(c.x + 0.5f, 255.0f);
+        out.y = (uchar)std::min(c.y + 0.5f, 255.0f);
+        out.z = (uchar)std::min(c.z + 0.5f, 255.0f);
+    }
+    if (!kUnpremultiplied) {
+        // Android premultiplies the sRGB encoded values.
+        out.x = (uchar)((out.x * out.w + 127) / 255);
+        out.y = (uchar)((out.y * out.w + 127) / 255);
+        out.z = (uchar)((out.z * out.w + 127) / 255);
+    }
+    return out;
+}
+
 inline size_t divideRoundingUp(size_t a, size_t b) {
     return a / b + (a % b == 0 ? 0 : 1);
 }
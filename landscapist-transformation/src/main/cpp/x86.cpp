@@ -83,7 +83,6 @@ extern "C" void rsdIntrinsicConvolve3x3_K(void *dst, const void *y0,
                                           const short *coef, uint32_t count) {
     __m128i x;
     __m128i c0, c2, c4, c6, c8;
-    __m128i r0, r1, r2;
     __m128i p0, p1, p2, p3, p4, p5, p6, p7, p8, p9, p10, p11;
     __m128i o0, o1;
     uint32_t i;
@@ -303,7 +302,7 @@ void rsdIntrinsicColorMatrixDot_K(void *dst, const void *src,
 }
 
 void rsdIntrinsicBlurVFU4_K(void *dst,
-                          const void *pin, int stride, const void *gptr,
+                          const void *const *rows, const void *gptr,
                           int rct, int x1, int x2) {
     const char *pi;
     __m128i pi0, pi1;
@@ -313,7 +312,6 @@ void rsdIntrinsicBlurVFU4_K(void *dst,
     int r;
 
     for (; x1 < x2; x1 += 2) {
-        pi = (const char *)pin + (x1 << 2);
         bp0 = _mm_setzero_ps();
         bp1 = _mm_setzero_ps();
 
@@ -321,6 +319,8 @@ void rsdIntrinsicBlurVFU4_K(void *dst,
             x = _mm_load_ss((const float *)gptr + r);
             x = _mm_shuffle_ps(x, x, _MM_SHUFFLE(0, 0, 0, 0));
 
+            pi = (const char *)rows[r] + (x1 << 2);
+
             pi0 = _mm_cvtsi32_si128(*(const int *)pi);
             pi1 = _mm_cvtsi32_si128(*((const int *)pi + 1));
 
@@ -329,8 +329,6 @@ void rsdIntrinsicBlurVFU4_K(void *dst,
 
             bp0 = _mm_add_ps(bp0, _mm_mul_ps(pf0, x));
             bp1 = _mm_add_ps(bp1, _mm_mul_ps(pf1, x));
-
-            pi += stride;
         }
 
         _mm_storeu_ps((float *)dst, bp0);
@@ -378,7 +376,7 @@ void rsdIntrinsicBlurHFU1_K(void *dst,
     const __m128i Mu8 = _mm_set_epi32(0xffffffff, 0xffffffff, 0xffffffff, 0x0c080400);
     const float *pi;
     __m128 pf, g0, g1, g2, g3, gx, p0, p1;
-    __m128i o;
+    __m128i i0, i1, o;
     int r;
 
     for (; x1 < x2; x1+=4) {
@@ -392,15 +390,17 @@ void rsdIntrinsicBlurHFU1_K(void *dst,
             gx = _mm_loadu_ps((const float *)gptr + r);
             p0 = _mm_loadu_ps(pi + r);
             p1 = _mm_loadu_ps(pi + r + 4);
+            i0 = _mm_castps_si128(p0);
+            i1 = _mm_castps_si128(p1);
 
             g0 = _mm_shuffle_ps(gx, gx, _MM_SHUFFLE(0, 0, 0, 0));
             pf = _mm_add_ps(pf, _mm_mul_ps(g0, p0));
             g1 = _mm_shuffle_ps(gx, gx, _MM_SHUFFLE(1, 1, 1, 1));
-            pf = _mm_add_ps(pf, _mm_mul_ps(g1, _mm_alignr_epi8(p1, p0, 4)));
+            pf = _mm_add_ps(pf, _mm_mul_ps(g1, _mm_castsi128_ps(_mm_alignr_epi8(i1, i0, 4))));
             g2 = _mm_shuffle_ps(gx, gx, _MM_SHUFFLE(2, 2, 2, 2));
-            pf = _mm_add_ps(pf, _mm_mul_ps(g2, _mm_alignr_epi8(p1, p0, 8)));
+            pf = _mm_add_ps(pf, _mm_mul_ps(g2, _mm_castsi128_ps(_mm_alignr_epi8(i1, i0, 8))));
             g3 = _mm_shuffle_ps(gx, gx, _MM_SHUFFLE(3, 3, 3, 3));
-            pf = _mm_add_ps(pf, _mm_mul_ps(g3, _mm_alignr_epi8(p1, p0, 12)));
+            pf = _mm_add_ps(pf, _mm_mul_ps(g3, _mm_castsi128_ps(_mm_alignr_epi8(i1, i0, 12))));
         }
 
         o = _mm_cvtps_epi32(pf);
@@ -602,7 +602,6 @@ extern "C" void rsdIntrinsicConvolve5x5_K(void *dst, const void *y0,
     __m128i x;
     __m128i c0, c2, c4, c6, c8, c10, c12;
     __m128i c14, c16, c18, c20, c22, c24;
-    __m128i r0, r1, r2, r3, r4, r5, r6, r7, r8, r9;
     __m128i p0,  p1,  p2,  p3,  p4,  p5,  p6,  p7;
     __m128i p8,  p9, p10, p11, p12, p13, p14, p15;
     __m128i p16, p17, p18, p19, p20, p21, p22, p23;
@@ -1318,4 +1317,254 @@ void rsdIntrinsicBlendSub_K(void *dst, const void *src, uint32_t count8) {
     }
 }
 
+/* The fixed point bicubic resize. The results match those of the ARM assembly in
+ * Resize_advsimd.S bit for bit.
+ *
+ * The vertical pass computes count 16 bit values with 14 fractional bits from four rows of
+ * bytes, (r1 * c1 - r0 * c0 + r2 * c2 - r3 * c3) >> 10, where c holds the four unsigned 16 bit
+ * coefficients.
+ */
+static inline void mulU16(__m128i p, __m128i c, __m128i *lo, __m128i *hi) {
+    __m128i l = _mm_mullo_epi16(p, c);
+    __m128i h = _mm_mulhi_epu16(p, c);
+    *lo = _mm_unpacklo_epi16(l, h);
+    *hi = _mm_unpackhi_epi16(l, h);
+}
+
+void rsdIntrinsicResizeVU_K(void *dst, const void *const *rows, const void *coefficients,
+                            int count) {
+    const uint16_t *c = (const uint16_t *)coefficients;
+    const uint8_t *r0 = (const uint8_t *)rows[0];
+    const uint8_t *r1 = (const uint8_t *)rows[1];
+    const uint8_t *r2 = (const uint8_t *)rows[2];
+    const uint8_t *r3 = (const uint8_t *)rows[3];
+    int16_t *out = (int16_t *)dst;
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i c0 = _mm_set1_epi16(c[0]);
+    const __m128i c1 = _mm_set1_epi16(c[1]);
+    const __m128i c2 = _mm_set1_epi16(c[2]);
+    const __m128i c3 = _mm_set1_epi16(c[3]);
+    __m128i lo, hi, tlo, thi;
+    int x = 0;
+
+    for (; x + 8 <= count; x += 8) {
+        mulU16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r1 + x)), zero), c1, &lo, &hi);
+        mulU16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r0 + x)), zero), c0, &tlo, &thi);
+        lo = _mm_sub_epi32(lo, tlo);
+        hi = _mm_sub_epi32(hi, thi);
+        mulU16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r2 + x)), zero), c2, &tlo, &thi);
+        lo = _mm_add_epi32(lo, tlo);
+        hi = _mm_add_epi32(hi, thi);
+        mulU16(_mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(r3 + x)), zero), c3, &tlo, &thi);
+        lo = _mm_sub_epi32(lo, tlo);
+        hi = _mm_sub_epi32(hi, thi);
+        _mm_storeu_si128((__m128i *)(out + x),
+                         _mm_packs_epi32(_mm_srai_epi32(lo, 10), _mm_srai_epi32(hi, 10)));
+    }
+
+    for (; x < count; x++) {
+        int32_t v = (r1[x] * c[1] - r0[x] * c[0] + r2[x] * c[2] - r3[x] * c[3]) >> 10;
+        out[x] = v < -32768 ? -32768 : (v > 32767 ? 32767 : v);
+    }
+}
+
+/* The horizontal passes compute count output cells from the row of the vertical pass. Output
+ * cell x uses the four cells from taps[x], with the four coefficients at coefficients + 4 * x.
+ * They are those of taps 0, 3, 1 and 2, and the sum is that of taps 0 and 3 minus that of taps
+ * 1 and 2. The sums have 29 fractional bits. They are rounded to 14, then to 0.
+ */
+static inline __m128i roundResizeSums(__m128i a, __m128i b) {
+    const __m128i half = _mm_set1_epi32(1 << 14);
+    return _mm_packs_epi32(_mm_srai_epi32(_mm_add_epi32(a, half), 15),
+                           _mm_srai_epi32(_mm_add_epi32(b, half), 15));
+}
+
+static inline __m128i roundResizeValues(__m128i a, __m128i b) {
+    const __m128i half = _mm_set1_epi16(1 << 5);
+    return _mm_packus_epi16(_mm_srai_epi16(_mm_adds_epi16(a, half), 6),
+                            _mm_srai_epi16(_mm_adds_epi16(b, half), 6));
+}
+
+/* The sums of the four channels of output cell x. */
+static inline __m128i resizeSumsU4(const int16_t *row, const int *taps, const int16_t *c, int x) {
+    const int16_t *p = row + (taps[x] << 2);
+    __m128i lo = _mm_loadu_si128((const __m128i *)p);
+    __m128i hi = _mm_loadu_si128((const __m128i *)(p + 8));
+    __m128i w = _mm_loadl_epi64((const __m128i *)(c + (x << 2)));
+    __m128i outer = _mm_madd_epi16(_mm_unpacklo_epi16(lo, _mm_srli_si128(hi, 8)),
+                                   _mm_shuffle_epi32(w, _MM_SHUFFLE(0, 0, 0, 0)));
+    __m128i inner = _mm_madd_epi16(_mm_unpacklo_epi16(_mm_srli_si128(lo, 8), hi),
+                                   _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_sub_epi32(outer, inner);
+}
+
+void rsdIntrinsicResizeHU4_K(void *dst, const void *row, const int *taps,
+                             const void *coefficients, int count) {
+    const int16_t *r = (const int16_t *)row;
+    const int16_t *c = (const int16_t *)coefficients;
+    uint8_t *out = (uint8_t *)dst;
+    __m128i v0, v1;
+    int x = 0;
+
+    for (; x + 4 <= count; x += 4) {
+        v0 = roundResizeSums(resizeSumsU4(r, taps, c, x), resizeSumsU4(r, taps, c, x + 1));
+        v1 = roundResizeSums(resizeSumsU4(r, taps, c, x + 2), resizeSumsU4(r, taps, c, x + 3));
+        _mm_storeu_si128((__m128i *)(out + (x << 2)), roundResizeValues(v0, v1));
+    }
+
+    for (; x < count; x++) {
+        v0 = roundResizeSums(resizeSumsU4(r, taps, c, x), _mm_setzero_si128());
+        *(int32_t *)(out + (x << 2)) = _mm_cvtsi128_si32(roundResizeValues(v0, v0));
+    }
+}
+
+/* The sums of the three channels of output cell x, then 0. The cells of the row are packed RGB;
+ * the taps are spread out to the layout resizeSumsU4 reads, with a 0 for the fourth channel.
+ */
+static inline __m128i resizeSumsU3(const int16_t *row, const int *taps, const int16_t *c, int x) {
+    const __m128i M0 = _mm_setr_epi8(0, 1, 2, 3, 4, 5, -1, -1, 6, 7, 8, 9, 10, 11, -1, -1);
+    const __m128i M1 = _mm_setr_epi8(4, 5, 6, 7, 8, 9, -1, -1, 10, 11, 12, 13, 14, 15, -1, -1);
+    const int16_t *p = row + taps[x] * 3;
+    /* The 12 values of the taps, read as the first 8 and the last 8. */
+    __m128i lo = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)p), M0);
+    __m128i hi = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(p + 4)), M1);
+    __m128i w = _mm_loadl_epi64((const __m128i *)(c + (x << 2)));
+    __m128i outer = _mm_madd_epi16(_mm_unpacklo_epi16(lo, _mm_srli_si128(hi, 8)),
+                                   _mm_shuffle_epi32(w, _MM_SHUFFLE(0, 0, 0, 0)));
+    __m128i inner = _mm_madd_epi16(_mm_unpacklo_epi16(_mm_srli_si128(lo, 8), hi),
+                                   _mm_shuffle_epi32(w, _MM_SHUFFLE(1, 1, 1, 1)));
+    return _mm_sub_epi32(outer, inner);
+}
+
+void rsdIntrinsicResizeHU3_K(void *dst, const void *row, const int *taps,
+                             const void *coefficients, int count) {
+    /* Drops the fourth byte of each cell. */
+    const __m128i M = _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    const int16_t *r = (const int16_t *)row;
+    const int16_t *c = (const int16_t *)coefficients;
+    uint8_t *out = (uint8_t *)dst;
+    __m128i v0, v1, v;
+    int x = 0;
+
+    for (; x + 4 <= count; x += 4) {
+        v0 = roundResizeSums(resizeSumsU3(r, taps, c, x), resizeSumsU3(r, taps, c, x + 1));
+        v1 = roundResizeSums(resizeSumsU3(r, taps, c, x + 2), resizeSumsU3(r, taps, c, x + 3));
+        v = _mm_shuffle_epi8(roundResizeValues(v0, v1), M);
+        _mm_storel_epi64((__m128i *)(out + x * 3), v);
+        *(int32_t *)(out + x * 3 + 8) = _mm_cvtsi128_si32(_mm_srli_si128(v, 8));
+    }
+
+    for (; x < count; x++) {
+        v0 = roundResizeSums(resizeSumsU3(r, taps, c, x), _mm_setzero_si128());
+        const uint32_t bytes = _mm_cvtsi128_si32(roundResizeValues(v0, v0));
+        out[x * 3] = (uint8_t)bytes;
+        out[x * 3 + 1] = (uint8_t)(bytes >> 8);
+        out[x * 3 + 2] = (uint8_t)(bytes >> 16);
+    }
+}
+
+/* The outer and inner sums of the two channels of output cell x, interleaved. */
+static inline __m128i resizeSumsU2(const int16_t *row, const int *taps, const int16_t *c, int x) {
+    const __m128i M = _mm_setr_epi8(0, 1, 12, 13, 4, 5, 8, 9, 2, 3, 14, 15, 6, 7, 10, 11);
+    __m128i p = _mm_loadu_si128((const __m128i *)(row + (taps[x] << 1)));
+    __m128i w = _mm_loadl_epi64((const __m128i *)(c + (x << 2)));
+    return _mm_madd_epi16(_mm_shuffle_epi8(p, M), _mm_unpacklo_epi64(w, w));
+}
+
+void rsdIntrinsicResizeHU2_K(void *dst, const void *row, const int *taps,
+                             const void *coefficients, int count) {
+    const int16_t *r = (const int16_t *)row;
+    const int16_t *c = (const int16_t *)coefficients;
+    uint8_t *out = (uint8_t *)dst;
+    __m128i s0, s1, v;
+    int x = 0;
+
+    for (; x + 4 <= count; x += 4) {
+        s0 = _mm_hsub_epi32(resizeSumsU2(r, taps, c, x), resizeSumsU2(r, taps, c, x + 1));
+        s1 = _mm_hsub_epi32(resizeSumsU2(r, taps, c, x + 2), resizeSumsU2(r, taps, c, x + 3));
+        v = roundResizeSums(s0, s1);
+        _mm_storel_epi64((__m128i *)(out + (x << 1)), roundResizeValues(v, v));
+    }
+
+    for (; x < count; x++) {
+        s0 = resizeSumsU2(r, taps, c, x);
+        s0 = _mm_hsub_epi32(s0, s0);
+        v = roundResizeSums(s0, s0);
+        *(int16_t *)(out + (x << 1)) = (int16_t)_mm_cvtsi128_si32(roundResizeValues(v, v));
+    }
+}
+
+/* The outer and inner sums of output cells x0 and x1, interleaved. */
+static inline __m128i resizeSumsU1(const int16_t *row, const int *taps, const int16_t *c, int x0,
+                                   int x1) {
+    const __m128i M = _mm_setr_epi8(0, 1, 6, 7, 2, 3, 4, 5, 8, 9, 14, 15, 10, 11, 12, 13);
+    __m128i p = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)(row + taps[x0])),
+                                   _mm_loadl_epi64((const __m128i *)(row + taps[x1])));
+    __m128i w = _mm_unpacklo_epi64(_mm_loadl_epi64((const __m128i *)(c + (x0 << 2))),
+                                   _mm_loadl_epi64((const __m128i *)(c + (x1 << 2))));
+    return _mm_madd_epi16(_mm_shuffle_epi8(p, M), w);
+}
+
+void rsdIntrinsicResizeHU1_K(void *dst, const void *row, const int *taps,
+                             const void *coefficients, int count) {
+    const int16_t *r = (const int16_t *)row;
+    const int16_t *c = (const int16_t *)coefficients;
+    uint8_t *out = (uint8_t *)dst;
+    __m128i s, v;
+    int x = 0;
+
+    for (; x + 4 <= count; x += 4) {
+        s = _mm_hsub_epi32(resizeSumsU1(r, taps, c, x, x + 1),
+                           resizeSumsU1(r, taps, c, x + 2, x + 3));
+        v = roundResizeSums(s, s);
+        *(int32_t *)(out + x) = _mm_cvtsi128_si32(roundResizeValues(v, v));
+    }
+
+    for (; x < count; x++) {
+        s = resizeSumsU1(r, taps, c, x, x);
+        s = _mm_hsub_epi32(s, s);
+        v = roundResizeSums(s, s);
+        out[x] = (uint8_t)_mm_cvtsi128_si32(roundResizeValues(v, v));
+    }
+}
+
+/* Halves two rows into one, for a 2x2 box reduction. Each output cell is the rounded average of
+ * the 2x2 cells it covers. The cells are 1, 2 or 4 bytes, as given by cellSize, and count is the
+ * number of output cells.
+ */
+void rsdIntrinsicHalveU_K(void *dst, const void *row0, const void *row1, int cellSize, int count) {
+    const uint8_t *r0 = (const uint8_t *)row0;
+    const uint8_t *r1 = (const uint8_t *)row1;
+    uint8_t *out = (uint8_t *)dst;
+    /* Puts the bytes of the same channel of two neighboring cells next to each other, for maddubs
+     * to add them. */
+    const __m128i M = cellSize == 4
+            ? _mm_setr_epi8(0, 4, 1, 5, 2, 6, 3, 7, 8, 12, 9, 13, 10, 14, 11, 15)
+            : cellSize == 2
+                    ? _mm_setr_epi8(0, 2, 1, 3, 4, 6, 5, 7, 8, 10, 9, 11, 12, 14, 13, 15)
+                    : _mm_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15);
+    const __m128i ones = _mm_set1_epi8(1);
+    const __m128i two = _mm_set1_epi16(2);
+    const int bytes = count * cellSize;
+    __m128i lo, hi;
+    int i = 0;
+
+    for (; i + 16 <= bytes; i += 16) {
+        const __m128i *p0 = (const __m128i *)(r0 + 2 * i);
+        const __m128i *p1 = (const __m128i *)(r1 + 2 * i);
+        lo = _mm_add_epi16(_mm_maddubs_epi16(_mm_shuffle_epi8(_mm_loadu_si128(p0), M), ones),
+                           _mm_maddubs_epi16(_mm_shuffle_epi8(_mm_loadu_si128(p1), M), ones));
+        hi = _mm_add_epi16(_mm_maddubs_epi16(_mm_shuffle_epi8(_mm_loadu_si128(p0 + 1), M), ones),
+                           _mm_maddubs_epi16(_mm_shuffle_epi8(_mm_loadu_si128(p1 + 1), M), ones));
+        lo = _mm_srli_epi16(_mm_add_epi16(lo, two), 2);
+        hi = _mm_srli_epi16(_mm_add_epi16(hi, two), 2);
+        _mm_storeu_si128((__m128i *)(out + i), _mm_packus_epi16(lo, hi));
+    }
+
+    for (; i < bytes; i++) {
+        const int x = i / cellSize * 2 * cellSize + i % cellSize;
+        out[i] = (r0[x] + r0[x + cellSize] + r1[x] + r1[x + cellSize] + 2) >> 2;
+    }
+}
+
 }  // namespace renderscript
@@ -18,6 +18,11 @@
 package com.skydoves.landscapist.transformation
 
 import android.graphics.Bitmap
+import android.graphics.RectF
+import android.os.Build
+import java.io.Closeable
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
 
 // This string is used for error messages.
 private const val externalName = "RenderScript Toolkit"
@@ -25,9 +30,11 @@ private const val externalName = "RenderScript Toolkit"
 /**
  * A collection of high-performance graphic utility functions like blur and blend.
  *
- * This toolkit provides ten image manipulation functions: blend, blur, color matrix, convolve,
- * histogram, histogramDot, lut, lut3d, resize, and YUV to RGB. These functions execute
- * multithreaded on the CPU.
+ * This toolkit provides image manipulation functions: blend, blur, blurDirtyRegions, blurLadder
+ * and interpolateBlurLadder, color matrix, convolve, generateMipmaps, histogram, histogramDot,
+ * lensBlur, lut, lut3d, motionBlur, resize, resizeMultiple, resizeToTensor, createResizeStream,
+ * shadow, and YUV to RGB. These functions execute multithreaded on the CPU, except for the
+ * resize streams, which work on the thread that pushes the rows.
  *
  * Most of the functions have two variants: one that manipulates Bitmaps, the other ByteArrays.
  * For ByteArrays, you need to specify the width and height of the data to be processed, as
@@ -44,8 +51,9 @@ private const val externalName = "RenderScript Toolkit"
  *
  * This toolkit can be used as a replacement for most RenderScript Intrinsic functions. Compared
  * to RenderScript, it's simpler to use and more than twice as fast on the CPU. However RenderScript
- * Intrinsics allow more flexibility for the type of allocation supported. In particular, this
- * toolkit does not support allocations of floats.
+ * Intrinsics allow more flexibility for the type of allocation supported. Only blur and resize
+ * accept floats, through their FloatArray variants and RGBA_F16 Bitmaps, and resizeToTensor
+ * writes float tensors. All the other functions take bytes only.
  */
 internal object RenderScriptToolkit {
 
@@ -108,6 +116,126 @@ internal object RenderScriptToolkit {
       sizeX,
       sizeY,
       radius,
+      radius,
+      AlphaType.PREMULTIPLIED.value,
+      ColorSpace.SRGB.value,
+      EdgeMode.CLAMP.value,
+      outputArray,
+      restriction,
+    )
+    return outputArray
+  }
+
+  /**
+   * Blurs an image with different radii along the X and Y axes.
+   *
+   * Same as [blur], except that the horizontal and vertical passes each have their own radius.
+   * Each radius accepts values between 0 and 25, but they can't both be 0. A radius of 0 skips
+   * the blur along that axis, e.g. radiusY = 0 gives a horizontal-only blur for about half the
+   * cost of a full one.
+   *
+   * RGBA images can also be blurred without the dark halos that appear around transparent
+   * edges when the input isn't premultiplied, by passing [AlphaType.UNPREMULTIPLIED], and in
+   * linear light, by passing [ColorSpace.LINEAR]. These options don't apply to alpha only
+   * images. The [edgeMode] determines which values replace the pixels that are out of boundary.
+   *
+   * @param inputArray The buffer of the image to be blurred.
+   * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+   * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+   * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+   * @param radiusX The radius of the blur along the X axis, a value from 0 to 25.
+   * @param radiusY The radius of the blur along the Y axis, a value from 0 to 25.
+   * @param alphaType Whether the color channels of the input are premultiplied by alpha. The
+   * output has the same alpha type.
+   * @param colorSpace The color space in which the pixels are mixed.
+   * @param edgeMode How the image extends past its edges.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @return The blurred pixels, a ByteArray of size.
+   */
+  @JvmOverloads
+  internal fun blur(
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radiusX: Int,
+    radiusY: Int,
+    alphaType: AlphaType = AlphaType.PREMULTIPLIED,
+    colorSpace: ColorSpace = ColorSpace.SRGB,
+    edgeMode: EdgeMode = EdgeMode.CLAMP,
+    restriction: Range2d? = null,
+  ): ByteArray {
+    require(vectorSize == 1 || vectorSize == 4) {
+      "$externalName blur. The vectorSize should be 1 or 4. $vectorSize provided."
+    }
+    require(inputArray.size >= sizeX * sizeY * vectorSize) {
+      "$externalName blur. inputArray is too small for the given dimensions. " +
+        "$sizeX*$sizeY*$vectorSize < ${inputArray.size}."
+    }
+    validateRadii(radiusX, radiusY)
+    validateRestriction("blur", sizeX, sizeY, restriction)
+
+    val outputArray = ByteArray(inputArray.size)
+    nativeBlur(
+      nativeHandle,
+      inputArray,
+      vectorSize,
+      sizeX,
+      sizeY,
+      radiusX,
+      radiusY,
+      alphaType.value,
+      colorSpace.value,
+      edgeMode.value,
+      outputArray,
+      restriction,
+    )
+    return outputArray
+  }
+
+  /**
+   * Blurs an image of RGBA floats.
+   *
+   * Same as the ByteArray version with radii, for images of 4 floats per pixel, e.g. HDR
+   * images or the inputs of models. The values are blurred as they are, in float, so there is
+   * no colorSpace to choose.
+   *
+   * @param inputArray The buffer of the image to be blurred, 4 floats per pixel.
+   * @param sizeX The width of both buffers, as a number of pixels.
+   * @param sizeY The height of both buffers, as a number of pixels.
+   * @param radiusX The radius of the blur along the X axis, a value from 0 to 25.
+   * @param radiusY The radius of the blur along the Y axis, a value from 0 to 25.
+   * @param alphaType Whether the color channels of the input are premultiplied by alpha. The
+   * output has the same alpha type.
+   * @param edgeMode How the image extends past its edges.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @return The blurred pixels, a FloatArray of size.
+   */
+  @JvmOverloads
+  internal fun blur(
+    inputArray: FloatArray,
+    sizeX: Int,
+    sizeY: Int,
+    radiusX: Int,
+    radiusY: Int,
+    alphaType: AlphaType = AlphaType.PREMULTIPLIED,
+    edgeMode: EdgeMode = EdgeMode.CLAMP,
+    restriction: Range2d? = null,
+  ): FloatArray {
+    validateFloatImage("blur", inputArray, sizeX, sizeY)
+    validateRadii(radiusX, radiusY)
+    validateRestriction("blur", sizeX, sizeY, restriction)
+
+    val outputArray = FloatArray(inputArray.size)
+    nativeBlurFloat(
+      nativeHandle,
+      inputArray,
+      sizeX,
+      sizeY,
+      radiusX,
+      radiusY,
+      alphaType.value,
+      edgeMode.value,
       outputArray,
       restriction,
     )
@@ -125,9 +253,10 @@ internal object RenderScriptToolkit {
    * take longer to compute. When the radius extends past the edge, the edge pixel will
    * be used as replacement for the pixel that's out off boundary.
    *
-   * This method supports input Bitmap of config ARGB_8888 and ALPHA_8. Bitmaps with a stride
-   * different than width * vectorSize are not currently supported. The returned Bitmap has the
-   * same config.
+   * This method supports input Bitmap of config ARGB_8888, ALPHA_8, RGBA_F16, RGB_565 and
+   * RGBA_1010102. The last three are converted to floats and back as they are blurred, without
+   * any copy of the image. Bitmaps with a stride different than width * the size of a pixel are
+   * not currently supported. The returned Bitmap has the same config.
    *
    * An optional range parameter can be set to restrict the operation to a rectangular subset
    * of each buffer. If provided, the range must be wholly contained with the dimensions
@@ -141,182 +270,1724 @@ internal object RenderScriptToolkit {
    */
   @JvmOverloads
   internal fun blur(inputBitmap: Bitmap, radius: Int = 5, restriction: Range2d? = null): Bitmap {
-    validateBitmap("blur", inputBitmap)
+    validateBlurBitmap("blur", inputBitmap)
     require(radius in 1..25) {
       "$externalName blur. The radius should be between 1 and 25. $radius provided."
     }
     validateRestriction("blur", inputBitmap.width, inputBitmap.height, restriction)
 
     val outputBitmap = createCompatibleBitmap(inputBitmap)
-    nativeBlurBitmap(nativeHandle, inputBitmap, outputBitmap, radius, restriction)
+    nativeBlurBitmap(
+      nativeHandle,
+      inputBitmap,
+      outputBitmap,
+      radius,
+      radius,
+      AlphaType.PREMULTIPLIED.value,
+      ColorSpace.SRGB.value,
+      EdgeMode.CLAMP.value,
+      restriction,
+    )
     return outputBitmap
   }
 
   /**
-   * Identity matrix that can be passed to the {@link RenderScriptToolkit::colorMatrix} method.
+   * Blurs a Bitmap with different radii along the X and Y axes.
    *
-   * Using this matrix will result in no change to the pixel through multiplication although
-   * the pixel value can still be modified by the add vector, or transformed to a different
-   * format.
+   * Same as [blur], except that the horizontal and vertical passes each have their own radius.
+   * Each radius accepts values between 0 and 25, but they can't both be 0. A radius of 0 skips
+   * the blur along that axis, e.g. radiusY = 0 gives a horizontal-only blur for about half the
+   * cost of a full one.
+   *
+   * Bitmaps that aren't premultiplied are blurred without the dark halos that would otherwise
+   * appear around their transparent edges, and the returned Bitmap isn't premultiplied either.
+   * The [edgeMode] determines which values replace the pixels that are out of boundary.
+   * RGBA_F16 Bitmaps are blurred as they are stored, usually in linear light, whatever the
+   * [colorSpace].
+   *
+   * @param inputBitmap The buffer of the image to be blurred.
+   * @param radiusX The radius of the blur along the X axis, a value from 0 to 25.
+   * @param radiusY The radius of the blur along the Y axis, a value from 0 to 25.
+   * @param colorSpace The color space in which the pixels are mixed.
+   * @param edgeMode How the image extends past its edges.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @return The blurred Bitmap.
    */
-  internal val identityMatrix: FloatArray
-    get() = floatArrayOf(
-      1f, 0f, 0f, 0f,
-      0f, 1f, 0f, 0f,
-      0f, 0f, 1f, 0f,
-      0f, 0f, 0f, 1f,
+  @JvmOverloads
+  internal fun blur(
+    inputBitmap: Bitmap,
+    radiusX: Int,
+    radiusY: Int,
+    colorSpace: ColorSpace = ColorSpace.SRGB,
+    edgeMode: EdgeMode = EdgeMode.CLAMP,
+    restriction: Range2d? = null,
+  ): Bitmap {
+    validateBlurBitmap("blur", inputBitmap)
+    validateRadii(radiusX, radiusY)
+    validateRestriction("blur", inputBitmap.width, inputBitmap.height, restriction)
+
+    val alphaType = alphaType(inputBitmap)
+    val outputBitmap = createCompatibleBitmap(inputBitmap)
+    outputBitmap.isPremultiplied = alphaType == AlphaType.PREMULTIPLIED
+    nativeBlurBitmap(
+      nativeHandle,
+      inputBitmap,
+      outputBitmap,
+      radiusX,
+      radiusY,
+      alphaType.value,
+      colorSpace.value,
+      edgeMode.value,
+      restriction,
     )
+    return outputBitmap
+  }
 
   /**
-   * Matrix to turn color pixels to a grey scale.
+   * Blurs an image with the chosen algorithm.
    *
-   * Use this matrix with the {@link RenderScriptToolkit::colorMatrix} method to convert an
-   * image from color to greyscale.
+   * Same as [blur] when [quality] is [BlurQuality.GAUSSIAN]. [BlurQuality.FAST] accepts radii up
+   * to 250 and costs about the same whatever the radius, which makes large blurs, e.g. frosted
+   * glass backgrounds, much cheaper. The result is close to, but not exactly, a Gaussian blur.
+   * Radii below 5 fall back to the Gaussian blur.
+   *
+   * @param inputArray The buffer of the image to be blurred.
+   * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+   * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+   * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+   * @param radius The radius of the pixels used to blur, a value from 1 to 25, or to 250 with
+   * [BlurQuality.FAST].
+   * @param quality The algorithm used to blur.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @return The blurred pixels, a ByteArray of size.
    */
-  internal val greyScaleColorMatrix: FloatArray
-    get() = floatArrayOf(
-      0.299f, 0.299f, 0.299f, 0f,
-      0.587f, 0.587f, 0.587f, 0f,
-      0.114f, 0.114f, 0.114f, 0f,
-      0f, 0f, 0f, 1f,
+  @JvmOverloads
+  internal fun blur(
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radius: Int,
+    quality: BlurQuality,
+    restriction: Range2d? = null,
+  ): ByteArray {
+    require(vectorSize == 1 || vectorSize == 4) {
+      "$externalName blur. The vectorSize should be 1 or 4. $vectorSize provided."
+    }
+    require(inputArray.size >= sizeX * sizeY * vectorSize) {
+      "$externalName blur. inputArray is too small for the given dimensions. " +
+        "$sizeX*$sizeY*$vectorSize < ${inputArray.size}."
+    }
+    validateRadius(radius, quality)
+    validateRestriction("blur", sizeX, sizeY, restriction)
+
+    val outputArray = ByteArray(inputArray.size)
+    nativeBlurWithQuality(
+      nativeHandle,
+      inputArray,
+      vectorSize,
+      sizeX,
+      sizeY,
+      radius,
+      quality.value,
+      outputArray,
+      restriction,
     )
+    return outputArray
+  }
 
   /**
-   * Resize an image.
+   * Blurs a Bitmap with the chosen algorithm.
    *
-   * Resizes an image using bicubic interpolation.
+   * Same as [blur] when [quality] is [BlurQuality.GAUSSIAN]. [BlurQuality.FAST] accepts radii up
+   * to 250 and costs about the same whatever the radius. The result is close to, but not
+   * exactly, a Gaussian blur.
    *
-   * This method supports elements of 1 to 4 bytes in length. Each byte of the element is
-   * interpolated independently from the others.
+   * @param inputBitmap The buffer of the image to be blurred.
+   * @param radius The radius of the pixels used to blur, a value from 1 to 25, or to 250 with
+   * [BlurQuality.FAST].
+   * @param quality The algorithm used to blur.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @return The blurred Bitmap.
+   */
+  @JvmOverloads
+  internal fun blur(
+    inputBitmap: Bitmap,
+    radius: Int,
+    quality: BlurQuality,
+    restriction: Range2d? = null,
+  ): Bitmap {
+    validateBitmap("blur", inputBitmap)
+    validateRadius(radius, quality)
+    validateRestriction("blur", inputBitmap.width, inputBitmap.height, restriction)
+
+    val outputBitmap = createCompatibleBitmap(inputBitmap)
+    nativeBlurWithQualityBitmap(
+      nativeHandle,
+      inputBitmap,
+      outputBitmap,
+      radius,
+      quality.value,
+      restriction,
+    )
+    return outputBitmap
+  }
+
+  /**
+   * Blurs an image with several radii at once.
    *
-   * An optional range parameter can be set to restrict the operation to a rectangular subset
-   * of the output buffer. The corresponding scaled range of the input will be used. If provided,
-   * the range must be wholly contained with the dimensions described by outputSizeX and
-   * outputSizeY.
+   * Each blurred image is computed from the work done for the previous ones, which costs less
+   * than a [blur] call per radius, e.g. to animate a blur. [interpolateBlurLadder] then gives any
+   * radius in between. With [BlurQuality.GAUSSIAN], the first image matches [blur].
    *
-   * The input and output arrays have a row-major layout. The input array should be
-   * large enough for sizeX * sizeY * vectorSize bytes.
+   * @param inputArray The buffer of the image to be blurred.
+   * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+   * @param sizeX The width of the buffers, as a number of 1 or 4 byte cells.
+   * @param sizeY The height of the buffers, as a number of 1 or 4 byte cells.
+   * @param radii The radii in increasing order, from 0 to 50, or to 250 with [BlurQuality.FAST].
+   * A radius of 0 gives a copy of the input.
+   * @param quality The algorithm used to blur.
+   * @return One blurred image per radius, each a ByteArray of size.
+   */
+  @JvmOverloads
+  internal fun blurLadder(
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radii: IntArray,
+    quality: BlurQuality = BlurQuality.GAUSSIAN,
+  ): List<ByteArray> {
+    require(vectorSize == 1 || vectorSize == 4) {
+      "$externalName blurLadder. The vectorSize should be 1 or 4. $vectorSize provided."
+    }
+    require(inputArray.size >= sizeX * sizeY * vectorSize) {
+      "$externalName blurLadder. inputArray is too small for the given dimensions. " +
+        "$sizeX*$sizeY*$vectorSize < ${inputArray.size}."
+    }
+    validateLadderRadii(radii, quality)
+
+    val outputArrays = Array(radii.size) { ByteArray(inputArray.size) }
+    nativeBlurLadder(
+      nativeHandle,
+      inputArray,
+      vectorSize,
+      sizeX,
+      sizeY,
+      radii,
+      quality.value,
+      outputArrays,
+    )
+    return outputArrays.toList()
+  }
+
+  /**
+   * Blurs a Bitmap with several radii at once. See the ByteArray version of [blurLadder].
    *
-   * Like the RenderScript Intrinsics, vectorSize of size 3 are padded to occupy 4 bytes.
+   * @param inputBitmap The buffer of the image to be blurred.
+   * @param radii The radii in increasing order, from 0 to 50, or to 250 with [BlurQuality.FAST].
+   * A radius of 0 gives a copy of the input.
+   * @param quality The algorithm used to blur.
+   * @return One blurred Bitmap per radius.
+   */
+  @JvmOverloads
+  internal fun blurLadder(
+    inputBitmap: Bitmap,
+    radii: IntArray,
+    quality: BlurQuality = BlurQuality.GAUSSIAN,
+  ): List<Bitmap> {
+    validateBitmap("blurLadder", inputBitmap)
+    validateLadderRadii(radii, quality)
+
+    val outputBitmaps = Array(radii.size) { createCompatibleBitmap(inputBitmap) }
+    nativeBlurLadderBitmap(nativeHandle, inputBitmap, radii, quality.value, outputBitmaps)
+    return outputBitmaps.toList()
+  }
+
+  /**
+   * Approximates the blur of an image with any radius from the images made by [blurLadder].
    *
-   * @param inputArray The buffer of the image to be resized.
-   * @param vectorSize The number of bytes in each element of both buffers. A value from 1 to 4.
-   * @param inputSizeX The width of the input buffer, as a number of 1-4 byte elements.
-   * @param inputSizeY The height of the input buffer, as a number of 1-4 byte elements.
-   * @param outputSizeX The width of the output buffer, as a number of 1-4 byte elements.
-   * @param outputSizeY The height of the output buffer, as a number of 1-4 byte elements.
+   * The two images whose radii surround [radius] are mixed so that the spread of the result
+   * matches that of [radius], for far less than the cost of a blur. Outside of the radii of the
+   * ladder, the first or last image is copied.
+   *
+   * @param ladder The images returned by [blurLadder].
+   * @param radii The radii given to [blurLadder].
+   * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+   * @param sizeX The width of the buffers, as a number of 1 or 4 byte cells.
+   * @param sizeY The height of the buffers, as a number of 1 or 4 byte cells.
+   * @param radius The radius of the blur to approximate.
    * @param restriction When not null, restricts the operation to a 2D range of pixels.
-   * @return An array that contains the rescaled image.
+   * @return The blurred pixels, a ByteArray of size.
    */
   @JvmOverloads
-  internal fun resize(
-    inputArray: ByteArray,
+  internal fun interpolateBlurLadder(
+    ladder: List<ByteArray>,
+    radii: IntArray,
     vectorSize: Int,
-    inputSizeX: Int,
-    inputSizeY: Int,
-    outputSizeX: Int,
-    outputSizeY: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radius: Float,
     restriction: Range2d? = null,
   ): ByteArray {
-    require(vectorSize in 1..4) {
-      "$externalName resize. The vectorSize should be between 1 and 4. $vectorSize provided."
+    require(vectorSize == 1 || vectorSize == 4) {
+      "$externalName interpolateBlurLadder. The vectorSize should be 1 or 4. " +
+        "$vectorSize provided."
     }
-    require(inputArray.size >= inputSizeX * inputSizeY * vectorSize) {
-      "$externalName resize. inputArray is too small for the given dimensions. " +
-        "$inputSizeX*$inputSizeY*$vectorSize < ${inputArray.size}."
+    require(ladder.isNotEmpty() && ladder.size == radii.size) {
+      "$externalName interpolateBlurLadder. The ladder should have one image per radius. " +
+        "${ladder.size} images and ${radii.size} radii provided."
     }
-    validateRestriction("resize", outputSizeX, outputSizeY, restriction)
+    require(ladder.all { it.size >= sizeX * sizeY * vectorSize }) {
+      "$externalName interpolateBlurLadder. The ladder images are too small for the given " +
+        "dimensions."
+    }
+    validateRestriction("interpolateBlurLadder", sizeX, sizeY, restriction)
 
-    val outputArray = ByteArray(outputSizeX * outputSizeY * paddedSize(vectorSize))
-    nativeResize(
+    val outputArray = ByteArray(ladder[0].size)
+    nativeInterpolateBlurLadder(
       nativeHandle,
-      inputArray,
+      ladder.toTypedArray(),
+      radii,
       vectorSize,
-      inputSizeX,
-      inputSizeY,
+      sizeX,
+      sizeY,
+      radius,
       outputArray,
-      outputSizeX,
-      outputSizeY,
       restriction,
     )
     return outputArray
   }
 
   /**
-   * Resize an image.
-   *
-   * Resizes an image using bicubic interpolation.
-   *
-   * This method supports input Bitmap of config ARGB_8888 and ALPHA_8. The returned Bitmap
-   * has the same config. Bitmaps with a stride different than width * vectorSize are not
-   * currently supported.
-   *
-   * An optional range parameter can be set to restrict the operation to a rectangular subset
-   * of the output buffer. The corresponding scaled range of the input will be used. If provided,
-   * the range must be wholly contained with the dimensions described by outputSizeX and
-   * outputSizeY.
+   * Approximates the blur of a Bitmap with any radius from the Bitmaps made by [blurLadder]. See
+   * the ByteArray version of [interpolateBlurLadder].
    *
-   * @param inputBitmap The Bitmap to be resized.
-   * @param outputSizeX The width of the output buffer, as a number of 1-4 byte elements.
-   * @param outputSizeY The height of the output buffer, as a number of 1-4 byte elements.
+   * @param ladder The Bitmaps returned by [blurLadder].
+   * @param radii The radii given to [blurLadder].
+   * @param radius The radius of the blur to approximate.
    * @param restriction When not null, restricts the operation to a 2D range of pixels.
-   * @return A Bitmap that contains the rescaled image.
+   * @return The blurred Bitmap.
    */
   @JvmOverloads
-  internal fun resize(
-    inputBitmap: Bitmap,
-    outputSizeX: Int,
-    outputSizeY: Int,
+  internal fun interpolateBlurLadder(
+    ladder: List<Bitmap>,
+    radii: IntArray,
+    radius: Float,
     restriction: Range2d? = null,
   ): Bitmap {
-    validateBitmap("resize", inputBitmap)
-    validateRestriction("resize", outputSizeX, outputSizeY, restriction)
+    require(ladder.isNotEmpty() && ladder.size == radii.size) {
+      "$externalName interpolateBlurLadder. The ladder should have one Bitmap per radius. " +
+        "${ladder.size} Bitmaps and ${radii.size} radii provided."
+    }
+    ladder.forEach { validateBitmap("interpolateBlurLadder", it) }
+    val first = ladder[0]
+    require(
+      ladder.all {
+        it.width == first.width && it.height == first.height && it.config == first.config
+      },
+    ) {
+      "$externalName interpolateBlurLadder. The ladder Bitmaps should have the same size and " +
+        "config."
+    }
+    validateRestriction("interpolateBlurLadder", first.width, first.height, restriction)
+
+    val outputBitmap = createCompatibleBitmap(first)
+    nativeInterpolateBlurLadderBitmap(
+      nativeHandle,
+      ladder.toTypedArray(),
+      radii,
+      radius,
+      outputBitmap,
+      restriction,
+    )
+    return outputBitmap
+  }
+
+  /**
+   * Blurs an image in place.
+   *
+   * Same as [blur], except that the result overwrites [inputArray] instead of going to a new
+   * ByteArray, which halves the memory needed for large images. The extra memory used is a
+   * few rows per thread.
+   *
+   * @param inputArray The buffer of the image to be blurred, which receives the blurred image.
+   * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+   * @param sizeX The width of the buffer, as a number of 1 or 4 byte cells.
+   * @param sizeY The height of the buffer, as a number of 1 or 4 byte cells.
+   * @param radiusX The radius of the blur along the X axis, a value from 0 to 25.
+   * @param radiusY The radius of the blur along the Y axis, a value from 0 to 25.
+   * @param alphaType Whether the color channels of the input are premultiplied by alpha.
+   * @param colorSpace The color space in which the pixels are mixed.
+   * @param edgeMode How the image extends past its edges.
+   */
+  @JvmOverloads
+  internal fun blurInPlace(
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radiusX: Int,
+    radiusY: Int,
+    alphaType: AlphaType = AlphaType.PREMULTIPLIED,
+    colorSpace: ColorSpace = ColorSpace.SRGB,
+    edgeMode: EdgeMode = EdgeMode.CLAMP,
+  ) {
+    require(vectorSize == 1 || vectorSize == 4) {
+      "$externalName blurInPlace. The vectorSize should be 1 or 4. $vectorSize provided."
+    }
+    require(inputArray.size >= sizeX * sizeY * vectorSize) {
+      "$externalName blurInPlace. inputArray is too small for the given dimensions. " +
+        "$sizeX*$sizeY*$vectorSize < ${inputArray.size}."
+    }
+    validateRadii(radiusX, radiusY)
+
+    nativeBlurInPlace(
+      nativeHandle,
+      inputArray,
+      vectorSize,
+      sizeX,
+      sizeY,
+      radiusX,
+      radiusY,
+      alphaType.value,
+      colorSpace.value,
+      edgeMode.value,
+    )
+  }
+
+  /**
+   * Blurs a mutable Bitmap in place.
+   *
+   * Same as [blur], except that the result overwrites [bitmap] instead of going to a new
+   * Bitmap. Bitmaps that aren't premultiplied stay that way. The same configs as [blur] are
+   * supported.
+   *
+   * @param bitmap The mutable Bitmap to be blurred, which receives the blurred image.
+   * @param radiusX The radius of the blur along the X axis, a value from 0 to 25.
+   * @param radiusY The radius of the blur along the Y axis, a value from 0 to 25.
+   * @param colorSpace The color space in which the pixels are mixed.
+   * @param edgeMode How the image extends past its edges.
+   */
+  @JvmOverloads
+  internal fun blurInPlace(
+    bitmap: Bitmap,
+    radiusX: Int,
+    radiusY: Int,
+    colorSpace: ColorSpace = ColorSpace.SRGB,
+    edgeMode: EdgeMode = EdgeMode.CLAMP,
+  ) {
+    validateBlurBitmap("blurInPlace", bitmap)
+    require(bitmap.isMutable) {
+      "$externalName blurInPlace. The bitmap should be mutable."
+    }
+    validateRadii(radiusX, radiusY)
+
+    nativeBlurInPlaceBitmap(
+      nativeHandle,
+      bitmap,
+      radiusX,
+      radiusY,
+      alphaType(bitmap).value,
+      colorSpace.value,
+      edgeMode.value,
+    )
+  }
+
+  /**
+   * Updates a blurred image after some pixels of the original changed.
+   *
+   * [outputArray] holds the blur of a previous version of [inputArray], made with the same
+   * options. Only the pixels that depend on the [dirtyRegions] are recomputed: each region is
+   * expanded by the radius and blurred again, reading its halo from [inputArray]. The cost is
+   * proportional to the expanded area rather than to the size of the image. The result is the
+   * same as blurring the whole input again, give or take one for a few pixels.
+   *
+   * @param inputArray The buffer of the image to be blurred.
+   * @param outputArray The buffer that holds the previous blurred image and receives the new one.
+   * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+   * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+   * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+   * @param radiusX The radius of the blur along the X axis, a value from 0 to 25.
+   * @param radiusY The radius of the blur along the Y axis, a value from 0 to 25.
+   * @param dirtyRegions The regions of inputArray that changed since outputArray was computed.
+   * @param alphaType Whether the color channels of the input are premultiplied by alpha.
+   * @param colorSpace The color space in which the pixels are mixed.
+   * @param edgeMode How the image extends past its edges.
+   */
+  @JvmOverloads
+  internal fun blurDirtyRegions(
+    inputArray: ByteArray,
+    outputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radiusX: Int,
+    radiusY: Int,
+    dirtyRegions: List<Range2d>,
+    alphaType: AlphaType = AlphaType.PREMULTIPLIED,
+    colorSpace: ColorSpace = ColorSpace.SRGB,
+    edgeMode: EdgeMode = EdgeMode.CLAMP,
+  ) {
+    require(vectorSize == 1 || vectorSize == 4) {
+      "$externalName blurDirtyRegions. The vectorSize should be 1 or 4. $vectorSize provided."
+    }
+    require(inputArray.size >= sizeX * sizeY * vectorSize) {
+      "$externalName blurDirtyRegions. inputArray is too small for the given dimensions. " +
+        "$sizeX*$sizeY*$vectorSize < ${inputArray.size}."
+    }
+    require(outputArray.size >= sizeX * sizeY * vectorSize) {
+      "$externalName blurDirtyRegions. outputArray is too small for the given dimensions. " +
+        "$sizeX*$sizeY*$vectorSize < ${outputArray.size}."
+    }
+    require(inputArray !== outputArray) {
+      "$externalName blurDirtyRegions. inputArray and outputArray should be different."
+    }
+    validateRadii(radiusX, radiusY)
+    dirtyRegions.forEach { validateRestriction("blurDirtyRegions", sizeX, sizeY, it) }
+
+    nativeBlurDirtyRegions(
+      nativeHandle,
+      inputArray,
+      vectorSize,
+      sizeX,
+      sizeY,
+      radiusX,
+      radiusY,
+      alphaType.value,
+      colorSpace.value,
+      edgeMode.value,
+      outputArray,
+      flattenRegions(dirtyRegions),
+    )
+  }
+
+  /**
+   * Updates a blurred Bitmap after some pixels of the original changed.
+   *
+   * Same as the ByteArray variant of [blurDirtyRegions]. [outputBitmap] holds the blur of a
+   * previous version of [inputBitmap], made with the same options, and is updated in place. Both
+   * Bitmaps must have the same dimensions and config.
+   *
+   * @param inputBitmap The buffer of the image to be blurred.
+   * @param outputBitmap The Bitmap that holds the previous blurred image and receives the new one.
+   * @param radiusX The radius of the blur along the X axis, a value from 0 to 25.
+   * @param radiusY The radius of the blur along the Y axis, a value from 0 to 25.
+   * @param dirtyRegions The regions of inputBitmap that changed since outputBitmap was computed.
+   * @param colorSpace The color space in which the pixels are mixed.
+   * @param edgeMode How the image extends past its edges.
+   */
+  @JvmOverloads
+  internal fun blurDirtyRegions(
+    inputBitmap: Bitmap,
+    outputBitmap: Bitmap,
+    radiusX: Int,
+    radiusY: Int,
+    dirtyRegions: List<Range2d>,
+    colorSpace: ColorSpace = ColorSpace.SRGB,
+    edgeMode: EdgeMode = EdgeMode.CLAMP,
+  ) {
+    validateBitmap("blurDirtyRegions", inputBitmap)
+    require(
+      outputBitmap.width == inputBitmap.width && outputBitmap.height == inputBitmap.height &&
+        outputBitmap.config == inputBitmap.config,
+    ) {
+      "$externalName blurDirtyRegions. outputBitmap should have the same dimensions and " +
+        "config as inputBitmap."
+    }
+    require(inputBitmap !== outputBitmap) {
+      "$externalName blurDirtyRegions. inputBitmap and outputBitmap should be different."
+    }
+    validateRadii(radiusX, radiusY)
+    dirtyRegions.forEach { validateRestriction("blurDirtyRegions", inputBitmap, it) }
+
+    nativeBlurDirtyRegionsBitmap(
+      nativeHandle,
+      inputBitmap,
+      outputBitmap,
+      radiusX,
+      radiusY,
+      alphaType(inputBitmap).value,
+      colorSpace.value,
+      edgeMode.value,
+      flattenRegions(dirtyRegions),
+    )
+  }
+
+  /**
+   * Draws the shadow or the glow of an RGBA image.
+   *
+   * The alpha channel of the input is blurred, tinted with [color], and drawn with its top left
+   * corner at ([offsetX], [offsetY]) in the output. The output pixels are premultiplied. This is
+   * done in a single native pass, without an intermediate alpha image. The input is transparent
+   * past its edges, so the shadow fades out there.
+   *
+   * The output defaults to the size of the input plus [radius] on each side, with the input
+   * centered, so that the shadow has room to spread.
+   *
+   * @param inputArray The buffer of the RGBA image that casts the shadow.
+   * @param sizeX The width of the input, in pixels.
+   * @param sizeY The height of the input, in pixels.
+   * @param radius The radius of the blur, a value from 0 to 25.
+   * @param color The color of the shadow, as an ARGB color int.
+   * @param offsetX Where the left edge of the input lands in the output.
+   * @param offsetY Where the top edge of the input lands in the output.
+   * @param outputSizeX The width of the output, in pixels.
+   * @param outputSizeY The height of the output, in pixels.
+   * @param restriction When not null, restricts the operation to a 2D range of output pixels.
+   * @return The shadow, a ByteArray of outputSizeX * outputSizeY * 4 bytes.
+   */
+  @JvmOverloads
+  internal fun shadow(
+    inputArray: ByteArray,
+    sizeX: Int,
+    sizeY: Int,
+    radius: Int,
+    color: Int,
+    offsetX: Int = radius,
+    offsetY: Int = radius,
+    outputSizeX: Int = sizeX + 2 * radius,
+    outputSizeY: Int = sizeY + 2 * radius,
+    restriction: Range2d? = null,
+  ): ByteArray {
+    require(inputArray.size >= sizeX * sizeY * 4) {
+      "$externalName shadow. inputArray is too small for the given dimensions. " +
+        "$sizeX*$sizeY*4 < ${inputArray.size}."
+    }
+    require(radius in 0..25) {
+      "$externalName shadow. The radius should be between 0 and 25. $radius provided."
+    }
+    validateRestriction("shadow", outputSizeX, outputSizeY, restriction)
+
+    val outputArray = ByteArray(outputSizeX * outputSizeY * 4)
+    nativeShadow(
+      nativeHandle,
+      inputArray,
+      sizeX,
+      sizeY,
+      outputArray,
+      outputSizeX,
+      outputSizeY,
+      radius,
+      color,
+      offsetX,
+      offsetY,
+      restriction,
+    )
+    return outputArray
+  }
+
+  /**
+   * Draws the shadow or the glow of a Bitmap.
+   *
+   * Same as the ByteArray variant of [shadow]. The input Bitmap must be ARGB_8888. The returned
+   * Bitmap is ARGB_8888 and premultiplied.
+   *
+   * @param inputBitmap The Bitmap that casts the shadow.
+   * @param radius The radius of the blur, a value from 0 to 25.
+   * @param color The color of the shadow, as an ARGB color int.
+   * @param offsetX Where the left edge of the input lands in the output.
+   * @param offsetY Where the top edge of the input lands in the output.
+   * @param outputSizeX The width of the output, in pixels.
+   * @param outputSizeY The height of the output, in pixels.
+   * @param restriction When not null, restricts the operation to a 2D range of output pixels.
+   * @return The shadow.
+   */
+  @JvmOverloads
+  internal fun shadow(
+    inputBitmap: Bitmap,
+    radius: Int,
+    color: Int,
+    offsetX: Int = radius,
+    offsetY: Int = radius,
+    outputSizeX: Int = inputBitmap.width + 2 * radius,
+    outputSizeY: Int = inputBitmap.height + 2 * radius,
+    restriction: Range2d? = null,
+  ): Bitmap {
+    validateBitmap("shadow", inputBitmap, alphaAllowed = false)
+    require(radius in 0..25) {
+      "$externalName shadow. The radius should be between 0 and 25. $radius provided."
+    }
+    validateRestriction("shadow", outputSizeX, outputSizeY, restriction)
+
+    val outputBitmap = Bitmap.createBitmap(outputSizeX, outputSizeY, Bitmap.Config.ARGB_8888)
+    nativeShadowBitmap(
+      nativeHandle,
+      inputBitmap,
+      outputBitmap,
+      radius,
+      color,
+      offsetX,
+      offsetY,
+      restriction,
+    )
+    return outputBitmap
+  }
+
+  /**
+   * Blurs an image along a line, i.e. a directional motion blur.
+   *
+   * Each output pixel is the average of 2 * radius + 1 pixels sampled at unit steps along a
+   * line of the given angle going through it. Samples that fall between pixels are bilinearly
+   * interpolated. When the line extends past the edge, the edge pixel will be used as
+   * replacement for the pixel that's out of boundary.
+   *
+   * The radius accepts values between 1 and 100. The cost grows linearly with the radius.
+   *
+   * @param inputArray The buffer of the image to be blurred.
+   * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+   * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+   * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+   * @param radius Half the length of the line in pixels, a value from 1 to 100.
+   * @param angle The direction of the line in degrees, counterclockwise from the X axis.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @return The blurred pixels, a ByteArray of size.
+   */
+  @JvmOverloads
+  internal fun motionBlur(
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radius: Int,
+    angle: Float,
+    restriction: Range2d? = null,
+  ): ByteArray {
+    require(vectorSize == 1 || vectorSize == 4) {
+      "$externalName motionBlur. The vectorSize should be 1 or 4. $vectorSize provided."
+    }
+    require(inputArray.size >= sizeX * sizeY * vectorSize) {
+      "$externalName motionBlur. inputArray is too small for the given dimensions. " +
+        "$sizeX*$sizeY*$vectorSize < ${inputArray.size}."
+    }
+    require(radius in 1..100) {
+      "$externalName motionBlur. The radius should be between 1 and 100. $radius provided."
+    }
+    validateRestriction("motionBlur", sizeX, sizeY, restriction)
+
+    val outputArray = ByteArray(inputArray.size)
+    nativeMotionBlur(
+      nativeHandle,
+      inputArray,
+      vectorSize,
+      sizeX,
+      sizeY,
+      radius,
+      angle,
+      outputArray,
+      restriction,
+    )
+    return outputArray
+  }
+
+  /**
+   * Blurs a Bitmap along a line, i.e. a directional motion blur.
+   *
+   * See the ByteArray variant of [motionBlur] for details. This method supports input Bitmap of
+   * config ARGB_8888 and ALPHA_8. The returned Bitmap has the same config.
+   *
+   * @param inputBitmap The buffer of the image to be blurred.
+   * @param radius Half the length of the line in pixels, a value from 1 to 100.
+   * @param angle The direction of the line in degrees, counterclockwise from the X axis.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @return The blurred Bitmap.
+   */
+  @JvmOverloads
+  internal fun motionBlur(
+    inputBitmap: Bitmap,
+    radius: Int,
+    angle: Float,
+    restriction: Range2d? = null,
+  ): Bitmap {
+    validateBitmap("motionBlur", inputBitmap)
+    require(radius in 1..100) {
+      "$externalName motionBlur. The radius should be between 1 and 100. $radius provided."
+    }
+    validateRestriction("motionBlur", inputBitmap.width, inputBitmap.height, restriction)
+
+    val outputBitmap = createCompatibleBitmap(inputBitmap)
+    nativeMotionBlurBitmap(nativeHandle, inputBitmap, outputBitmap, radius, angle, restriction)
+    return outputBitmap
+  }
+
+  /**
+   * Blurs an image the way an out of focus lens does.
+   *
+   * Each output pixel is the average of the pixels inside a disc or a hexagon of the given radius
+   * centered on it, so bright spots spread into evenly lit copies of the shape. When the shape
+   * extends past the edge, the edge pixel will be used as replacement for the pixel that's out
+   * of boundary.
+   *
+   * The radius accepts values between 1 and 100. The cost grows linearly with the radius, and is
+   * within a few times that of a Gaussian [blur] of the same radius.
+   *
+   * @param inputArray The buffer of the image to be blurred.
+   * @param vectorSize Either 1 or 4, the number of bytes in each cell, i.e. A vs. RGBA.
+   * @param sizeX The width of both buffers, as a number of 1 or 4 byte cells.
+   * @param sizeY The height of both buffers, as a number of 1 or 4 byte cells.
+   * @param radius The radius of the shape in pixels, a value from 1 to 100.
+   * @param shape The shape of the aperture.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @return The blurred pixels, a ByteArray of size.
+   */
+  @JvmOverloads
+  internal fun lensBlur(
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radius: Int,
+    shape: LensShape = LensShape.DISC,
+    restriction: Range2d? = null,
+  ): ByteArray {
+    require(vectorSize == 1 || vectorSize == 4) {
+      "$externalName lensBlur. The vectorSize should be 1 or 4. $vectorSize provided."
+    }
+    require(inputArray.size >= sizeX * sizeY * vectorSize) {
+      "$externalName lensBlur. inputArray is too small for the given dimensions. " +
+        "$sizeX*$sizeY*$vectorSize < ${inputArray.size}."
+    }
+    require(radius in 1..100) {
+      "$externalName lensBlur. The radius should be between 1 and 100. $radius provided."
+    }
+    validateRestriction("lensBlur", sizeX, sizeY, restriction)
+
+    val outputArray = ByteArray(inputArray.size)
+    nativeLensBlur(
+      nativeHandle,
+      inputArray,
+      vectorSize,
+      sizeX,
+      sizeY,
+      radius,
+      shape.value,
+      outputArray,
+      restriction,
+    )
+    return outputArray
+  }
+
+  /**
+   * Blurs a Bitmap the way an out of focus lens does.
+   *
+   * See the ByteArray variant of [lensBlur] for details. This method supports input Bitmap of
+   * config ARGB_8888 and ALPHA_8. The returned Bitmap has the same config.
+   *
+   * @param inputBitmap The buffer of the image to be blurred.
+   * @param radius The radius of the shape in pixels, a value from 1 to 100.
+   * @param shape The shape of the aperture.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @return The blurred Bitmap.
+   */
+  @JvmOverloads
+  internal fun lensBlur(
+    inputBitmap: Bitmap,
+    radius: Int,
+    shape: LensShape = LensShape.DISC,
+    restriction: Range2d? = null,
+  ): Bitmap {
+    validateBitmap("lensBlur", inputBitmap)
+    require(radius in 1..100) {
+      "$externalName lensBlur. The radius should be between 1 and 100. $radius provided."
+    }
+    validateRestriction("lensBlur", inputBitmap.width, inputBitmap.height, restriction)
+
+    val outputBitmap = createCompatibleBitmap(inputBitmap)
+    nativeLensBlurBitmap(
+      nativeHandle,
+      inputBitmap,
+      outputBitmap,
+      radius,
+      shape.value,
+      restriction,
+    )
+    return outputBitmap
+  }
+
+  /**
+   * Identity matrix that can be passed to the {@link RenderScriptToolkit::colorMatrix} method.
+   *
+   * Using this matrix will result in no change to the pixel through multiplication although
+   * the pixel value can still be modified by the add vector, or transformed to a different
+   * format.
+   */
+  internal val identityMatrix: FloatArray
+    get() = floatArrayOf(
+      1f, 0f, 0f, 0f,
+      0f, 1f, 0f, 0f,
+      0f, 0f, 1f, 0f,
+      0f, 0f, 0f, 1f,
+    )
+
+  /**
+   * Matrix to turn color pixels to a grey scale.
+   *
+   * Use this matrix with the {@link RenderScriptToolkit::colorMatrix} method to convert an
+   * image from color to greyscale.
+   */
+  internal val greyScaleColorMatrix: FloatArray
+    get() = floatArrayOf(
+      0.299f, 0.299f, 0.299f, 0f,
+      0.587f, 0.587f, 0.587f, 0f,
+      0.114f, 0.114f, 0.114f, 0f,
+      0f, 0f, 0f, 1f,
+    )
+
+  /**
+   * Resize an image.
+   *
+   * Resizes an image using bicubic interpolation by default. Along an axis that is reduced by a
+   * factor of 2 or more, each output pixel is instead the average of the input area it covers,
+   * which keeps fine detail from aliasing, e.g. when making thumbnails of camera pictures. See
+   * [ResizeFilter] for the other filters.
+   *
+   * This method supports elements of 1 to 4 bytes in length. Each byte of the element is
+   * interpolated independently from the others.
+   *
+   * An optional range parameter can be set to restrict the operation to a rectangular subset
+   * of the output buffer. The corresponding scaled range of the input will be used. If provided,
+   * the range must be wholly contained with the dimensions described by outputSizeX and
+   * outputSizeY.
+   *
+   * The input and output arrays have a row-major layout. The input array should be
+   * large enough for sizeX * sizeY * vectorSize bytes.
+   *
+   * Like the RenderScript Intrinsics, vectorSize of size 3 are padded to occupy 4 bytes, unless
+   * [packedRgb] is set. Both arrays then hold 3 bytes per pixel, as JPEG decoders return RGB,
+   * which moves a quarter less memory than padding them.
+   *
+   * RGBA images whose color channels aren't premultiplied by alpha, as decoders often return
+   * them, can be resized without bleeding the color of transparent pixels into their neighbors,
+   * by passing [AlphaType.UNPREMULTIPLIED]. Images of 3 and 4 byte elements can be resized in
+   * linear light, by passing [ColorSpace.LINEAR], which keeps bright details from darkening.
+   * Elements of 3 bytes are then opaque RGB. Both are slower than the defaults.
+   *
+   * A source rectangle can be passed to resize only part of the input, e.g. to center-crop and
+   * scale an image in a single pass, without copying the cropped part first. Its edges can fall
+   * between pixels, and the output pixels are sampled at their exact positions within it. The
+   * filter still reads the input pixels just outside it, as if the whole image had been resized
+   * and the rectangle cut out of it.
+   *
+   * @param inputArray The buffer of the image to be resized.
+   * @param vectorSize The number of bytes in each element of both buffers. A value from 1 to 4.
+   * @param inputSizeX The width of the input buffer, as a number of 1-4 byte elements.
+   * @param inputSizeY The height of the input buffer, as a number of 1-4 byte elements.
+   * @param outputSizeX The width of the output buffer, as a number of 1-4 byte elements.
+   * @param outputSizeY The height of the output buffer, as a number of 1-4 byte elements.
+   * @param filter The filter used to compute the output pixels.
+   * @param alphaType Whether the color channels of the input are premultiplied by alpha. The
+   * output has the same alpha type.
+   * @param colorSpace The color space in which the pixels are mixed.
+   * @param sourceRect When not null, the rectangle of the input to resize, in pixels. It must be
+   * within the input and not empty.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @param packedRgb Whether elements of 3 bytes are packed rather than padded to 4. Only for a
+   * vectorSize of 3.
+   * @return An array that contains the rescaled image.
+   */
+  @JvmOverloads
+  internal fun resize(
+    inputArray: ByteArray,
+    vectorSize: Int,
+    inputSizeX: Int,
+    inputSizeY: Int,
+    outputSizeX: Int,
+    outputSizeY: Int,
+    filter: ResizeFilter = ResizeFilter.CATMULL_ROM,
+    alphaType: AlphaType = AlphaType.PREMULTIPLIED,
+    colorSpace: ColorSpace = ColorSpace.SRGB,
+    sourceRect: RectF? = null,
+    restriction: Range2d? = null,
+    packedRgb: Boolean = false,
+  ): ByteArray {
+    require(vectorSize in 1..4) {
+      "$externalName resize. The vectorSize should be between 1 and 4. $vectorSize provided."
+    }
+    require(!packedRgb || vectorSize == 3) {
+      "$externalName resize. packedRgb requires a vectorSize of 3. $vectorSize provided."
+    }
+    require(inputArray.size >= inputSizeX * inputSizeY * vectorSize) {
+      "$externalName resize. inputArray is too small for the given dimensions. " +
+        "$inputSizeX*$inputSizeY*$vectorSize < ${inputArray.size}."
+    }
+    validateSourceRect("resize", inputSizeX, inputSizeY, sourceRect)
+    validateRestriction("resize", outputSizeX, outputSizeY, restriction)
+
+    val elementSize = if (packedRgb) vectorSize else paddedSize(vectorSize)
+    val outputArray = ByteArray(outputSizeX * outputSizeY * elementSize)
+    nativeResize(
+      nativeHandle,
+      inputArray,
+      vectorSize,
+      packedRgb,
+      inputSizeX,
+      inputSizeY,
+      outputArray,
+      outputSizeX,
+      outputSizeY,
+      filter.value,
+      alphaType.value,
+      colorSpace.value,
+      sourceRect,
+      restriction,
+    )
+    return outputArray
+  }
+
+  /**
+   * Resize an image.
+   *
+   * Resizes an image using bicubic interpolation by default. See [ResizeFilter] for the other
+   * filters. Passing [ColorSpace.LINEAR] resizes in linear light, which is slower.
+   *
+   * Bitmaps that aren't premultiplied are resized without bleeding the color of their
+   * transparent pixels into their neighbors, and the returned Bitmap isn't premultiplied either.
+   *
+   * A source rectangle can be passed to resize only part of the input, e.g. to center-crop and
+   * scale a Bitmap in a single pass, as ContentScale.Crop does. See the ByteArray version.
+   *
+   * This method supports input Bitmap of config ARGB_8888, ALPHA_8 and RGBA_F16. The returned
+   * Bitmap has the same config. RGBA_F16 Bitmaps, e.g. HDR images, are mixed in float as they
+   * are, without clamping, so [colorSpace] doesn't apply to them, and keep their color space.
+   * Bitmaps with a stride different than width * the size of a pixel are not currently
+   * supported.
+   *
+   * An optional range parameter can be set to restrict the operation to a rectangular subset
+   * of the output buffer. The corresponding scaled range of the input will be used. If provided,
+   * the range must be wholly contained with the dimensions described by outputSizeX and
+   * outputSizeY.
+   *
+   * @param inputBitmap The Bitmap to be resized.
+   * @param outputSizeX The width of the output buffer, as a number of 1-4 byte elements.
+   * @param outputSizeY The height of the output buffer, as a number of 1-4 byte elements.
+   * @param filter The filter used to compute the output pixels.
+   * @param colorSpace The color space in which the pixels are mixed. Doesn't apply to ALPHA_8
+   * bitmaps.
+   * @param sourceRect When not null, the rectangle of the input to resize, in pixels. It must be
+   * within the input and not empty.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @return A Bitmap that contains the rescaled image.
+   */
+  @JvmOverloads
+  internal fun resize(
+    inputBitmap: Bitmap,
+    outputSizeX: Int,
+    outputSizeY: Int,
+    filter: ResizeFilter = ResizeFilter.CATMULL_ROM,
+    colorSpace: ColorSpace = ColorSpace.SRGB,
+    sourceRect: RectF? = null,
+    restriction: Range2d? = null,
+  ): Bitmap {
+    validateResizeBitmap("resize", inputBitmap)
+    validateSourceRect("resize", inputBitmap.width, inputBitmap.height, sourceRect)
+    validateRestriction("resize", outputSizeX, outputSizeY, restriction)
+
+    val alphaType = alphaType(inputBitmap)
+    val outputBitmap = createCompatibleBitmap(inputBitmap, outputSizeX, outputSizeY)
+    outputBitmap.isPremultiplied = alphaType == AlphaType.PREMULTIPLIED
+    nativeResizeBitmap(
+      nativeHandle,
+      inputBitmap,
+      outputBitmap,
+      filter.value,
+      alphaType.value,
+      colorSpace.value,
+      sourceRect,
+      restriction,
+    )
+    return outputBitmap
+  }
+
+  /**
+   * Resize an image of RGBA floats.
+   *
+   * Same as the ByteArray version, for images of 4 floats per pixel, e.g. HDR images or the
+   * inputs of models. The values are mixed as they are, in float, and aren't clamped, so the
+   * filters with negative weights can overshoot past the range of the input.
+   *
+   * @param inputArray The buffer of the image to be resized, 4 floats per pixel.
+   * @param inputSizeX The width of the input buffer, as a number of pixels.
+   * @param inputSizeY The height of the input buffer, as a number of pixels.
+   * @param outputSizeX The width of the output buffer, as a number of pixels.
+   * @param outputSizeY The height of the output buffer, as a number of pixels.
+   * @param filter The filter used to compute the output pixels.
+   * @param alphaType Whether the color channels of the input are premultiplied by alpha. The
+   * output has the same alpha type.
+   * @param sourceRect When not null, the rectangle of the input to resize, in pixels. It must be
+   * within the input and not empty.
+   * @param restriction When not null, restricts the operation to a 2D range of pixels.
+   * @return An array that contains the rescaled image.
+   */
+  @JvmOverloads
+  internal fun resize(
+    inputArray: FloatArray,
+    inputSizeX: Int,
+    inputSizeY: Int,
+    outputSizeX: Int,
+    outputSizeY: Int,
+    filter: ResizeFilter = ResizeFilter.CATMULL_ROM,
+    alphaType: AlphaType = AlphaType.PREMULTIPLIED,
+    sourceRect: RectF? = null,
+    restriction: Range2d? = null,
+  ): FloatArray {
+    validateFloatImage("resize", inputArray, inputSizeX, inputSizeY)
+    validateSourceRect("resize", inputSizeX, inputSizeY, sourceRect)
+    validateRestriction("resize", outputSizeX, outputSizeY, restriction)
+
+    val outputArray = FloatArray(outputSizeX * outputSizeY * 4)
+    nativeResizeFloat(
+      nativeHandle,
+      inputArray,
+      inputSizeX,
+      inputSizeY,
+      outputArray,
+      outputSizeX,
+      outputSizeY,
+      filter.value,
+      alphaType.value,
+      sourceRect,
+      restriction,
+    )
+    return outputArray
+  }
+
+  /**
+   * Resize an RGBA image into the input tensor of a model, e.g. a 224x224 classifier.
+   *
+   * The tensor is planar, as models with an NCHW layout take it: the outputSizeX * outputSizeY
+   * values of R, then those of G, then those of B. Each value is the channel of the resized
+   * pixel, from 0 to 255, times the [scale] of its channel plus its [bias]. They are computed as
+   * the resized rows are stored, without an intermediate image nor a conversion loop. To
+   * normalize the channels by the mean and the standard deviation of [0, 1] values, as most
+   * models expect, pass a scale of 1 / (255 * std) and a bias of -mean / std.
+   *
+   * The tensor is written from the start of [outputBuffer], a direct ByteBuffer in native byte
+   * order, e.g. the input buffer of an interpreter, whatever its position.
+   *
+   * @param inputArray The buffer of the RGBA image to be resized.
+   * @param inputSizeX The width of the input buffer, as a number of pixels.
+   * @param inputSizeY The height of the input buffer, as a number of pixels.
+   * @param outputSizeX The width of the tensor, as a number of values.
+   * @param outputSizeY The height of the tensor, as a number of values.
+   * @param outputBuffer The buffer that receives the tensor.
+   * @param scale The scale of the R, G and B channels.
+   * @param bias The bias of the R, G and B channels.
+   * @param type The type of the values of the tensor.
+   * @param filter The filter used to compute the output pixels.
+   * @param alphaType Whether the color channels of the input are premultiplied by alpha. The
+   * values of the tensor aren't.
+   * @param sourceRect When not null, the rectangle of the input to resize, in pixels, e.g. its
+   * center square. It must be within the input and not empty.
+   */
+  @JvmOverloads
+  internal fun resizeToTensor(
+    inputArray: ByteArray,
+    inputSizeX: Int,
+    inputSizeY: Int,
+    outputSizeX: Int,
+    outputSizeY: Int,
+    outputBuffer: ByteBuffer,
+    scale: FloatArray,
+    bias: FloatArray,
+    type: TensorType = TensorType.FLOAT32,
+    filter: ResizeFilter = ResizeFilter.CATMULL_ROM,
+    alphaType: AlphaType = AlphaType.PREMULTIPLIED,
+    sourceRect: RectF? = null,
+  ) {
+    require(inputArray.size >= inputSizeX * inputSizeY * 4) {
+      "$externalName resizeToTensor. inputArray is too small for the given dimensions. " +
+        "$inputSizeX*$inputSizeY*4 < ${inputArray.size}."
+    }
+    validateSourceRect("resizeToTensor", inputSizeX, inputSizeY, sourceRect)
+    validateTensor(outputSizeX, outputSizeY, outputBuffer, scale, bias, type)
+
+    nativeResizeToTensor(
+      nativeHandle,
+      inputArray,
+      inputSizeX,
+      inputSizeY,
+      outputBuffer,
+      outputSizeX,
+      outputSizeY,
+      type.value,
+      scale,
+      bias,
+      filter.value,
+      alphaType.value,
+      sourceRect,
+    )
+  }
+
+  /**
+   * Resize a Bitmap into the input tensor of a model.
+   *
+   * Same as the ByteArray version. This method supports input Bitmap of config ARGB_8888.
+   * Bitmaps that aren't premultiplied are resized without bleeding the color of their
+   * transparent pixels into their neighbors.
+   *
+   * @param inputBitmap The Bitmap to be resized.
+   * @param outputSizeX The width of the tensor, as a number of values.
+   * @param outputSizeY The height of the tensor, as a number of values.
+   * @param outputBuffer The buffer that receives the tensor.
+   * @param scale The scale of the R, G and B channels.
+   * @param bias The bias of the R, G and B channels.
+   * @param type The type of the values of the tensor.
+   * @param filter The filter used to compute the output pixels.
+   * @param sourceRect When not null, the rectangle of the input to resize, in pixels, e.g. its
+   * center square. It must be within the input and not empty.
+   */
+  @JvmOverloads
+  internal fun resizeToTensor(
+    inputBitmap: Bitmap,
+    outputSizeX: Int,
+    outputSizeY: Int,
+    outputBuffer: ByteBuffer,
+    scale: FloatArray,
+    bias: FloatArray,
+    type: TensorType = TensorType.FLOAT32,
+    filter: ResizeFilter = ResizeFilter.CATMULL_ROM,
+    sourceRect: RectF? = null,
+  ) {
+    validateBitmap("resizeToTensor", inputBitmap, alphaAllowed = false)
+    validateSourceRect("resizeToTensor", inputBitmap.width, inputBitmap.height, sourceRect)
+    validateTensor(outputSizeX, outputSizeY, outputBuffer, scale, bias, type)
+
+    nativeResizeToTensorBitmap(
+      nativeHandle,
+      inputBitmap,
+      outputBuffer,
+      outputSizeX,
+      outputSizeY,
+      type.value,
+      scale,
+      bias,
+      filter.value,
+      alphaType(inputBitmap).value,
+      sourceRect,
+    )
+  }
+
+  /**
+   * Resizes an image to several sizes at once, e.g. a list thumbnail, a grid tile and a detail
+   * preview.
+   *
+   * Each input row is read once for all the sizes, rather than once per call to [resize]. With
+   * [cascade], a size that is at most half of another one on both axes is resized from the
+   * latter as it's computed, which takes far less work, for a slightly blurrier result. Each
+   * output is otherwise the same as that of a [createResizeStream] stream.
+   *
+   * Like the RenderScript Intrinsics, vectorSize of size 3 are padded to occupy 4 bytes.
+   *
+   * @param inputArray The buffer of the image to be resized.
+   * @param vectorSize The number of bytes in each element of all the buffers. A value from 1 to
+   * 4.
+   * @param inputSizeX The width of the input buffer, as a number of 1-4 byte elements.
+   * @param inputSizeY The height of the input buffer, as a number of 1-4 byte elements.
+   * @param outputSizes The width and height of each output, one after the other, e.g.
+   * `intArrayOf(1080, 810, 400, 300)`.
+   * @param filter The filter used to compute the output pixels.
+   * @param cascade Whether the smaller outputs can be resized from the larger ones.
+   * @return One resized image per size, in the order of [outputSizes].
+   */
+  @JvmOverloads
+  internal fun resizeMultiple(
+    inputArray: ByteArray,
+    vectorSize: Int,
+    inputSizeX: Int,
+    inputSizeY: Int,
+    outputSizes: IntArray,
+    filter: ResizeFilter = ResizeFilter.CATMULL_ROM,
+    cascade: Boolean = false,
+  ): List<ByteArray> {
+    require(vectorSize in 1..4) {
+      "$externalName resizeMultiple. The vectorSize should be between 1 and 4. " +
+        "$vectorSize provided."
+    }
+    require(inputArray.size >= inputSizeX * inputSizeY * vectorSize) {
+      "$externalName resizeMultiple. inputArray is too small for the given dimensions. " +
+        "$inputSizeX*$inputSizeY*$vectorSize < ${inputArray.size}."
+    }
+    validateOutputSizes("resizeMultiple", outputSizes)
+
+    val outputArrays = Array(outputSizes.size / 2) { index ->
+      ByteArray(outputSizes[index * 2] * outputSizes[index * 2 + 1] * paddedSize(vectorSize))
+    }
+    nativeResizeMultiple(
+      nativeHandle,
+      inputArray,
+      vectorSize,
+      inputSizeX,
+      inputSizeY,
+      outputSizes,
+      filter.value,
+      cascade,
+      outputArrays,
+    )
+    return outputArrays.toList()
+  }
+
+  /**
+   * Resizes a Bitmap to several sizes at once. See the ByteArray version of [resizeMultiple].
+   *
+   * The pixels are mixed as they are stored, so Bitmaps that aren't premultiplied should go
+   * through [resize] instead.
+   *
+   * @param inputBitmap The Bitmap to be resized.
+   * @param outputSizes The width and height of each output, one after the other.
+   * @param filter The filter used to compute the output pixels.
+   * @param cascade Whether the smaller outputs can be resized from the larger ones.
+   * @return One resized Bitmap per size, in the order of [outputSizes].
+   */
+  @JvmOverloads
+  internal fun resizeMultiple(
+    inputBitmap: Bitmap,
+    outputSizes: IntArray,
+    filter: ResizeFilter = ResizeFilter.CATMULL_ROM,
+    cascade: Boolean = false,
+  ): List<Bitmap> {
+    validateBitmap("resizeMultiple", inputBitmap)
+    validateOutputSizes("resizeMultiple", outputSizes)
+
+    val outputBitmaps = Array(outputSizes.size / 2) { index ->
+      val outputBitmap = Bitmap.createBitmap(
+        outputSizes[index * 2],
+        outputSizes[index * 2 + 1],
+        inputBitmap.config,
+      )
+      outputBitmap.isPremultiplied = inputBitmap.isPremultiplied
+      outputBitmap
+    }
+    nativeResizeMultipleBitmap(
+      nativeHandle,
+      inputBitmap,
+      outputSizes,
+      filter.value,
+      cascade,
+      outputBitmaps,
+    )
+    return outputBitmaps.toList()
+  }
+
+  /**
+   * Creates a stream that resizes an image row by row, as the rows arrive, e.g. from a decoder.
+   *
+   * Same as [resize], except that the input is pushed one row at a time with
+   * [ResizeStream.pushRow], and each output row comes out as soon as the input rows it needs
+   * are in. Only a few rows are kept, so a large picture can be shrunk to the screen without
+   * ever holding all of it in memory. The stream works on the thread that pushes the rows.
+   *
+   * Like the RenderScript Intrinsics, vectorSize of size 3 are padded to occupy 4 bytes.
+   *
+   * @param vectorSize The number of bytes in each element of both images. A value from 1 to 4.
+   * @param inputSizeX The width of the input, as a number of 1-4 byte elements.
+   * @param inputSizeY The height of the input, as a number of 1-4 byte elements.
+   * @param outputSizeX The width of the output, as a number of 1-4 byte elements.
+   * @param outputSizeY The height of the output, as a number of 1-4 byte elements.
+   * @param filter The filter used to compute the output pixels.
+   * @return The stream, to be closed once done.
+   */
+  @JvmOverloads
+  internal fun createResizeStream(
+    vectorSize: Int,
+    inputSizeX: Int,
+    inputSizeY: Int,
+    outputSizeX: Int,
+    outputSizeY: Int,
+    filter: ResizeFilter = ResizeFilter.CATMULL_ROM,
+  ): ResizeStream {
+    require(vectorSize in 1..4) {
+      "$externalName createResizeStream. The vectorSize should be between 1 and 4. " +
+        "$vectorSize provided."
+    }
+    require(inputSizeX > 0 && inputSizeY > 0 && outputSizeX > 0 && outputSizeY > 0) {
+      "$externalName createResizeStream. The sizes should be positive. " +
+        "${inputSizeX}x$inputSizeY to ${outputSizeX}x$outputSizeY provided."
+    }
+
+    val streamHandle = nativeCreateResizeStream(
+      nativeHandle,
+      vectorSize,
+      inputSizeX,
+      inputSizeY,
+      outputSizeX,
+      outputSizeY,
+      filter.value,
+    )
+    check(streamHandle != 0L) {
+      "$externalName createResizeStream. The buffers of the stream couldn't be allocated."
+    }
+    return ResizeStream(streamHandle, vectorSize, inputSizeX, outputSizeX)
+  }
+
+  /**
+   * Generates the mipmap chain of an image, e.g. to upload it as a texture.
+   *
+   * Each level is half the size of the one above it, rounded down, and at least 1 element, as
+   * OpenGL expects. Each element is the rounded average of the 2x2 elements it covers in the level
+   * above; an odd last row or column of the latter is left out. Along an axis that's down to 1
+   * element, the level averages pairs of elements along the other axis only. Level 0 is the input.
+   *
+   * The levels are computed a few at a time in a single pass over the level they start from, so
+   * the input is read once. A level can also be the input of [resize], e.g. to reduce an image by
+   * a large factor with few taps.
+   *
+   * Like the RenderScript Intrinsics, vectorSize of size 3 are padded to occupy 4 bytes.
+   *
+   * @param inputArray The buffer of the image.
+   * @param vectorSize The number of bytes in each element of the buffers. A value from 1 to 4.
+   * @param sizeX The width of the input buffer, as a number of 1-4 byte elements.
+   * @param sizeY The height of the input buffer, as a number of 1-4 byte elements.
+   * @param levelCount The number of levels to generate, by default until both sides are 1.
+   * @return The levels 1 to levelCount, back to back and without padding. See [mipmapOffsets]
+   * for where each one starts.
+   */
+  @JvmOverloads
+  internal fun generateMipmaps(
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    levelCount: Int = mipmapLevelCount(sizeX, sizeY),
+  ): ByteArray {
+    require(vectorSize in 1..4) {
+      "$externalName generateMipmaps. The vectorSize should be between 1 and 4. " +
+        "$vectorSize provided."
+    }
+    require(inputArray.size >= sizeX * sizeY * vectorSize) {
+      "$externalName generateMipmaps. inputArray is too small for the given dimensions. " +
+        "$sizeX*$sizeY*$vectorSize < ${inputArray.size}."
+    }
+    val maxLevels = mipmapLevelCount(sizeX, sizeY)
+    require(levelCount in 1..maxLevels) {
+      "$externalName generateMipmaps. The levelCount should be between 1 and $maxLevels for a " +
+        "${sizeX}x$sizeY image. $levelCount provided."
+    }
+
+    val offsets = mipmapOffsets(sizeX, sizeY, vectorSize, levelCount)
+    val outputArray = ByteArray(offsets[levelCount])
+    nativeGenerateMipmaps(
+      nativeHandle,
+      inputArray,
+      vectorSize,
+      sizeX,
+      sizeY,
+      levelCount,
+      outputArray,
+    )
+    return outputArray
+  }
+
+  /**
+   * Generates the mipmap chain of a Bitmap. See the ByteArray variant of [generateMipmaps].
+   *
+   * This method supports input Bitmap of config ARGB_8888 and ALPHA_8. The levels have 4 and 1
+   * bytes per pixel, respectively.
+   *
+   * @param inputBitmap The Bitmap of the image.
+   * @param levelCount The number of levels to generate, by default until both sides are 1.
+   * @return The levels 1 to levelCount, back to back and without padding. See [mipmapOffsets]
+   * for where each one starts.
+   */
+  @JvmOverloads
+  internal fun generateMipmaps(
+    inputBitmap: Bitmap,
+    levelCount: Int = mipmapLevelCount(inputBitmap.width, inputBitmap.height),
+  ): ByteArray {
+    validateBitmap("generateMipmaps", inputBitmap)
+    val maxLevels = mipmapLevelCount(inputBitmap.width, inputBitmap.height)
+    require(levelCount in 1..maxLevels) {
+      "$externalName generateMipmaps. The levelCount should be between 1 and $maxLevels for a " +
+        "${inputBitmap.width}x${inputBitmap.height} bitmap. $levelCount provided."
+    }
+
+    val offsets =
+      mipmapOffsets(inputBitmap.width, inputBitmap.height, vectorSize(inputBitmap), levelCount)
+    val outputArray = ByteArray(offsets[levelCount])
+    nativeGenerateMipmapsBitmap(nativeHandle, inputBitmap, levelCount, outputArray)
+    return outputArray
+  }
+
+  /**
+   * The number of levels of the full mipmap chain of an image, below the full size image, i.e.
+   * the most levels [generateMipmaps] accepts.
+   */
+  internal fun mipmapLevelCount(sizeX: Int, sizeY: Int): Int =
+    31 - Integer.numberOfLeadingZeros(maxOf(sizeX, sizeY))
+
+  /**
+   * Where each level starts in the array returned by [generateMipmaps]. Entry k - 1 is the offset
+   * of level k, and entry levelCount is the size of the array.
+   *
+   * @param sizeX The width of the image, as a number of 1-4 byte elements.
+   * @param sizeY The height of the image, as a number of 1-4 byte elements.
+   * @param vectorSize The number of bytes in each element. A value from 1 to 4.
+   * @param levelCount The number of levels.
+   */
+  internal fun mipmapOffsets(sizeX: Int, sizeY: Int, vectorSize: Int, levelCount: Int): IntArray {
+    val offsets = IntArray(levelCount + 1)
+    for (level in 1..levelCount) {
+      val levelSize = maxOf(sizeX shr level, 1) * maxOf(sizeY shr level, 1)
+      offsets[level] = offsets[level - 1] + levelSize * paddedSize(vectorSize)
+    }
+    return offsets
+  }
+
+  /**
+   * Caps the kernels used by the following calls, e.g. to check that the SIMD kernels agree with
+   * each other and with the scalar code, or to compare their speed. By default, the toolkit uses
+   * the most capable kernels the processor supports.
+   *
+   * @param level The most capable kernels to use. Levels the processor doesn't support are
+   * lowered to the most capable one it does.
+   * @return The level actually used.
+   */
+  internal fun setMaxSimdLevel(level: SimdLevel): SimdLevel {
+    val used = nativeSetMaxSimdLevel(nativeHandle, level.value)
+    return SimdLevel.entries.first { it.value == used }
+  }
+
+  private var nativeHandle: Long = 0
+
+  init {
+    System.loadLibrary("renderscript-toolkit")
+    nativeHandle = createNative()
+  }
+
+  /**
+   * Shutdown the thread pool.
+   *
+   * Waits for the threads to complete their work and destroys them.
+   *
+   * An application should call this method only if it is sure that it won't call the
+   * toolkit again, as it is irreversible.
+   */
+  internal fun shutdown() {
+    destroyNative(nativeHandle)
+    nativeHandle = 0
+  }
+
+  private external fun createNative(): Long
+
+  private external fun destroyNative(nativeHandle: Long)
+
+  private external fun nativeSetMaxSimdLevel(nativeHandle: Long, level: Int): Int
+
+  private external fun nativeBlur(
+    nativeHandle: Long,
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radiusX: Int,
+    radiusY: Int,
+    alphaType: Int,
+    colorSpace: Int,
+    edgeMode: Int,
+    outputArray: ByteArray,
+    restriction: Range2d?,
+  )
+
+  private external fun nativeBlurFloat(
+    nativeHandle: Long,
+    inputArray: FloatArray,
+    sizeX: Int,
+    sizeY: Int,
+    radiusX: Int,
+    radiusY: Int,
+    alphaType: Int,
+    edgeMode: Int,
+    outputArray: FloatArray,
+    restriction: Range2d?,
+  )
+
+  private external fun nativeBlurBitmap(
+    nativeHandle: Long,
+    inputBitmap: Bitmap,
+    outputBitmap: Bitmap,
+    radiusX: Int,
+    radiusY: Int,
+    alphaType: Int,
+    colorSpace: Int,
+    edgeMode: Int,
+    restriction: Range2d?,
+  )
+
+  private external fun nativeBlurWithQuality(
+    nativeHandle: Long,
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radius: Int,
+    quality: Int,
+    outputArray: ByteArray,
+    restriction: Range2d?,
+  )
+
+  private external fun nativeBlurWithQualityBitmap(
+    nativeHandle: Long,
+    inputBitmap: Bitmap,
+    outputBitmap: Bitmap,
+    radius: Int,
+    quality: Int,
+    restriction: Range2d?,
+  )
+
+  private external fun nativeBlurLadder(
+    nativeHandle: Long,
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radii: IntArray,
+    quality: Int,
+    outputArrays: Array<ByteArray>,
+  )
+
+  private external fun nativeBlurLadderBitmap(
+    nativeHandle: Long,
+    inputBitmap: Bitmap,
+    radii: IntArray,
+    quality: Int,
+    outputBitmaps: Array<Bitmap>,
+  )
+
+  private external fun nativeInterpolateBlurLadder(
+    nativeHandle: Long,
+    ladder: Array<ByteArray>,
+    radii: IntArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radius: Float,
+    outputArray: ByteArray,
+    restriction: Range2d?,
+  )
+
+  private external fun nativeInterpolateBlurLadderBitmap(
+    nativeHandle: Long,
+    ladder: Array<Bitmap>,
+    radii: IntArray,
+    radius: Float,
+    outputBitmap: Bitmap,
+    restriction: Range2d?,
+  )
 
-    val outputBitmap = Bitmap.createBitmap(outputSizeX, outputSizeY, Bitmap.Config.ARGB_8888)
-    nativeResizeBitmap(nativeHandle, inputBitmap, outputBitmap, restriction)
-    return outputBitmap
-  }
+  private external fun nativeBlurInPlace(
+    nativeHandle: Long,
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radiusX: Int,
+    radiusY: Int,
+    alphaType: Int,
+    colorSpace: Int,
+    edgeMode: Int,
+  )
 
-  private var nativeHandle: Long = 0
+  private external fun nativeBlurInPlaceBitmap(
+    nativeHandle: Long,
+    bitmap: Bitmap,
+    radiusX: Int,
+    radiusY: Int,
+    alphaType: Int,
+    colorSpace: Int,
+    edgeMode: Int,
+  )
 
-  init {
-    System.loadLibrary("renderscript-toolkit")
-    nativeHandle = createNative()
-  }
+  private external fun nativeBlurDirtyRegions(
+    nativeHandle: Long,
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radiusX: Int,
+    radiusY: Int,
+    alphaType: Int,
+    colorSpace: Int,
+    edgeMode: Int,
+    outputArray: ByteArray,
+    dirtyRegions: IntArray,
+  )
 
-  /**
-   * Shutdown the thread pool.
-   *
-   * Waits for the threads to complete their work and destroys them.
-   *
-   * An application should call this method only if it is sure that it won't call the
-   * toolkit again, as it is irreversible.
-   */
-  internal fun shutdown() {
-    destroyNative(nativeHandle)
-    nativeHandle = 0
-  }
+  private external fun nativeBlurDirtyRegionsBitmap(
+    nativeHandle: Long,
+    inputBitmap: Bitmap,
+    outputBitmap: Bitmap,
+    radiusX: Int,
+    radiusY: Int,
+    alphaType: Int,
+    colorSpace: Int,
+    edgeMode: Int,
+    dirtyRegions: IntArray,
+  )
 
-  private external fun createNative(): Long
+  private external fun nativeShadow(
+    nativeHandle: Long,
+    inputArray: ByteArray,
+    sizeX: Int,
+    sizeY: Int,
+    outputArray: ByteArray,
+    outputSizeX: Int,
+    outputSizeY: Int,
+    radius: Int,
+    color: Int,
+    offsetX: Int,
+    offsetY: Int,
+    restriction: Range2d?,
+  )
 
-  private external fun destroyNative(nativeHandle: Long)
+  private external fun nativeShadowBitmap(
+    nativeHandle: Long,
+    inputBitmap: Bitmap,
+    outputBitmap: Bitmap,
+    radius: Int,
+    color: Int,
+    offsetX: Int,
+    offsetY: Int,
+    restriction: Range2d?,
+  )
 
-  private external fun nativeBlur(
+  private external fun nativeMotionBlur(
     nativeHandle: Long,
     inputArray: ByteArray,
     vectorSize: Int,
     sizeX: Int,
     sizeY: Int,
     radius: Int,
+    angle: Float,
     outputArray: ByteArray,
     restriction: Range2d?,
   )
 
-  private external fun nativeBlurBitmap(
+  private external fun nativeMotionBlurBitmap(
+    nativeHandle: Long,
+    inputBitmap: Bitmap,
+    outputBitmap: Bitmap,
+    radius: Int,
+    angle: Float,
+    restriction: Range2d?,
+  )
+
+  private external fun nativeLensBlur(
+    nativeHandle: Long,
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    radius: Int,
+    shape: Int,
+    outputArray: ByteArray,
+    restriction: Range2d?,
+  )
+
+  private external fun nativeLensBlurBitmap(
     nativeHandle: Long,
     inputBitmap: Bitmap,
     outputBitmap: Bitmap,
     radius: Int,
+    shape: Int,
     restriction: Range2d?,
   )
 
@@ -324,11 +1995,16 @@ internal object RenderScriptToolkit {
     nativeHandle: Long,
     inputArray: ByteArray,
     vectorSize: Int,
+    packedRgb: Boolean,
     inputSizeX: Int,
     inputSizeY: Int,
     outputArray: ByteArray,
     outputSizeX: Int,
     outputSizeY: Int,
+    filter: Int,
+    alphaType: Int,
+    colorSpace: Int,
+    sourceRect: RectF?,
     restriction: Range2d?,
   )
 
@@ -336,8 +2012,104 @@ internal object RenderScriptToolkit {
     nativeHandle: Long,
     inputBitmap: Bitmap,
     outputBitmap: Bitmap,
+    filter: Int,
+    alphaType: Int,
+    colorSpace: Int,
+    sourceRect: RectF?,
+    restriction: Range2d?,
+  )
+
+  private external fun nativeResizeFloat(
+    nativeHandle: Long,
+    inputArray: FloatArray,
+    inputSizeX: Int,
+    inputSizeY: Int,
+    outputArray: FloatArray,
+    outputSizeX: Int,
+    outputSizeY: Int,
+    filter: Int,
+    alphaType: Int,
+    sourceRect: RectF?,
     restriction: Range2d?,
   )
+
+  private external fun nativeResizeToTensor(
+    nativeHandle: Long,
+    inputArray: ByteArray,
+    inputSizeX: Int,
+    inputSizeY: Int,
+    outputBuffer: ByteBuffer,
+    outputSizeX: Int,
+    outputSizeY: Int,
+    type: Int,
+    scale: FloatArray,
+    bias: FloatArray,
+    filter: Int,
+    alphaType: Int,
+    sourceRect: RectF?,
+  )
+
+  private external fun nativeResizeToTensorBitmap(
+    nativeHandle: Long,
+    inputBitmap: Bitmap,
+    outputBuffer: ByteBuffer,
+    outputSizeX: Int,
+    outputSizeY: Int,
+    type: Int,
+    scale: FloatArray,
+    bias: FloatArray,
+    filter: Int,
+    alphaType: Int,
+    sourceRect: RectF?,
+  )
+
+  private external fun nativeResizeMultiple(
+    nativeHandle: Long,
+    inputArray: ByteArray,
+    vectorSize: Int,
+    inputSizeX: Int,
+    inputSizeY: Int,
+    outputSizes: IntArray,
+    filter: Int,
+    cascade: Boolean,
+    outputArrays: Array<ByteArray>,
+  )
+
+  private external fun nativeResizeMultipleBitmap(
+    nativeHandle: Long,
+    inputBitmap: Bitmap,
+    outputSizes: IntArray,
+    filter: Int,
+    cascade: Boolean,
+    outputBitmaps: Array<Bitmap>,
+  )
+
+  private external fun nativeCreateResizeStream(
+    nativeHandle: Long,
+    vectorSize: Int,
+    inputSizeX: Int,
+    inputSizeY: Int,
+    outputSizeX: Int,
+    outputSizeY: Int,
+    filter: Int,
+  ): Long
+
+  private external fun nativeGenerateMipmaps(
+    nativeHandle: Long,
+    inputArray: ByteArray,
+    vectorSize: Int,
+    sizeX: Int,
+    sizeY: Int,
+    levelCount: Int,
+    outputArray: ByteArray,
+  )
+
+  private external fun nativeGenerateMipmapsBitmap(
+    nativeHandle: Long,
+    inputBitmap: Bitmap,
+    levelCount: Int,
+    outputArray: ByteArray,
+  )
 }
 
 /**
@@ -382,6 +2154,109 @@ internal data class Range2d(
   internal constructor() : this(0, 0, 0, 0)
 }
 
+/**
+ * How the color channels of a pixel relate to its alpha channel.
+ *
+ * Android Bitmaps are premultiplied, i.e. each color channel has already been multiplied by the
+ * alpha of the pixel. Images decoded straight from PNG files usually aren't.
+ */
+internal enum class AlphaType(val value: Int) {
+  PREMULTIPLIED(0),
+  UNPREMULTIPLIED(1),
+}
+
+/**
+ * The color space in which the pixels are mixed.
+ *
+ * [SRGB] mixes the encoded bytes directly, which is fast but darkens the transitions between
+ * bright and dark areas. [LINEAR] mixes the pixels in linear light, which matches how light
+ * combines.
+ */
+internal enum class ColorSpace(val value: Int) {
+  SRGB(0),
+  LINEAR(1),
+}
+
+/**
+ * How an image extends past its edges, i.e. which values replace the pixels that are out of
+ * boundary.
+ *
+ * [CLAMP] repeats the edge pixels. [MIRROR] and [WRAP] repeat the whole image, the first
+ * flipping every other copy so that adjacent copies seam, the second not. They are the right
+ * choices for tiled backgrounds. [TRANSPARENT] uses fully transparent pixels.
+ */
+internal enum class EdgeMode(val value: Int) {
+  CLAMP(0),
+  MIRROR(1),
+  WRAP(2),
+  TRANSPARENT(3),
+}
+
+/**
+ * The algorithm used to blur an image.
+ *
+ * [GAUSSIAN] convolves the image with a Gaussian kernel, for a cost that grows with the radius.
+ * [FAST] halves the image a few times and doubles it back to its size, mixing neighboring
+ * pixels at each step, for a cost that stays about the same whatever the radius. Its result is
+ * close to, but not exactly, a Gaussian blur.
+ */
+internal enum class BlurQuality(val value: Int) {
+  GAUSSIAN(0),
+  FAST(1),
+}
+
+/**
+ * The shape of the aperture simulated by lensBlur.
+ *
+ * [DISC] is the round aperture of a wide open lens. [HEXAGON] is that of a lens stopped down
+ * with six blades; it has flat top and bottom sides.
+ */
+internal enum class LensShape(val value: Int) {
+  DISC(0),
+  HEXAGON(1),
+}
+
+/**
+ * The filter used by resize to compute each output pixel from the input pixels around it.
+ *
+ * [NEAREST] copies the closest input pixel, the fastest choice, e.g. for placeholders.
+ * [BILINEAR] mixes the 2x2 closest pixels. [CATMULL_ROM] is the bicubic of RenderScript; it's
+ * sharp but rings a little around edges. [MITCHELL] rings less, at the price of a little blur.
+ * [LANCZOS3] mixes the 6x6 closest pixels, keeping the most detail, e.g. for detail views, at the
+ * highest cost.
+ */
+internal enum class ResizeFilter(val value: Int) {
+  NEAREST(0),
+  BILINEAR(1),
+  CATMULL_ROM(2),
+  MITCHELL(3),
+  LANCZOS3(4),
+}
+
+/**
+ * The type of the values of the tensors resizeToTensor fills, as models take them.
+ *
+ * [FLOAT32] is a float per value, in native byte order. [INT8] is a signed byte per value,
+ * rounded to the nearest and saturated, for quantized models.
+ */
+internal enum class TensorType(val value: Int, val size: Int) {
+  FLOAT32(0, 4),
+  INT8(1, 1),
+}
+
+/**
+ * The sets of kernels the toolkit picks from, from the least to the most capable.
+ *
+ * [SCALAR] is the plain C++ code. [BASELINE] adds the NEON kernels on ARM and the SSSE3 ones on
+ * x86. [AVX2] and [AVX512] add the wider x86 kernels.
+ */
+internal enum class SimdLevel(val value: Int) {
+  SCALAR(0),
+  BASELINE(1),
+  AVX2(2),
+  AVX512(3),
+}
+
 internal class Rgba3dArray(val values: ByteArray, val sizeX: Int, val sizeY: Int, val sizeZ: Int) {
   init {
     require(values.size >= sizeX * sizeY * sizeZ * 4)
@@ -408,6 +2283,64 @@ internal class Rgba3dArray(val values: ByteArray, val sizeX: Int, val sizeY: Int
   }
 }
 
+/**
+ * Resizes an image whose rows arrive one at a time, in order. Created by
+ * [RenderScriptToolkit.createResizeStream]. It holds native buffers until it's closed.
+ */
+internal class ResizeStream internal constructor(
+  private var nativeHandle: Long,
+  private val vectorSize: Int,
+  private val inputSizeX: Int,
+  private val outputSizeX: Int,
+) : Closeable {
+  /**
+   * The most output rows a single call to [pushRow] can produce.
+   */
+  val maxRowsPerPush: Int = nativeMaxRowsPerPush(nativeHandle)
+
+  /**
+   * Pushes the next input row and writes the output rows it completes, if any.
+   *
+   * @param inputRow The input row, inputSizeX elements.
+   * @param outputRows The array that receives the completed output rows, back to back. It
+   * should be large enough for [maxRowsPerPush] rows of outputSizeX elements.
+   * @return The number of output rows written to outputRows. All the output rows have been
+   * written once the last input row is pushed.
+   */
+  fun pushRow(inputRow: ByteArray, outputRows: ByteArray): Int {
+    check(nativeHandle != 0L) { "$externalName pushRow. The stream is closed." }
+    require(inputRow.size >= inputSizeX * paddedSize(vectorSize)) {
+      "$externalName pushRow. inputRow is too small for the input width. " +
+        "${inputRow.size} < $inputSizeX*${paddedSize(vectorSize)}."
+    }
+    require(outputRows.size >= maxRowsPerPush * outputSizeX * paddedSize(vectorSize)) {
+      "$externalName pushRow. outputRows is too small for maxRowsPerPush rows. " +
+        "${outputRows.size} < $maxRowsPerPush*$outputSizeX*${paddedSize(vectorSize)}."
+    }
+    return nativePushRow(nativeHandle, inputRow, outputRows)
+  }
+
+  /**
+   * Frees the native buffers of the stream.
+   */
+  override fun close() {
+    if (nativeHandle != 0L) {
+      nativeDestroy(nativeHandle)
+      nativeHandle = 0
+    }
+  }
+
+  private external fun nativeMaxRowsPerPush(nativeHandle: Long): Int
+
+  private external fun nativePushRow(
+    nativeHandle: Long,
+    inputRow: ByteArray,
+    outputRows: ByteArray,
+  ): Int
+
+  private external fun nativeDestroy(nativeHandle: Long)
+}
+
 internal fun validateBitmap(
   function: String,
   inputBitmap: Bitmap,
@@ -434,8 +2367,166 @@ internal fun validateBitmap(
   }
 }
 
-internal fun createCompatibleBitmap(inputBitmap: Bitmap) =
-  Bitmap.createBitmap(inputBitmap.width, inputBitmap.height, inputBitmap.config)
+/**
+ * Whether the Gaussian blur of a Bitmap of this config can be done without converting the
+ * Bitmap first.
+ */
+internal fun isBlurSupported(config: Bitmap.Config?): Boolean =
+  config == Bitmap.Config.ARGB_8888 ||
+    config == Bitmap.Config.ALPHA_8 ||
+    config == Bitmap.Config.RGB_565 ||
+    (Build.VERSION.SDK_INT >= Build.VERSION_CODES.O && config == Bitmap.Config.RGBA_F16) ||
+    (
+      Build.VERSION.SDK_INT >= Build.VERSION_CODES.TIRAMISU &&
+        config == Bitmap.Config.RGBA_1010102
+      )
+
+internal fun validateBlurBitmap(function: String, inputBitmap: Bitmap) {
+  val config = inputBitmap.config
+  if (config == Bitmap.Config.ARGB_8888 || config == Bitmap.Config.ALPHA_8) {
+    validateBitmap(function, inputBitmap)
+    return
+  }
+  require(isBlurSupported(config)) {
+    "$externalName. $function supports only ARGB_8888, ALPHA_8, RGBA_F16, RGB_565 and " +
+      "RGBA_1010102 bitmaps. $config provided."
+  }
+  val pixelSize = when {
+    config == Bitmap.Config.RGB_565 -> 2
+    Build.VERSION.SDK_INT >= Build.VERSION_CODES.O && config == Bitmap.Config.RGBA_F16 -> 8
+    else -> 4
+  }
+  require(inputBitmap.width * pixelSize == inputBitmap.rowBytes) {
+    "$externalName $function. Only bitmaps with rowSize equal to the width * pixelSize are " +
+      "currently supported. Provided were rowBytes=${inputBitmap.rowBytes}, " +
+      "width=${inputBitmap.width}, and pixelSize=$pixelSize."
+  }
+}
+
+/**
+ * Whether the Bitmap holds half floats, which resize and blur mix as they are.
+ */
+internal fun isHalfFloat(inputBitmap: Bitmap): Boolean =
+  Build.VERSION.SDK_INT >= Build.VERSION_CODES.O && inputBitmap.config == Bitmap.Config.RGBA_F16
+
+internal fun validateResizeBitmap(function: String, inputBitmap: Bitmap) {
+  if (!isHalfFloat(inputBitmap)) {
+    validateBitmap(function, inputBitmap)
+    return
+  }
+  require(inputBitmap.width * 8 == inputBitmap.rowBytes) {
+    "$externalName $function. Only bitmaps with rowSize equal to the width * pixelSize are " +
+      "currently supported. Provided were rowBytes=${inputBitmap.rowBytes}, " +
+      "width=${inputBitmap.width}, and pixelSize=8."
+  }
+}
+
+internal fun validateFloatImage(function: String, inputArray: FloatArray, sizeX: Int, sizeY: Int) {
+  require(inputArray.size >= sizeX * sizeY * 4) {
+    "$externalName $function. inputArray is too small for the given dimensions. " +
+      "$sizeX*$sizeY*4 < ${inputArray.size}."
+  }
+}
+
+internal fun validateTensor(
+  outputSizeX: Int,
+  outputSizeY: Int,
+  outputBuffer: ByteBuffer,
+  scale: FloatArray,
+  bias: FloatArray,
+  type: TensorType,
+) {
+  require(outputSizeX > 0 && outputSizeY > 0) {
+    "$externalName resizeToTensor. The output sizes should be greater than 0. " +
+      "$outputSizeX and $outputSizeY provided."
+  }
+  require(outputBuffer.isDirect) {
+    "$externalName resizeToTensor. outputBuffer should be a direct ByteBuffer."
+  }
+  require(type == TensorType.INT8 || outputBuffer.order() == ByteOrder.nativeOrder()) {
+    "$externalName resizeToTensor. outputBuffer should be in native byte order. " +
+      "${outputBuffer.order()} provided."
+  }
+  val tensorSize = 3 * outputSizeX * outputSizeY * type.size
+  require(outputBuffer.capacity() >= tensorSize) {
+    "$externalName resizeToTensor. outputBuffer is too small for the given dimensions. " +
+      "${outputBuffer.capacity()} < 3*$outputSizeX*$outputSizeY*${type.size}."
+  }
+  require(scale.size == 3 && bias.size == 3) {
+    "$externalName resizeToTensor. scale and bias should have 3 values. " +
+      "${scale.size} and ${bias.size} provided."
+  }
+}
+
+internal fun validateRadii(radiusX: Int, radiusY: Int) {
+  require(radiusX in 0..25 && radiusY in 0..25) {
+    "$externalName blur. The radii should be between 0 and 25. " +
+      "$radiusX and $radiusY provided."
+  }
+  require(radiusX > 0 || radiusY > 0) {
+    "$externalName blur. At least one of the radii should be greater than 0."
+  }
+}
+
+internal fun validateRadius(radius: Int, quality: BlurQuality) {
+  val maxRadius = if (quality == BlurQuality.FAST) 250 else 25
+  require(radius in 1..maxRadius) {
+    "$externalName blur. The radius should be between 1 and $maxRadius. $radius provided."
+  }
+}
+
+internal fun validateLadderRadii(radii: IntArray, quality: BlurQuality) {
+  val maxRadius = if (quality == BlurQuality.FAST) 250 else 50
+  require(radii.isNotEmpty()) {
+    "$externalName blurLadder. At least one radius should be provided."
+  }
+  radii.forEachIndexed { index, radius ->
+    require(radius in 0..maxRadius) {
+      "$externalName blurLadder. The radii should be between 0 and $maxRadius. " +
+        "$radius provided."
+    }
+    require(index == 0 || radius > radii[index - 1]) {
+      "$externalName blurLadder. The radii should be in increasing order. " +
+        "$radius follows ${radii[index - 1]}."
+    }
+  }
+}
+
+/**
+ * Packs the regions as startX, endX, startY, endY quadruplets, the layout of the C++ Restriction.
+ */
+internal fun flattenRegions(regions: List<Range2d>): IntArray {
+  val flattened = IntArray(regions.size * 4)
+  regions.forEachIndexed { index, region ->
+    flattened[index * 4] = region.startX
+    flattened[index * 4 + 1] = region.endX
+    flattened[index * 4 + 2] = region.startY
+    flattened[index * 4 + 3] = region.endY
+  }
+  return flattened
+}
+
+internal fun alphaType(bitmap: Bitmap) =
+  if (bitmap.isPremultiplied || !bitmap.hasAlpha()) {
+    AlphaType.PREMULTIPLIED
+  } else {
+    AlphaType.UNPREMULTIPLIED
+  }
+
+internal fun createCompatibleBitmap(
+  inputBitmap: Bitmap,
+  width: Int = inputBitmap.width,
+  height: Int = inputBitmap.height,
+): Bitmap {
+  // Keeps the color space, e.g. the linear one of RGBA_F16 Bitmaps.
+  if (Build.VERSION.SDK_INT >= Build.VERSION_CODES.O) {
+    val colorSpace = inputBitmap.colorSpace
+    if (colorSpace != null) {
+      return Bitmap.createBitmap(width, height, inputBitmap.config, true, colorSpace)
+    }
+  }
+  return Bitmap.createBitmap(width, height, inputBitmap.config)
+}
 
 internal fun validateHistogramDotCoefficients(
   coefficients: FloatArray?,
@@ -490,6 +2581,34 @@ internal fun validateRestriction(
   }
 }
 
+internal fun validateSourceRect(tag: String, sizeX: Int, sizeY: Int, sourceRect: RectF?) {
+  if (sourceRect == null) return
+  require(
+    sourceRect.left >= 0f && sourceRect.left < sourceRect.right && sourceRect.right <= sizeX,
+  ) {
+    "$externalName $tag. The source rectangle should be within 0 and $sizeX horizontally, " +
+      "and not empty. ${sourceRect.left} and ${sourceRect.right} were provided respectively."
+  }
+  require(
+    sourceRect.top >= 0f && sourceRect.top < sourceRect.bottom && sourceRect.bottom <= sizeY,
+  ) {
+    "$externalName $tag. The source rectangle should be within 0 and $sizeY vertically, " +
+      "and not empty. ${sourceRect.top} and ${sourceRect.bottom} were provided respectively."
+  }
+}
+
+internal fun validateOutputSizes(tag: String, outputSizes: IntArray) {
+  require(outputSizes.isNotEmpty() && outputSizes.size % 2 == 0) {
+    "$externalName $tag. outputSizes should hold a width and a height per output. " +
+      "${outputSizes.size} values provided."
+  }
+  outputSizes.forEach { size ->
+    require(size > 0) {
+      "$externalName $tag. The output sizes should be greater than 0. $size provided."
+    }
+  }
+}
+
 internal fun vectorSize(bitmap: Bitmap): Int {
   return when (bitmap.config) {
     Bitmap.Config.ARGB_8888 -> 4
@@ -24,6 +24,7 @@ import androidx.compose.ui.graphics.asImageBitmap
 import androidx.compose.ui.graphics.painter.Painter
 import com.skydoves.landscapist.transformation.RenderScriptToolkit
 import com.skydoves.landscapist.transformation.TransformationPainter
+import com.skydoves.landscapist.transformation.isBlurSupported
 
 /**
  * This is an extension of the [Painter] for giving blur transformation effect to the given [imageBitmap].
@@ -36,18 +37,15 @@ internal fun Painter.rememberBlurPainter(
   imageBitmap: ImageBitmap,
   radius: Int,
 ): Painter {
-  var androidBitmap = imageBitmap.asAndroidBitmap()
-
-  if (!(
-      androidBitmap.config == Bitmap.Config.ARGB_8888 ||
-        androidBitmap.config == Bitmap.Config.ALPHA_8
-      )
-  ) {
-    androidBitmap = androidBitmap.copy(Bitmap.Config.ARGB_8888, false)
-  }
-
   val blurredBitmap = remember(imageBitmap, radius) {
-    iterativeBlur(androidBitmap, radius)
+    val androidBitmap = imageBitmap.asAndroidBitmap()
+    if (isBlurSupported(androidBitmap.config)) {
+      // The blur reads and writes the pixels in their own format, e.g. RGBA_F16 or RGB_565.
+      iterativeBlur(androidBitmap, radius, ownsBitmap = false)
+    } else {
+      // E.g. a HARDWARE Bitmap. The converted copy is ours, so it can be blurred in place.
+      iterativeBlur(androidBitmap.copy(Bitmap.Config.ARGB_8888, true), radius, ownsBitmap = true)
+    }
   }
   return remember(this) {
     TransformationPainter(
@@ -57,21 +55,35 @@ internal fun Painter.rememberBlurPainter(
   }
 }
 
+/**
+ * Blurs [androidBitmap] with as many passes of radius 25 as needed. Only the first pass allocates
+ * a Bitmap, and none does if we own [androidBitmap]; the others blur in place.
+ */
 private fun iterativeBlur(
   androidBitmap: Bitmap,
   radius: Int,
+  ownsBitmap: Boolean,
 ): Bitmap {
-  val iterate = (radius + 1) / 25
-  var bitmap: Bitmap = RenderScriptToolkit.blur(
-    inputBitmap = androidBitmap,
-    radius = (radius + 1) % 25,
-  )
+  var iterate = (radius + 1) / 25
+  var firstRadius = (radius + 1) % 25
+  if (firstRadius == 0 && !ownsBitmap) {
+    // There's no shorter first pass, e.g. for a radius of 24, so a radius 25 pass makes the copy.
+    firstRadius = 25
+    iterate--
+  }
+  val bitmap: Bitmap = when {
+    firstRadius == 0 -> androidBitmap
+    ownsBitmap -> androidBitmap.also {
+      RenderScriptToolkit.blurInPlace(it, firstRadius, firstRadius)
+    }
+    else -> RenderScriptToolkit.blur(
+      inputBitmap = androidBitmap,
+      radius = firstRadius,
+    )
+  }
 
   for (i in 0 until iterate) {
-    bitmap = RenderScriptToolkit.blur(
-      inputBitmap = bitmap,
-      radius = 25,
-    )
+    RenderScriptToolkit.blurInPlace(bitmap, radiusX = 25, radiusY = 25)
   }
 
   return bitmap